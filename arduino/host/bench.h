@@ -0,0 +1,59 @@
+/**
+ * LTP Host Build - Micro-Benchmark Registry
+ *
+ * Each benchmark is a function that performs `iterations` operations of a
+ * firmware kernel. The runner (bench_main.cpp) calibrates the iteration
+ * count, takes several samples and reports the median ns per operation.
+ */
+
+#ifndef LTP_HOST_BENCH_H
+#define LTP_HOST_BENCH_H
+
+#include <stdint.h>
+#include <vector>
+
+typedef void (*BenchFunction)(uint32_t iterations);
+
+struct BenchCase {
+    const char* name;   // Hierarchical id, e.g. "parser/pixel_frame_160"
+    const char* unit;   // What one operation is: "packet", "pixel", "frame", ...
+    BenchFunction run;
+};
+
+inline std::vector<BenchCase>& benchRegistry() {
+    static std::vector<BenchCase> cases;
+    return cases;
+}
+
+struct BenchRegistrar {
+    BenchRegistrar(const char* name, const char* unit, BenchFunction run) {
+        benchRegistry().push_back({ name, unit, run });
+    }
+};
+
+// Define and register a benchmark:
+//   LTP_BENCH(checksum_1k, "checksum/1024", "KiB") { ... loop iterations ... }
+#define LTP_BENCH(id, name, unit) \
+    static void id(uint32_t iterations); \
+    static BenchRegistrar id##_registrar(name, unit, id); \
+    static void id(uint32_t iterations)
+
+// Keep a value (and everything it depends on) from being optimized away
+template <typename T>
+inline void benchKeep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Per-process setup hooks run once before any benchmark
+typedef void (*BenchSetupFunction)();
+
+inline std::vector<BenchSetupFunction>& benchSetupHooks() {
+    static std::vector<BenchSetupFunction> hooks;
+    return hooks;
+}
+
+struct BenchSetupRegistrar {
+    explicit BenchSetupRegistrar(BenchSetupFunction fn) { benchSetupHooks().push_back(fn); }
+};
+
+#endif // LTP_HOST_BENCH_H
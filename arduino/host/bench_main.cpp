@@ -0,0 +1,227 @@
+/**
+ * LTP Host Build - Micro-Benchmark Runner
+ *
+ * Usage:
+ *   ltp_bench [--filter TEXT] [--samples N] [--min-time MS]
+ *             [--baseline FILE [--threshold PCT]] [--write-baseline FILE]
+ *
+ * Output is one line per benchmark: name, median ns/op, spread across
+ * samples. With --baseline, each result is compared to the stored value
+ * and the exit status is 1 if any benchmark is slower by more than the
+ * threshold (default 10%).
+ *
+ * Built with PROFILE=1, each benchmark is followed by the firmware profile
+ * sections (profile.h) it entered: calls per operation, mean and max time.
+ * Profiling scopes add their own overhead, so compare those builds only
+ * with each other.
+ */
+
+#include <Arduino.h>
+#include "bench.h"
+#include "profile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Result {
+    std::string name;
+    std::string unit;
+    double nsPerOp;
+    double spread;
+};
+
+// Operations run by measure(), for per-operation profile counts
+uint64_t operationsRun = 0;
+
+double timeRun(const BenchCase& bc, uint32_t iterations) {
+    operationsRun += iterations;
+    auto start = std::chrono::steady_clock::now();
+    bc.run(iterations);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+Result measure(const BenchCase& bc, int samples, double minTimeNs) {
+    // Calibrate: double the iteration count until one run takes a quarter
+    // of the sample time, then scale to the full sample time.
+    uint32_t iterations = 1;
+    double elapsed = timeRun(bc, iterations);
+    while (elapsed < minTimeNs / 4 && iterations < (1u << 30)) {
+        iterations *= 2;
+        elapsed = timeRun(bc, iterations);
+    }
+    iterations = (uint32_t)std::max(1.0, iterations * (minTimeNs / std::max(elapsed, 1.0)));
+
+    std::vector<double> perOp;
+    for (int i = 0; i < samples; i++) {
+        perOp.push_back(timeRun(bc, iterations) / iterations);
+    }
+    std::sort(perOp.begin(), perOp.end());
+
+    Result r;
+    r.name = bc.name;
+    r.unit = bc.unit;
+    r.nsPerOp = perOp[perOp.size() / 2];
+    r.spread = r.nsPerOp > 0 ? (perOp.back() - perOp.front()) / r.nsPerOp * 100.0 : 0;
+    return r;
+}
+
+#if LTP_PROFILE
+const char* const kProfileSections[PROF_SECTION_COUNT] = {
+    "parse/wait_start", "parse/read_flags", "parse/read_length_low", "parse/read_length_high",
+    "parse/read_cmd", "parse/read_payload", "parse/read_checksum",
+    "handle/get_info", "handle/show", "handle/pixel_set_all", "handle/pixel_set_range",
+    "handle/pixel_frame", "handle/set_control", "handle/get_control", "handle/get_pixels",
+    "map_pixel", "driver/show",
+};
+
+// Sections entered since the last clear, per benchmark operation
+void printProfile(uint64_t operations) {
+    for (uint8_t i = 0; i < PROF_SECTION_COUNT; i++) {
+        const LtpProfileEntry& e = LtpProfile::table()[i];
+        if (e.count == 0) continue;
+        printf("    %-40s %10.2f calls/op %10.1f ns mean %10u ns max\n", kProfileSections[i],
+               (double)e.count / operations, (double)e.total / e.count, e.max);
+    }
+}
+#endif
+
+std::map<std::string, double> loadBaseline(const char* path) {
+    std::map<std::string, double> baseline;
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return baseline;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        char name[200];
+        double ns;
+        if (sscanf(line, "%199s %lf", name, &ns) == 2) baseline[name] = ns;
+    }
+    fclose(f);
+    return baseline;
+}
+
+bool writeBaseline(const char* path, const std::vector<Result>& results) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    fprintf(f, "# LTP firmware micro-benchmark baseline (ns per operation)\n");
+    fprintf(f, "# Machine specific: regenerate with 'make bench-baseline' before comparing\n");
+    for (const Result& r : results) {
+        fprintf(f, "%-44s %.2f\n", r.name.c_str(), r.nsPerOp);
+    }
+    fclose(f);
+    return true;
+}
+
+void usage(const char* prog) {
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "\n"
+        "Options:\n"
+        "  --filter TEXT          Only run benchmarks whose name contains TEXT\n"
+        "  --samples N            Samples per benchmark (default 7)\n"
+        "  --min-time MS          Target time per sample (default 20)\n"
+        "  --baseline FILE        Compare against a baseline file\n"
+        "  --threshold PCT        Allowed slowdown vs baseline (default 10)\n"
+        "  --write-baseline FILE  Write results as a new baseline\n"
+        "  --list                 List benchmarks and exit\n",
+        prog);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string filter;
+    int samples = 7;
+    double minTimeMs = 20;
+    const char* baselinePath = nullptr;
+    const char* writePath = nullptr;
+    double threshold = 10.0;
+    bool list = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) filter = argv[++i];
+        else if (arg == "--samples" && hasValue) samples = std::max(1, atoi(argv[++i]));
+        else if (arg == "--min-time" && hasValue) minTimeMs = atof(argv[++i]);
+        else if (arg == "--baseline" && hasValue) baselinePath = argv[++i];
+        else if (arg == "--threshold" && hasValue) threshold = atof(argv[++i]);
+        else if (arg == "--write-baseline" && hasValue) writePath = argv[++i];
+        else if (arg == "--list") list = true;
+        else {
+            usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 2;
+        }
+    }
+
+    std::vector<BenchCase> cases = benchRegistry();
+    std::sort(cases.begin(), cases.end(), [](const BenchCase& a, const BenchCase& b) {
+        return std::string(a.name) < std::string(b.name);
+    });
+
+    if (list) {
+        for (const BenchCase& bc : cases) printf("%s\n", bc.name);
+        return 0;
+    }
+
+    // Benchmarks run on the virtual clock so firmware timeouts and delays
+    // never depend on how long a sample takes.
+    ArduinoHost::useVirtualClock(true);
+    for (BenchSetupFunction hook : benchSetupHooks()) hook();
+
+    std::map<std::string, double> baseline;
+    if (baselinePath) baseline = loadBaseline(baselinePath);
+
+    std::vector<Result> results;
+    int regressions = 0;
+
+    for (const BenchCase& bc : cases) {
+        if (!filter.empty() && std::string(bc.name).find(filter) == std::string::npos) continue;
+
+#if LTP_PROFILE
+        LtpProfile::clear();
+        operationsRun = 0;
+#endif
+        Result r = measure(bc, samples, minTimeMs * 1e6);
+        results.push_back(r);
+
+        std::string unit = "ns/" + r.unit;
+        printf("%-44s %12.2f %-10s (spread %4.1f%%)", r.name.c_str(), r.nsPerOp, unit.c_str(), r.spread);
+
+        auto it = baseline.find(r.name);
+        if (it != baseline.end() && it->second > 0) {
+            double delta = (r.nsPerOp - it->second) / it->second * 100.0;
+            bool regressed = delta > threshold;
+            printf("  %+6.1f%%%s", delta, regressed ? "  REGRESSION" : "");
+            if (regressed) regressions++;
+        } else if (baselinePath) {
+            printf("  (new)");
+        }
+        printf("\n");
+#if LTP_PROFILE
+        printProfile(operationsRun);
+#endif
+        fflush(stdout);
+    }
+
+    if (writePath && !writeBaseline(writePath, results)) return 1;
+
+    if (baselinePath) {
+        printf("\n%d regression(s) over %.1f%% threshold\n", regressions, threshold);
+        return regressions ? 1 : 0;
+    }
+    return 0;
+}
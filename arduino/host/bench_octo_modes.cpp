@@ -0,0 +1,65 @@
+/**
+ * LTP Host Build - ltp_octo_v2 Pixel Mapping Micro-Benchmarks
+ *
+ * Compiled once per display mode (-DMODE_STRIPS, -DMODE_MATRIX_8,
+ * -DMODE_MATRIX_16). The driver is included inside a per-mode namespace so
+ * all three builds link into one benchmark binary.
+ */
+
+#include <Arduino.h>
+#include <OctoWS2811.h>
+#include "protocol.h"
+#include "profile.h"     // Before the namespace: one profile table for all modes
+
+#include "bench.h"
+
+#if defined(MODE_STRIPS)
+    #define BENCH_OCTO_NAMESPACE    bench_octo_strips
+    #define BENCH_OCTO_MODE         "strips"
+#elif defined(MODE_MATRIX_8)
+    #define BENCH_OCTO_NAMESPACE    bench_octo_matrix8
+    #define BENCH_OCTO_MODE         "matrix_8"
+#elif defined(MODE_MATRIX_16)
+    #define BENCH_OCTO_NAMESPACE    bench_octo_matrix16
+    #define BENCH_OCTO_MODE         "matrix_16"
+#else
+    #error "Compile with -DMODE_STRIPS, -DMODE_MATRIX_8 or -DMODE_MATRIX_16"
+#endif
+
+namespace BENCH_OCTO_NAMESPACE {
+
+#include "led_driver_octo.h"
+
+LedDriverOcto octo;
+
+void setupOctoBench() {
+    octo.begin();
+}
+
+BenchSetupRegistrar setupRegistrar(setupOctoBench);
+
+LTP_BENCH(mapPixel, "octo/" BENCH_OCTO_MODE "/map_pixel", "pixel") {
+    uint16_t count = octo.getLogicalPixelCount();
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        sum += octo.mapPixel((uint16_t)(i % count));
+    }
+    benchKeep(sum);
+}
+
+LTP_BENCH(setPixel, "octo/" BENCH_OCTO_MODE "/set_pixel", "pixel") {
+    uint16_t count = octo.getLogicalPixelCount();
+    for (uint32_t i = 0; i < iterations; i++) {
+        octo.setPixel((uint16_t)(i % count), (uint8_t)i, (uint8_t)(i >> 3), (uint8_t)(i >> 5));
+    }
+    benchKeep(octoDrawingMemory);
+}
+
+LTP_BENCH(fill, "octo/" BENCH_OCTO_MODE "/fill", "frame") {
+    for (uint32_t i = 0; i < iterations; i++) {
+        octo.fill((uint8_t)i, 20, 30);
+    }
+    benchKeep(octoDrawingMemory);
+}
+
+} // namespace BENCH_OCTO_NAMESPACE
@@ -0,0 +1,264 @@
+/**
+ * LTP Host Build - ltp_serial_v2 Micro-Benchmarks
+ *
+ * Kernels on the receive-to-wire path of the Uno firmware:
+ *   parser     LtpProtocol::processInput() over recorded packet streams
+ *   handler    Pixel command handlers, called directly (autoShow off)
+ *   driver     LED driver setPixel() and show() encoders
+ *   checksum   Packet XOR checksum
+ *
+ * Links against sketch_serial_v2.cpp; Serial is an in-memory backend and
+ * SPI output goes to a capture buffer, so nothing waits on a wire.
+ */
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#include "bench.h"
+#include "memory_serial.h"
+#include "packet_builder.h"
+
+#include "protocol.h"
+#include "led_driver_lpd8806.h"
+#include "led_driver_lpd8806_palette.h"
+#include "led_driver_lpd8806_spans.h"
+#include "led_driver_apa102.h"
+#include "led_driver_ws2812.h"
+#include "fill.h"
+
+// Sketch globals and handlers (ltp_serial_v2.ino)
+extern LedDriverLPD8806 leds;
+extern LtpProtocol protocol;
+void setup();
+void handlePixelFrame(const uint8_t* payload, uint16_t length);
+void handlePixelSetRange(const uint8_t* payload, uint16_t length);
+
+namespace {
+
+const uint16_t kPixels = 160;
+
+MemorySerialBackend serialMem;
+uint8_t spiCapture[4096];
+
+// Recorded host streams
+std::vector<uint8_t> frameStream;   // PIXEL_FRAME (160 px) + SHOW, 8 frames
+std::vector<uint8_t> mixedStream;   // Small commands typical of interactive use
+
+// Handler payloads
+std::vector<uint8_t> framePayload;
+std::vector<uint8_t> rangeFullPayload;
+std::vector<uint8_t> rangeShortPayload;
+
+uint8_t checksumData[1024];
+
+// Standalone drivers with the sketch's pixel count, in static storage
+alignas(8) uint8_t lpd8806HwStorage[LedDriverLPD8806::storageBytes(kPixels)];
+alignas(8) uint8_t lpd8806SoftStorage[LedDriverLPD8806::storageBytes(kPixels)];
+alignas(8) uint8_t lpd8806Pal4Storage[LedDriverLPD8806Palette<4>::storageBytes(kPixels)];
+alignas(8) uint8_t lpd8806SpansStorage[LedDriverLPD8806Spans<32>::storageBytes(kPixels)];
+alignas(8) uint8_t apa102HwStorage[LedDriverAPA102::storageBytes(kPixels)];
+alignas(8) uint8_t apa102SoftStorage[LedDriverAPA102::storageBytes(kPixels)];
+alignas(8) uint8_t ws2812Storage[LedDriverWS2812::storageBytes(kPixels)];
+
+LedDriverLPD8806 lpd8806Hw(kPixels, lpd8806HwStorage, 11, 13, true);
+LedDriverLPD8806 lpd8806Soft(kPixels, lpd8806SoftStorage, 11, 13, false);
+LedDriverLPD8806Palette<4> lpd8806Pal4(kPixels, lpd8806Pal4Storage, 11, 13, true);
+LedDriverLPD8806Spans<32> lpd8806Spans(kPixels, lpd8806SpansStorage, 11, 13, true);
+LedDriverAPA102 apa102Hw(kPixels, apa102HwStorage, 11, 13, true);
+LedDriverAPA102 apa102Soft(kPixels, apa102SoftStorage, 11, 13, false);
+LedDriverWS2812 ws2812(kPixels, ws2812Storage, 6);
+
+void setupSerialBench() {
+    Serial.setBackend(&serialMem);
+    setup();
+
+    for (uint16_t f = 0; f < 8; f++) {
+        std::vector<uint8_t> rgb = PacketBuilder::testPattern(kPixels, (uint8_t)f);
+        PacketBuilder::append(frameStream, CMD_PIXEL_FRAME, PacketBuilder::pixelFramePayload(0, 0, rgb.data(), kPixels));
+        PacketBuilder::append(frameStream, CMD_SHOW, PacketBuilder::showPayload(f));
+    }
+
+    const uint8_t setAll[] = { 0, 10, 20, 30 };
+    const uint8_t getInfo[] = { INFO_STATS };
+    PacketBuilder::append(mixedStream, CMD_NOP, nullptr, 0, FLAG_ACK_REQ);
+    PacketBuilder::append(mixedStream, CMD_PIXEL_SET_ALL, setAll, sizeof(setAll));
+    PacketBuilder::append(mixedStream, CMD_PIXEL_SET_RANGE, PacketBuilder::setRangePayload(0, 10, 20, 255, 0, 0));
+    PacketBuilder::append(mixedStream, CMD_GET_INFO, getInfo, sizeof(getInfo));
+    PacketBuilder::append(mixedStream, CMD_SHOW, PacketBuilder::showPayload(1));
+
+    std::vector<uint8_t> rgb = PacketBuilder::testPattern(kPixels);
+    framePayload = PacketBuilder::pixelFramePayload(0, 0, rgb.data(), kPixels);
+    rangeFullPayload = PacketBuilder::setRangePayload(0, 0, kPixels, 12, 34, 56);
+    rangeShortPayload = PacketBuilder::setRangePayload(0, 40, 50, 12, 34, 56);
+
+    for (size_t i = 0; i < sizeof(checksumData); i++) checksumData[i] = (uint8_t)(i * 31);
+
+    lpd8806Hw.begin();
+    lpd8806Soft.begin();
+    apa102Hw.begin();
+    apa102Soft.begin();
+    ws2812.begin();
+}
+
+BenchSetupRegistrar setupRegistrar(setupSerialBench);
+
+// Parse `iterations` packets from a looping stream
+void parseStream(const std::vector<uint8_t>& stream, uint32_t iterations) {
+    serialMem.setInput(stream.data(), stream.size());
+    for (uint32_t i = 0; i < iterations; i++) {
+        if (serialMem.exhausted()) serialMem.rewind();
+        bool complete = protocol.processInput();
+        benchKeep(complete);
+    }
+    serialMem.setInput(nullptr, 0);
+}
+
+void fillFrame(LedDriver& driver, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint16_t index = i % kPixels;
+        driver.setPixel(index, (uint8_t)i, (uint8_t)(i >> 3), (uint8_t)(i >> 5));
+    }
+    benchKeep(*driver.getPixelBuffer());
+}
+
+void showFrames(LedDriver& driver, uint32_t iterations) {
+    SPI.setCapture(spiCapture, sizeof(spiCapture));
+    for (uint32_t i = 0; i < iterations; i++) {
+        SPI.rewindCapture();
+        driver.show();
+    }
+    SPI.setCapture(nullptr, 0);
+    benchKeep(spiCapture);
+}
+
+} // namespace
+
+// ============================================================================
+// Parser
+// ============================================================================
+
+LTP_BENCH(parserFrame160, "parser/pixel_frame_160+show", "packet") {
+    parseStream(frameStream, iterations);
+}
+
+LTP_BENCH(parserMixed, "parser/small_commands", "packet") {
+    parseStream(mixedStream, iterations);
+}
+
+// ============================================================================
+// Handlers
+// ============================================================================
+
+LTP_BENCH(handlerPixelFrame, "handler/pixel_frame_160", "frame") {
+    for (uint32_t i = 0; i < iterations; i++) {
+        handlePixelFrame(framePayload.data(), (uint16_t)framePayload.size());
+    }
+    benchKeep(*leds.getPixelBuffer());
+}
+
+LTP_BENCH(handlerSetRangeFull, "handler/pixel_set_range_160", "command") {
+    for (uint32_t i = 0; i < iterations; i++) {
+        handlePixelSetRange(rangeFullPayload.data(), (uint16_t)rangeFullPayload.size());
+    }
+    benchKeep(*leds.getPixelBuffer());
+}
+
+LTP_BENCH(handlerSetRangeShort, "handler/pixel_set_range_10", "command") {
+    for (uint32_t i = 0; i < iterations; i++) {
+        handlePixelSetRange(rangeShortPayload.data(), (uint16_t)rangeShortPayload.size());
+    }
+    benchKeep(*leds.getPixelBuffer());
+}
+
+// ============================================================================
+// Drivers
+// ============================================================================
+
+LTP_BENCH(lpd8806SetPixel, "driver/lpd8806/set_pixel", "pixel") {
+    fillFrame(lpd8806Hw, iterations);
+}
+
+LTP_BENCH(lpd8806ShowHw, "driver/lpd8806/show_160_hw_spi", "frame") {
+    showFrames(lpd8806Hw, iterations);
+}
+
+LTP_BENCH(lpd8806ShowSoft, "driver/lpd8806/show_160_bitbang", "frame") {
+    showFrames(lpd8806Soft, iterations);
+}
+
+// Palette-indexed: setPixel() searches the 16 entries for the nearest color
+LTP_BENCH(lpd8806Pal4SetPixel, "driver/lpd8806_pal4/set_pixel", "pixel") {
+    for (uint32_t i = 0; i < iterations; i++) {
+        lpd8806Pal4.setPixel(i % kPixels, (uint8_t)i, (uint8_t)(i >> 3), (uint8_t)(i >> 5));
+    }
+    benchKeep(lpd8806Pal4.getIndex(0));
+}
+
+LTP_BENCH(lpd8806Pal4SetIndex, "driver/lpd8806_pal4/set_index", "pixel") {
+    for (uint32_t i = 0; i < iterations; i++) {
+        lpd8806Pal4.setIndex(i % kPixels, i & 0x0F);
+    }
+    benchKeep(lpd8806Pal4.getIndex(0));
+}
+
+LTP_BENCH(lpd8806Pal4ShowHw, "driver/lpd8806_pal4/show_160_hw_spi", "frame") {
+    showFrames(lpd8806Pal4, iterations);
+}
+
+LTP_BENCH(lpd8806Pal4Rotate, "driver/lpd8806_pal4/rotate_16", "rotation") {
+    for (uint32_t i = 0; i < iterations; i++) {
+        lpd8806Pal4.rotate(0, 16, 1);
+    }
+    benchKeep(lpd8806Pal4.nearest(255, 0, 0));
+}
+
+// Display list: fillRange() rewrites the span list; show() evaluates 20
+// solid blocks or one three-stop gradient (two ramps) per frame
+LTP_BENCH(lpd8806SpansFillRange, "driver/lpd8806_spans/fill_range_8", "range") {
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint16_t start = (i % (kPixels / 8)) * 8;
+        lpd8806Spans.fillRange(start, start + 8, (uint8_t)i, (uint8_t)(i >> 3), 0);
+    }
+    benchKeep(lpd8806Spans.spanCount());
+}
+
+LTP_BENCH(lpd8806SpansShowBlocks, "driver/lpd8806_spans/show_160_blocks_hw_spi", "frame") {
+    for (uint16_t i = 0; i < kPixels; i += 8) {
+        lpd8806Spans.fillRange(i, i + 8, (uint8_t)i, 0, 255 - i);
+    }
+    showFrames(lpd8806Spans, iterations);
+}
+
+LTP_BENCH(lpd8806SpansShowGradient, "driver/lpd8806_spans/show_160_gradient_hw_spi", "frame") {
+    const uint8_t gradient[] = { FILL_GRADIENT, 3, 255, 0, 0, 0, 255, 0, 0, 0, 255 };
+    LtpFill::draw(gradient, sizeof(gradient), 0, kPixels, lpd8806Spans);
+    showFrames(lpd8806Spans, iterations);
+}
+
+LTP_BENCH(apa102SetPixel, "driver/apa102/set_pixel", "pixel") {
+    fillFrame(apa102Hw, iterations);
+}
+
+LTP_BENCH(apa102ShowHw, "driver/apa102/show_160_hw_spi", "frame") {
+    showFrames(apa102Hw, iterations);
+}
+
+LTP_BENCH(apa102ShowSoft, "driver/apa102/show_160_bitbang", "frame") {
+    showFrames(apa102Soft, iterations);
+}
+
+LTP_BENCH(ws2812SetPixel, "driver/ws2812_stub/set_pixel", "pixel") {
+    fillFrame(ws2812, iterations);
+}
+
+// ============================================================================
+// Checksum
+// ============================================================================
+
+LTP_BENCH(checksum1k, "checksum/1024_bytes", "KiB") {
+    uint8_t sum = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        sum ^= LtpProtocol::checksum(checksumData, sizeof(checksumData), (uint8_t)i);
+        benchKeep(sum);
+    }
+}
@@ -0,0 +1,519 @@
+/**
+ * LTP Host Build - Link/LED Capacity Planner
+ *
+ * Estimates the sustainable frame rate of a controller configuration and
+ * the stage that limits it. Packet sizes, payload limits and the parser
+ * timeout come from the firmware's protocol.h; LED timings follow the
+ * drivers in ltp_serial_v2 and ltp_octo_v2.
+ *
+ * Per frame the model accounts for:
+ *   link      Host-to-device bytes (pixel packets + SHOW) at the link rate
+ *   cpu       Receive ISR + parser per byte, handler per pixel and packet
+ *   show      Time show() blocks the CPU (SPI/bit-bang/WS2812 output)
+ *   dma       OctoWS2811 DMA output, overlapped with the next frame
+ *   response  FRAME_ACK traffic back to the host, and the round trip when
+ *             the host waits for it
+ *
+ * CPU costs per MCU are estimates (see McuProfile); the "host" profile
+ * sets them to zero to match the virtual MCU, against which the link and
+ * DMA model can be checked (validate_capacity.py).
+ */
+
+#include "protocol.h"
+
+#include <algorithm>
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+// START + flags + length (2) + cmd + checksum
+const uint32_t PACKET_OVERHEAD = 6;
+// PIXEL_FRAME payload header: strip, start (2), count (2)
+const uint32_t PIXEL_FRAME_HEADER = 5;
+
+// ============================================================================
+// Hardware profiles
+// ============================================================================
+
+struct McuProfile {
+    const char* name;
+    double clockHz;
+    double cyclesPerByte;       // RX interrupt + LtpProtocol::processInput()
+    double cyclesPerPixel;      // Handler loop + LedDriver::setPixel()
+    double cyclesPerPacket;     // Dispatch, validation, stats
+    double cyclesPerSpiByte;    // SPI.transfer() overhead beyond the wire time
+    double cyclesPerBitbangByte;// 8 x (data + 2 clock) digitalWrite() calls
+    bool ws2812NoInterrupts;    // WS2812 output runs with interrupts off (AVR NeoPixel)
+};
+
+// Estimates from the instruction mix of the paths above; override with
+// --cycles-per-byte/--cycles-per-pixel when measured on real hardware.
+const McuProfile MCUS[] = {
+    { "avr16",    16000000.0, 120, 70, 600, 14, 1200, true  },  // ATmega328P (Uno/Nano)
+    { "teensy32", 72000000.0,  25, 30, 300,  6,  200, false },  // MK20DX256 (Teensy 3.2)
+    { "host",              0,   0,  0,   0,  0,    0, false },  // Virtual MCU: CPU time ignored
+};
+
+enum class Driver { LPD8806, APA102, WS2812, OCTO };
+
+struct Controller {
+    const char* name;
+    const char* description;
+    const char* mcu;
+    Driver driver;
+    uint32_t baud;              // 0 = USB CDC
+    uint16_t maxPayload;        // Sketch MAX_PAYLOAD_SIZE
+    uint16_t rxBuffer;          // UART receive buffer
+    uint16_t pixels;            // Per strip
+    uint8_t strips;
+    uint8_t spiDivider;         // F_CPU / n
+    bool realSpiTime;           // SPI/bit-bang output takes wire time
+};
+
+const Controller CONTROLLERS[] = {
+    { "uno-lpd8806",  "ltp_serial_v2 on Uno, LPD8806 over hardware SPI",
+      "avr16",    Driver::LPD8806, 115200, 512,   64, 160, 1, 8, true },
+    { "uno-apa102",   "ltp_serial_v2 on Uno, APA102 over hardware SPI",
+      "avr16",    Driver::APA102,  115200, 512,   64, 160, 1, 4, true },
+    { "uno-ws2812",   "ltp_serial_v2 on Uno, WS2812 via Adafruit NeoPixel",
+      "avr16",    Driver::WS2812,  115200, 512,   64, 160, 1, 0, true },
+    { "teensy-octo",  "ltp_octo_v2 on Teensy 3.2, 8 x 120 WS2812 (STRIPS mode)",
+      "teensy32", Driver::OCTO,         0, 4096, 4096, 120, 8, 0, true },
+    { "vmcu-serial",  "Virtual MCU build of ltp_serial_v2 (host/vmcu_main.cpp)",
+      "host",     Driver::LPD8806, 115200, 512,   64, 160, 1, 8, false },
+    { "vmcu-octo",    "Virtual MCU build of ltp_octo_v2 (host/vmcu_main.cpp)",
+      "host",     Driver::OCTO,         0, 4096, 4096, 120, 8, 0, true },
+};
+
+const double F_CPU_AVR = 16000000.0;
+
+// ============================================================================
+// Model
+// ============================================================================
+
+enum class Encoding { FRAME, RLE, SET_ALL };
+enum class AckMode { NONE, FRAME, WAIT };
+
+struct Config {
+    Controller ctl;
+    McuProfile mcu;
+    bool bitbang = false;
+    double usbBytesPerSec = 1000000;   // Full-speed USB CDC, effective
+    Encoding encoding = Encoding::FRAME;
+    double rleRatio = 0.5;
+    AckMode ack = AckMode::NONE;
+    double hostLatencyMs = 1.0;        // USB-serial adapter / USB frame latency
+    bool autoShow = false;
+};
+
+struct Estimate {
+    uint32_t packets;
+    uint32_t txBytes;           // Host to device
+    uint32_t rxBytes;           // Device to host
+    uint32_t shows;
+    double linkMs;
+    double cpuMs;
+    double showMs;              // CPU blocked in show()
+    double dmaMs;
+    double responseMs;
+    double periodMs;
+    double fps;
+    const char* bottleneck;
+    std::vector<std::string> warnings;
+};
+
+uint32_t packetBytes(uint32_t payload) { return PACKET_OVERHEAD + payload; }
+
+// Received bytes are lost while show() runs
+bool showBlocksReceive(const Config& c) {
+    return c.ctl.driver == Driver::WS2812 && c.mcu.ws2812NoInterrupts;
+}
+
+double byteTimeMs(const Config& c) {
+    if (c.ctl.baud == 0) return c.usbBytesPerSec > 0 ? 1000.0 / c.usbBytesPerSec : 0;
+    return 10.0 * 1000.0 / c.ctl.baud;      // 8N1
+}
+
+double cyclesMs(const Config& c, double cycles) {
+    return c.mcu.clockHz > 0 ? cycles / c.mcu.clockHz * 1000.0 : 0;
+}
+
+// Time one show() call keeps the CPU busy, and DMA time after it returns
+void showTime(const Config& c, double& blockingMs, double& dmaMs) {
+    uint32_t n = c.ctl.pixels;
+    blockingMs = 0;
+    dmaMs = 0;
+
+    uint32_t spiBytes = 0;
+    switch (c.ctl.driver) {
+        case Driver::LPD8806:
+            spiBytes = n * 3 + (n + 31) / 32;               // GRB + latch
+            break;
+        case Driver::APA102:
+            spiBytes = 4 + n * 4 + (n / 16) + 1;            // start + BGR+brightness + end
+            break;
+        case Driver::WS2812:
+            blockingMs = n * 0.030 + 0.050;                 // 24 bits at 800 kHz + reset
+            return;
+        case Driver::OCTO:
+            dmaMs = n * 0.030 + 0.300;                      // Per strip, all strips in parallel
+            return;
+    }
+
+    if (!c.ctl.realSpiTime) return;
+    if (c.bitbang) {
+        blockingMs = cyclesMs(c, spiBytes * c.mcu.cyclesPerBitbangByte);
+    } else {
+        double wireMs = spiBytes * 8.0 * c.ctl.spiDivider / F_CPU_AVR * 1000.0;
+        blockingMs = wireMs + cyclesMs(c, spiBytes * c.mcu.cyclesPerSpiByte);
+    }
+}
+
+Estimate estimate(const Config& c) {
+    Estimate e = {};
+    uint16_t maxPayload = std::min<uint16_t>(c.ctl.maxPayload, LTP_MAX_PAYLOAD);
+    uint32_t pixels = (uint32_t)c.ctl.pixels * c.ctl.strips;
+
+    // Host-to-device packets for one frame
+    if (c.encoding == Encoding::SET_ALL) {
+        e.packets = 1;
+        e.txBytes = packetBytes(4);
+    } else {
+        uint32_t perPacket = (maxPayload - PIXEL_FRAME_HEADER) / 3;
+        if (c.encoding == Encoding::RLE) perPacket = (uint32_t)(perPacket / c.rleRatio);
+        for (uint8_t s = 0; s < c.ctl.strips; s++) {
+            for (uint32_t start = 0; start < c.ctl.pixels; start += perPacket) {
+                uint32_t count = std::min(perPacket, (uint32_t)c.ctl.pixels - start);
+                uint32_t data = count * 3;
+                if (c.encoding == Encoding::RLE) data = (uint32_t)ceil(data * c.rleRatio);
+                e.packets++;
+                e.txBytes += packetBytes(PIXEL_FRAME_HEADER + data);
+            }
+        }
+    }
+
+    if (c.autoShow) {
+        e.shows = e.packets;
+    } else {
+        e.shows = 1;
+        e.packets++;
+        e.txBytes += packetBytes(2);
+    }
+
+    if (c.ack != AckMode::NONE) e.rxBytes = packetBytes(4);  // FRAME_ACK
+
+    double byteMs = byteTimeMs(c);
+    e.linkMs = e.txBytes * byteMs;
+    e.responseMs = e.rxBytes * byteMs;
+
+    e.cpuMs = cyclesMs(c, e.txBytes * c.mcu.cyclesPerByte +
+                          pixels * c.mcu.cyclesPerPixel +
+                          e.packets * c.mcu.cyclesPerPacket);
+
+    double blockingMs, dmaMs;
+    showTime(c, blockingMs, dmaMs);
+    e.showMs = blockingMs * e.shows;
+    e.dmaMs = dmaMs;
+
+    // Steady-state frame period
+    struct Stage { const char* name; double ms; };
+    std::vector<Stage> stages;
+    if (c.ack == AckMode::WAIT) {
+        // Stop-and-wait: nothing overlaps
+        double rtt = e.linkMs + e.cpuMs + e.showMs + e.responseMs + c.hostLatencyMs;
+        stages.push_back({ "ack round trip", std::max(rtt, e.dmaMs) });
+    } else if (showBlocksReceive(c) && e.showMs > 0) {
+        // Bytes arriving during show() are lost, so the host must pause
+        stages.push_back({ "link + show (interrupts off)", std::max(e.linkMs, e.cpuMs) + e.showMs });
+    } else {
+        stages.push_back({ "link", e.linkMs });
+        stages.push_back({ "cpu + show", e.cpuMs + e.showMs });
+        stages.push_back({ "led output (dma)", e.dmaMs });
+        stages.push_back({ "responses", e.responseMs });
+    }
+
+    e.periodMs = 0;
+    e.bottleneck = "none";
+    for (const Stage& s : stages) {
+        if (s.ms > e.periodMs) {
+            e.periodMs = s.ms;
+            e.bottleneck = s.name;
+        }
+    }
+    e.fps = e.periodMs > 0 ? 1000.0 / e.periodMs : INFINITY;
+
+    // Loss hazards
+    char buf[200];
+    if (c.encoding == Encoding::RLE) {
+        e.warnings.push_back("PIXEL_FRAME_RLE is not implemented by ltp_serial_v2/ltp_octo_v2");
+    }
+    if (c.ctl.baud && e.showMs > 0 && !showBlocksReceive(c) && c.ack != AckMode::WAIT) {
+        double arriving = blockingMs / byteMs;
+        if (arriving > c.ctl.rxBuffer) {
+            snprintf(buf, sizeof(buf),
+                     "RX overrun: %.0f bytes arrive during a %.2f ms show(), the UART buffer holds %u",
+                     arriving, blockingMs, c.ctl.rxBuffer);
+            e.warnings.push_back(buf);
+        }
+    }
+    if (showBlocksReceive(c) && e.showMs > 0 && c.ack != AckMode::WAIT) {
+        e.warnings.push_back("show() runs with interrupts off: bytes sent during it are lost; "
+                             "use --ack wait or pace frames on the host");
+    }
+    // A packet split across a long show() is dropped by the inter-byte timeout
+    double blockedMs = blockingMs;
+    if (e.dmaMs > 0) blockedMs = std::max(blockedMs, e.dmaMs - e.linkMs - e.cpuMs);
+    if (blockedMs > LtpProtocol::INTER_BYTE_TIMEOUT && c.ack != AckMode::WAIT) {
+        snprintf(buf, sizeof(buf),
+                 "show() blocks %.1f ms > INTER_BYTE_TIMEOUT (%u ms): a packet in flight is discarded",
+                 blockedMs, (unsigned)LtpProtocol::INTER_BYTE_TIMEOUT);
+        e.warnings.push_back(buf);
+    }
+    if (c.ctl.maxPayload > LTP_MAX_PAYLOAD) {
+        snprintf(buf, sizeof(buf), "MAX_PAYLOAD_SIZE %u is clamped to LTP_MAX_PAYLOAD (%u)",
+                 c.ctl.maxPayload, LTP_MAX_PAYLOAD);
+        e.warnings.push_back(buf);
+    }
+    return e;
+}
+
+// ============================================================================
+// Output
+// ============================================================================
+
+const char* driverName(Driver d) {
+    switch (d) {
+        case Driver::LPD8806: return "lpd8806";
+        case Driver::APA102:  return "apa102";
+        case Driver::WS2812:  return "ws2812";
+        case Driver::OCTO:    return "octo";
+    }
+    return "?";
+}
+
+std::string linkName(const Config& c) {
+    char buf[64];
+    if (c.ctl.baud) snprintf(buf, sizeof(buf), "UART %u baud", c.ctl.baud);
+    else snprintf(buf, sizeof(buf), "USB CDC %.0f KB/s", c.usbBytesPerSec / 1000);
+    return buf;
+}
+
+void printReport(const Config& c, const Estimate& e) {
+    static const char* ACK_NAMES[] = { "none", "frame (pipelined)", "wait (stop-and-wait)" };
+    static const char* ENC_NAMES[] = { "PIXEL_FRAME", "PIXEL_FRAME_RLE", "PIXEL_SET_ALL" };
+
+    printf("Controller:   %s (%s)\n", c.ctl.name, c.mcu.name);
+    printf("LEDs:         %u x %u %s%s\n", c.ctl.strips, c.ctl.pixels, driverName(c.ctl.driver),
+           c.bitbang ? " (bit-bang)" : "");
+    printf("Link:         %s, max payload %u\n", linkName(c).c_str(),
+           std::min<uint16_t>(c.ctl.maxPayload, LTP_MAX_PAYLOAD));
+    printf("Encoding:     %s%s, ack %s\n", ENC_NAMES[(int)c.encoding], c.autoShow ? " + auto-show" : " + SHOW",
+           ACK_NAMES[(int)c.ack]);
+    printf("\n");
+    printf("Per frame:\n");
+    printf("  Host->device   %6u bytes in %u packets   %8.3f ms\n", e.txBytes, e.packets, e.linkMs);
+    printf("  Parse/handle                              %8.3f ms\n", e.cpuMs);
+    printf("  show() x%-3u                              %8.3f ms\n", e.shows, e.showMs);
+    if (e.dmaMs > 0) printf("  DMA output                                %8.3f ms\n", e.dmaMs);
+    if (e.rxBytes) printf("  Device->host   %6u bytes                %8.3f ms\n", e.rxBytes, e.responseMs);
+    printf("\n");
+    printf("Sustainable:  %.1f FPS (%.3f ms/frame), bottleneck: %s\n", e.fps, e.periodMs, e.bottleneck);
+    for (const std::string& w : e.warnings) printf("Warning:      %s\n", w.c_str());
+}
+
+void printCsvHeader() {
+    printf("controller,pixels,strips,link,tx_bytes,packets,link_ms,cpu_ms,show_ms,dma_ms,period_ms,fps,bottleneck\n");
+}
+
+void printCsvRow(const Config& c, const Estimate& e) {
+    printf("%s,%u,%u,%s,%u,%u,%.3f,%.3f,%.3f,%.3f,%.3f,%.1f,%s\n", c.ctl.name, c.ctl.pixels, c.ctl.strips,
+           c.ctl.baud ? std::to_string(c.ctl.baud).c_str() : "usb", e.txBytes, e.packets, e.linkMs, e.cpuMs,
+           e.showMs, e.dmaMs, e.periodMs, e.fps, e.bottleneck);
+}
+
+std::vector<uint32_t> parseList(const char* s) {
+    std::vector<uint32_t> values;
+    std::string str = s;
+    size_t pos = 0;
+    while (pos <= str.size()) {
+        size_t comma = str.find(',', pos);
+        if (comma == std::string::npos) comma = str.size();
+        if (comma > pos) values.push_back((uint32_t)strtoul(str.substr(pos, comma - pos).c_str(), nullptr, 0));
+        pos = comma + 1;
+    }
+    return values;
+}
+
+void usage(const char* prog) {
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "\n"
+        "Estimate sustainable FPS and the limiting stage for an LTP controller.\n"
+        "\n"
+        "Options:\n"
+        "  --controller NAME     Start from a profile (default uno-lpd8806, --list)\n"
+        "  --driver NAME         lpd8806, apa102, ws2812 or octo\n"
+        "  --mcu NAME            avr16, teensy32 or host\n"
+        "  --pixels N            Pixels per strip\n"
+        "  --strips N            Number of strips\n"
+        "  --baud N              UART link at N baud\n"
+        "  --usb [BYTES_PER_S]   USB CDC link (default 1000000 B/s)\n"
+        "  --max-payload N       Sketch MAX_PAYLOAD_SIZE\n"
+        "  --rx-buffer N         UART receive buffer\n"
+        "  --spi-div N           SPI clock divider (F_CPU / N)\n"
+        "  --bitbang             Software SPI instead of hardware SPI\n"
+        "  --encoding E          frame, rle or set_all (default frame)\n"
+        "  --rle-ratio R         Compressed/raw size for rle (default 0.5)\n"
+        "  --ack MODE            none, frame or wait (default none)\n"
+        "  --host-latency MS     Host turnaround for --ack wait (default 1)\n"
+        "  --auto-show           Device shows after every pixel packet\n"
+        "  --cycles-per-byte N   Override the MCU receive cost\n"
+        "  --cycles-per-pixel N  Override the MCU handler cost\n"
+        "  --sweep-pixels LIST   Evaluate each pixel count (comma separated)\n"
+        "  --sweep-baud LIST     Evaluate each baud rate (0 = USB)\n"
+        "  --csv                 Machine-readable output\n"
+        "  --list                List controller profiles\n",
+        prog);
+}
+
+template <typename T, size_t N>
+const T* findByName(const T (&table)[N], const std::string& name) {
+    for (const T& t : table) {
+        if (name == t.name) return &t;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config c;
+    c.ctl = CONTROLLERS[0];
+    c.mcu = *findByName(MCUS, c.ctl.mcu);
+    std::vector<uint32_t> sweepPixels;
+    std::vector<uint32_t> sweepBaud;
+    bool csv = false;
+
+    // The controller profile is applied first so other options refine it
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--controller") {
+            const Controller* ctl = findByName(CONTROLLERS, argv[i + 1]);
+            if (!ctl) {
+                fprintf(stderr, "Unknown controller: %s (see --list)\n", argv[i + 1]);
+                return 2;
+            }
+            c.ctl = *ctl;
+            c.mcu = *findByName(MCUS, c.ctl.mcu);
+        }
+    }
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--controller" && hasValue) {
+            i++;
+        } else if (arg == "--driver" && hasValue) {
+            std::string d = argv[++i];
+            if (d == "lpd8806") c.ctl.driver = Driver::LPD8806;
+            else if (d == "apa102") c.ctl.driver = Driver::APA102;
+            else if (d == "ws2812") c.ctl.driver = Driver::WS2812;
+            else if (d == "octo") c.ctl.driver = Driver::OCTO;
+            else { usage(argv[0]); return 2; }
+        } else if (arg == "--mcu" && hasValue) {
+            const McuProfile* mcu = findByName(MCUS, argv[++i]);
+            if (!mcu) { usage(argv[0]); return 2; }
+            c.mcu = *mcu;
+        } else if (arg == "--pixels" && hasValue) {
+            c.ctl.pixels = (uint16_t)strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--strips" && hasValue) {
+            c.ctl.strips = (uint8_t)strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--baud" && hasValue) {
+            c.ctl.baud = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--usb") {
+            c.ctl.baud = 0;
+            if (hasValue && isdigit((unsigned char)argv[i + 1][0])) c.usbBytesPerSec = atof(argv[++i]);
+        } else if (arg == "--max-payload" && hasValue) {
+            c.ctl.maxPayload = (uint16_t)strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--rx-buffer" && hasValue) {
+            c.ctl.rxBuffer = (uint16_t)strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--spi-div" && hasValue) {
+            c.ctl.spiDivider = (uint8_t)strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--bitbang") {
+            c.bitbang = true;
+        } else if (arg == "--encoding" && hasValue) {
+            std::string e = argv[++i];
+            if (e == "frame") c.encoding = Encoding::FRAME;
+            else if (e == "rle") c.encoding = Encoding::RLE;
+            else if (e == "set_all") c.encoding = Encoding::SET_ALL;
+            else { usage(argv[0]); return 2; }
+        } else if (arg == "--rle-ratio" && hasValue) {
+            c.rleRatio = std::max(0.01, atof(argv[++i]));
+        } else if (arg == "--ack" && hasValue) {
+            std::string a = argv[++i];
+            if (a == "none") c.ack = AckMode::NONE;
+            else if (a == "frame") c.ack = AckMode::FRAME;
+            else if (a == "wait") c.ack = AckMode::WAIT;
+            else { usage(argv[0]); return 2; }
+        } else if (arg == "--host-latency" && hasValue) {
+            c.hostLatencyMs = atof(argv[++i]);
+        } else if (arg == "--auto-show") {
+            c.autoShow = true;
+        } else if (arg == "--cycles-per-byte" && hasValue) {
+            c.mcu.cyclesPerByte = atof(argv[++i]);
+        } else if (arg == "--cycles-per-pixel" && hasValue) {
+            c.mcu.cyclesPerPixel = atof(argv[++i]);
+        } else if (arg == "--sweep-pixels" && hasValue) {
+            sweepPixels = parseList(argv[++i]);
+        } else if (arg == "--sweep-baud" && hasValue) {
+            sweepBaud = parseList(argv[++i]);
+        } else if (arg == "--csv") {
+            csv = true;
+        } else if (arg == "--list") {
+            for (const Controller& ctl : CONTROLLERS) printf("  %-14s %s\n", ctl.name, ctl.description);
+            return 0;
+        } else {
+            usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 2;
+        }
+    }
+
+    if (c.ctl.pixels == 0 || c.ctl.strips == 0) {
+        fprintf(stderr, "Pixel and strip counts must be non-zero\n");
+        return 2;
+    }
+    if (c.ctl.driver == Driver::OCTO && c.ctl.strips > 8) {
+        fprintf(stderr, "OctoWS2811 drives at most 8 strips\n");
+        return 2;
+    }
+
+    if (sweepPixels.empty()) sweepPixels.push_back(c.ctl.pixels);
+    if (sweepBaud.empty()) sweepBaud.push_back(c.ctl.baud);
+    bool table = csv || sweepPixels.size() > 1 || sweepBaud.size() > 1;
+
+    if (csv) printCsvHeader();
+    else if (table) printf("%-10s %8s %12s %10s %10s  %s\n", "pixels", "strips", "link", "ms/frame", "fps", "bottleneck");
+
+    for (uint32_t baud : sweepBaud) {
+        for (uint32_t pixels : sweepPixels) {
+            Config run = c;
+            run.ctl.baud = baud;
+            run.ctl.pixels = (uint16_t)pixels;
+            Estimate e = estimate(run);
+            if (csv) {
+                printCsvRow(run, e);
+            } else if (table) {
+                printf("%-10u %8u %12s %10.3f %10.1f  %s%s\n", pixels, run.ctl.strips,
+                       baud ? std::to_string(baud).c_str() : "usb", e.periodMs, e.fps, e.bottleneck,
+                       e.warnings.empty() ? "" : "  (!)");
+            } else {
+                printReport(run, e);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * LTP Host Build - Serial Capture Files
+ *
+ * Timestamped raw bytes per direction, as seen on the serial link. The
+ * same format is written by ltp_serial_cli (LtpDevice capture=...), the
+ * serial sink (--capture) and the virtual MCU (--capture), and read by the
+ * replay harness. See src/ltp_serial_cli/capture.py for the Python side.
+ *
+ * Layout (all integers little-endian):
+ *   Header   "LTPCAP01" (8 bytes), uint64 start time (us since Unix epoch)
+ *   Record   uint64 timestamp (us since start), uint8 direction,
+ *            uint16 length, data[length]
+ *
+ * Direction 0 is host to device, 1 is device to host.
+ */
+
+#ifndef LTP_HOST_CAPTURE_FILE_H
+#define LTP_HOST_CAPTURE_FILE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <vector>
+
+#define LTP_CAPTURE_MAGIC       "LTPCAP01"
+#define LTP_CAPTURE_HEADER_SIZE 16
+#define LTP_CAPTURE_RECORD_SIZE 11
+
+#define LTP_CAPTURE_HOST_TO_DEVICE  0
+#define LTP_CAPTURE_DEVICE_TO_HOST  1
+
+struct CaptureRecord {
+    uint64_t timestampUs;
+    uint8_t direction;
+    std::vector<uint8_t> data;
+};
+
+namespace CaptureFile {
+
+inline uint64_t epochMicros() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+inline void putLE(uint8_t* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) out[i] = (uint8_t)(value >> (8 * i));
+}
+
+inline uint64_t getLE(const uint8_t* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) value |= (uint64_t)in[i] << (8 * i);
+    return value;
+}
+
+/**
+ * Load every record of a capture file.
+ * Returns false if the file cannot be read or has no valid header;
+ * a truncated final record is ignored.
+ */
+inline bool load(const char* path, std::vector<CaptureRecord>& records, uint64_t* startEpochUs = nullptr) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+
+    uint8_t header[LTP_CAPTURE_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), f) != sizeof(header) || memcmp(header, LTP_CAPTURE_MAGIC, 8) != 0) {
+        fclose(f);
+        return false;
+    }
+    if (startEpochUs) *startEpochUs = getLE(header + 8, 8);
+
+    uint8_t rec[LTP_CAPTURE_RECORD_SIZE];
+    while (fread(rec, 1, sizeof(rec), f) == sizeof(rec)) {
+        CaptureRecord r;
+        r.timestampUs = getLE(rec, 8);
+        r.direction = rec[8];
+        r.data.resize((size_t)getLE(rec + 9, 2));
+        if (fread(r.data.data(), 1, r.data.size(), f) != r.data.size()) break;
+        records.push_back(std::move(r));
+    }
+    fclose(f);
+    return true;
+}
+
+} // namespace CaptureFile
+
+/**
+ * Appends records to a capture file.
+ *
+ * Opening an existing capture continues it, keeping the original start
+ * time; the virtual MCU relies on this to capture across a firmware reset.
+ */
+class CaptureWriter {
+public:
+    CaptureWriter() : file(nullptr), startUs(0) {}
+    ~CaptureWriter() { close(); }
+
+    bool open(const char* path, bool append = false) {
+        close();
+        if (append && (file = fopen(path, "r+b")) != nullptr) {
+            uint8_t header[LTP_CAPTURE_HEADER_SIZE];
+            if (fread(header, 1, sizeof(header), file) == sizeof(header) &&
+                memcmp(header, LTP_CAPTURE_MAGIC, 8) == 0) {
+                startUs = CaptureFile::getLE(header + 8, 8);
+                fseek(file, 0, SEEK_END);
+                return true;
+            }
+            fclose(file);
+        }
+
+        file = fopen(path, "wb");
+        if (!file) return false;
+        startUs = CaptureFile::epochMicros();
+        uint8_t header[LTP_CAPTURE_HEADER_SIZE];
+        memcpy(header, LTP_CAPTURE_MAGIC, 8);
+        CaptureFile::putLE(header + 8, startUs, 8);
+        fwrite(header, 1, sizeof(header), file);
+        return true;
+    }
+
+    void close() {
+        if (file) fclose(file);
+        file = nullptr;
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+    // Record bytes at the current time; chunks over 65535 bytes are split
+    void write(uint8_t direction, const uint8_t* data, size_t len) {
+        if (!file) return;
+        uint64_t t = CaptureFile::epochMicros() - startUs;
+        while (len > 0) {
+            uint16_t n = len > 0xFFFF ? 0xFFFF : (uint16_t)len;
+            uint8_t rec[LTP_CAPTURE_RECORD_SIZE];
+            CaptureFile::putLE(rec, t, 8);
+            rec[8] = direction;
+            CaptureFile::putLE(rec + 9, n, 2);
+            fwrite(rec, 1, sizeof(rec), file);
+            fwrite(data, 1, n, file);
+            data += n;
+            len -= n;
+        }
+    }
+
+    void flush() { if (file) fflush(file); }
+
+private:
+    FILE* file;
+    uint64_t startUs;
+};
+
+#endif // LTP_HOST_CAPTURE_FILE_H
@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+"""
+LTP Host Build - Link Measurement
+
+Starts a virtual MCU, connects to its pty with the ltp_serial_cli protocol
+code and measures what the firmware actually sustains:
+
+- Round-trip latency of NOP/ACK pings
+- Frame throughput when streaming PIXEL_FRAME + SHOW as fast as the link allows
+- Frames the device reports as displayed (from GET_INFO stats), in total
+  and as a steady-state rate sampled while streaming
+
+Usage:
+    python3 measure_link.py build/ltp_vmcu_serial_v2 [--baud 115200] [--seconds 5]
+"""
+
+import argparse
+import os
+import struct
+import subprocess
+import sys
+import threading
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "..", "..", "src"))
+
+import serial  # noqa: E402
+
+from ltp_serial_cli.protocol import (  # noqa: E402
+    LtpProtocol,
+    CMD_ACK,
+    CMD_HELLO,
+    CMD_INFO_RESPONSE,
+    INFO_ALL,
+    INFO_STATS,
+    LTP_MAX_PAYLOAD,
+)
+
+
+class Link:
+    """Raw packet I/O without the reader thread, so timings are not quantized."""
+
+    def __init__(self, port: str):
+        self.serial = serial.Serial(port, 115200, timeout=0)
+        self.protocol = LtpProtocol()
+
+    def send(self, packet: bytes):
+        self.serial.write(packet)
+
+    def wait_for(self, cmd: int, timeout: float = 2.0):
+        deadline = time.perf_counter() + timeout
+        while time.perf_counter() < deadline:
+            data = self.serial.read(self.serial.in_waiting or 1)
+            if not data:
+                time.sleep(0.0001)
+                continue
+            for packet in self.protocol.feed(data):
+                if packet.cmd == cmd:
+                    return packet
+        return None
+
+    def close(self):
+        self.serial.close()
+
+
+def start_vmcu(binary: str, extra: list[str]) -> tuple[subprocess.Popen, str]:
+    proc = subprocess.Popen([binary, *extra], stdout=subprocess.PIPE, text=True)
+    line = proc.stdout.readline().strip()
+    if not line.startswith("pty: "):
+        proc.kill()
+        raise RuntimeError(f"Unexpected virtual MCU output: {line!r}")
+    return proc, line[5:]
+
+
+def measure_ping(link: Link, count: int) -> list[float]:
+    rtts = []
+    for _ in range(count):
+        start = time.perf_counter()
+        link.send(LtpProtocol.build_nop(ack_request=True))
+        if link.wait_for(CMD_ACK, timeout=1.0) is not None:
+            rtts.append((time.perf_counter() - start) * 1000)
+    return rtts
+
+
+def build_frame(pixels: int) -> bytes:
+    """PIXEL_FRAME packets for one frame, split to fit LTP_MAX_PAYLOAD."""
+    per_packet = (LTP_MAX_PAYLOAD - 5) // 3
+    data = bytes((i * 7) & 0xFF for i in range(pixels * 3))
+    packets = bytearray()
+    for start in range(0, pixels, per_packet):
+        chunk = data[start * 3:(start + per_packet) * 3]
+        packets += LtpProtocol.build_pixel_frame(0, start, chunk)
+    return bytes(packets)
+
+
+def displayed_count(payload: bytes) -> int | None:
+    """framesDisplayed from an INFO_STATS response."""
+    if len(payload) >= 8:
+        return struct.unpack("<I", payload[4:8])[0]
+    return None
+
+
+def measure_stream(link: Link, packet: bytes, seconds: float) -> tuple[int, float, float]:
+    """
+    Stream frames for the given time.
+
+    Returns frames sent, elapsed time and the device's steady-state display
+    rate. The rate comes from INFO_STATS requests interleaved with the
+    frames. Responses are not queued behind host data and are timestamped
+    by a reader thread, so they track the device even while writes block
+    on a full send buffer.
+    """
+    samples: list[tuple[float, int]] = []
+    done = threading.Event()
+
+    def reader():
+        protocol = LtpProtocol()
+        while not done.is_set():
+            data = link.serial.read(link.serial.in_waiting or 1)
+            if not data:
+                time.sleep(0.0005)
+                continue
+            now = time.perf_counter()
+            for response in protocol.feed(data):
+                if response.cmd == CMD_INFO_RESPONSE:
+                    count = displayed_count(response.payload)
+                    if count is not None:
+                        samples.append((now, count))
+
+    thread = threading.Thread(target=reader, daemon=True)
+    thread.start()
+
+    frames = 0
+    next_sample = 0.0
+    start = time.perf_counter()
+    while time.perf_counter() - start < seconds:
+        frames += 1
+        data = packet + LtpProtocol.build_show(frames & 0xFFFF)
+        now = time.perf_counter() - start
+        if now >= next_sample:
+            data += LtpProtocol.build_get_info(INFO_STATS)
+            next_sample = now + 0.25
+        link.send(data)
+    link.serial.flush()
+    elapsed = time.perf_counter() - start
+    done.set()
+    thread.join()
+
+    # Skip the start while the link queues fill up
+    steady = [s for s in samples if s[0] - start >= min(1.0, seconds / 3)]
+    rate = 0.0
+    if len(steady) >= 2 and steady[-1][0] > steady[0][0]:
+        rate = (steady[-1][1] - steady[0][1]) / (steady[-1][0] - steady[0][0])
+    return frames, elapsed, rate
+
+
+def get_info(link: Link, info_type: int) -> bytes:
+    link.protocol.reset()
+    link.send(LtpProtocol.build_get_info(info_type))
+    packet = link.wait_for(CMD_INFO_RESPONSE, timeout=5.0)
+    return packet.payload if packet else b""
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Measure an LTP virtual MCU link")
+    parser.add_argument("binary", help="Virtual MCU binary (build/ltp_vmcu_*)")
+    parser.add_argument("--baud", type=int, help="Override link baud rate")
+    parser.add_argument("--usb", action="store_true", help="Unpaced USB CDC link")
+    parser.add_argument("--pixels", type=int, help="Pixels per frame (default: device pixel count)")
+    parser.add_argument("--seconds", type=float, default=5.0, help="Streaming duration")
+    parser.add_argument("--pings", type=int, default=50, help="Number of pings")
+    args = parser.parse_args()
+
+    extra = ["--spin"]
+    if args.baud:
+        extra += ["--baud", str(args.baud)]
+    if args.usb:
+        extra.append("--usb")
+
+    proc, port = start_vmcu(args.binary, extra)
+    try:
+        link = Link(port)
+        link.wait_for(CMD_HELLO, timeout=1.0)
+
+        info = get_info(link, INFO_ALL)
+        device_pixels = struct.unpack("<H", info[5:7])[0] if len(info) >= 7 else 0
+        pixels = args.pixels or device_pixels
+
+        rtts = sorted(measure_ping(link, args.pings))
+        frame = build_frame(pixels)
+        frames, elapsed, steady_fps = measure_stream(link, frame, args.seconds)
+
+        # Let the device drain its queue before reading stats
+        displayed = -1
+        while True:
+            time.sleep(0.5)
+            stats = get_info(link, INFO_STATS)
+            count = displayed_count(stats) or 0
+            if count == displayed:
+                break
+            displayed = count
+        link.close()
+    finally:
+        proc.terminate()
+        proc.wait()
+
+    print(f"Virtual MCU: {os.path.basename(args.binary)} ({port})")
+    if rtts:
+        p50 = rtts[len(rtts) // 2]
+        p99 = rtts[min(len(rtts) - 1, int(len(rtts) * 0.99))]
+        print(f"Ping RTT: p50 {p50:.2f} ms, p99 {p99:.2f} ms, max {rtts[-1]:.2f} ms ({len(rtts)}/{args.pings})")
+    else:
+        print("Ping RTT: no responses")
+    frame_bytes = len(frame) + len(LtpProtocol.build_show())
+    print(f"Stream: {pixels} pixels, {frame_bytes} bytes/frame")
+    print(f"  Host sent:         {frames} frames in {elapsed:.2f} s ({frames / elapsed:.1f} FPS, "
+          f"{frames * frame_bytes / elapsed / 1024:.1f} KiB/s)")
+    print(f"  Device displayed:  {displayed} frames ({displayed / elapsed:.1f} FPS)")
+    print(f"  Device steady:     {steady_fps:.1f} FPS")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,60 @@
+/**
+ * LTP Host Build - In-Memory Serial Backend
+ *
+ * Feeds the firmware from a byte buffer and counts (optionally keeps)
+ * what it transmits. Used by the benchmark and replay harnesses, where
+ * the link must not add noise or wall-clock waits.
+ */
+
+#ifndef LTP_HOST_MEMORY_SERIAL_H
+#define LTP_HOST_MEMORY_SERIAL_H
+
+#include <Arduino.h>
+#include <vector>
+
+class MemorySerialBackend : public SerialBackend {
+public:
+    MemorySerialBackend() : input(nullptr), inputLen(0), inputPos(0), limit(0), keepOutput(false), txBytes(0) {}
+
+    // Bytes to be read by the firmware; not copied
+    void setInput(const uint8_t* data, size_t len) {
+        input = data;
+        inputLen = len;
+        inputPos = 0;
+        limit = len;
+    }
+
+    // Expose only the first n input bytes to available()/read()
+    void setReadLimit(size_t n) { limit = n < inputLen ? n : inputLen; }
+
+    void rewind() { inputPos = 0; }
+    size_t position() const { return inputPos; }
+    bool exhausted() const { return inputPos >= limit; }
+
+    void setKeepOutput(bool keep) { keepOutput = keep; }
+    std::vector<uint8_t>& output() { return txData; }
+    uint32_t getTxBytes() const { return txBytes; }
+
+    int available() override { return (int)(limit - inputPos); }
+    int read() override { return inputPos < limit ? input[inputPos++] : -1; }
+    int peek() override { return inputPos < limit ? input[inputPos] : -1; }
+
+    size_t write(uint8_t b) override {
+        txBytes++;
+        if (keepOutput) txData.push_back(b);
+        return 1;
+    }
+
+    int availableForWrite() override { return 64; }
+
+private:
+    const uint8_t* input;
+    size_t inputLen;
+    size_t inputPos;
+    size_t limit;
+    bool keepOutput;
+    uint32_t txBytes;
+    std::vector<uint8_t> txData;
+};
+
+#endif // LTP_HOST_MEMORY_SERIAL_H
@@ -0,0 +1,53 @@
+/**
+ * LTP Host Build - Packet Builder
+ *
+ * Builds host-to-device LTP packets for synthetic byte streams, mirroring
+ * LtpProtocol.build_* in src/ltp_serial_cli/protocol.py.
+ */
+
+#ifndef LTP_HOST_PACKET_BUILDER_H
+#define LTP_HOST_PACKET_BUILDER_H
+
+#include "protocol.h"
+#include <vector>
+
+namespace PacketBuilder {
+
+inline void append(std::vector<uint8_t>& out, uint8_t cmd, const uint8_t* payload, uint16_t length, uint8_t flags = 0) {
+    uint8_t header[4] = { flags, (uint8_t)(length & 0xFF), (uint8_t)(length >> 8), cmd };
+    out.push_back(LTP_START_BYTE);
+    out.insert(out.end(), header, header + 4);
+    out.insert(out.end(), payload, payload + length);
+    out.push_back(LtpProtocol::checksum(payload, length, LtpProtocol::checksum(header, 4)));
+}
+
+inline void append(std::vector<uint8_t>& out, uint8_t cmd, const std::vector<uint8_t>& payload, uint8_t flags = 0) {
+    append(out, cmd, payload.data(), (uint16_t)payload.size(), flags);
+}
+
+inline std::vector<uint8_t> pixelFramePayload(uint8_t strip, uint16_t start, const uint8_t* rgb, uint16_t count) {
+    std::vector<uint8_t> p = { strip, (uint8_t)(start & 0xFF), (uint8_t)(start >> 8),
+                               (uint8_t)(count & 0xFF), (uint8_t)(count >> 8) };
+    p.insert(p.end(), rgb, rgb + count * 3);
+    return p;
+}
+
+inline std::vector<uint8_t> setRangePayload(uint8_t strip, uint16_t start, uint16_t end, uint8_t r, uint8_t g, uint8_t b) {
+    return { strip, (uint8_t)(start & 0xFF), (uint8_t)(start >> 8),
+             (uint8_t)(end & 0xFF), (uint8_t)(end >> 8), r, g, b };
+}
+
+inline std::vector<uint8_t> showPayload(uint16_t frame) {
+    return { (uint8_t)(frame & 0xFF), (uint8_t)(frame >> 8) };
+}
+
+// Deterministic test frame: count RGB pixels
+inline std::vector<uint8_t> testPattern(uint16_t count, uint8_t seed = 0) {
+    std::vector<uint8_t> rgb(count * 3);
+    for (size_t i = 0; i < rgb.size(); i++) rgb[i] = (uint8_t)(i * 7 + seed * 13);
+    return rgb;
+}
+
+} // namespace PacketBuilder
+
+#endif // LTP_HOST_PACKET_BUILDER_H
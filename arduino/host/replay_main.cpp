@@ -0,0 +1,178 @@
+/**
+ * LTP Host Build - Capture Replay Harness
+ *
+ * Feeds the host-to-device side of a capture file (capture_file.h) into
+ * the sketch's parser and handlers and reports what the firmware made of
+ * it: parse rate, parser losses and the final framebuffer hash.
+ *
+ * The firmware runs on the virtual clock, which follows the recorded
+ * timestamps, so inter-byte timeouts fire exactly as they would have on
+ * the device. By default the stream is replayed as fast as the host can
+ * parse it; --realtime also waits out the recorded gaps.
+ */
+
+#include <Arduino.h>
+#include "capture_file.h"
+#include "memory_serial.h"
+#include "protocol.h"
+#include "sketch_hooks.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+void setup();
+void loop();
+
+#ifndef LTP_HOST_SKETCH
+#define LTP_HOST_SKETCH "sketch"
+#endif
+
+namespace {
+
+struct Chunk {
+    uint64_t timestampUs;
+    size_t end;          // Offset one past this chunk in the input stream
+};
+
+void usage(const char* prog) {
+    fprintf(stderr,
+        "Usage: %s [options] CAPTURE\n"
+        "\n"
+        "Replay a serial capture into the " LTP_HOST_SKETCH " firmware.\n"
+        "\n"
+        "Options:\n"
+        "  --realtime        Wait out recorded gaps (default: maximum speed)\n"
+        "  --repeat N        Replay the capture N times (default 1)\n"
+        "  --hash-only       Print only the final framebuffer hash\n",
+        prog);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    bool realtime = false;
+    bool hashOnly = false;
+    int repeat = 1;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--realtime") {
+            realtime = true;
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+            if (repeat < 1) repeat = 1;
+        } else if (arg == "--hash-only") {
+            hashOnly = true;
+        } else if (arg[0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 2;
+        }
+    }
+    if (!path) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<CaptureRecord> records;
+    if (!CaptureFile::load(path, records)) {
+        fprintf(stderr, "%s: not a readable capture file\n", path);
+        return 1;
+    }
+
+    // Host-to-device bytes as one stream, released chunk by chunk
+    std::vector<uint8_t> input;
+    std::vector<Chunk> chunks;
+    uint32_t recordedTxBytes = 0;
+    uint64_t spanUs = 0;
+    for (const CaptureRecord& r : records) {
+        spanUs = r.timestampUs;
+        if (r.direction == LTP_CAPTURE_DEVICE_TO_HOST) {
+            recordedTxBytes += r.data.size();
+            continue;
+        }
+        input.insert(input.end(), r.data.begin(), r.data.end());
+        chunks.push_back({ r.timestampUs, input.size() });
+    }
+
+    MemorySerialBackend serialMem;
+    Serial.setBackend(&serialMem);
+    ArduinoHost::useVirtualClock(true);
+    setup();
+
+    LtpProtocol& protocol = sketchProtocol();
+    protocol.clearParserStats();
+    protocol.clearErrorStats();
+    uint32_t framesBefore = sketchFramesDisplayed();
+    uint32_t txBefore = serialMem.getTxBytes();
+    uint32_t resets = 0;
+
+    auto wallStart = std::chrono::steady_clock::now();
+
+    for (int pass = 0; pass < repeat; pass++) {
+        serialMem.setInput(input.data(), input.size());
+        serialMem.setReadLimit(0);
+        uint64_t base = ArduinoHost::nowMicros();
+        auto passStart = std::chrono::steady_clock::now();
+
+        for (const Chunk& chunk : chunks) {
+            uint64_t due = base + chunk.timestampUs;
+            if (ArduinoHost::nowMicros() < due) ArduinoHost::setMicros(due);
+            if (realtime) {
+                std::this_thread::sleep_until(passStart + std::chrono::microseconds(chunk.timestampUs));
+            }
+
+            serialMem.setReadLimit(chunk.end);
+            while (!serialMem.exhausted()) {
+                loop();
+                if (ArduinoHost::resetRequested()) {
+                    // RAM is not reinitialized here; the reset is only counted
+                    SCB_AIRCR = 0;
+                    resets++;
+                }
+            }
+        }
+
+        // Let a trailing partial packet time out as it would on the device
+        ArduinoHost::advanceMicros(1000000);
+        loop();
+    }
+
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    const LtpParserStats& ps = protocol.getParserStats();
+    uint32_t hash = sketchFramebufferHash();
+
+    if (hashOnly) {
+        printf("%08x\n", hash);
+        return 0;
+    }
+
+    double totalBytes = (double)input.size() * repeat;
+    printf("Capture: %s\n", path);
+    printf("  Records:           %zu (%zu host->device)\n", records.size(), chunks.size());
+    printf("  Host->device:      %zu bytes over %.3f s\n", input.size(), spanUs / 1e6);
+    printf("  Device->host:      %u bytes recorded\n", recordedTxBytes);
+    printf("Replay (%s, %d pass%s): %.3f s\n", realtime ? "realtime" : "max speed", repeat,
+           repeat == 1 ? "" : "es", wallSeconds);
+    printf("  Packets parsed:    %u (%.0f packets/s, %.2f MiB/s)\n", ps.packets,
+           wallSeconds > 0 ? ps.packets / wallSeconds : 0,
+           wallSeconds > 0 ? totalBytes / wallSeconds / (1024 * 1024) : 0);
+    printf("  Checksum failures: %u\n", ps.checksumErrors);
+    printf("  Oversize headers:  %u\n", ps.oversizePackets);
+    printf("  Timeouts:          %u\n", ps.timeouts);
+    printf("  Resync bytes:      %u\n", ps.resyncBytes);
+    printf("  Dropped bytes:     %u (in discarded packets)\n", ps.droppedBytes);
+    printf("  Frames displayed:  %u\n", sketchFramesDisplayed() - framesBefore);
+    const LtpErrorStats& es = protocol.getErrorStats();
+    printf("  Dropped frames:    %u (SHOW frame number gaps)\n", es.droppedFrames);
+    printf("  NAKs sent:         %u\n", es.nakTotal);
+    printf("  Device->host:      %u bytes replayed\n", serialMem.getTxBytes() - txBefore);
+    if (resets) printf("  Resets requested:  %u (not performed)\n", resets);
+    printf("Framebuffer hash:    %08x\n", hash);
+    return 0;
+}
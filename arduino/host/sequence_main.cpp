@@ -0,0 +1,192 @@
+/**
+ * LTP Host Build - Sequence File Reader
+ *
+ * Plays an LSQ1 sequence file through ltp_octo_v2's player (sequence.h)
+ * from the SD shim, as SEQ_PLAY would from the card: 512-byte blocks, read
+ * ahead between frames on a virtual clock that follows the recorded
+ * timing; sync points are cued at once. Prints the file's size against
+ * raw frames, the blocks read and stalls, and the host cost per frame
+ * decode; --frames lists every frame and --verify-seek checks that
+ * SEQ_SEEK to each frame gives the same pixels as playing up to it.
+ *
+ * Usage:
+ *   ltp_sequence [--frames] [--verify-seek] FILE.lsq
+ */
+
+#include "memory_serial.h"
+#include "sequence.h"
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+const uint16_t BLOCK = 512;
+const uint16_t MAX_PIXELS = 4096;
+
+LtpSequence<BLOCK> sequence;
+MemorySerialBackend serialMem;
+LtpProtocol protocol(Serial, LTP_MAX_PAYLOAD);
+std::vector<uint8_t> pixels(MAX_PIXELS * 3);
+
+void usage(const char* prog) {
+    fprintf(stderr,
+        "Usage: %s [options] FILE.lsq\n"
+        "\n"
+        "Play an LSQ1 sequence file through the ltp_octo_v2 sequence player\n"
+        "(%u-byte SD blocks).\n"
+        "\n"
+        "Options:\n"
+        "  --frames          List every frame: time, hold, decode cost, hash\n"
+        "  --verify-seek     Check SEQ_SEEK to every frame against playback\n",
+        prog, BLOCK);
+}
+
+void setPixel(uint16_t i, uint8_t r, uint8_t g, uint8_t b) {
+    pixels[i * 3] = r;
+    pixels[i * 3 + 1] = g;
+    pixels[i * 3 + 2] = b;
+}
+
+// Send one CMD_SEQUENCE packet; true if the player ACKed (or answered)
+bool command(const std::vector<uint8_t>& payload) {
+    LtpPacket pkt;
+    pkt.clear();
+    pkt.cmd = CMD_SEQUENCE;
+    pkt.length = payload.size();
+    memcpy(pkt.payload, payload.data(), payload.size());
+    serialMem.output().clear();
+    sequence.command(protocol, pkt, setPixel);
+    const std::vector<uint8_t>& out = serialMem.output();
+    return out.size() > 4 && out[4] != CMD_NAK;
+}
+
+std::vector<uint8_t> info() {
+    std::vector<uint8_t> out(LtpSequence<BLOCK>::INFO_SIZE);
+    sequence.writeInfo(out.data());
+    return out;
+}
+
+// FNV-1a over the frame's RGB bytes
+uint32_t frameHash(uint16_t count) {
+    uint32_t h = 2166136261u;
+    for (uint32_t i = 0; i < count * 3u; i++) h = (h ^ pixels[i]) * 16777619u;
+    return h;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    bool listFrames = false;
+    bool verifySeek = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--frames") {
+            listFrames = true;
+        } else if (arg == "--verify-seek") {
+            verifySeek = true;
+        } else if (arg[0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!path) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // The file's directory becomes the card, as vmcu --sd does
+    std::string file = path;
+    size_t slash = file.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : file.substr(0, slash);
+    std::string name = slash == std::string::npos ? file : file.substr(slash + 1);
+    if (name.size() > LTP_SEQ_NAME_MAX) {
+        fprintf(stderr, "%s: name longer than %d characters\n", path, LTP_SEQ_NAME_MAX);
+        return 1;
+    }
+    SD.setRoot(dir.c_str());
+    serialMem.setKeepOutput(true);
+    Serial.setBackend(&serialMem);
+    sequence.begin(nullptr, 0, 0, MAX_PIXELS);
+
+    std::vector<uint8_t> play = { SEQ_PLAY, SEQ_SD, 0 };
+    play.insert(play.end(), name.begin(), name.end());
+    if (!command(play)) {
+        fprintf(stderr, "%s: not an LSQ1 sequence or not readable\n", path);
+        return 1;
+    }
+    std::vector<uint8_t> header = info();
+    uint16_t count = header[4] | (header[5] << 8);
+    uint32_t frames = getU32(&header[6]);
+    uint32_t durationMs = getU32(&header[14]);
+    if (count > MAX_PIXELS) count = MAX_PIXELS;
+
+    if (listFrames) printf("frame    time_ms  hold_ms  decode_us  hash\n");
+    std::vector<uint32_t> hashes;
+    uint64_t decodeUs = 0;
+    uint32_t now = 0;
+    uint32_t shownAt = 0;
+    uint32_t syncs = 0;
+    while (sequence.isRunning()) {
+        if (!sequence.update(now, setPixel)) {
+            if (info()[0] == 2) {
+                command({ SEQ_SYNC });
+                syncs++;
+            }
+            now += 1000;
+            continue;
+        }
+        std::vector<uint8_t> state = info();
+        uint32_t us = getU32(&state[30]);
+        decodeUs += us;
+        hashes.push_back(frameHash(count));
+        if (listFrames && hashes.size() > 1) {
+            printf("%5zu  %9.1f  %7u  %9u  %08x\n", hashes.size() - 2, shownAt / 1000.0,
+                   (now - shownAt) / 1000, us, hashes[hashes.size() - 2]);
+        }
+        shownAt = now;
+    }
+    if (listFrames && !hashes.empty()) {
+        printf("%5zu  %9.1f  %7s  %9s  %08x\n", hashes.size() - 1, shownAt / 1000.0, "-", "-",
+               hashes.back());
+    }
+
+    std::vector<uint8_t> done = info();
+    uint32_t blockReads = getU32(&done[22]);
+    uint32_t stalls = getU32(&done[26]);
+    uint32_t maxUs = getU32(&done[34]);
+    uint32_t fileSize = SD.open(name.c_str()).size();
+    double raw = (double)frames * count * 3;
+
+    printf("%s: %u pixels, %u frames, %.3f s\n", path, count, frames, durationMs / 1000.0);
+    printf("size        %u bytes, %.1f%% of raw frames (%.0f bytes)\n", fileSize,
+           raw ? 100.0 * fileSize / raw : 0.0, raw);
+    if (syncs) printf("sync points %u\n", syncs);
+    printf("blocks      %u x %u bytes read, %u stalls\n", blockReads, BLOCK, stalls);
+    printf("decode      mean %.1f us, max %u us per frame\n",
+           hashes.empty() ? 0.0 : (double)decodeUs / hashes.size(), maxUs);
+    if (hashes.size() != frames) {
+        printf("truncated   %zu of %u frames decoded\n", hashes.size(), frames);
+        return 1;
+    }
+
+    if (verifySeek) {
+        uint32_t mismatches = 0;
+        for (uint32_t f = 0; f < frames; f++) {
+            std::fill(pixels.begin(), pixels.end(), 0x5A);
+            std::vector<uint8_t> seek = { SEQ_SEEK, (uint8_t)f, (uint8_t)(f >> 8),
+                                          (uint8_t)(f >> 16), (uint8_t)(f >> 24) };
+            if (!command(seek) || frameHash(count) != hashes[f]) {
+                if (mismatches++ < 10) printf("seek        frame %u differs\n", f);
+            }
+        }
+        printf("seek        %u frames, %u mismatches\n", frames, mismatches);
+        if (mismatches) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,225 @@
+/**
+ * LTP Host Build - Pseudo-Terminal Serial Backend Implementation
+ */
+
+#include "serial_pty.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <termios.h>
+#include <unistd.h>
+
+PtySerialBackend::PtySerialBackend()
+    : masterFd(-1)
+    , slaveFd(-1)
+    , baud(0)
+    , baudForced(false)
+    , byteNanos(0)
+    , rxBufferSize(64)
+    , txBufferSize(64)
+    , rxNextNanos(0)
+    , txNextNanos(0)
+    , rxOverruns(0)
+    , rxBytes(0)
+    , txBytes(0)
+    , capture(nullptr)
+{}
+
+PtySerialBackend::~PtySerialBackend() {
+    if (!linkName.empty()) unlink(linkName.c_str());
+}
+
+bool PtySerialBackend::open(const char* linkPath) {
+    masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (masterFd < 0 || grantpt(masterFd) != 0 || unlockpt(masterFd) != 0) {
+        perror("posix_openpt");
+        return false;
+    }
+
+    slaveName = ptsname(masterFd);
+
+    // Hold the slave open so the master never sees a hangup between
+    // host connections, and put it in raw mode like a real adapter.
+    slaveFd = ::open(slaveName.c_str(), O_RDWR | O_NOCTTY);
+    if (slaveFd < 0) {
+        perror("open slave pty");
+        return false;
+    }
+    struct termios tio;
+    if (tcgetattr(slaveFd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(slaveFd, TCSANOW, &tio);
+    }
+
+    fcntl(masterFd, F_SETFL, fcntl(masterFd, F_GETFL) | O_NONBLOCK);
+
+    if (linkPath && *linkPath) {
+        unlink(linkPath);
+        if (symlink(slaveName.c_str(), linkPath) == 0) {
+            linkName = linkPath;
+        } else {
+            perror("symlink");
+        }
+    }
+    return true;
+}
+
+void PtySerialBackend::adopt(int master, int slave, const char* linkPath) {
+    masterFd = master;
+    slaveFd = slave;
+    slaveName = ptsname(masterFd);
+    if (linkPath) linkName = linkPath;
+    fcntl(masterFd, F_SETFL, fcntl(masterFd, F_GETFL) | O_NONBLOCK);
+}
+
+void PtySerialBackend::forceBaud(uint32_t b) {
+    baudForced = true;
+    setPacing(b);
+}
+
+void PtySerialBackend::begin(uint32_t b) {
+    if (!baudForced) setPacing(b);
+}
+
+void PtySerialBackend::setPacing(uint32_t b) {
+    baud = b;
+    // 8N1: start + 8 data + stop = 10 bit times per byte
+    byteNanos = b ? (uint32_t)(10000000000ULL / b) : 0;
+}
+
+int PtySerialBackend::available() {
+    service();
+    return (int)rxBuf.size();
+}
+
+int PtySerialBackend::read() {
+    service();
+    if (rxBuf.empty()) return -1;
+    uint8_t b = rxBuf.front();
+    rxBuf.pop_front();
+    return b;
+}
+
+int PtySerialBackend::peek() {
+    service();
+    return rxBuf.empty() ? -1 : rxBuf.front();
+}
+
+size_t PtySerialBackend::write(uint8_t b) {
+    txBytes++;
+    if (!byteNanos) {
+        writeFd(&b, 1);
+        return 1;
+    }
+
+    // Block while the TX buffer is full, as HardwareSerial does on AVR
+    service();
+    while (txQueue.size() >= txBufferSize) {
+        uint64_t now = ArduinoHost::nowMicros() * 1000;
+        uint64_t due = txQueue.front().due;
+        if (due > now) delayMicroseconds((uint32_t)((due - now + 999) / 1000));
+        service();
+    }
+
+    uint64_t now = ArduinoHost::nowMicros() * 1000;
+    if (txNextNanos < now) txNextNanos = now;
+    txNextNanos += byteNanos;
+    txQueue.push_back({ txNextNanos, b });
+    return 1;
+}
+
+int PtySerialBackend::availableForWrite() {
+    if (!byteNanos) return txBufferSize;
+    service();
+    return (int)(txBufferSize - txQueue.size());
+}
+
+void PtySerialBackend::flush() {
+    while (!txQueue.empty()) {
+        delayMicroseconds(byteNanos / 1000 + 1);
+        service();
+    }
+}
+
+void PtySerialBackend::service() {
+    uint64_t now = ArduinoHost::nowMicros() * 1000;
+    pullFromPty(now);
+    pushToPty(now);
+}
+
+void PtySerialBackend::pullFromPty(uint64_t now) {
+    // Only read from the pty while the adapter-side queue has room, so the
+    // host's write() blocks once it gets too far ahead of the wire.
+    if (pending.size() < ADAPTER_QUEUE) {
+        uint8_t buf[512];
+        ssize_t n = ::read(masterFd, buf, sizeof(buf));
+        if (n > 0) {
+            if (capture) capture->write(LTP_CAPTURE_HOST_TO_DEVICE, buf, n);
+            if (pending.empty() && rxNextNanos < now) rxNextNanos = now;
+            pending.insert(pending.end(), buf, buf + n);
+        }
+    }
+
+    while (!pending.empty()) {
+        // USB CDC is flow controlled end to end: hold bytes back instead
+        // of overrunning the receive buffer.
+        if (!byteNanos && rxBuf.size() >= rxBufferSize) break;
+        if (byteNanos) {
+            if (rxNextNanos + byteNanos > now) break;
+            rxNextNanos += byteNanos;
+        }
+        uint8_t b = pending.front();
+        pending.pop_front();
+        if (rxBuf.size() < rxBufferSize) {
+            rxBuf.push_back(b);
+            rxBytes++;
+        } else {
+            rxOverruns++;
+        }
+    }
+}
+
+void PtySerialBackend::pushToPty(uint64_t now) {
+    uint8_t buf[256];
+    size_t n = 0;
+    while (!txQueue.empty() && txQueue.front().due <= now) {
+        buf[n++] = txQueue.front().value;
+        txQueue.pop_front();
+        if (n == sizeof(buf)) {
+            writeFd(buf, n);
+            n = 0;
+        }
+    }
+    if (n) writeFd(buf, n);
+}
+
+void PtySerialBackend::writeFd(const uint8_t* data, size_t len) {
+    if (capture) capture->write(LTP_CAPTURE_DEVICE_TO_HOST, data, len);
+
+    // Bytes nobody is reading are lost, like a UART with nothing attached
+    while (len > 0) {
+        ssize_t n = ::write(masterFd, data, len);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return;
+        }
+        data += n;
+        len -= n;
+    }
+}
+
+void PtySerialBackend::waitForActivity(uint32_t timeoutUs) {
+    if (!rxBuf.empty() || !pending.empty() || !txQueue.empty()) {
+        // Data in flight: wait only as long as the next byte's wire time
+        if (byteNanos && timeoutUs > byteNanos / 1000) timeoutUs = byteNanos / 1000 + 1;
+        if (!rxBuf.empty()) return;
+        delayMicroseconds(timeoutUs);
+        return;
+    }
+
+    struct pollfd pfd = { masterFd, POLLIN, 0 };
+    struct timespec ts = { 0, (long)timeoutUs * 1000 };
+    ppoll(&pfd, 1, &ts, nullptr);
+}
@@ -0,0 +1,105 @@
+/**
+ * LTP Host Build - Pseudo-Terminal Serial Backend
+ *
+ * Exposes the firmware's Serial port as a Linux pty so unmodified host
+ * tools (ltp_serial_cli, ltp_serial_sink) can open it like a USB adapter.
+ *
+ * Baud-rate pacing emulates a hardware UART:
+ * - Received bytes are released to the firmware at one byte per 10 bit
+ *   times into a fixed-size RX buffer (64 bytes on AVR). Bytes arriving
+ *   while that buffer is full are dropped and counted as overruns.
+ * - Transmitted bytes drain at the same rate through a fixed-size TX
+ *   buffer; write() blocks while it is full, as on AVR.
+ * - Host writes see back-pressure once the adapter-side queue fills.
+ *
+ * With baud 0 (USB CDC boards such as Teensy) no pacing is applied.
+ */
+
+#ifndef LTP_HOST_SERIAL_PTY_H
+#define LTP_HOST_SERIAL_PTY_H
+
+#include <Arduino.h>
+#include "capture_file.h"
+#include <deque>
+#include <string>
+
+class PtySerialBackend : public SerialBackend {
+public:
+    PtySerialBackend();
+    ~PtySerialBackend();
+
+    // Create a new pty; optionally symlink its slave path to linkPath
+    bool open(const char* linkPath = nullptr);
+
+    // Take over an existing pty (after a reset re-exec)
+    void adopt(int masterFd, int slaveFd, const char* linkPath = nullptr);
+
+    const std::string& slavePath() const { return slaveName; }
+    int getMasterFd() const { return masterFd; }
+    int getSlaveFd() const { return slaveFd; }
+
+    // Pacing configuration. A forced baud overrides Serial.begin().
+    void forceBaud(uint32_t baud);
+    void setRxBufferSize(uint16_t size) { rxBufferSize = size; }
+    void setTxBufferSize(uint16_t size) { txBufferSize = size; }
+    uint32_t getBaud() const { return baud; }
+
+    // Record bytes as they cross the pty (nullptr to stop)
+    void setCapture(CaptureWriter* writer) { capture = writer; }
+
+    // SerialBackend
+    void begin(uint32_t baud) override;
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t b) override;
+    int availableForWrite() override;
+    void flush() override;
+
+    // Move bytes between the pty and the emulated UART buffers
+    void service();
+
+    // Block for up to timeoutUs waiting for input or TX drain
+    void waitForActivity(uint32_t timeoutUs);
+
+    // Statistics
+    uint32_t getRxOverruns() const { return rxOverruns; }
+    uint32_t getRxBytes() const { return rxBytes; }
+    uint32_t getTxBytes() const { return txBytes; }
+
+private:
+    int masterFd;
+    int slaveFd;
+    std::string slaveName;
+    std::string linkName;
+
+    uint32_t baud;
+    bool baudForced;
+    uint32_t byteNanos;          // Wire time per byte (0 = unpaced)
+
+    uint16_t rxBufferSize;
+    uint16_t txBufferSize;
+
+    std::deque<uint8_t> pending; // Read from pty, not yet "on the wire"
+    std::deque<uint8_t> rxBuf;   // Emulated UART receive buffer
+    uint64_t rxNextNanos;        // When the next pending byte completes
+
+    struct TxByte { uint64_t due; uint8_t value; };
+    std::deque<TxByte> txQueue;  // Emulated UART transmit buffer
+    uint64_t txNextNanos;
+
+    uint32_t rxOverruns;
+    uint32_t rxBytes;
+    uint32_t txBytes;
+
+    CaptureWriter* capture;
+
+    static const size_t ADAPTER_QUEUE = 4096;
+
+    void setPacing(uint32_t baud);
+    void pullFromPty(uint64_t now);
+    void pushToPty(uint64_t now);
+    void writeFd(const uint8_t* data, size_t len);
+};
+
+#endif // LTP_HOST_SERIAL_PTY_H
@@ -0,0 +1,212 @@
+/**
+ * LTP Host Build - Arduino Core Shim
+ *
+ * Minimal subset of the Arduino core used by the LTP sketches, implemented
+ * on top of POSIX so the firmware can be compiled and run on Linux.
+ * See arduino/host/README.md.
+ */
+
+#ifndef LTP_HOST_ARDUINO_H
+#define LTP_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <type_traits>
+
+#ifndef LTP_HOST_BUILD
+#define LTP_HOST_BUILD 1
+#endif
+
+// Pin levels and modes
+#define LOW             0
+#define HIGH            1
+#define INPUT           0
+#define OUTPUT          1
+#define INPUT_PULLUP    2
+
+// Bit order
+#define LSBFIRST        0
+#define MSBFIRST        1
+
+// Program memory (flat address space on the host)
+#define PROGMEM
+#define DMAMEM
+#define F(s)            (s)
+#define pgm_read_byte(addr)  (*(const uint8_t*)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define memcpy_P(dst, src, n) memcpy((dst), (src), (n))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// Teensy-style min/max (templates rather than macros so std headers still work)
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type min(A a, B b) { return a < b ? a : b; }
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type max(A a, B b) { return a > b ? a : b; }
+template <typename T, typename L, typename H>
+inline T constrain(T x, L lo, H hi) { return x < lo ? lo : (x > hi ? hi : x); }
+
+// Timing
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+inline void yield() {}
+
+// Sketch entry points, declared as the Arduino core does
+void setup();
+void loop();
+
+// Interrupts are a no-op on the host
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// GPIO
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+// Teensy periodic timer interrupt. Callbacks fire from
+// ArduinoHost::runTimers(), which the runners call between loop() passes:
+// late, but as many times as the real timer would have fired.
+class IntervalTimer {
+public:
+    IntervalTimer() : slot(-1) {}
+    ~IntervalTimer() { end(); }
+    bool begin(void (*callback)(), float microseconds);
+    void end();
+
+private:
+    int slot;
+};
+
+// Teensy application interrupt and reset control register.
+// Writing 0x05FA0004 requests a reset, which the host runner performs
+// by re-executing itself (see vmcu_main.cpp).
+extern volatile uint32_t SCB_AIRCR;
+
+// ============================================================================
+// Print / Stream
+// ============================================================================
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t b) = 0;
+
+    virtual size_t write(const uint8_t* buf, size_t len) {
+        size_t n = 0;
+        while (len--) n += write(*buf++);
+        return n;
+    }
+
+    // Bytes that can be written without blocking
+    virtual int availableForWrite() { return 0; }
+
+    virtual void flush() {}
+
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t println(const char* s) { return print(s) + print("\r\n"); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+// ============================================================================
+// Serial
+// ============================================================================
+
+/**
+ * Byte transport behind the host Serial object.
+ *
+ * The virtual MCU runner installs a pseudo-terminal backend; benchmark and
+ * replay harnesses install in-memory backends.
+ */
+class SerialBackend {
+public:
+    virtual ~SerialBackend() {}
+    virtual void begin(uint32_t baud) { (void)baud; }
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual size_t write(uint8_t b) = 0;
+    virtual int availableForWrite() { return 64; }
+    virtual void flush() {}
+};
+
+class HardwareSerial : public Stream {
+public:
+    HardwareSerial() : backend(nullptr) {}
+
+    void begin(uint32_t baud) { if (backend) backend->begin(baud); }
+    void end() {}
+
+    int available() override { return backend ? backend->available() : 0; }
+    int read() override { return backend ? backend->read() : -1; }
+    int peek() override { return backend ? backend->peek() : -1; }
+    size_t write(uint8_t b) override { return backend ? backend->write(b) : 1; }
+    using Print::write;
+    int availableForWrite() override { return backend ? backend->availableForWrite() : 64; }
+    void flush() override { if (backend) backend->flush(); }
+
+    operator bool() const { return true; }
+
+    void setBackend(SerialBackend* b) { backend = b; }
+    SerialBackend* getBackend() const { return backend; }
+
+private:
+    SerialBackend* backend;
+};
+
+extern HardwareSerial Serial;
+
+// ============================================================================
+// Host runtime controls (not part of the Arduino API)
+// ============================================================================
+
+namespace ArduinoHost {
+
+// Switch millis()/micros() between the wall clock (default) and a virtual
+// clock that only moves when advanced explicitly or by delay().
+void useVirtualClock(bool enable);
+bool isVirtualClock();
+void setMicros(uint64_t us);
+void advanceMicros(uint64_t us);
+uint64_t nowMicros();
+
+// Reset requested through SCB_AIRCR
+bool resetRequested();
+
+// Last level written to a pin (for capture/inspection)
+uint8_t pinState(uint8_t pin);
+
+// Record a bit-banged clock/data pair: the data pin level is sampled on each
+// rising clock edge and packed MSB first into buf (nullptr to stop). This is
+// the software-SPI counterpart of SPIClass::setCapture().
+void setPinCapture(uint8_t dataPin, uint8_t clockPin, uint8_t* buf, size_t size);
+size_t getPinCaptureLength();   // Complete bytes recorded
+uint32_t getPinCaptureBits();   // Clock edges seen, including a partial byte
+void rewindPinCapture();
+
+// Fire the IntervalTimer callbacks that have come due, each seeing its own
+// scheduled time in micros() and analogRead()
+void runTimers();
+
+// Drive analogRead() on every pin from signed 16-bit samples at rate Hz,
+// looped, as 10-bit readings centered on 512 (nullptr to stop)
+void setAnalogInput(const int16_t* samples, size_t count, uint32_t rate);
+
+} // namespace ArduinoHost
+
+#endif // LTP_HOST_ARDUINO_H
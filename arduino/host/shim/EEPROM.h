@@ -0,0 +1,72 @@
+/**
+ * LTP Host Build - EEPROM Shim
+ *
+ * The byte-wise Arduino EEPROM API over a RAM image the size of the Teensy
+ * 4.1's emulated EEPROM, erased (0xFF) at startup. With a backing file
+ * attached, the image is loaded from it and every changed byte is written
+ * through, so saved settings survive a vmcu reset or restart.
+ */
+
+#ifndef LTP_HOST_EEPROM_H
+#define LTP_HOST_EEPROM_H
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef LTP_HOST_EEPROM_SIZE
+#define LTP_HOST_EEPROM_SIZE 4284
+#endif
+
+class EEPROMClass {
+public:
+    EEPROMClass() : file(nullptr), writes(0) { memset(data, 0xFF, sizeof(data)); }
+
+    uint8_t read(int address) const {
+        return address >= 0 && address < LTP_HOST_EEPROM_SIZE ? data[address] : 0xFF;
+    }
+
+    void write(int address, uint8_t value) {
+        if (address < 0 || address >= LTP_HOST_EEPROM_SIZE) return;
+        data[address] = value;
+        writes++;
+        if (file) {
+            fseek(file, address, SEEK_SET);
+            fputc(value, file);
+            fflush(file);
+        }
+    }
+
+    void update(int address, uint8_t value) {
+        if (read(address) != value) write(address, value);
+    }
+
+    uint16_t length() const { return LTP_HOST_EEPROM_SIZE; }
+
+    // Host-only: load the image from path (created erased if missing) and
+    // write changes through to it
+    bool attach(const char* path) {
+        file = fopen(path, "r+b");
+        if (!file) {
+            file = fopen(path, "w+b");
+            if (!file) return false;
+            fwrite(data, 1, sizeof(data), file);
+            fflush(file);
+        }
+        size_t n = fread(data, 1, sizeof(data), file);
+        (void)n;
+        return true;
+    }
+
+    // Host-only: bytes written (update() skips unchanged ones)
+    uint32_t getWrites() const { return writes; }
+
+private:
+    uint8_t data[LTP_HOST_EEPROM_SIZE];
+    FILE* file;
+    uint32_t writes;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // LTP_HOST_EEPROM_H
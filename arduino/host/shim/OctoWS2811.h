@@ -0,0 +1,94 @@
+/**
+ * LTP Host Build - OctoWS2811 Stub
+ *
+ * Stands in for PJRC's OctoWS2811 library. Pixels are stored as 0xRRGGBB
+ * words in the drawing buffer (the layout the LTP readback code expects),
+ * and show() models the DMA transfer time so busy() behaves like hardware:
+ * 8 strips clocked in parallel at 800 kHz, 24 bits per pixel, followed by
+ * the 300 us reset gap.
+ */
+
+#ifndef LTP_HOST_OCTOWS2811_H
+#define LTP_HOST_OCTOWS2811_H
+
+#include <Arduino.h>
+
+#define WS2811_RGB      0
+#define WS2811_RBG      1
+#define WS2811_GRB      2
+#define WS2811_GBR      3
+#define WS2811_BRG      4
+#define WS2811_BGR      5
+
+#define WS2811_800kHz   0x00
+#define WS2811_400kHz   0x10
+
+class OctoWS2811 {
+public:
+    OctoWS2811(uint32_t numPerStrip, void* frameBuf, void* drawBuf, uint8_t config = WS2811_GRB)
+        : stripLen(numPerStrip)
+        , frameBuffer((uint32_t*)frameBuf)
+        , drawBuffer((uint32_t*)drawBuf)
+        , params(config)
+        , busyUntil(0)
+        , showCount(0)
+    {}
+
+    void begin() {
+        memset(drawBuffer, 0, stripLen * 8 * sizeof(uint32_t));
+        memset(frameBuffer, 0, stripLen * 8 * sizeof(uint32_t));
+    }
+
+    void setPixel(uint32_t num, int color) {
+        if (num < stripLen * 8) drawBuffer[num] = (uint32_t)color & 0xFFFFFF;
+    }
+
+    void setPixel(uint32_t num, uint8_t red, uint8_t green, uint8_t blue) {
+        setPixel(num, color(red, green, blue));
+    }
+
+    int getPixel(uint32_t num) {
+        return num < stripLen * 8 ? (int)drawBuffer[num] : 0;
+    }
+
+    void show() {
+        // Like the real library, wait for the previous DMA transfer to finish
+        while (busy()) {
+            if (ArduinoHost::isVirtualClock()) {
+                ArduinoHost::setMicros(busyUntil);
+            } else {
+                delayMicroseconds(10);
+            }
+        }
+        memcpy(frameBuffer, drawBuffer, stripLen * 8 * sizeof(uint32_t));
+        busyUntil = ArduinoHost::nowMicros() + frameTimeMicros();
+        showCount++;
+    }
+
+    int busy() {
+        return ArduinoHost::nowMicros() < busyUntil;
+    }
+
+    int numPixels() { return stripLen * 8; }
+
+    int color(uint8_t red, uint8_t green, uint8_t blue) {
+        return (red << 16) | (green << 8) | blue;
+    }
+
+    // Host-only: DMA time for one frame, and shows performed
+    uint32_t frameTimeMicros() const {
+        uint32_t bitNs = (params & WS2811_400kHz) ? 2500 : 1250;
+        return (uint32_t)((uint64_t)stripLen * 24 * bitNs / 1000) + 300;
+    }
+    uint32_t getShowCount() const { return showCount; }
+
+private:
+    uint32_t stripLen;
+    uint32_t* frameBuffer;
+    uint32_t* drawBuffer;
+    uint8_t params;
+    uint64_t busyUntil;
+    uint32_t showCount;
+};
+
+#endif // LTP_HOST_OCTOWS2811_H
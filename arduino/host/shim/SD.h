@@ -0,0 +1,101 @@
+/**
+ * LTP Host Build - SD Shim
+ *
+ * The SD library's File and SDClass over a host directory, so firmware that
+ * streams from an SD card reads local files. Until a directory is attached
+ * (SD.setRoot), begin() fails as it does without a card. Files open read
+ * only.
+ */
+
+#ifndef LTP_HOST_SD_H
+#define LTP_HOST_SD_H
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string>
+
+#define FILE_READ 0
+
+class File {
+public:
+    File() : file(nullptr), length(0) {}
+
+    int read() {
+        return file ? fgetc(file) : -1;
+    }
+
+    int read(void* buf, size_t n) {
+        if (!file) return -1;
+        return (int)fread(buf, 1, n, file);
+    }
+
+    bool seek(uint32_t pos) {
+        return file && pos <= length && fseek(file, (long)pos, SEEK_SET) == 0;
+    }
+
+    uint32_t position() const { return file ? (uint32_t)ftell(file) : 0; }
+    uint32_t size() const { return length; }
+    int available() const { return file ? (int)(length - position()) : 0; }
+
+    void close() {
+        if (file) fclose(file);
+        file = nullptr;
+    }
+
+    operator bool() const { return file != nullptr; }
+
+private:
+    friend class SDClass;
+    FILE* file;
+    uint32_t length;
+};
+
+class SDClass {
+public:
+    SDClass() : started(false) {}
+
+    bool begin(uint8_t csPin = 0) {
+        (void)csPin;
+        started = !root.empty();
+        return started;
+    }
+
+    File open(const char* path, uint8_t mode = FILE_READ) {
+        (void)mode;
+        File f;
+        if (!started) return f;
+        f.file = fopen(fullPath(path).c_str(), "rb");
+        if (f.file) {
+            fseek(f.file, 0, SEEK_END);
+            f.length = (uint32_t)ftell(f.file);
+            fseek(f.file, 0, SEEK_SET);
+        }
+        return f;
+    }
+
+    bool exists(const char* path) {
+        File f = open(path);
+        bool found = f;
+        f.close();
+        return found;
+    }
+
+    // Host-only: serve files from directory path (nullptr: no card)
+    void setRoot(const char* path) {
+        root = path ? path : "";
+        started = false;
+    }
+
+private:
+    std::string root;
+    bool started;
+
+    std::string fullPath(const char* path) const {
+        while (*path == '/') path++;
+        return root + "/" + path;
+    }
+};
+
+extern SDClass SD;
+
+#endif // LTP_HOST_SD_H
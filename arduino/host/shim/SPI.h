@@ -0,0 +1,93 @@
+/**
+ * LTP Host Build - SPI Shim
+ *
+ * Accepts the AVR-style SPI API used by the SPI LED drivers. Transfers are
+ * discarded unless a capture buffer is attached; the configured clock is
+ * tracked so host tools can reason about wire time.
+ */
+
+#ifndef LTP_HOST_SPI_H
+#define LTP_HOST_SPI_H
+
+#include <Arduino.h>
+
+#define SPI_MODE0           0x00
+#define SPI_MODE1           0x04
+#define SPI_MODE2           0x08
+#define SPI_MODE3           0x0C
+
+// Divider values match the AVR core (F_CPU / n)
+#define SPI_CLOCK_DIV2      2
+#define SPI_CLOCK_DIV4      4
+#define SPI_CLOCK_DIV8      8
+#define SPI_CLOCK_DIV16     16
+#define SPI_CLOCK_DIV32     32
+#define SPI_CLOCK_DIV64     64
+#define SPI_CLOCK_DIV128    128
+
+#ifndef F_CPU
+#define F_CPU               16000000UL
+#endif
+
+class SPISettings {
+public:
+    SPISettings(uint32_t clock = 4000000, uint8_t bitOrder = MSBFIRST, uint8_t dataMode = SPI_MODE0)
+        : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+    uint32_t clock;
+    uint8_t bitOrder;
+    uint8_t dataMode;
+};
+
+class SPIClass {
+public:
+    SPIClass()
+        : clockHz(F_CPU / SPI_CLOCK_DIV4)
+        , bytesTransferred(0)
+        , captureBuf(nullptr)
+        , captureSize(0)
+        , captureLen(0)
+    {}
+
+    void begin() {}
+    void end() {}
+    void setBitOrder(uint8_t order) { (void)order; }
+    void setDataMode(uint8_t mode) { (void)mode; }
+    void setClockDivider(uint8_t div) { clockHz = F_CPU / div; }
+    void beginTransaction(const SPISettings& s) { clockHz = s.clock; }
+    void endTransaction() {}
+
+    uint8_t transfer(uint8_t b) {
+        bytesTransferred++;
+        if (captureLen < captureSize) captureBuf[captureLen++] = b;
+        return 0;
+    }
+
+    void transfer(void* buf, size_t count) {
+        uint8_t* p = (uint8_t*)buf;
+        for (size_t i = 0; i < count; i++) p[i] = transfer(p[i]);
+    }
+
+    // Host-only accessors
+    uint32_t getClockHz() const { return clockHz; }
+    uint32_t getBytesTransferred() const { return bytesTransferred; }
+
+    // Host-only: record transferred bytes into buf (nullptr to stop)
+    void setCapture(uint8_t* buf, size_t size) {
+        captureBuf = buf;
+        captureSize = buf ? size : 0;
+        captureLen = 0;
+    }
+    size_t getCaptureLength() const { return captureLen; }
+    void rewindCapture() { captureLen = 0; }
+
+private:
+    uint32_t clockHz;
+    uint32_t bytesTransferred;
+    uint8_t* captureBuf;
+    size_t captureSize;
+    size_t captureLen;
+};
+
+extern SPIClass SPI;
+
+#endif // LTP_HOST_SPI_H
@@ -0,0 +1,181 @@
+/**
+ * LTP Host Build - Arduino Core Shim Implementation
+ */
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <EEPROM.h>
+#include <SD.h>
+#include <time.h>
+
+HardwareSerial Serial;
+SPIClass SPI;
+EEPROMClass EEPROM;
+SDClass SD;
+volatile uint32_t SCB_AIRCR = 0;
+
+namespace {
+
+bool virtualClock = false;
+uint64_t virtualMicros = 0;
+uint64_t bootMicros = 0;
+uint8_t pinLevels[256];
+
+// Bit-bang capture (setPinCapture)
+uint8_t captureDataPin = 0;
+uint8_t captureClockPin = 0;
+uint8_t* pinCaptureBuf = nullptr;
+size_t pinCaptureSize = 0;
+size_t pinCaptureLen = 0;
+uint32_t pinCaptureBits = 0;
+uint8_t pinCaptureShift = 0;
+
+// IntervalTimer slots (a Teensy has four PIT channels); times in ns so
+// fractional periods keep their average rate
+struct HostTimer {
+    void (*callback)();
+    uint64_t periodNs;
+    uint64_t nextNs;
+};
+HostTimer timers[4];
+bool inTimer = false;
+uint64_t timerMicros = 0;
+
+// analogRead() source (setAnalogInput)
+const int16_t* analogSamples = nullptr;
+size_t analogCount = 0;
+uint32_t analogRate = 0;
+
+uint64_t monotonicMicros() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+struct BootTime {
+    BootTime() { bootMicros = monotonicMicros(); }
+} bootTime;
+
+} // namespace
+
+namespace ArduinoHost {
+
+void useVirtualClock(bool enable) {
+    if (enable && !virtualClock) virtualMicros = nowMicros();
+    virtualClock = enable;
+}
+
+bool isVirtualClock() { return virtualClock; }
+
+void setMicros(uint64_t us) { virtualMicros = us; }
+
+void advanceMicros(uint64_t us) { virtualMicros += us; }
+
+uint64_t nowMicros() {
+    if (inTimer) return timerMicros;
+    return virtualClock ? virtualMicros : monotonicMicros() - bootMicros;
+}
+
+bool resetRequested() { return SCB_AIRCR == 0x05FA0004; }
+
+uint8_t pinState(uint8_t pin) { return pinLevels[pin]; }
+
+void setPinCapture(uint8_t dataPin, uint8_t clockPin, uint8_t* buf, size_t size) {
+    captureDataPin = dataPin;
+    captureClockPin = clockPin;
+    pinCaptureBuf = buf;
+    pinCaptureSize = buf ? size : 0;
+    rewindPinCapture();
+}
+
+size_t getPinCaptureLength() { return pinCaptureLen; }
+
+uint32_t getPinCaptureBits() { return pinCaptureBits; }
+
+void rewindPinCapture() {
+    pinCaptureLen = 0;
+    pinCaptureBits = 0;
+    pinCaptureShift = 0;
+}
+
+void runTimers() {
+    uint64_t nowNs = nowMicros() * 1000;
+    for (HostTimer& t : timers) {
+        // After a long stall, drop all but the last second of firings
+        if (t.callback && nowNs > t.nextNs + 1000000000ULL) t.nextNs = nowNs - 1000000000ULL;
+        while (t.callback && t.nextNs <= nowNs) {
+            timerMicros = t.nextNs / 1000;
+            inTimer = true;
+            t.callback();
+            inTimer = false;
+            t.nextNs += t.periodNs;
+        }
+    }
+}
+
+void setAnalogInput(const int16_t* samples, size_t count, uint32_t rate) {
+    analogSamples = count ? samples : nullptr;
+    analogCount = count;
+    analogRate = rate;
+}
+
+} // namespace ArduinoHost
+
+uint32_t millis() { return (uint32_t)(ArduinoHost::nowMicros() / 1000); }
+
+uint32_t micros() { return (uint32_t)ArduinoHost::nowMicros(); }
+
+void delayMicroseconds(uint32_t us) {
+    if (virtualClock) {
+        virtualMicros += us;
+        return;
+    }
+    struct timespec ts;
+    ts.tv_sec = us / 1000000;
+    ts.tv_nsec = (long)(us % 1000000) * 1000;
+    nanosleep(&ts, nullptr);
+}
+
+void delay(uint32_t ms) { delayMicroseconds(ms * 1000); }
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    uint8_t level = value ? HIGH : LOW;
+    if (pinCaptureBuf && pin == captureClockPin && level == HIGH && pinLevels[pin] == LOW) {
+        pinCaptureShift = (uint8_t)((pinCaptureShift << 1) | pinLevels[captureDataPin]);
+        if ((++pinCaptureBits & 7) == 0 && pinCaptureLen < pinCaptureSize) {
+            pinCaptureBuf[pinCaptureLen++] = pinCaptureShift;
+        }
+    }
+    pinLevels[pin] = level;
+}
+
+int digitalRead(uint8_t pin) { return pinLevels[pin]; }
+
+int analogRead(uint8_t pin) {
+    (void)pin;
+    if (!analogSamples) return 0;
+    uint64_t index = ArduinoHost::nowMicros() * analogRate / 1000000 % analogCount;
+    return 512 + (analogSamples[index] >> 6);
+}
+
+bool IntervalTimer::begin(void (*callback)(), float microseconds) {
+    if (slot < 0) {
+        for (int i = 0; i < 4 && slot < 0; i++) {
+            if (!timers[i].callback) slot = i;
+        }
+        if (slot < 0) return false;
+    }
+    HostTimer& t = timers[slot];
+    t.callback = callback;
+    t.periodNs = (uint64_t)(microseconds * 1000.0f);
+    if (t.periodNs == 0) t.periodNs = 1;
+    t.nextNs = ArduinoHost::nowMicros() * 1000 + t.periodNs;
+    return true;
+}
+
+void IntervalTimer::end() {
+    if (slot >= 0) timers[slot].callback = nullptr;
+    slot = -1;
+}
@@ -0,0 +1,38 @@
+/**
+ * LTP Host Build - Sketch Inspection Hooks
+ *
+ * Host tools link against a sketch translation unit (sketch_*.cpp), which
+ * implements these so the tools can inspect firmware state without
+ * knowing which sketch or LED driver they were built with.
+ */
+
+#ifndef LTP_HOST_SKETCH_HOOKS_H
+#define LTP_HOST_SKETCH_HOOKS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+class LtpProtocol;
+
+// The sketch's protocol handler
+LtpProtocol& sketchProtocol();
+
+// FNV-1a hash of the drawing buffer (pixels as the firmware holds them)
+uint32_t sketchFramebufferHash();
+
+// Frames shown (stats.framesDisplayed)
+uint32_t sketchFramesDisplayed();
+
+namespace SketchHooks {
+
+inline uint32_t fnv1a(const uint8_t* data, size_t len, uint32_t hash = 2166136261u) {
+    for (size_t i = 0; i < len; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+} // namespace SketchHooks
+
+#endif // LTP_HOST_SKETCH_HOOKS_H
@@ -0,0 +1,32 @@
+/**
+ * LTP Host Build - ltp_octo_v2 sketch translation unit
+ *
+ * The Arduino builder compiles .ino files as C++; the host build does the
+ * same by including the sketch directly.
+ */
+
+#include "ltp_octo_v2.ino"
+
+// ============================================================================
+// Host inspection hooks (sketch_hooks.h)
+// ============================================================================
+
+#include "sketch_hooks.h"
+
+LtpProtocol& sketchProtocol() {
+    return protocol;
+}
+
+uint32_t sketchFramebufferHash() {
+    uint32_t hash = SketchHooks::fnv1a(nullptr, 0);
+    for (uint16_t i = 0; i < TOTAL_PIXELS; i++) {
+        uint32_t color = leds.getPixelColor(i);
+        uint8_t rgb[3] = { (uint8_t)(color >> 16), (uint8_t)(color >> 8), (uint8_t)color };
+        hash = SketchHooks::fnv1a(rgb, 3, hash);
+    }
+    return hash;
+}
+
+uint32_t sketchFramesDisplayed() {
+    return stats.framesDisplayed;
+}
@@ -0,0 +1,33 @@
+/**
+ * LTP Host Build - ltp_serial_v2 sketch translation unit
+ *
+ * The Arduino builder compiles .ino files as C++; the host build does the
+ * same by including the sketch directly.
+ */
+
+#include "ltp_serial_v2.ino"
+
+// ============================================================================
+// Host inspection hooks (sketch_hooks.h)
+// ============================================================================
+
+#include "sketch_hooks.h"
+
+LtpProtocol& sketchProtocol() {
+    return protocol;
+}
+
+uint32_t sketchFramebufferHash() {
+    // Through readBuffer(), which palette drivers expand pixel by pixel
+    uint32_t hash = 2166136261u;
+    uint8_t bytes[4];
+    for (uint16_t i = 0; i < leds.getNumPixels(); i++) {
+        leds.readBuffer(i, 1, bytes);
+        hash = SketchHooks::fnv1a(bytes, leds.getBytesPerPixel(), hash);
+    }
+    return hash;
+}
+
+uint32_t sketchFramesDisplayed() {
+    return stats.framesDisplayed;
+}
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""
+LTP Host Build - Capacity Planner Validation
+
+Runs measure_link.py against the virtual MCUs for a set of link rates and
+pixel counts and compares the frame rate the device displayed with what
+ltp_capacity predicts for the same configuration (host CPU profile).
+The measured rate is the device's steady-state rate, sampled with
+INFO_STATS while streaming, so the queued backlog does not inflate it.
+
+The virtual MCU emulates the UART, USB flow control and OctoWS2811 DMA
+timing, so this checks the planner's packet, link and DMA model; MCU CPU
+costs have to be checked on real hardware.
+
+Usage:
+    python3 validate_capacity.py [--seconds 3] [--tolerance 10]
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+BUILD = os.path.join(HERE, "build")
+
+# (virtual MCU, planner arguments, measure_link arguments, minimum seconds)
+# At low baud rates host writes block for seconds at a time on the full pty
+# buffer, so those cases need a longer run to collect enough stats samples.
+CASES = [
+    ("ltp_vmcu_serial_v2", ["--controller", "vmcu-serial", "--baud", "57600", "--pixels", "60"],
+     ["--baud", "57600", "--pixels", "60"], 8.0),
+    ("ltp_vmcu_serial_v2", ["--controller", "vmcu-serial", "--baud", "115200", "--pixels", "160"],
+     ["--baud", "115200", "--pixels", "160"], 0.0),
+    ("ltp_vmcu_serial_v2", ["--controller", "vmcu-serial", "--baud", "230400", "--pixels", "100"],
+     ["--baud", "230400", "--pixels", "100"], 0.0),
+    ("ltp_vmcu_serial_v2", ["--controller", "vmcu-serial", "--baud", "460800", "--pixels", "160"],
+     ["--baud", "460800", "--pixels", "160"], 0.0),
+    # Unpaced USB: the DMA model is the only limit
+    ("ltp_vmcu_octo_v2", ["--controller", "vmcu-octo", "--usb", "0"],
+     ["--pixels", "960"], 0.0),
+]
+
+
+def predict(args: list[str]) -> float:
+    out = subprocess.run([os.path.join(BUILD, "ltp_capacity"), "--csv", *args],
+                         check=True, capture_output=True, text=True).stdout
+    header, row = out.strip().splitlines()[:2]
+    return float(dict(zip(header.split(","), row.split(",")))["fps"])
+
+
+def measure(binary: str, args: list[str], seconds: float) -> float:
+    out = subprocess.run([sys.executable, os.path.join(HERE, "measure_link.py"),
+                          os.path.join(BUILD, binary), "--seconds", str(seconds), "--pings", "5", *args],
+                         check=True, capture_output=True, text=True).stdout
+    match = re.search(r"Device steady:\s+([\d.]+) FPS", out)
+    if not match:
+        raise RuntimeError(f"Unexpected measure_link output:\n{out}")
+    return float(match.group(1))
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Validate ltp_capacity against virtual MCUs")
+    parser.add_argument("--seconds", type=float, default=3.0, help="Streaming time per case")
+    parser.add_argument("--tolerance", type=float, default=10.0, help="Allowed error in percent")
+    args = parser.parse_args()
+
+    failures = 0
+    print(f"{'case':<48} {'predicted':>10} {'measured':>10} {'error':>8}")
+    for binary, plan_args, measure_args, min_seconds in CASES:
+        predicted = predict(plan_args)
+        measured = measure(binary, measure_args, max(args.seconds, min_seconds))
+        error = (measured - predicted) / predicted * 100.0
+        ok = abs(error) <= args.tolerance
+        failures += not ok
+        name = " ".join(plan_args[1:])
+        print(f"{name:<48} {predicted:10.1f} {measured:10.1f} {error:+7.1f}%{'' if ok else '  FAIL'}")
+
+    print()
+    print(f"{len(CASES) - failures}/{len(CASES)} within {args.tolerance:.0f}%")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
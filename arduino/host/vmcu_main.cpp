@@ -0,0 +1,185 @@
+/**
+ * LTP Host Build - Virtual MCU Runner
+ *
+ * Runs a sketch's setup()/loop() on Linux with Serial attached to a
+ * pseudo-terminal. The pty path is printed on stdout ("pty: /dev/pts/N")
+ * so scripts can hand it to ltp_serial_cli or ltp_serial_sink.
+ */
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <SD.h>
+#include "serial_pty.h"
+#include "wav_file.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+void setup();
+void loop();
+
+#ifndef LTP_HOST_SKETCH
+#define LTP_HOST_SKETCH "sketch"
+#endif
+
+namespace {
+
+volatile sig_atomic_t stopRequested = 0;
+
+void onSignal(int) { stopRequested = 1; }
+
+void usage(const char* prog) {
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "\n"
+        "Run the " LTP_HOST_SKETCH " firmware as a virtual MCU on a pty.\n"
+        "\n"
+        "Options:\n"
+        "  --link PATH       Symlink the pty to PATH (e.g. /tmp/ltp-vmcu)\n"
+        "  --baud N          Pace the link at N baud (overrides Serial.begin)\n"
+        "  --usb             USB CDC link: no baud pacing\n"
+        "  --rx-buffer N     UART receive buffer size (default %d)\n"
+        "  --tx-buffer N     UART transmit buffer size (default 64)\n"
+        "  --spin            Busy-loop like real firmware (lowest latency)\n"
+        "  --capture FILE    Record link traffic to FILE (see capture_file.h)\n"
+        "  --eeprom FILE     Keep the EEPROM image in FILE across runs\n"
+        "  --audio FILE      Feed analogRead() from a 16-bit WAV file, looped\n"
+        "  --sd DIR          Serve the SD card's files from DIR\n"
+        "  --stats           Print link statistics on exit\n",
+        prog, LTP_HOST_RX_BUFFER);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    PtySerialBackend pty;
+    CaptureWriter capture;
+    const char* linkPath = nullptr;
+    const char* capturePath = nullptr;
+    const char* eepromPath = nullptr;
+    const char* audioPath = nullptr;
+    const char* sdPath = nullptr;
+    std::vector<int16_t> audio;
+    uint32_t audioRate = 0;
+    bool spin = false;
+    bool printStats = false;
+    int inheritMaster = -1;
+    int inheritSlave = -1;
+
+    pty.setRxBufferSize(LTP_HOST_RX_BUFFER);
+#if LTP_HOST_USB_SERIAL
+    pty.forceBaud(0);
+#endif
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--link" && hasValue) {
+            linkPath = argv[++i];
+        } else if (arg == "--baud" && hasValue) {
+            pty.forceBaud((uint32_t)strtoul(argv[++i], nullptr, 0));
+        } else if (arg == "--usb") {
+            pty.forceBaud(0);
+        } else if (arg == "--rx-buffer" && hasValue) {
+            pty.setRxBufferSize((uint16_t)strtoul(argv[++i], nullptr, 0));
+        } else if (arg == "--tx-buffer" && hasValue) {
+            pty.setTxBufferSize((uint16_t)strtoul(argv[++i], nullptr, 0));
+        } else if (arg == "--spin") {
+            spin = true;
+        } else if (arg == "--capture" && hasValue) {
+            capturePath = argv[++i];
+        } else if (arg == "--eeprom" && hasValue) {
+            eepromPath = argv[++i];
+        } else if (arg == "--audio" && hasValue) {
+            audioPath = argv[++i];
+        } else if (arg == "--sd" && hasValue) {
+            sdPath = argv[++i];
+        } else if (arg == "--stats") {
+            printStats = true;
+        } else if (arg == "--inherit" && hasValue) {
+            // Internal: re-exec after a firmware reset keeps the same pty
+            sscanf(argv[++i], "%d,%d", &inheritMaster, &inheritSlave);
+        } else {
+            usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 2;
+        }
+    }
+
+    if (inheritMaster >= 0) {
+        pty.adopt(inheritMaster, inheritSlave, linkPath);
+    } else {
+        if (!pty.open(linkPath)) return 1;
+        printf("pty: %s\n", pty.slavePath().c_str());
+        fflush(stdout);
+    }
+
+    // After a reset the capture continues in the same file
+    if (capturePath) {
+        if (!capture.open(capturePath, inheritMaster >= 0)) {
+            perror(capturePath);
+            return 1;
+        }
+        pty.setCapture(&capture);
+    }
+
+    if (eepromPath && !EEPROM.attach(eepromPath)) {
+        perror(eepromPath);
+        return 1;
+    }
+
+    if (audioPath) {
+        const char* error = WavFile::load(audioPath, audio, audioRate);
+        if (error) {
+            fprintf(stderr, "%s: %s\n", audioPath, error);
+            return 1;
+        }
+        ArduinoHost::setAnalogInput(audio.data(), audio.size(), audioRate);
+    }
+
+    if (sdPath) SD.setRoot(sdPath);
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    Serial.setBackend(&pty);
+    setup();
+
+    while (!stopRequested) {
+        ArduinoHost::runTimers();
+        loop();
+        pty.service();
+
+        if (ArduinoHost::resetRequested()) {
+            // A real reset reinitializes all RAM; re-exec to get the same
+            // effect while keeping the host's pty connection alive.
+            pty.flush();
+            capture.flush();
+            std::vector<char*> args;
+            args.push_back(argv[0]);
+            std::string fds = std::to_string(pty.getMasterFd()) + "," + std::to_string(pty.getSlaveFd());
+            std::string inherit = "--inherit";
+            for (int i = 1; i < argc; i++) {
+                std::string arg = argv[i];
+                if (arg == "--inherit") { i++; continue; }
+                args.push_back(argv[i]);
+            }
+            args.push_back(&inherit[0]);
+            args.push_back(&fds[0]);
+            args.push_back(nullptr);
+            execv("/proc/self/exe", args.data());
+            perror("execv");
+            return 1;
+        }
+
+        if (!spin) pty.waitForActivity(200);
+    }
+
+    if (printStats) {
+        fprintf(stderr, "rx_bytes=%u tx_bytes=%u rx_overruns=%u\n",
+                pty.getRxBytes(), pty.getTxBytes(), pty.getRxOverruns());
+    }
+    return 0;
+}
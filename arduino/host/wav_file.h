@@ -0,0 +1,85 @@
+/**
+ * LTP Host Build - WAV Files
+ *
+ * Reads 16-bit PCM WAV files as mono samples, for driving the firmware's
+ * audio input (analogRead() on the virtual MCU, the audio engine in
+ * ltp_audio). Channels are averaged; other sample formats are rejected.
+ */
+
+#ifndef LTP_HOST_WAV_FILE_H
+#define LTP_HOST_WAV_FILE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace WavFile {
+
+inline uint32_t getLE(const uint8_t* in, int bytes) {
+    uint32_t value = 0;
+    for (int i = 0; i < bytes; i++) value |= (uint32_t)in[i] << (8 * i);
+    return value;
+}
+
+/**
+ * Load a WAV file into samples (mono) and its sample rate.
+ * Returns nullptr on success, else what was wrong with the file.
+ */
+inline const char* load(const char* path, std::vector<int16_t>& samples, uint32_t& rate) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return "cannot open file";
+
+    uint8_t riff[12];
+    if (fread(riff, 1, sizeof(riff), f) != sizeof(riff) ||
+        memcmp(riff, "RIFF", 4) != 0 || memcmp(riff + 8, "WAVE", 4) != 0) {
+        fclose(f);
+        return "not a WAV file";
+    }
+
+    uint16_t channels = 0;
+    uint16_t bits = 0;
+    uint8_t chunk[8];
+    while (fread(chunk, 1, sizeof(chunk), f) == sizeof(chunk)) {
+        uint32_t size = getLE(chunk + 4, 4);
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t fmt[16];
+            if (size < sizeof(fmt) || fread(fmt, 1, sizeof(fmt), f) != sizeof(fmt)) break;
+            if (getLE(fmt, 2) != 1) {
+                fclose(f);
+                return "not PCM";
+            }
+            channels = (uint16_t)getLE(fmt + 2, 2);
+            rate = getLE(fmt + 4, 4);
+            bits = (uint16_t)getLE(fmt + 14, 2);
+            fseek(f, (long)(size - sizeof(fmt) + (size & 1)), SEEK_CUR);
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (bits != 16 || channels == 0) {
+                fclose(f);
+                return "not 16-bit PCM";
+            }
+            uint32_t frames = size / (2 * channels);
+            samples.clear();
+            samples.reserve(frames);
+            for (uint32_t i = 0; i < frames; i++) {
+                uint8_t raw[2];
+                int32_t sum = 0;
+                for (uint16_t c = 0; c < channels; c++) {
+                    if (fread(raw, 1, 2, f) != 2) break;
+                    sum += (int16_t)getLE(raw, 2);
+                }
+                samples.push_back((int16_t)(sum / channels));
+            }
+            fclose(f);
+            return samples.empty() ? "no samples" : nullptr;
+        } else {
+            fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+    fclose(f);
+    return "no data chunk";
+}
+
+} // namespace WavFile
+
+#endif // LTP_HOST_WAV_FILE_H
@@ -0,0 +1,133 @@
+/**
+ * LTP Host Build - LED Wire Decoders
+ *
+ * Turns the bytes an SPI LED driver put on the wire (SPI or pin capture)
+ * back into per-LED colors, and splits the byte count into pixel data and
+ * framing (latch, start and end frames) so driver output cost can be
+ * compared exactly.
+ *
+ * LPD8806   GRB, one byte per channel with the MSB set (7-bit color),
+ *           followed by zero latch bytes.
+ * APA102    32-bit zero start frame, one 0b111bbbbb,B,G,R frame per LED,
+ *           then 0xFF end frame bytes (at least one clock per two LEDs).
+ */
+
+#ifndef LTP_HOST_WIRE_DECODE_H
+#define LTP_HOST_WIRE_DECODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+struct WireFrame {
+    std::vector<uint8_t> rgb;           // Decoded colors, 3 bytes per LED
+    std::vector<uint8_t> ledBrightness; // APA102 5-bit per-LED brightness
+    uint32_t dataBytes = 0;             // Bytes carrying LED data
+    uint32_t startBytes = 0;            // APA102 start frame
+    uint32_t endBytes = 0;              // LPD8806 latch / APA102 end frame
+    uint32_t totalBytes = 0;
+    std::string error;                  // Empty if the stream is well formed
+
+    uint16_t pixels() const { return (uint16_t)(rgb.size() / 3); }
+    uint32_t framingBytes() const { return startBytes + endBytes; }
+    bool ok() const { return error.empty(); }
+};
+
+namespace WireDecode {
+
+/**
+ * Decode one LPD8806 show(): data bytes until the first zero byte, then
+ * latch. Colors are the 7-bit channel values shifted back to 8 bits.
+ * expectedPixels (if non-zero) checks the LED count and the latch length
+ * the strip needs, (pixels + 31) / 32 zero bytes.
+ */
+inline WireFrame lpd8806(const uint8_t* data, size_t len, uint16_t expectedPixels = 0) {
+    WireFrame f;
+    f.totalBytes = (uint32_t)len;
+
+    size_t i = 0;
+    while (i < len && (data[i] & 0x80)) i++;
+    f.dataBytes = (uint32_t)i;
+    for (; i < len; i++) {
+        if (data[i] != 0) {
+            f.error = "data byte without MSB at offset " + std::to_string(i);
+            return f;
+        }
+        f.endBytes++;
+    }
+
+    if (f.dataBytes % 3) {
+        f.error = std::to_string(f.dataBytes) + " data bytes is not a whole number of LEDs";
+        return f;
+    }
+    for (uint32_t p = 0; p < f.dataBytes; p += 3) {
+        f.rgb.push_back((uint8_t)((data[p + 1] & 0x7F) << 1));  // R
+        f.rgb.push_back((uint8_t)((data[p + 0] & 0x7F) << 1));  // G
+        f.rgb.push_back((uint8_t)((data[p + 2] & 0x7F) << 1));  // B
+    }
+
+    if (expectedPixels) {
+        uint32_t latch = (expectedPixels + 31) / 32;
+        if (f.pixels() != expectedPixels) {
+            f.error = "decoded " + std::to_string(f.pixels()) + " LEDs, expected " + std::to_string(expectedPixels);
+        } else if (f.endBytes < latch) {
+            f.error = "latch is " + std::to_string(f.endBytes) + " bytes, strip needs " + std::to_string(latch);
+        }
+    }
+    return f;
+}
+
+/**
+ * Decode one APA102 show() for a strip of `pixels` LEDs. The LED count has
+ * to be known: a full-white LED frame and end frame bytes look the same.
+ */
+inline WireFrame apa102(const uint8_t* data, size_t len, uint16_t pixels) {
+    WireFrame f;
+    f.totalBytes = (uint32_t)len;
+
+    size_t i = 0;
+    while (i < len && i < 4 && data[i] == 0) i++;
+    f.startBytes = (uint32_t)i;
+    if (f.startBytes < 4) {
+        f.error = "start frame is " + std::to_string(f.startBytes) + " zero bytes, needs 4";
+        return f;
+    }
+
+    for (uint16_t p = 0; p < pixels; p++, i += 4) {
+        if (i + 4 > len) {
+            f.error = "stream ends after " + std::to_string(p) + " of " + std::to_string(pixels) + " LEDs";
+            return f;
+        }
+        if ((data[i] & 0xE0) != 0xE0) {
+            f.error = "LED " + std::to_string(p) + " frame does not start with 0b111";
+            return f;
+        }
+        f.ledBrightness.push_back(data[i] & 0x1F);
+        f.rgb.push_back(data[i + 3]);  // R
+        f.rgb.push_back(data[i + 2]);  // G
+        f.rgb.push_back(data[i + 1]);  // B
+        f.dataBytes += 4;
+    }
+
+    for (; i < len; i++) {
+        if (data[i] != 0xFF) {
+            char byteHex[8];
+            snprintf(byteHex, sizeof(byteHex), "0x%02x", data[i]);
+            f.error = std::string("end frame byte ") + byteHex + " at offset " + std::to_string(i);
+            return f;
+        }
+        f.endBytes++;
+    }
+    // The data is delayed by half a clock per LED
+    if (f.endBytes * 8 < (uint32_t)(pixels + 1) / 2) {
+        f.error = "end frame is " + std::to_string(f.endBytes) + " bytes, too short for " +
+                  std::to_string(pixels) + " LEDs";
+    }
+    return f;
+}
+
+} // namespace WireDecode
+
+#endif // LTP_HOST_WIRE_DECODE_H
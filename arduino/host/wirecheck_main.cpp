@@ -0,0 +1,342 @@
+/**
+ * LTP Host Build - SPI LED Wire Verifier
+ *
+ * Runs the ltp_serial_v2 SPI LED drivers over hardware SPI and the
+ * bit-banged path, captures what show() puts on the wire (SPI capture
+ * buffer or clock/data pin capture), decodes it back into LED colors with
+ * wire_decode.h and checks them against the colors that were set.
+ *
+ * Reports wire bytes per frame split into LED data and framing, and the
+ * wire time at the configured SPI clock. The bit-banged output must match
+ * the hardware SPI bytes exactly. Wire output is deterministic, so
+ * --baseline compares byte counts exactly: a driver change that alters
+ * output cost shows up as a difference to wire_baseline.txt.
+ *
+ * The palette-indexed LPD8806 variants load the pattern's first colors
+ * into the palette and index them, so the pattern repeats every palette
+ * size pixels; their wire output must match the RGB driver's byte count.
+ * The display-list variants draw solid blocks of 8 pixels over the first
+ * half and a PIXEL_FILL gradient over the rest, checked against the same
+ * fill rendered pixel by pixel.
+ */
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#include "packet_builder.h"
+#include "wire_decode.h"
+
+#include "led_driver_lpd8806.h"
+#include "led_driver_lpd8806_palette.h"
+#include "led_driver_lpd8806_spans.h"
+#include "led_driver_apa102.h"
+
+#include <map>
+#include <memory>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+const uint8_t kDataPin = 11;
+const uint8_t kClockPin = 13;
+
+enum Chip { CHIP_LPD8806, CHIP_APA102 };
+
+struct Variant {
+    const char* name;
+    Chip chip;
+    bool hardwareSpi;
+    uint8_t paletteBits;        // 0 = RGB per pixel
+    bool displayList;
+};
+
+const Variant kVariants[] = {
+    { "lpd8806/hw",            CHIP_LPD8806, true,  0, false },
+    { "lpd8806/bitbang",       CHIP_LPD8806, false, 0, false },
+    { "lpd8806-pal4/hw",       CHIP_LPD8806, true,  4, false },
+    { "lpd8806-pal4/bitbang",  CHIP_LPD8806, false, 4, false },
+    { "lpd8806-pal8/hw",       CHIP_LPD8806, true,  8, false },
+    { "lpd8806-pal8/bitbang",  CHIP_LPD8806, false, 8, false },
+    { "lpd8806-spans/hw",      CHIP_LPD8806, true,  0, true  },
+    { "lpd8806-spans/bitbang", CHIP_LPD8806, false, 0, true  },
+    { "apa102/hw",             CHIP_APA102,  true,  0, false },
+    { "apa102/bitbang",        CHIP_APA102,  false, 0, false },
+};
+
+struct Result {
+    WireFrame frame;            // Last decoded frame
+    std::vector<uint8_t> wire;  // Last frame as captured
+    uint32_t bits;              // Clock edges (bit-bang) or 8 x bytes (SPI)
+    uint32_t spiClockHz;        // 0 for bit-bang
+    int mismatches;             // LEDs decoded with the wrong color
+    std::string error;
+};
+
+// A driver laid out in storage, as the sketch carves it from its arena
+template <typename Driver>
+std::unique_ptr<LedDriver> makeIn(std::vector<uint8_t>& storage, uint16_t pixels, bool hardwareSpi) {
+    storage.assign(Driver::storageBytes(pixels), 0);
+    return std::unique_ptr<LedDriver>(new Driver(pixels, storage.data(), kDataPin, kClockPin, hardwareSpi));
+}
+
+std::unique_ptr<LedDriver> makeDriver(const Variant& v, uint16_t pixels, std::vector<uint8_t>& storage) {
+    if (v.displayList) {
+        return makeIn<LedDriverLPD8806Spans<255>>(storage, pixels, v.hardwareSpi);
+    }
+    if (v.paletteBits == 4) {
+        return makeIn<LedDriverLPD8806Palette<4>>(storage, pixels, v.hardwareSpi);
+    }
+    if (v.paletteBits == 8) {
+        return makeIn<LedDriverLPD8806Palette<8>>(storage, pixels, v.hardwareSpi);
+    }
+    if (v.chip == CHIP_LPD8806) {
+        return makeIn<LedDriverLPD8806>(storage, pixels, v.hardwareSpi);
+    }
+    return makeIn<LedDriverAPA102>(storage, pixels, v.hardwareSpi);
+}
+
+// Pixel i shows entry i % Colors, loaded with the pattern's first colors;
+// rgb is rewritten to the colors that should reach the wire
+template <uint8_t Bits>
+void drawPalette(LedDriver* driver, std::vector<uint8_t>& rgb, uint16_t pixels) {
+    auto* leds = static_cast<LedDriverLPD8806Palette<Bits>*>(driver);
+    const uint16_t colors = LedDriverLPD8806Palette<Bits>::PALETTE_COLORS;
+    for (uint16_t i = 0; i < pixels; i++) {
+        uint16_t e = i % colors;
+        if (i < colors) leds->setPaletteColor(e, rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        for (int c = 0; c < 3; c++) rgb[i * 3 + c] = rgb[e * 3 + c];
+        leds->setIndex(i, e);
+    }
+}
+
+// Blocks of 8 pixels, then a three-stop gradient from the pattern's colors
+// drawn as spans; rgb is rewritten to the fill rendered pixel by pixel
+void drawSpans(LedDriver* driver, std::vector<uint8_t>& rgb, uint16_t pixels) {
+    auto* leds = static_cast<LedDriverLPD8806Spans<255>*>(driver);
+    uint16_t half = pixels / 2;
+    leds->clear();
+    for (uint16_t i = 0; i < half; i += 8) {
+        uint16_t end = i + 8 < half ? i + 8 : half;
+        leds->fillRange(i, end, rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        for (uint16_t k = i; k < end; k++) {
+            for (int c = 0; c < 3; c++) rgb[k * 3 + c] = rgb[i * 3 + c];
+        }
+    }
+    uint8_t fill[11] = { FILL_GRADIENT, 3 };
+    for (int c = 0; c < 3; c++) {
+        fill[2 + c] = rgb[half * 3 + c];
+        fill[5 + c] = rgb[(half + pixels) / 2 * 3 + c];
+        fill[8 + c] = rgb[(pixels - 1) * 3 + c];
+    }
+    LtpFill::draw(fill, sizeof(fill), half, pixels, *leds);
+    LtpFill::render(fill, sizeof(fill), half, pixels, [&rgb](uint16_t i, uint8_t r, uint8_t g, uint8_t b) {
+        rgb[i * 3] = r;
+        rgb[i * 3 + 1] = g;
+        rgb[i * 3 + 2] = b;
+    });
+}
+
+// What the wire should carry for color value c, per the driver's scaling
+uint8_t expectedChannel(Chip chip, uint8_t c, uint8_t brightness) {
+    uint8_t scaled = ((uint16_t)c * (uint16_t)(brightness + 1)) >> 8;
+    return chip == CHIP_LPD8806 ? (uint8_t)((scaled >> 1) << 1) : scaled;
+}
+
+Result run(const Variant& v, uint16_t pixels, uint8_t brightness, int frames) {
+    Result r = {};
+    std::vector<uint8_t> storage;
+    std::unique_ptr<LedDriver> driver = makeDriver(v, pixels, storage);
+    driver->setBrightness(brightness);
+    driver->begin();
+
+    std::vector<uint8_t> capture(pixels * 4 + 1024);
+    for (int f = 0; f < frames && r.error.empty(); f++) {
+        std::vector<uint8_t> rgb = PacketBuilder::testPattern(pixels, (uint8_t)f);
+        if (v.displayList) {
+            drawSpans(driver.get(), rgb, pixels);
+        } else if (v.paletteBits == 4) {
+            drawPalette<4>(driver.get(), rgb, pixels);
+        } else if (v.paletteBits == 8) {
+            drawPalette<8>(driver.get(), rgb, pixels);
+        } else {
+            for (uint16_t i = 0; i < pixels; i++) {
+                driver->setPixel(i, rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+            }
+        }
+
+        size_t len;
+        if (v.hardwareSpi) {
+            SPI.setCapture(capture.data(), capture.size());
+            driver->show();
+            len = SPI.getCaptureLength();
+            SPI.setCapture(nullptr, 0);
+            r.bits = len * 8;
+            r.spiClockHz = SPI.getClockHz();
+        } else {
+            ArduinoHost::setPinCapture(kDataPin, kClockPin, capture.data(), capture.size());
+            driver->show();
+            len = ArduinoHost::getPinCaptureLength();
+            r.bits = ArduinoHost::getPinCaptureBits();
+            ArduinoHost::setPinCapture(0, 0, nullptr, 0);
+            if (r.bits % 8) {
+                r.error = std::to_string(r.bits) + " clock edges is not a whole number of bytes";
+            }
+        }
+        if (len == capture.size()) r.error = "capture buffer full";
+
+        r.wire.assign(capture.begin(), capture.begin() + len);
+        r.frame = v.chip == CHIP_LPD8806 ? WireDecode::lpd8806(r.wire.data(), len, pixels)
+                                         : WireDecode::apa102(r.wire.data(), len, pixels);
+        if (!r.frame.ok()) {
+            if (r.error.empty()) r.error = r.frame.error;
+            break;
+        }
+
+        for (uint16_t i = 0; i < pixels; i++) {
+            bool same = true;
+            for (int c = 0; c < 3; c++) {
+                same &= r.frame.rgb[i * 3 + c] == expectedChannel(v.chip, rgb[i * 3 + c], brightness);
+            }
+            r.mismatches += !same;
+        }
+        if (r.mismatches && r.error.empty()) {
+            r.error = std::to_string(r.mismatches) + " LEDs decoded with the wrong color in frame " + std::to_string(f);
+        }
+    }
+    return r;
+}
+
+void dump(const std::vector<uint8_t>& wire) {
+    for (size_t i = 0; i < wire.size(); i++) {
+        printf("%02x%s", wire[i], (i % 24 == 23 || i + 1 == wire.size()) ? "\n" : " ");
+    }
+}
+
+bool loadBaseline(const char* path, std::map<std::string, uint32_t>& out) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char name[128];
+        unsigned bytes;
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%127s %u", name, &bytes) == 2) out[name] = bytes;
+    }
+    fclose(f);
+    return true;
+}
+
+void usage(const char* prog) {
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "\n"
+        "Capture and decode SPI LED driver output.\n"
+        "\n"
+        "Options:\n"
+        "  --filter TEXT           Only variants whose name contains TEXT\n"
+        "  --pixels N              Strip length (default 160)\n"
+        "  --brightness N          Driver brightness 0-255 (default 255)\n"
+        "  --frames N              Test patterns to check (default 4)\n"
+        "  --dump                  Print the last frame's wire bytes\n"
+        "  --baseline FILE         Fail if wire bytes differ from FILE\n"
+        "  --write-baseline FILE   Record wire bytes to FILE\n",
+        prog);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string filter;
+    int pixels = 160;
+    int brightness = 255;
+    int frames = 4;
+    bool dumpWire = false;
+    const char* baselinePath = nullptr;
+    const char* writePath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) {
+            filter = argv[++i];
+        } else if (arg == "--pixels" && hasValue) {
+            pixels = atoi(argv[++i]);
+        } else if (arg == "--brightness" && hasValue) {
+            brightness = atoi(argv[++i]);
+        } else if (arg == "--frames" && hasValue) {
+            frames = atoi(argv[++i]);
+        } else if (arg == "--dump") {
+            dumpWire = true;
+        } else if (arg == "--baseline" && hasValue) {
+            baselinePath = argv[++i];
+        } else if (arg == "--write-baseline" && hasValue) {
+            writePath = argv[++i];
+        } else {
+            usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 2;
+        }
+    }
+    if (pixels < 1 || pixels > 2048 || brightness < 0 || brightness > 255 || frames < 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::map<std::string, uint32_t> baseline;
+    if (baselinePath && !loadBaseline(baselinePath, baseline)) {
+        fprintf(stderr, "%s: cannot read baseline\n", baselinePath);
+        return 1;
+    }
+
+    FILE* out = nullptr;
+    if (writePath) {
+        out = fopen(writePath, "w");
+        if (!out) {
+            fprintf(stderr, "%s: cannot write baseline\n", writePath);
+            return 1;
+        }
+        fprintf(out, "# SPI LED wire bytes per show(), %d pixels (make wire-baseline)\n", pixels);
+    }
+
+    int failures = 0;
+    std::map<std::string, std::vector<uint8_t>> hardwareWire;  // Per driver, to compare the bit-bang path against
+    printf("%-22s %7s %7s %7s %8s %10s  %s\n", "driver", "bytes", "data", "framing", "bits", "wire_us", "result");
+    for (const Variant& v : kVariants) {
+        if (!filter.empty() && std::string(v.name).find(filter) == std::string::npos) continue;
+
+        Result r = run(v, (uint16_t)pixels, (uint8_t)brightness, frames);
+        std::string key = std::string(v.name) + "/" + std::to_string(pixels);
+        std::string family = std::string(v.name).substr(0, std::string(v.name).find('/'));
+        if (v.hardwareSpi) {
+            hardwareWire[family] = r.wire;
+        } else if (r.error.empty() && hardwareWire.count(family) && hardwareWire[family] != r.wire) {
+            r.error = "wire bytes differ from hardware SPI";
+        }
+        std::string result = r.error.empty() ? "ok" : r.error;
+
+        if (baselinePath && r.error.empty()) {
+            auto it = baseline.find(key);
+            if (it == baseline.end()) {
+                result = "ok (not in baseline)";
+            } else if (it->second != r.frame.totalBytes) {
+                result = "wire bytes changed: " + std::to_string(it->second) + " -> " + std::to_string(r.frame.totalBytes) +
+                         " (" + (r.frame.totalBytes > it->second ? "+" : "") +
+                         std::to_string((int)r.frame.totalBytes - (int)it->second) + ")";
+                failures++;
+            }
+        }
+        if (!r.error.empty()) failures++;
+
+        char wireUs[16] = "-";
+        if (r.spiClockHz) snprintf(wireUs, sizeof(wireUs), "%.1f", r.bits * 1e6 / r.spiClockHz);
+        printf("%-22s %7u %7u %7u %8u %10s  %s\n", v.name, r.frame.totalBytes, r.frame.dataBytes,
+               r.frame.framingBytes(), r.bits, wireUs, result.c_str());
+
+        if (dumpWire) dump(r.wire);
+        if (out && r.error.empty()) fprintf(out, "%s %u\n", key.c_str(), r.frame.totalBytes);
+    }
+
+    if (out) fclose(out);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,421 @@
+/**
+ * LTP Serial Protocol v2 - Audio Engine
+ *
+ * Audio analysis on the device, so audio-reactive shows respond without the
+ * host sampling audio, computing spectra and streaming frames. An analog
+ * input (line level biased to mid-rail) is sampled at LTP_AUDIO_RATE into a
+ * double buffer; each full block of Samples is windowed, run through a
+ * fixed-point FFT, grouped into AUDIO_BANDS octave bands and checked for a
+ * beat. The spectrum and beat animations (ANIM_SPECTRUM, ANIM_PULSE) read
+ * the result.
+ *
+ * Sampling runs from an IntervalTimer interrupt calling analogRead(), with
+ * the loop processing one block while the interrupt fills the other; a
+ * block finished while the previous one is still waiting is dropped and
+ * counted as an overrun. Everything after sampling is integer:
+ *
+ *   FFT       Radix-2, Q15 twiddles, halved every stage so it cannot
+ *             overflow (output = DFT / Samples)
+ *   Bands     Loudest bin of each octave, on a log scale covering 48 dB
+ *             below the reference level, as 0-255
+ *   Reference Fixed gain, or automatic: follows the loudest band and falls
+ *             about 6 dB per second
+ *   Beats     Bass (bands 0-2) above its running average by the
+ *             threshold, at most one per LTP_AUDIO_BEAT_GAP ms
+ *
+ * The sketch calls begin() from setup(), dispatches CMD_AUDIO (0x69) to
+ * command() and calls update() once per loop(), which returns true when a
+ * new block has been analysed. Block cost is kept in LtpTicks ticks (CPU
+ * cycles on a Teensy) and reported by AUDIO_INFO.
+ */
+
+#ifndef LTP_AUDIO_H
+#define LTP_AUDIO_H
+
+#include <Arduino.h>
+#include "protocol.h"
+#include "profile.h"
+
+// Samples per second
+#ifndef LTP_AUDIO_RATE
+#define LTP_AUDIO_RATE      16000
+#endif
+
+// analogRead() resolution the samples arrive at
+#ifndef LTP_AUDIO_ADC_BITS
+#define LTP_AUDIO_ADC_BITS  10
+#endif
+
+// Shortest time between beats, ms (240 BPM)
+#ifndef LTP_AUDIO_BEAT_GAP
+#define LTP_AUDIO_BEAT_GAP  250
+#endif
+
+// Timer-driven sampling where the core has IntervalTimer
+#if defined(CORE_TEENSY) || defined(LTP_HOST_BUILD)
+#define LTP_AUDIO_TIMER     1
+#else
+#define LTP_AUDIO_TIMER     0
+#endif
+
+template <uint16_t Samples>
+class LtpAudio {
+public:
+    static_assert(Samples == 0 || (Samples >= 256 && (Samples & (Samples - 1)) == 0),
+                  "Samples must be a power of two of at least 256");
+
+    LtpAudio() : running(false), pin(0), gain(0), threshold(DEFAULT_THRESHOLD), level(0) {
+        memset(bands, 0, sizeof(bands));
+        reset();
+    }
+
+    // Set the input pin and build the window and twiddle tables
+    void begin(uint8_t analogPin) {
+        pin = analogPin;
+        instance = this;
+        LtpTicks::begin();
+        for (uint16_t i = 0; i < Samples; i++) {
+            float hann = 16384.0f * (1.0f - cosf(2.0f * (float)M_PI * i / Samples));
+            window[i] = hann < 32767.0f ? (int16_t)hann : 32767;
+        }
+        for (uint16_t i = 0; i < Samples / 2; i++) {
+            cosTable[i] = (int16_t)(32767.0f * cosf(2.0f * (float)M_PI * i / Samples));
+            sinTable[i] = (int16_t)(32767.0f * sinf(2.0f * (float)M_PI * i / Samples));
+        }
+    }
+
+    /**
+     * CMD_AUDIO: operation byte, then for AUDIO_START the optional gain (dB
+     * of boost, 0 = automatic) and beat threshold (bass over its average,
+     * in 1/64, 0 = default 1.4x). START and STOP reply ACK; INFO replies
+     * with a CMD_AUDIO packet.
+     */
+    void command(LtpProtocol& protocol, const LtpPacket& pkt) {
+        if (pkt.length < 1) {
+            protocol.sendNak(CMD_AUDIO, ERR_INVALID_LENGTH);
+            return;
+        }
+        uint8_t err = ERR_OK;
+        switch (pkt.payload[0]) {
+            case AUDIO_START:
+                err = start(pkt.payload + 1, pkt.length - 1);
+                break;
+            case AUDIO_STOP:
+                stop();
+                break;
+            case AUDIO_INFO: {
+                uint8_t response[INFO_SIZE];
+                protocol.sendPacket(CMD_AUDIO, response, writeInfo(response));
+                return;
+            }
+            default:
+                err = ERR_INVALID_PARAM;
+                break;
+        }
+        if (err != ERR_OK) {
+            protocol.sendNak(CMD_AUDIO, err);
+        } else {
+            protocol.sendAck(CMD_AUDIO);
+        }
+    }
+
+    // AUDIO_START parameters: gain, threshold. Starts the sampling timer.
+    uint8_t start(const uint8_t* data, uint16_t length) {
+        if (Samples == 0) return ERR_NOT_SUPPORTED;
+        uint8_t g = length > 0 ? data[0] : 0;
+        uint8_t t = length > 1 && data[1] ? data[1] : DEFAULT_THRESHOLD;
+        if (g > 48 || t < 64) return ERR_INVALID_PARAM;
+        stop();
+        gain = g;
+        threshold = t;
+        reset();
+        running = true;
+#if LTP_AUDIO_TIMER
+        if (!timer.begin(timerIsr, 1000000.0f / LTP_AUDIO_RATE)) {
+            running = false;
+            return ERR_HARDWARE;
+        }
+#endif
+        return ERR_OK;
+    }
+
+    void stop() {
+#if LTP_AUDIO_TIMER
+        timer.end();
+#endif
+        running = false;
+    }
+
+    // One ADC reading, from the sampling interrupt (or a host test feed)
+    void sample(uint16_t value) {
+        buffers[filling][fillPos] = value;
+        if (++fillPos < Samples) return;
+        fillPos = 0;
+        if (ready >= 0) {
+            overruns++;             // Refill the same buffer
+            return;
+        }
+        ready = filling;
+        filling ^= 1;
+    }
+
+    /**
+     * Analyse the block the interrupt finished, if there is one. Returns
+     * true with new bands, level and beat.
+     */
+    bool update() {
+        if (ready < 0) return false;
+        LTP_PROFILE_SCOPE(PROF_AUDIO_BLOCK);
+        uint32_t startTicks = LtpTicks::ticks();
+        analyse(buffers[(uint8_t)ready]);
+        ready = -1;
+        uint32_t cost = LtpTicks::since(startTicks);
+        lastTicks = cost;
+        totalTicks += cost;
+        if (cost > maxTicks) maxTicks = cost;
+        blocks++;
+        return true;
+    }
+
+    bool isRunning() const { return running; }
+    const uint8_t* getBands() const { return bands; }
+    uint8_t getLevel() const { return level; }
+    bool isBeat() const { return beat; }
+
+    // AUDIO_INFO response: running, rate, block size, band count, gain,
+    // threshold, level, bands, blocks, overruns, beats, beat interval (ms),
+    // then the tick rate and last, mean and maximum ticks per block
+    uint16_t writeInfo(uint8_t* out) const {
+        uint16_t n = 0;
+        out[n++] = running;
+        n += putU16(out + n, LTP_AUDIO_RATE);
+        n += putU16(out + n, Samples);
+        out[n++] = AUDIO_BANDS;
+        out[n++] = gain;
+        out[n++] = threshold;
+        out[n++] = level;
+        for (uint8_t b = 0; b < AUDIO_BANDS; b++) out[n++] = bands[b];
+        n += putU32(out + n, blocks);
+        n += putU32(out + n, overruns);
+        n += putU32(out + n, beats);
+        n += putU16(out + n, beatInterval);
+        n += putU32(out + n, LtpTicks::tickHz());
+        n += putU32(out + n, lastTicks);
+        n += putU32(out + n, blocks ? (uint32_t)(totalTicks / blocks) : 0);
+        n += putU32(out + n, maxTicks);
+        return n;
+    }
+
+    static const uint8_t INFO_SIZE = 47;
+
+private:
+    static const uint8_t DEFAULT_THRESHOLD = 90;        // 1.4x in 1/64
+    static const uint16_t SIZE = Samples ? Samples : 1;
+    static const uint16_t HALF = Samples ? Samples / 2 : 1;
+    // log2 in 1/16: a full-scale sine peaks at 4096 in its bin (Hann
+    // window, output / Samples), 48 dB is 8 octaves
+    static const int16_t FULL_SCALE_LOG = 12 * 16;
+    static const int16_t RANGE_LOG = 8 * 16;
+
+    bool running;
+    uint8_t pin;
+    uint8_t gain;
+    uint8_t threshold;
+    uint8_t level;
+    bool beat;
+    uint8_t bands[AUDIO_BANDS];
+
+    // Sampling: the interrupt fills buffers[filling]; ready is the finished
+    // one waiting for update(), or -1
+    uint16_t buffers[2][SIZE];
+    volatile uint8_t filling;
+    volatile uint16_t fillPos;
+    volatile int8_t ready;
+
+    int16_t re[SIZE];
+    int16_t im[SIZE];
+    int16_t window[SIZE];       // Hann, Q15
+    int16_t cosTable[HALF];     // Q15
+    int16_t sinTable[HALF];
+
+    int16_t referenceLog;       // Automatic gain, log2 in 1/16
+    uint32_t bassAverage;       // Bass magnitude, 8.8
+    uint32_t clockMs;           // Audio time, from blocks analysed
+    uint32_t msCarry;
+    uint32_t lastBeatMs;
+    uint16_t beatInterval;      // Average ms between beats, 0 = none yet
+
+    uint32_t blocks;
+    uint32_t overruns;
+    uint32_t beats;
+    uint32_t lastTicks;
+    uint64_t totalTicks;
+    uint32_t maxTicks;
+
+#if LTP_AUDIO_TIMER
+    IntervalTimer timer;
+#endif
+    static LtpAudio* instance;
+
+    static void timerIsr() { instance->sample(analogRead(instance->pin)); }
+
+    void reset() {
+        filling = 0;
+        fillPos = 0;
+        ready = -1;
+        beat = false;
+        referenceLog = FULL_SCALE_LOG - RANGE_LOG / 2;
+        bassAverage = 0;
+        clockMs = msCarry = 0;
+        lastBeatMs = 0;
+        beatInterval = 0;
+        blocks = overruns = beats = 0;
+        lastTicks = maxTicks = 0;
+        totalTicks = 0;
+    }
+
+    void analyse(const uint16_t* block) {
+        // Remove the bias, scale to Q14 and window
+        uint32_t sum = 0;
+        for (uint16_t i = 0; i < Samples; i++) sum += block[i];
+        int32_t mean = sum / Samples;
+        uint64_t power = 0;
+        for (uint16_t i = 0; i < Samples; i++) {
+            int32_t x = ((int32_t)block[i] - mean) << (15 - LTP_AUDIO_ADC_BITS);
+            if (x > 16383) x = 16383;
+            if (x < -16384) x = -16384;
+            power += (uint32_t)(x * x);
+            re[i] = (x * window[i]) >> 15;
+            im[i] = 0;
+        }
+        fft();
+
+        // Octave bands: bin 1, 2, 3-4, 5-8, ... (bin k is k x rate / Samples Hz)
+        int16_t loudest = 0;
+        int16_t bandLog[AUDIO_BANDS];
+        uint32_t bass = 0;
+        uint16_t first = 1;
+        for (uint8_t b = 0; b < AUDIO_BANDS; b++) {
+            uint16_t last = b + 1 < AUDIO_BANDS ? (Samples / 2 >> (AUDIO_BANDS - 1 - b)) : Samples / 2 - 1;
+            uint16_t peak = 0;
+            for (uint16_t k = first; k <= last; k++) {
+                uint16_t m = sqrt32((uint32_t)((int32_t)re[k] * re[k]) + (uint32_t)((int32_t)im[k] * im[k]));
+                if (m > peak) peak = m;
+                if (b < 3) bass += m;
+            }
+            bandLog[b] = log2x16(peak);
+            if (bandLog[b] > loudest) loudest = bandLog[b];
+            first = last + 1;
+        }
+
+        // Reference: fixed, or following the loudest band down at ~6 dB/s
+        int16_t reference;
+        if (gain) {
+            reference = FULL_SCALE_LOG - (int16_t)gain * 16 / 6;
+        } else {
+            if (loudest > referenceLog) {
+                referenceLog = loudest;
+            } else if ((blocks & 3) == 0 && referenceLog > RANGE_LOG / 2) {
+                referenceLog--;
+            }
+            reference = referenceLog;
+        }
+        for (uint8_t b = 0; b < AUDIO_BANDS; b++) bands[b] = scaleLog(bandLog[b], reference);
+        // RMS of a full-scale sine is 11585 (log 13.5); bands are 1.5 octaves lower
+        level = scaleLog(log2x16(sqrt32(power / Samples)) - 24, reference);
+
+        // Audio time from the samples analysed
+        msCarry += (uint32_t)Samples * 1000;
+        clockMs += msCarry / LTP_AUDIO_RATE;
+        msCarry %= LTP_AUDIO_RATE;
+
+        // Beat: bass above its running average (8.8) by the threshold
+        uint32_t bass88 = bass << 8;
+        beat = false;
+        if (bassAverage && bass >= 4 && bass88 / 64 * threshold > bassAverage &&
+            clockMs - lastBeatMs >= LTP_AUDIO_BEAT_GAP) {
+            uint32_t interval = clockMs - lastBeatMs;
+            if (beats && interval <= 1500) {
+                beatInterval = beatInterval ? (beatInterval * 3 + interval) / 4 : interval;
+            }
+            lastBeatMs = clockMs;
+            beats++;
+            beat = true;
+        }
+        bassAverage = bassAverage ? bassAverage - (bassAverage >> 5) + (bass88 >> 5) : bass88;
+    }
+
+    void fft() {
+        for (uint16_t i = 1, j = 0; i < Samples; i++) {
+            uint16_t bit = Samples >> 1;
+            for (; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if (i < j) {
+                int16_t t = re[i];
+                re[i] = re[j];
+                re[j] = t;
+                t = im[i];
+                im[i] = im[j];
+                im[j] = t;
+            }
+        }
+        for (uint16_t length = 2; length <= Samples; length <<= 1) {
+            uint16_t half = length >> 1;
+            uint16_t step = Samples / length;
+            for (uint16_t i = 0; i < Samples; i += length) {
+                for (uint16_t k = 0; k < half; k++) {
+                    int32_t wr = cosTable[k * step];
+                    int32_t wi = -sinTable[k * step];
+                    uint16_t a = i + k;
+                    uint16_t b = a + half;
+                    int32_t tr = (re[b] * wr - im[b] * wi) >> 15;
+                    int32_t ti = (re[b] * wi + im[b] * wr) >> 15;
+                    re[b] = (re[a] - tr) >> 1;
+                    im[b] = (im[a] - ti) >> 1;
+                    re[a] = (re[a] + tr) >> 1;
+                    im[a] = (im[a] + ti) >> 1;
+                }
+            }
+        }
+    }
+
+    // log2(v) in 1/16, 0 for 0 and 1
+    static int16_t log2x16(uint32_t v) {
+        if (v < 2) return 0;
+        int16_t n = 31;
+        while (!(v & 0x80000000UL)) {
+            v <<= 1;
+            n--;
+        }
+        return n * 16 + ((v >> 27) & 15);
+    }
+
+    // 0-255 over the RANGE_LOG below reference
+    static uint8_t scaleLog(int16_t value, int16_t reference) {
+        int16_t above = value - (reference - RANGE_LOG);
+        if (above <= 0) return 0;
+        if (above >= RANGE_LOG) return 255;
+        return above * 255 / RANGE_LOG;
+    }
+
+    static uint16_t sqrt32(uint32_t v) {
+        uint32_t root = 0;
+        uint32_t bit = 1UL << 30;
+        while (bit > v) bit >>= 2;
+        while (bit) {
+            if (v >= root + bit) {
+                v -= root + bit;
+                root = (root >> 1) + bit;
+            } else {
+                root >>= 1;
+            }
+            bit >>= 2;
+        }
+        return root;
+    }
+};
+
+template <uint16_t Samples>
+LtpAudio<Samples>* LtpAudio<Samples>::instance = nullptr;
+
+#endif // LTP_AUDIO_H
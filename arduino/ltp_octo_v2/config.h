@@ -63,7 +63,10 @@
 // Mode 3: Folded Matrix (16 rows)
 // Each strip folded in half with serpentine addressing
 // Width = PIXELS_PER_STRIP/2, Height = 16
+// (A mode given on the compiler command line takes precedence.)
+#if !defined(MODE_STRIPS) && !defined(MODE_MATRIX_8) && !defined(MODE_MATRIX_16)
 #define MODE_MATRIX_16      1
+#endif
 
 // ============================================================================
 // DERIVED CONFIGURATION - Do not modify
@@ -112,4 +115,16 @@
 // Pin 5:  Strip 8
 // These are directly connected to the OctoWS2811 adapter board
 
+// Audio input for the AUDIO engine: line level biased to mid-rail, on a pin
+// OctoWS2811 leaves free (A3)
+#define AUDIO_PIN           17
+
+// SD card for SEQUENCE playback: the built-in slot on Teensy 3.5/3.6/4.x,
+// else a reader on SPI (pins 11-13) with chip select on pin 10
+#ifdef BUILTIN_SDCARD
+#define SD_CS_PIN           BUILTIN_SDCARD
+#else
+#define SD_CS_PIN           10
+#endif
+
 #endif // LTP_OCTO_CONFIG_H
@@ -0,0 +1,190 @@
+/**
+ * LTP Serial Protocol v2 - Fill Primitives
+ *
+ * Structured fills drawn on the device from a few parameters, so a
+ * gradient, repeating stripes or every Nth pixel lit is one PIXEL_FILL
+ * (0x36) packet of under 20 bytes however long the strip is, instead of a
+ * PIXEL_FRAME. Pixels go straight to the driver through setPixel(), or as
+ * runs to a display-list driver through draw(); none of the fills divides
+ * per pixel:
+ *
+ *   FILL_GRADIENT  2-16 color stops, evenly spaced or at given positions,
+ *                  interpolated with 16.16 fixed-point steps per segment
+ *   FILL_PATTERN   a list of colors, each width pixels, repeated
+ *   FILL_STRIDE    one color on width pixels out of every stride; the
+ *                  pixels between keep their colors
+ *
+ * The sketch checks the strip and range as for PIXEL_SET_RANGE, then calls
+ * render() with the data after the range.
+ */
+
+#ifndef LTP_FILL_H
+#define LTP_FILL_H
+
+#include <Arduino.h>
+#include "protocol.h"
+
+class LtpFill {
+public:
+    static const uint8_t MAX_STOPS = 16;
+
+    /**
+     * Draw operation data[0] with its parameters (data[1..]) over pixels
+     * start to end - 1 through setPixel(index, r, g, b). Returns ERR_OK or
+     * the error code to NAK with; nothing is drawn on error.
+     */
+    template <typename SetPixel>
+    static uint8_t render(const uint8_t* data, uint16_t length, uint16_t start, uint16_t end,
+                          SetPixel setPixel) {
+        Pixels<SetPixel> out = { setPixel };
+        return draw(data, length, start, end, out);
+    }
+
+    /**
+     * Check and draw the operation as render() does, handing it to out in
+     * runs rather than pixels, for drivers that keep a display list:
+     *
+     *   out.solid(start, end, rgb)
+     *   out.ramp(start, end, rgb0, rgb1)     rgb0 at start, stepping toward
+     *                                        rgb1, reached at end
+     *   out.pattern(start, end, width, phase, table, colors)
+     *                                        colors RGB entries of table,
+     *                                        width pixels each, starting
+     *                                        phase pixels into the cycle
+     */
+    template <typename Out>
+    static uint8_t draw(const uint8_t* data, uint16_t length, uint16_t start, uint16_t end, Out& out) {
+        if (length < 1) return ERR_INVALID_LENGTH;
+        if (start > end) return ERR_INVALID_PARAM;
+        switch (data[0]) {
+            case FILL_GRADIENT:
+                return gradient(data + 1, length - 1, start, end, out);
+            case FILL_PATTERN:
+                return pattern(data + 1, length - 1, start, end, out);
+            case FILL_STRIDE:
+                return stride(data + 1, length - 1, start, end, out);
+            default:
+                return ERR_INVALID_PARAM;
+        }
+    }
+
+    // Color of a ramp k pixels after its start, n pixels long, as
+    // Pixels::ramp() steps it: 16.16 fixed point
+    static void rampStart(const uint8_t* c0, const uint8_t* c1, uint16_t n, uint16_t k,
+                          int32_t* acc, int32_t* step) {
+        for (uint8_t i = 0; i < 3; i++) {
+            step[i] = ((int32_t)c1[i] - c0[i]) * 65536 / n;
+            acc[i] = ((int32_t)c0[i] << 16) + 0x8000 + step[i] * k;
+        }
+    }
+
+private:
+    // Runs expanded to setPixel() calls
+    template <typename SetPixel>
+    struct Pixels {
+        SetPixel setPixel;
+
+        void solid(uint16_t start, uint16_t end, const uint8_t* c) {
+            for (uint16_t i = start; i < end; i++) setPixel(i, c[0], c[1], c[2]);
+        }
+
+        void ramp(uint16_t start, uint16_t end, const uint8_t* c0, const uint8_t* c1) {
+            int32_t acc[3], step[3];
+            rampStart(c0, c1, end - start, 0, acc, step);
+            for (uint16_t i = start; i < end; i++) {
+                setPixel(i, acc[0] >> 16, acc[1] >> 16, acc[2] >> 16);
+                for (uint8_t k = 0; k < 3; k++) acc[k] += step[k];
+            }
+        }
+
+        void pattern(uint16_t start, uint16_t end, uint8_t width, uint16_t phase,
+                     const uint8_t* table, uint16_t colors) {
+            uint16_t c = phase / width;
+            uint8_t k = phase % width;
+            const uint8_t* color = table + c * 3;
+            for (uint16_t i = start; i < end; i++) {
+                setPixel(i, color[0], color[1], color[2]);
+                if (++k == width) {
+                    k = 0;
+                    if (++c == colors) {
+                        c = 0;
+                        color = table;
+                    } else {
+                        color += 3;
+                    }
+                }
+            }
+        }
+    };
+
+    // Stops (1, bit 7 FILL_POSITIONS), then per stop its position along
+    // the range (1, 0-255, with FILL_POSITIONS) and RGB
+    template <typename Out>
+    static uint8_t gradient(const uint8_t* data, uint16_t length, uint16_t start, uint16_t end, Out& out) {
+        if (length < 1) return ERR_INVALID_LENGTH;
+        bool positioned = data[0] & FILL_POSITIONS;
+        uint8_t stops = data[0] & ~FILL_POSITIONS;
+        uint8_t stopSize = positioned ? 4 : 3;
+        if (stops < 2 || stops > MAX_STOPS) return ERR_INVALID_PARAM;
+        if (length < 1 + stops * stopSize) return ERR_INVALID_LENGTH;
+        if (start == end) return ERR_OK;
+
+        // Pixel of each stop; the last pixel is position 255
+        uint16_t span = end - start - 1;
+        uint16_t at[MAX_STOPS];
+        const uint8_t* stop = data + 1;
+        for (uint8_t s = 0; s < stops; s++, stop += stopSize) {
+            uint32_t offset = positioned ? ((uint32_t)stop[0] * span + 127) / 255 :
+                                           (uint32_t)s * span / (stops - 1);
+            at[s] = start + offset;
+            if (s > 0 && at[s] < at[s - 1]) return ERR_INVALID_PARAM;
+        }
+
+        const uint8_t* first = data + 1 + (positioned ? 1 : 0);
+        const uint8_t* last = first + (stops - 1) * stopSize;
+        if (start < at[0]) out.solid(start, at[0], first);
+        const uint8_t* c0 = first;
+        for (uint8_t s = 0; s + 1 < stops; s++, c0 += stopSize) {
+            if (at[s + 1] > at[s]) out.ramp(at[s], at[s + 1], c0, c0 + stopSize);
+        }
+        out.solid(at[stops - 1], end, last);
+        return ERR_OK;
+    }
+
+    // Width (1, pixels per color), offset (1, pixels the pattern is shifted
+    // by), then RGB per color
+    template <typename Out>
+    static uint8_t pattern(const uint8_t* data, uint16_t length, uint16_t start, uint16_t end, Out& out) {
+        if (length < 5 || (length - 2) % 3) return ERR_INVALID_LENGTH;
+        uint8_t width = data[0];
+        if (width == 0) return ERR_INVALID_PARAM;
+        uint16_t colors = (length - 2) / 3;
+        // Start the walk offset pixels into the pattern
+        uint16_t phase = data[1] % ((uint32_t)width * colors);
+        if (start < end) out.pattern(start, end, width, phase, data + 2, colors);
+        return ERR_OK;
+    }
+
+    // Stride (1), width (1, lit pixels per stride), phase (1, pixels before
+    // the first lit one), RGB
+    template <typename Out>
+    static uint8_t stride(const uint8_t* data, uint16_t length, uint16_t start, uint16_t end, Out& out) {
+        if (length < 6) return ERR_INVALID_LENGTH;
+        uint8_t every = data[0];
+        uint8_t width = data[1];
+        if (every == 0 || width == 0 || width > every) return ERR_INVALID_PARAM;
+        uint16_t k = (every - data[2] % every) % every;     // Position in the stride
+        // Lit runs as solids, the pixels between skipped
+        for (uint16_t i = start; i < end; ) {
+            uint16_t n = (k < width ? width : every) - k;
+            if (n > end - i) n = end - i;
+            if (k < width) out.solid(i, i + n, data + 3);
+            i += n;
+            k += n;
+            if (k == every) k = 0;
+        }
+        return ERR_OK;
+    }
+};
+
+#endif // LTP_FILL_H
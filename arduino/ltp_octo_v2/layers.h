@@ -0,0 +1,322 @@
+/**
+ * LTP Serial Protocol v2 - Layer Compositor
+ *
+ * Overlay layers blended over the frame at show time, so the host can
+ * stream a small overlay (a progress bar, an alert) on top of an animation
+ * running on the device instead of compositing on the host and sending
+ * every pixel. Layer 0, the base, is the driver's buffer that animations,
+ * fades, shaders, sequences and the pixel data commands draw into as
+ * before; layers 1 to Layers sit over it in order.
+ *
+ * Each overlay covers a window of logical pixels (start, count) with its
+ * own colors, taken from a pool of PoolPixels shared by all layers, and
+ * has an opacity and a blend mode:
+ *
+ *   LAYER_OVER      the layer's color
+ *   LAYER_ADD       base + layer, clipped
+ *   LAYER_MULTIPLY  base x layer / 255
+ *   LAYER_MAX       the brighter of the two, per channel
+ *
+ * mixed with the base by opacity (0-255). With LAYER_KEY, black pixels of
+ * the layer leave the base showing through.
+ *
+ * The sketch calls composite() just before the driver's show(): it saves
+ * the base colors under each window, writes the blended colors into the
+ * buffer in one pass per layer, and restore() puts the base back once the
+ * driver has taken the frame. Reads of the buffer between shows (fades,
+ * SCENE_STORE, GET_PIXELS) see the base only. Blending works on the
+ * buffer's brightness-scaled colors: layer colors are scaled the same way,
+ * except as MULTIPLY factors. Composite cost is kept in LtpTicks ticks and
+ * reported by LAYER_INFO.
+ */
+
+#ifndef LTP_LAYERS_H
+#define LTP_LAYERS_H
+
+#include <Arduino.h>
+#include "protocol.h"
+#include "profile.h"
+#include "fill.h"
+
+template <uint16_t Pixels, uint8_t Layers, uint16_t PoolPixels>
+class LtpLayers {
+public:
+    LtpLayers() : pixels(0), used(0), composites(0), lastTicks(0), totalTicks(0), maxTicks(0) {
+        memset(layers, 0, sizeof(layers));
+    }
+
+    void begin(uint16_t pixelCount) {
+        pixels = pixelCount < Pixels ? pixelCount : Pixels;
+        LtpTicks::begin();
+    }
+
+    /**
+     * CMD_LAYER: operation byte, then the layer ID (1 to Layers) and the
+     * operation's parameters. CONFIG and CLEAR reply ACK; OPACITY, PIXELS
+     * and FILL are only NAKed, like pixel data; INFO replies with a
+     * CMD_LAYER packet. Returns true when the composited frame changed, for
+     * the sketch to show it under Auto Show.
+     */
+    bool command(LtpProtocol& protocol, const LtpPacket& pkt) {
+        if (pkt.length < 1) {
+            protocol.sendNak(CMD_LAYER, ERR_INVALID_LENGTH);
+            return false;
+        }
+        const uint8_t* data = pkt.payload + 1;
+        uint16_t length = pkt.length - 1;
+        uint8_t err;
+        switch (pkt.payload[0]) {
+            case LAYER_CONFIG:
+                err = configure(data, length);
+                break;
+            case LAYER_CLEAR:
+                clear();
+                err = ERR_OK;
+                break;
+            case LAYER_OPACITY:
+                return replyData(protocol, setOpacity(data, length));
+            case LAYER_PIXELS:
+                return replyData(protocol, setPixels(data, length));
+            case LAYER_FILL:
+                return replyData(protocol, fill(data, length));
+            case LAYER_INFO: {
+                uint8_t response[INFO_SIZE];
+                protocol.sendPacket(CMD_LAYER, response, writeInfo(response));
+                return false;
+            }
+            default:
+                err = ERR_INVALID_PARAM;
+                break;
+        }
+        if (err != ERR_OK) {
+            protocol.sendNak(CMD_LAYER, err);
+            return false;
+        }
+        protocol.sendAck(CMD_LAYER);
+        return true;
+    }
+
+    // Turn every overlay off and free the pool
+    void clear() {
+        for (uint8_t l = 0; l < Layers; l++) layers[l].count = 0;
+        used = 0;
+    }
+
+    bool isActive() const {
+        for (uint8_t l = 0; l < Layers; l++) {
+            if (layers[l].count && layers[l].opacity) return true;
+        }
+        return false;
+    }
+
+    /**
+     * Blend the overlays into the driver's buffer through getRaw(index)
+     * and setRaw(index, color), the buffer's 0xRRGGBB words with
+     * brightness applied. Returns true if a layer was drawn, in which case
+     * the sketch calls restore() after show().
+     */
+    template <typename GetRaw, typename SetRaw>
+    bool composite(uint8_t brightness, GetRaw getRaw, SetRaw setRaw) {
+        if (!isActive()) return false;
+        LTP_PROFILE_SCOPE(PROF_LAYER_COMPOSITE);
+        uint32_t startTicks = LtpTicks::ticks();
+        for (uint8_t l = 0; l < Layers; l++) {
+            Layer& layer = layers[l];
+            layer.applied = layer.count && layer.opacity;
+            if (!layer.applied) continue;
+            const uint8_t* c = pool + layer.offset * 3;
+            uint8_t* save = saved + layer.offset * 3;
+            uint16_t alpha = layer.opacity + 1;
+            bool keyed = layer.flags & LAYER_KEY;
+            for (uint16_t i = layer.start; i < layer.start + layer.count; i++, c += 3, save += 3) {
+                uint32_t base = getRaw(i);
+                save[0] = base >> 16;
+                save[1] = base >> 8;
+                save[2] = base;
+                if (keyed && !(c[0] | c[1] | c[2])) continue;
+                uint8_t out[3];
+                for (uint8_t k = 0; k < 3; k++) {
+                    uint8_t b = save[k];
+                    uint8_t top = blend(layer.mode, b, c[k], brightness);
+                    out[k] = ((uint16_t)b * (256 - alpha) + (uint16_t)top * alpha) >> 8;
+                }
+                setRaw(i, ((uint32_t)out[0] << 16) | ((uint32_t)out[1] << 8) | out[2]);
+            }
+        }
+        uint32_t cost = LtpTicks::since(startTicks);
+        lastTicks = cost;
+        totalTicks += cost;
+        if (cost > maxTicks) maxTicks = cost;
+        composites++;
+        return true;
+    }
+
+    // Put back the base colors composite() saved, topmost layer first
+    template <typename SetRaw>
+    void restore(SetRaw setRaw) {
+        for (uint8_t l = Layers; l-- > 0;) {
+            Layer& layer = layers[l];
+            if (!layer.applied) continue;
+            layer.applied = false;
+            const uint8_t* save = saved + layer.offset * 3;
+            for (uint16_t i = layer.start; i < layer.start + layer.count; i++, save += 3) {
+                setRaw(i, ((uint32_t)save[0] << 16) | ((uint32_t)save[1] << 8) | save[2]);
+            }
+        }
+    }
+
+    // LAYER_INFO response: layer count, pool size and pixels used, then per
+    // layer its mode, opacity, flags, start (2) and count (2), then the
+    // tick rate, composites and last, mean and maximum ticks per composite
+    uint16_t writeInfo(uint8_t* out) const {
+        uint16_t n = 0;
+        out[n++] = Layers;
+        n += putU16(out + n, PoolPixels);
+        n += putU16(out + n, used);
+        for (uint8_t l = 0; l < Layers; l++) {
+            out[n++] = layers[l].mode;
+            out[n++] = layers[l].opacity;
+            out[n++] = layers[l].flags;
+            n += putU16(out + n, layers[l].start);
+            n += putU16(out + n, layers[l].count);
+        }
+        n += putU32(out + n, LtpTicks::tickHz());
+        n += putU32(out + n, composites);
+        n += putU32(out + n, lastTicks);
+        n += putU32(out + n, composites ? (uint32_t)(totalTicks / composites) : 0);
+        n += putU32(out + n, maxTicks);
+        return n;
+    }
+
+    static const uint16_t INFO_SIZE = 5 + 7 * Layers + 20;
+
+private:
+    struct Layer {
+        uint8_t mode;
+        uint8_t opacity;
+        uint8_t flags;
+        bool applied;       // Drawn by the last composite()
+        uint16_t start;     // First logical pixel
+        uint16_t count;     // Pixels, 0 = off
+        uint16_t offset;    // First pixel in the pool
+    };
+
+    uint16_t pixels;
+    uint16_t used;          // Pool pixels held by the layers, in layer order
+    Layer layers[Layers];
+    uint8_t pool[PoolPixels * 3];       // Layer colors, RGB
+    uint8_t saved[PoolPixels * 3];      // Base colors under the layers
+
+    uint32_t composites;
+    uint32_t lastTicks;
+    uint64_t totalTicks;
+    uint32_t maxTicks;
+
+    static uint8_t scale(uint8_t value, uint8_t brightness) {
+        return ((uint16_t)value * (uint16_t)(brightness + 1)) >> 8;
+    }
+
+    // Blend mode applied to one channel, before the opacity mix
+    static uint8_t blend(uint8_t mode, uint8_t base, uint8_t color, uint8_t brightness) {
+        switch (mode) {
+            case LAYER_ADD: {
+                uint16_t sum = base + scale(color, brightness);
+                return sum > 255 ? 255 : sum;
+            }
+            case LAYER_MULTIPLY:
+                return ((uint16_t)base * (color + 1)) >> 8;
+            case LAYER_MAX: {
+                uint8_t c = scale(color, brightness);
+                return c > base ? c : base;
+            }
+            default:
+                return scale(color, brightness);
+        }
+    }
+
+    // Layer by ID (1 to Layers), or nullptr
+    Layer* find(uint8_t id) {
+        return id >= 1 && id <= Layers ? &layers[id - 1] : nullptr;
+    }
+
+    // Data operations reply only on error; true if the frame changed
+    static bool replyData(LtpProtocol& protocol, uint8_t err) {
+        if (err != ERR_OK) {
+            protocol.sendNak(CMD_LAYER, err);
+            return false;
+        }
+        return true;
+    }
+
+    // LAYER_CONFIG: ID, mode, opacity, flags, start (2), count (2; 0 turns
+    // the layer off). The layer starts out black.
+    uint8_t configure(const uint8_t* data, uint16_t length) {
+        if (length < 8) return ERR_INVALID_LENGTH;
+        Layer* layer = find(data[0]);
+        uint8_t mode = data[1];
+        if (!layer || mode > LAYER_MAX) return ERR_INVALID_PARAM;
+        uint16_t start = data[4] | ((uint16_t)data[5] << 8);
+        uint16_t count = data[6] | ((uint16_t)data[7] << 8);
+        if ((uint32_t)start + count > pixels) return ERR_PIXEL_OVERFLOW;
+        if (used - layer->count + count > PoolPixels) return ERR_BUFFER_OVERFLOW;
+
+        // Move the layers above up or down the pool to the new size
+        uint16_t oldEnd = layer->offset + layer->count;
+        uint16_t newEnd = layer->offset + count;
+        memmove(pool + newEnd * 3, pool + oldEnd * 3, (used - oldEnd) * 3);
+        used = used - layer->count + count;
+        for (Layer* above = layer + 1; above < layers + Layers; above++) {
+            above->offset = above->offset - oldEnd + newEnd;
+        }
+        memset(pool + layer->offset * 3, 0, count * 3);
+
+        layer->mode = mode;
+        layer->opacity = data[2];
+        layer->flags = data[3];
+        layer->start = start;
+        layer->count = count;
+        return ERR_OK;
+    }
+
+    // LAYER_OPACITY: ID, opacity, then optionally a new mode
+    uint8_t setOpacity(const uint8_t* data, uint16_t length) {
+        if (length < 2) return ERR_INVALID_LENGTH;
+        Layer* layer = find(data[0]);
+        if (!layer || (length >= 3 && data[2] > LAYER_MAX)) return ERR_INVALID_PARAM;
+        layer->opacity = data[1];
+        if (length >= 3) layer->mode = data[2];
+        return ERR_OK;
+    }
+
+    // LAYER_PIXELS: ID, first pixel in the layer (2), RGB per pixel
+    uint8_t setPixels(const uint8_t* data, uint16_t length) {
+        if (length < 3 || (length - 3) % 3) return ERR_INVALID_LENGTH;
+        Layer* layer = find(data[0]);
+        if (!layer) return ERR_INVALID_PARAM;
+        uint16_t first = data[1] | ((uint16_t)data[2] << 8);
+        uint16_t count = (length - 3) / 3;
+        if ((uint32_t)first + count > layer->count) return ERR_PIXEL_OVERFLOW;
+        memcpy(pool + (layer->offset + first) * 3, data + 3, count * 3);
+        return ERR_OK;
+    }
+
+    // LAYER_FILL: ID, start (2), end (2, exclusive) within the layer, then
+    // a PIXEL_FILL operation and its parameters (fill.h)
+    uint8_t fill(const uint8_t* data, uint16_t length) {
+        if (length < 6) return ERR_INVALID_LENGTH;
+        Layer* layer = find(data[0]);
+        if (!layer) return ERR_INVALID_PARAM;
+        uint16_t start = data[1] | ((uint16_t)data[2] << 8);
+        uint16_t end = data[3] | ((uint16_t)data[4] << 8);
+        if (end > layer->count) return ERR_PIXEL_OVERFLOW;
+        uint8_t* colors = pool + layer->offset * 3;
+        return LtpFill::render(data + 5, length - 5, start, end,
+            [colors](uint16_t i, uint8_t r, uint8_t g, uint8_t b) {
+                colors[i * 3] = r;
+                colors[i * 3 + 1] = g;
+                colors[i * 3 + 2] = b;
+            });
+    }
+};
+
+#endif // LTP_LAYERS_H
@@ -11,6 +11,7 @@
 #include <OctoWS2811.h>
 #include "config.h"
 #include "protocol.h"
+#include "profile.h"
 
 // OctoWS2811 requires these memory arrays at global scope for DMAMEM
 DMAMEM static uint32_t octoDisplayMemory[PIXELS_PER_STRIP * NUM_STRIPS];
@@ -30,6 +31,7 @@ public:
     }
 
     void show() {
+        LTP_PROFILE_SCOPE(PROF_DRIVER_SHOW);
         leds.show();
     }
 
@@ -44,6 +46,7 @@ public:
      * @return Physical pixel index for OctoWS2811 (0 to TOTAL_PIXELS-1)
      */
     uint16_t mapPixel(uint16_t logicalIndex) {
+        LTP_PROFILE_SCOPE(PROF_MAP_PIXEL);
 #if MATRIX_MODE
     #if MATRIX_FOLD == 2
         // MATRIX_16: Each physical strip is 2 logical rows with serpentine
@@ -102,6 +105,32 @@ public:
         leds.setPixel(physIndex, color);
     }
 
+    /**
+     * Read a pixel back by logical index, brightness scaling undone (to the
+     * nearest value).
+     */
+    void getPixel(uint16_t logicalIndex, uint8_t& r, uint8_t& g, uint8_t& b) {
+        r = g = b = 0;
+        if (logicalIndex >= getLogicalPixelCount()) return;
+
+        uint32_t color = octoDrawingMemory[mapPixel(logicalIndex)];
+        r = unscale8((color >> 16) & 0xFF);
+        g = unscale8((color >> 8) & 0xFF);
+        b = unscale8(color & 0xFF);
+    }
+
+    /**
+     * Buffer word of a logical pixel as stored (0xRRGGBB, brightness
+     * applied), so the layer compositor can save and restore it exactly.
+     */
+    uint32_t getRawPixel(uint16_t logicalIndex) {
+        return (uint32_t)leds.getPixel(mapPixel(logicalIndex)) & 0xFFFFFF;
+    }
+
+    void setRawPixel(uint16_t logicalIndex, uint32_t color) {
+        leds.setPixel(mapPixel(logicalIndex), (int)color);
+    }
+
     /**
      * Set a pixel on a specific strip (for STRIPS mode).
      * In matrix mode, stripId must be 0.
@@ -215,6 +244,12 @@ private:
     uint8_t scale8(uint8_t value) const {
         return ((uint16_t)value * (uint16_t)(brightness + 1)) >> 8;
     }
+
+    uint8_t unscale8(uint8_t value) const {
+        if (brightness == 255) return value;
+        uint16_t v = ((uint16_t)value * 256 + brightness / 2) / (brightness + 1);
+        return v > 255 ? 255 : v;
+    }
 };
 
 #endif // LTP_LED_DRIVER_OCTO_H
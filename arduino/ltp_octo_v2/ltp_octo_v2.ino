@@ -22,6 +22,23 @@
 #include <OctoWS2811.h>
 #include "config.h"
 #include "protocol.h"
+#include "latency.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "selfbench.h"
+#include "linkprobe.h"
+#include "animation.h"
+#include "fade.h"
+#include "shader.h"
+#include "fill.h"
+#include "coords.h"
+#include "visualizer.h"
+#include "audio.h"
+#include "scene.h"
+#include "sequence.h"
+#include "sequence_data.h"
+#include "layers.h"
+#include "profile.h"
 #include "led_driver_octo.h"
 
 // ============================================================================
@@ -48,11 +65,64 @@ struct {
     uint32_t framesReceived = 0;
     uint32_t framesDisplayed = 0;
     uint32_t bytesReceived = 0;
-    uint16_t checksumErrors = 0;
-    uint16_t bufferOverflows = 0;
     uint32_t startTime = 0;
 } stats;
 
+// Per-frame latency histograms (GET_INFO INFO_LATENCY)
+LtpLatency latency;
+
+// STATUS_UPDATE telemetry every config.statusInterval seconds
+LtpTelemetry telemetry;
+
+#if LTP_TRACE_ENTRIES
+// Last packets handled (CMD_TRACE)
+LtpTrace trace;
+#endif
+
+// ECHO / SINK link measurements
+LtpLinkProbe linkProbe;
+
+// Built-in animations (CMD_ANIM_*) over the logical pixels; sparkle and fire
+// keep a byte per pixel
+LtpAnimation animation;
+uint8_t animationStorage[TOTAL_PIXELS * LtpAnimation::BYTES_PER_PIXEL];
+
+// FADE_TO keyframes over the logical pixels
+LtpFade<4> fade;
+uint8_t fadeStorage[TOTAL_PIXELS * decltype(fade)::BYTES_PER_PIXEL];
+
+// SHADER_LOAD programs, bytes of bytecode; x/y follow the matrix rows
+LtpShader<512> shader;
+#if MATRIX_MODE
+#define SHADER_WIDTH MATRIX_WIDTH
+#else
+#define SHADER_WIDTH PIXELS_PER_STRIP
+#endif
+
+// COORDS table for spatial animations and shaders; 8-bit coordinates so a
+// full table fits the Teensy's EEPROM
+LtpCoords<int8_t> coords;
+uint8_t coordsStorage[TOTAL_PIXELS * decltype(coords)::BYTES_PER_PIXEL];
+
+// VIS_CONFIG bar graphs and meters driven by VIS_VALUE
+LtpVisualizer visualizer;
+
+// AUDIO engine on AUDIO_PIN, 256-sample blocks for the audio animations
+LtpAudio<256> audio;
+
+// SCENE slots, 3 bytes per pixel each, in RAM: the EEPROM holds the COORDS
+// table
+LtpScenes<4, 0> scenes;
+uint8_t sceneStorage[TOTAL_PIXELS * decltype(scenes)::BYTES_PER_PIXEL];
+
+// SEQUENCE playback from PROGMEM (sequence_data.h) or the SD card on
+// SD_CS_PIN, read in 512-byte blocks
+LtpSequence<512> sequence;
+
+// LAYER overlays over the frame: 3 layers sharing one frame's worth of
+// pixels, composited at show time
+LtpLayers<TOTAL_PIXELS, 3, TOTAL_PIXELS> layers;
+
 #define NUM_CONTROLS 6
 
 // ============================================================================
@@ -77,7 +147,7 @@ void sendHello() {
     caps1 |= CAPS_MULTI_STRIP;
 #endif
     payload[8] = caps1;
-    payload[9] = CAPS_PIXEL_READBACK;
+    payload[9] = CAPS_PIXEL_READBACK | CAPS_ANIMATION | CAPS_SHADER;
     payload[10] = NUM_CONTROLS;
     payload[11] = 0; // Input count
 
@@ -91,7 +161,127 @@ void sendHello() {
 #endif
 }
 
+void sendLatencyInfo(bool clear) {
+    uint8_t response[LtpLatency::INFO_SIZE];
+    uint16_t respLen = latency.writeInfo(response);
+    protocol.sendPacket(CMD_INFO_RESPONSE, response, respLen);
+    if (clear) latency.clear();
+}
+
+void sendStatsInfo() {
+    uint8_t response[20 + LtpProtocol::ERROR_INFO_MAX_SIZE];
+    uint16_t respLen = 0;
+    const LtpParserStats& ps = protocol.getParserStats();
+    uint32_t uptime = (millis() - stats.startTime) / 1000;
+
+    // Frames received (4 bytes)
+    response[respLen++] = stats.framesReceived & 0xFF;
+    response[respLen++] = (stats.framesReceived >> 8) & 0xFF;
+    response[respLen++] = (stats.framesReceived >> 16) & 0xFF;
+    response[respLen++] = (stats.framesReceived >> 24) & 0xFF;
+    // Frames displayed (4 bytes)
+    response[respLen++] = stats.framesDisplayed & 0xFF;
+    response[respLen++] = (stats.framesDisplayed >> 8) & 0xFF;
+    response[respLen++] = (stats.framesDisplayed >> 16) & 0xFF;
+    response[respLen++] = (stats.framesDisplayed >> 24) & 0xFF;
+    // Bytes received (4 bytes)
+    response[respLen++] = stats.bytesReceived & 0xFF;
+    response[respLen++] = (stats.bytesReceived >> 8) & 0xFF;
+    response[respLen++] = (stats.bytesReceived >> 16) & 0xFF;
+    response[respLen++] = (stats.bytesReceived >> 24) & 0xFF;
+    // Checksum errors (2 bytes)
+    response[respLen++] = ps.checksumErrors & 0xFF;
+    response[respLen++] = ps.checksumErrors >> 8;
+    // Buffer overflows: times the serial RX buffer filled (2 bytes)
+    response[respLen++] = ps.rxBufferFull & 0xFF;
+    response[respLen++] = ps.rxBufferFull >> 8;
+    // Uptime (4 bytes, seconds)
+    response[respLen++] = uptime & 0xFF;
+    response[respLen++] = (uptime >> 8) & 0xFF;
+    response[respLen++] = (uptime >> 16) & 0xFF;
+    response[respLen++] = (uptime >> 24) & 0xFF;
+    // Extended: parser discards, dropped frames, NAKs per command
+    respLen += protocol.writeErrorInfo(response + respLen);
+    protocol.sendPacket(CMD_INFO_RESPONSE, response, respLen);
+}
+
+// Raw buffer access for the layer compositor
+uint32_t getLedRaw(uint16_t index) {
+    return leds.getRawPixel(index);
+}
+
+void setLedRaw(uint16_t index, uint32_t color) {
+    leds.setRawPixel(index, color);
+}
+
+// Display the pixel buffer as a frame. OctoWS2811 show() only waits for
+// the previous DMA transfer and starts the next, so show duration here is
+// that wait, not the wire time. Overlay layers are blended into the buffer
+// for the show and the base put back after it.
+void showFrame() {
+    latency.showStart();
+    uint32_t start = micros();
+    bool layered = layers.composite(leds.getBrightness(), getLedRaw, setLedRaw);
+    leds.show();
+    if (layered) layers.restore(setLedRaw);
+    telemetry.frameShown(micros() - start);
+    latency.showDone();
+    stats.framesDisplayed++;
+}
+
+// Pixel writer for the animation renderer (logical index, mapped)
+void setLedPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b) {
+    leds.setPixel(index, r, g, b);
+}
+
+// Pixel reader for fades starting from the current colors
+void getLedPixel(uint16_t index, uint8_t& r, uint8_t& g, uint8_t& b) {
+    leds.getPixel(index, r, g, b);
+}
+
+// Pixel position for spatial animations and shaders
+bool getLedCoord(uint16_t index, int16_t& x, int16_t& y, int16_t& z) {
+    return coords.lookup(index, x, y, z);
+}
+
+// What draws on the pixels, for stopEffects()
+#define FX_ANIMATION        0x01
+#define FX_FADE             0x02
+#define FX_SHADER           0x04
+#define FX_VISUALIZER       0x08
+#define FX_SEQUENCE         0x10
+#define FX_ALL              0x1F
+
+// Stop the effects in `which`; whatever starts drawing stops the ones that
+// would overwrite it
+void stopEffects(uint8_t which) {
+    if (which & FX_ANIMATION) animation.stop();
+    if (which & FX_FADE) fade.stop();
+    if (which & FX_SHADER) shader.stop();
+    if (which & FX_VISUALIZER) visualizer.stop();
+    if (which & FX_SEQUENCE) sequence.stop();
+}
+
+// Next animation, fade, shader, visualizer or sequence frame, for those
+// running and due; true if any drew
+bool updateEffects() {
+    bool rendered = animation.update(micros(), getLedCoord, setLedPixel);
+    rendered |= fade.update(micros(), getLedPixel, setLedPixel);
+    rendered |= shader.update(micros(), getLedCoord, setLedPixel);
+    rendered |= visualizer.update(micros(), setLedPixel);
+    rendered |= sequence.update(micros(), setLedPixel);
+    return rendered;
+}
+
+// Whether updateEffects() would draw now, without drawing
+bool effectsDue() {
+    uint32_t now = micros();
+    return animation.due(now) || fade.due(now) || shader.due(now) || visualizer.due(now) || sequence.due(now);
+}
+
 void handleGetInfo(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_GET_INFO);
+
     if (length < 1) {
         protocol.sendNak(CMD_GET_INFO, ERR_INVALID_LENGTH);
         return;
@@ -112,7 +302,7 @@ void handleGetInfo(const uint8_t* payload, uint16_t length) {
             response[respLen++] = leds.getPixelsPerStrip() >> 8;
             response[respLen++] = leds.getColorFormat();
             response[respLen++] = CAPS_BRIGHTNESS | CAPS_EXTENDED;
-            response[respLen++] = CAPS_PIXEL_READBACK;
+            response[respLen++] = CAPS_PIXEL_READBACK | CAPS_ANIMATION | CAPS_SHADER;
             response[respLen++] = NUM_CONTROLS;
             // Device name
             {
@@ -162,36 +352,13 @@ void handleGetInfo(const uint8_t* payload, uint16_t length) {
             break;
 
         case INFO_STATS:
-            // Frames received (4 bytes)
-            response[respLen++] = stats.framesReceived & 0xFF;
-            response[respLen++] = (stats.framesReceived >> 8) & 0xFF;
-            response[respLen++] = (stats.framesReceived >> 16) & 0xFF;
-            response[respLen++] = (stats.framesReceived >> 24) & 0xFF;
-            // Frames displayed
-            response[respLen++] = stats.framesDisplayed & 0xFF;
-            response[respLen++] = (stats.framesDisplayed >> 8) & 0xFF;
-            response[respLen++] = (stats.framesDisplayed >> 16) & 0xFF;
-            response[respLen++] = (stats.framesDisplayed >> 24) & 0xFF;
-            // Bytes received
-            response[respLen++] = stats.bytesReceived & 0xFF;
-            response[respLen++] = (stats.bytesReceived >> 8) & 0xFF;
-            response[respLen++] = (stats.bytesReceived >> 16) & 0xFF;
-            response[respLen++] = (stats.bytesReceived >> 24) & 0xFF;
-            // Checksum errors
-            response[respLen++] = stats.checksumErrors & 0xFF;
-            response[respLen++] = stats.checksumErrors >> 8;
-            // Buffer overflows
-            response[respLen++] = stats.bufferOverflows & 0xFF;
-            response[respLen++] = stats.bufferOverflows >> 8;
-            // Uptime
-            {
-                uint32_t uptime = (millis() - stats.startTime) / 1000;
-                response[respLen++] = uptime & 0xFF;
-                response[respLen++] = (uptime >> 8) & 0xFF;
-                response[respLen++] = (uptime >> 16) & 0xFF;
-                response[respLen++] = (uptime >> 24) & 0xFF;
-            }
-            break;
+            sendStatsInfo();
+            return;
+
+        case INFO_LATENCY:
+            // Optional second byte: bit 0 clears the histograms after reading
+            sendLatencyInfo(length >= 2 && (payload[1] & 0x01));
+            return;
 
         default:
             protocol.sendNak(CMD_GET_INFO, ERR_INVALID_PARAM);
@@ -202,8 +369,11 @@ void handleGetInfo(const uint8_t* payload, uint16_t length) {
 }
 
 void handleShow(const uint8_t* payload, uint16_t length) {
-    leds.show();
-    stats.framesDisplayed++;
+    LTP_PROFILE_SCOPE(PROF_HANDLE_SHOW);
+
+    if (length >= 2) protocol.trackFrameNumber(payload[0] | (payload[1] << 8));
+
+    showFrame();
 
     if (config.frameAck && length >= 2) {
         uint8_t response[4];
@@ -217,6 +387,8 @@ void handleShow(const uint8_t* payload, uint16_t length) {
 }
 
 void handlePixelSetAll(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_PIXEL_SET_ALL);
+
     if (length < 4) {
         protocol.sendNak(CMD_PIXEL_SET_ALL, ERR_INVALID_LENGTH);
         return;
@@ -246,12 +418,13 @@ void handlePixelSetAll(const uint8_t* payload, uint16_t length) {
     stats.framesReceived++;
 
     if (config.autoShow) {
-        leds.show();
-        stats.framesDisplayed++;
+        showFrame();
     }
 }
 
 void handlePixelSetRange(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_PIXEL_SET_RANGE);
+
     if (length < 8) {
         protocol.sendNak(CMD_PIXEL_SET_RANGE, ERR_INVALID_LENGTH);
         return;
@@ -289,12 +462,76 @@ void handlePixelSetRange(const uint8_t* payload, uint16_t length) {
     stats.framesReceived++;
 
     if (config.autoShow) {
-        leds.show();
-        stats.framesDisplayed++;
+        showFrame();
+    }
+}
+
+// PIXEL_FILL: strip, start (2), end (2, exclusive) as PIXEL_SET_RANGE, then
+// the fill operation and its parameters (fill.h)
+void handlePixelFill(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_PIXEL_FILL);
+
+    if (length < 6) {
+        protocol.sendNak(CMD_PIXEL_FILL, ERR_INVALID_LENGTH);
+        return;
+    }
+
+    uint8_t stripId = payload[0];
+    uint16_t start = payload[1] | ((uint16_t)payload[2] << 8);
+    uint16_t end = payload[3] | ((uint16_t)payload[4] << 8);
+
+#if MATRIX_MODE
+    if (stripId != 0) {
+        protocol.sendNak(CMD_PIXEL_FILL, ERR_INVALID_PARAM);
+        return;
+    }
+    if (end > leds.getLogicalPixelCount()) {
+        protocol.sendNak(CMD_PIXEL_FILL, ERR_PIXEL_OVERFLOW);
+        return;
+    }
+    uint8_t err = LtpFill::render(payload + 5, length - 5, start, end, setLedPixel);
+#else
+    if (stripId >= NUM_STRIPS) {
+        protocol.sendNak(CMD_PIXEL_FILL, ERR_INVALID_PARAM);
+        return;
+    }
+    if (end > PIXELS_PER_STRIP) {
+        protocol.sendNak(CMD_PIXEL_FILL, ERR_PIXEL_OVERFLOW);
+        return;
+    }
+    uint8_t err = LtpFill::render(payload + 5, length - 5, start, end,
+        [stripId](uint16_t i, uint8_t r, uint8_t g, uint8_t b) { leds.setStripPixel(stripId, i, r, g, b); });
+#endif
+    if (err != ERR_OK) {
+        protocol.sendNak(CMD_PIXEL_FILL, err);
+        return;
+    }
+    stats.framesReceived++;
+
+    if (config.autoShow) {
+        showFrame();
+    }
+}
+
+// Copy PIXEL_FRAME color data into a strip (the matrix in matrix modes)
+void copyPixels(uint8_t stripId, uint16_t start, const uint8_t* pixelData, uint16_t count) {
+    uint8_t bpp = leds.getBytesPerPixel();
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t offset = i * bpp;
+#if MATRIX_MODE
+        // Logical-to-physical mapping
+        (void)stripId;
+        leds.setPixel(start + i, pixelData[offset], pixelData[offset + 1], pixelData[offset + 2]);
+#else
+        leds.setStripPixel(stripId, start + i, pixelData[offset], pixelData[offset + 1], pixelData[offset + 2]);
+#endif
     }
 }
 
 void handlePixelFrame(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_PIXEL_FRAME);
+
     if (length < 5) {
         protocol.sendNak(CMD_PIXEL_FRAME, ERR_INVALID_LENGTH);
         return;
@@ -321,15 +558,6 @@ void handlePixelFrame(const uint8_t* payload, uint16_t length) {
         protocol.sendNak(CMD_PIXEL_FRAME, ERR_PIXEL_OVERFLOW);
         return;
     }
-
-    // Copy pixel data with logical-to-physical mapping
-    const uint8_t* pixelData = payload + dataOffset;
-    uint8_t bpp = leds.getBytesPerPixel();
-
-    for (uint16_t i = 0; i < count; i++) {
-        uint16_t offset = i * bpp;
-        leds.setPixel(start + i, pixelData[offset], pixelData[offset + 1], pixelData[offset + 2]);
-    }
 #else
     if (stripId >= NUM_STRIPS) {
         protocol.sendNak(CMD_PIXEL_FRAME, ERR_INVALID_PARAM);
@@ -339,27 +567,21 @@ void handlePixelFrame(const uint8_t* payload, uint16_t length) {
         protocol.sendNak(CMD_PIXEL_FRAME, ERR_PIXEL_OVERFLOW);
         return;
     }
-
-    // Copy pixel data directly to strip
-    const uint8_t* pixelData = payload + dataOffset;
-    uint8_t bpp = leds.getBytesPerPixel();
-
-    for (uint16_t i = 0; i < count; i++) {
-        uint16_t offset = i * bpp;
-        leds.setStripPixel(stripId, start + i, pixelData[offset], pixelData[offset + 1], pixelData[offset + 2]);
-    }
 #endif
 
+    copyPixels(stripId, start, payload + dataOffset, count);
+
     stats.framesReceived++;
     stats.bytesReceived += expectedBytes;
 
     if (config.autoShow) {
-        leds.show();
-        stats.framesDisplayed++;
+        showFrame();
     }
 }
 
 void handleSetControl(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_SET_CONTROL);
+
     if (length < 2) {
         protocol.sendNak(CMD_SET_CONTROL, ERR_INVALID_LENGTH);
         return;
@@ -411,6 +633,8 @@ void handleSetControl(const uint8_t* payload, uint16_t length) {
 }
 
 void handleGetControl(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_GET_CONTROL);
+
     if (length < 1) {
         protocol.sendNak(CMD_GET_CONTROL, ERR_INVALID_LENGTH);
         return;
@@ -451,6 +675,8 @@ void handleGetControl(const uint8_t* payload, uint16_t length) {
 }
 
 void handleGetPixels(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_GET_PIXELS);
+
     if (length < 5) {
         protocol.sendNak(CMD_GET_PIXELS, ERR_INVALID_LENGTH);
         return;
@@ -485,20 +711,18 @@ void handleGetPixels(const uint8_t* payload, uint16_t length) {
     uint16_t maxRespPixels = (MAX_PAYLOAD_SIZE - 5) / leds.getBytesPerPixel();
     if (count > maxRespPixels) count = maxRespPixels;
 
-    uint8_t* response = new uint8_t[5 + count * leds.getBytesPerPixel()];
-    if (!response) {
-        protocol.sendNak(CMD_GET_PIXELS, ERR_BUFFER_OVERFLOW);
-        return;
-    }
-
-    response[0] = stripId;
-    response[1] = start & 0xFF;
-    response[2] = start >> 8;
-    response[3] = count & 0xFF;
-    response[4] = count >> 8;
+    uint8_t header[5];
+    header[0] = stripId;
+    header[1] = start & 0xFF;
+    header[2] = start >> 8;
+    header[3] = count & 0xFF;
+    header[4] = count >> 8;
 
-    // Read back pixel data
+    // Read back pixel data, streamed a pixel at a time so the reply needs
+    // no buffer
     uint8_t bpp = leds.getBytesPerPixel();
+    protocol.beginPacket(CMD_PIXEL_RESPONSE, 5 + count * bpp);
+    protocol.writePayload(header, sizeof(header));
     for (uint16_t i = 0; i < count; i++) {
         uint16_t logicalIdx = start + i;
         uint16_t physIdx = leds.mapPixel(logicalIdx);
@@ -506,13 +730,233 @@ void handleGetPixels(const uint8_t* payload, uint16_t length) {
         physIdx = stripId * PIXELS_PER_STRIP + logicalIdx;
 #endif
         uint32_t color = leds.getPixelColor(physIdx);
-        response[5 + i * bpp + 0] = (color >> 16) & 0xFF; // R
-        response[5 + i * bpp + 1] = (color >> 8) & 0xFF;  // G
-        response[5 + i * bpp + 2] = color & 0xFF;         // B
+        uint8_t rgb[3];
+        rgb[0] = (color >> 16) & 0xFF; // R
+        rgb[1] = (color >> 8) & 0xFF;  // G
+        rgb[2] = color & 0xFF;         // B
+        protocol.writePayload(rgb, sizeof(rgb));
+    }
+    protocol.endPacket();
+}
+
+void handleProfile(const uint8_t* payload, uint16_t length) {
+#if LTP_PROFILE
+    uint8_t response[LtpProfile::INFO_MAX_SIZE];
+    uint16_t respLen = LtpProfile::writeInfo(response);
+    protocol.sendPacket(CMD_PROFILE, response, respLen);
+    // Optional options byte: bit 0 clears the table after reading
+    if (length >= 1 && (payload[0] & 0x01)) LtpProfile::clear();
+#else
+    protocol.sendNak(CMD_PROFILE, ERR_NOT_SUPPORTED);
+#endif
+}
+
+void handleTrace(const uint8_t* payload, uint16_t length) {
+#if LTP_TRACE_ENTRIES
+    // Optional: options byte (bit 0 clears the ring after reading), then
+    // the sequence number to start from (4 bytes, default oldest)
+    uint32_t from = 0;
+    if (length >= 5) {
+        from = (uint32_t)payload[1] | ((uint32_t)payload[2] << 8) |
+               ((uint32_t)payload[3] << 16) | ((uint32_t)payload[4] << 24);
+    }
+    uint8_t response[LtpTrace::INFO_MAX_SIZE];
+    uint16_t respLen = trace.writeInfo(response, from);
+    protocol.sendPacket(CMD_TRACE, response, respLen);
+    if (length >= 1 && (payload[0] & 0x01)) trace.clear();
+#else
+    protocol.sendNak(CMD_TRACE, ERR_NOT_SUPPORTED);
+#endif
+}
+
+void handleAnimStart(const uint8_t* payload, uint16_t length) {
+    uint8_t err = animation.start(payload, length, leds.getLogicalPixelCount());
+    if (err != ERR_OK) {
+        protocol.sendNak(CMD_ANIM_START, err);
+        return;
+    }
+    stopEffects(FX_FADE | FX_SHADER | FX_SEQUENCE);
+    protocol.sendAck(CMD_ANIM_START);
+}
+
+void handleAnimStop(const uint8_t* payload, uint16_t length) {
+    stopEffects(FX_ALL);
+    // Option bit 0: blank the animation's, shader's and visualizer's pixels
+    if (length >= 1 && (payload[0] & 0x01)) {
+        animation.clear(setLedPixel);
+        shader.clear(setLedPixel);
+        visualizer.clear(setLedPixel);
+        showFrame();
+    }
+    protocol.sendAck(CMD_ANIM_STOP);
+}
+
+void handleAnimStatus() {
+    uint8_t response[decltype(animation)::INFO_SIZE + decltype(fade)::INFO_SIZE + decltype(shader)::INFO_SIZE +
+                     LtpVisualizer::INFO_SIZE];
+    uint16_t respLen = animation.writeInfo(response);
+    respLen += fade.writeInfo(response + respLen);
+    respLen += shader.writeInfo(response + respLen);
+    respLen += visualizer.writeInfo(response + respLen);
+    protocol.sendPacket(CMD_ANIM_STATUS, response, respLen);
+}
+
+void handleFadeTo(const uint8_t* payload, uint16_t length) {
+    uint8_t err = fade.queue(payload, length, leds.getLogicalPixelCount());
+    if (err != ERR_OK) {
+        protocol.sendNak(CMD_FADE_TO, err);
+        return;
+    }
+    // The animation would overwrite the fade's frames
+    stopEffects(FX_ANIMATION | FX_SHADER | FX_SEQUENCE);
+    protocol.sendAck(CMD_FADE_TO);
+}
+
+void handleShaderLoad(const uint8_t* payload, uint16_t length) {
+    uint8_t err = shader.load(payload, length, leds.getLogicalPixelCount(), SHADER_WIDTH);
+    if (err != ERR_OK) {
+        protocol.sendNak(CMD_SHADER_LOAD, err);
+        return;
+    }
+    if (payload[0] & SHADER_RUN) {
+        stopEffects(FX_ANIMATION | FX_FADE | FX_SEQUENCE);
+        shader.start();
+    }
+    if (payload[0] & SHADER_TEST) {
+        uint8_t response[decltype(shader)::TEST_SIZE];
+        uint16_t respLen = shader.test(response, getLedCoord);
+        protocol.sendPacket(CMD_SHADER_LOAD, response, respLen);
+        return;
+    }
+    protocol.sendAck(CMD_SHADER_LOAD);
+}
+
+void handleShaderParam(const uint8_t* payload, uint16_t length) {
+    uint8_t err = shader.setParams(payload, length);
+    if (err != ERR_OK) {
+        protocol.sendNak(CMD_SHADER_PARAM, err);
+        return;
+    }
+    protocol.sendAck(CMD_SHADER_PARAM);
+}
+
+void handleVisConfig(const uint8_t* payload, uint16_t length) {
+    uint8_t err = visualizer.configure(payload, length, leds.getLogicalPixelCount());
+    if (err != ERR_OK) {
+        protocol.sendNak(CMD_VIS_CONFIG, err);
+        return;
+    }
+    protocol.sendAck(CMD_VIS_CONFIG);
+}
+
+// Like the pixel data commands, values are only NAKed
+void handleVisValue(const uint8_t* payload, uint16_t length) {
+    uint8_t err = visualizer.setValues(payload, length);
+    if (err != ERR_OK) protocol.sendNak(CMD_VIS_VALUE, err);
+}
+
+// SCENE_RECALL: slot ID, then optionally a fade time (4 bytes, ms) and
+// easing; without a fade the scene is shown at once
+void handleSceneRecall(const uint8_t* data, uint16_t length) {
+    if (length < 1) {
+        protocol.sendNak(CMD_SCENE, ERR_INVALID_LENGTH);
+        return;
+    }
+    uint8_t id = data[0];
+    uint32_t fadeMs = 0;
+    if (length >= 5) {
+        fadeMs = (uint32_t)data[1] | ((uint32_t)data[2] << 8) |
+                 ((uint32_t)data[3] << 16) | ((uint32_t)data[4] << 24);
+    }
+    uint8_t easing = length >= 6 ? data[5] : FADE_LINEAR;
+    uint8_t err = scenes.check(id);
+    if (err == ERR_OK && fadeMs) {
+        err = fade.queueFrame(fadeMs, easing, FADE_REPLACE, 0, scenes.size(),
+            [id](uint16_t i, uint8_t& r, uint8_t& g, uint8_t& b) { scenes.getPixel(id, i, r, g, b); });
+    }
+    if (err != ERR_OK) {
+        protocol.sendNak(CMD_SCENE, err);
+        return;
     }
+    // The scene replaces whatever else was drawing
+    stopEffects(FX_ANIMATION | FX_SHADER | FX_VISUALIZER | FX_SEQUENCE);
+    if (!fadeMs) {
+        stopEffects(FX_FADE);
+        scenes.recall(id, setLedPixel);
+        showFrame();
+    }
+    protocol.sendAck(CMD_SCENE);
+}
 
-    protocol.sendPacket(CMD_PIXEL_RESPONSE, response, 5 + count * bpp);
-    delete[] response;
+void handleScene(const LtpPacket& pkt) {
+    if (pkt.length >= 1 && pkt.payload[0] == SCENE_RECALL) {
+        handleSceneRecall(pkt.payload + 1, pkt.length - 1);
+        return;
+    }
+    scenes.command(protocol, pkt, getLedPixel);
+}
+
+void handleSequence(const LtpPacket& pkt) {
+    sequence.command(protocol, pkt, setLedPixel);
+    // A playing sequence replaces whatever else was drawing
+    if (sequence.isRunning()) stopEffects(FX_ANIMATION | FX_FADE | FX_SHADER | FX_VISUALIZER);
+}
+
+void handleLayer(const LtpPacket& pkt) {
+    if (layers.command(protocol, pkt) && config.autoShow) showFrame();
+}
+
+// A pass of loop() with nothing to handle, for BENCH: telemetry, the
+// receive check and the effects' due checks, but no packet or frame
+bool benchIdlePass() {
+    telemetry.update(protocol, config.statusInterval, stats.framesReceived, Serial.available());
+    bool input = Serial.available() > 0;
+    return effectsDue() || input;
+}
+
+void handleBench(const uint8_t* payload, uint16_t length) {
+    const uint16_t pixels = leds.getLogicalPixelCount();
+    LtpBenchResult r;
+    r.pixels = pixels;
+    // Optional iteration count (default 10)
+    r.iterations = (length >= 1 && payload[0]) ? payload[0] : LtpBenchResult::DEFAULT_ITERATIONS;
+    uint8_t n = r.iterations;
+
+    r.timeShow([] { leds.show(); });
+
+    r.setPixelNs = LtpBenchResult::nanosPer((uint32_t)pixels * n, [n, pixels] {
+        for (uint8_t k = 0; k < n; k++) {
+            for (uint16_t i = 0; i < pixels; i++) leds.setPixel(i, i, k, 0);
+        }
+    });
+
+    // Copy 16 pixels at a time from RGB bytes into every strip, as
+    // PIXEL_FRAME does
+    uint8_t chunk[16 * 3];
+    for (uint8_t i = 0; i < sizeof(chunk); i++) chunk[i] = i * 5;
+    r.ingestNs = LtpBenchResult::nanosPer((uint32_t)pixels * n, [n, &chunk] {
+        for (uint8_t k = 0; k < n; k++) {
+            for (uint8_t strip = 0; strip < leds.getStripCount(); strip++) {
+                for (uint16_t start = 0; start < leds.getPixelsPerStrip(); start += 16) {
+                    copyPixels(strip, start, chunk, min(16, leds.getPixelsPerStrip() - start));
+                }
+            }
+        }
+    });
+
+    // One strip's PIXEL_FRAME per packet (capped at the maximum payload);
+    // overwrites `payload`
+    r.parserNs = protocol.benchParser(5 + leds.getPixelsPerStrip() * leds.getBytesPerPixel(), n);
+
+    // loop() with no input and no frame due (benchIdlePass)
+    r.timeLoop(benchIdlePass, Serial);
+
+    leds.clear();
+    leds.show();
+
+    uint8_t response[LtpBenchResult::INFO_SIZE];
+    uint16_t respLen = r.writeInfo(response);
+    protocol.sendPacket(CMD_BENCH, response, respLen);
 }
 
 void processPacket(const LtpPacket& pkt) {
@@ -562,10 +1006,86 @@ void processPacket(const LtpPacket& pkt) {
             handlePixelFrame(pkt.payload, pkt.length);
             break;
 
+        case CMD_PIXEL_FILL:
+            handlePixelFill(pkt.payload, pkt.length);
+            break;
+
         case CMD_SET_CONTROL:
             handleSetControl(pkt.payload, pkt.length);
             break;
 
+        case CMD_ANIM_START:
+            handleAnimStart(pkt.payload, pkt.length);
+            break;
+
+        case CMD_ANIM_STOP:
+            handleAnimStop(pkt.payload, pkt.length);
+            break;
+
+        case CMD_ANIM_STATUS:
+            handleAnimStatus();
+            break;
+
+        case CMD_FADE_TO:
+            handleFadeTo(pkt.payload, pkt.length);
+            break;
+
+        case CMD_SHADER_LOAD:
+            handleShaderLoad(pkt.payload, pkt.length);
+            break;
+
+        case CMD_SHADER_PARAM:
+            handleShaderParam(pkt.payload, pkt.length);
+            break;
+
+        case CMD_COORDS:
+            coords.command(protocol, pkt);
+            break;
+
+        case CMD_VIS_CONFIG:
+            handleVisConfig(pkt.payload, pkt.length);
+            break;
+
+        case CMD_VIS_VALUE:
+            handleVisValue(pkt.payload, pkt.length);
+            break;
+
+        case CMD_AUDIO:
+            audio.command(protocol, pkt);
+            break;
+
+        case CMD_SCENE:
+            handleScene(pkt);
+            break;
+
+        case CMD_SEQUENCE:
+            handleSequence(pkt);
+            break;
+
+        case CMD_LAYER:
+            handleLayer(pkt);
+            break;
+
+        case CMD_PROFILE:
+            handleProfile(pkt.payload, pkt.length);
+            break;
+
+        case CMD_TRACE:
+            handleTrace(pkt.payload, pkt.length);
+            break;
+
+        case CMD_BENCH:
+            handleBench(pkt.payload, pkt.length);
+            break;
+
+        case CMD_ECHO:
+            linkProbe.echo(protocol, pkt);
+            break;
+
+        case CMD_SINK:
+            linkProbe.sink(protocol, pkt);
+            break;
+
         default:
             protocol.sendNak(pkt.cmd, ERR_INVALID_CMD);
             break;
@@ -583,8 +1103,22 @@ void setup() {
     leds.clear();
     leds.show();
 
+    animation.setStorage(animationStorage, TOTAL_PIXELS);
+    fade.setStorage(fadeStorage, TOTAL_PIXELS);
+    coords.setStorage(coordsStorage, TOTAL_PIXELS);
+    scenes.setStorage(sceneStorage, TOTAL_PIXELS);
+    coords.begin(leds.getLogicalPixelCount());
+    scenes.begin(leds.getLogicalPixelCount());
+    sequence.begin(SEQUENCE_DATA, sizeof(SEQUENCE_DATA), SD_CS_PIN, leds.getLogicalPixelCount());
+    layers.begin(leds.getLogicalPixelCount());
+    audio.begin(AUDIO_PIN);
+
     stats.startTime = millis();
 
+#if LTP_PROFILE
+    LtpProfile::begin();
+#endif
+
     // Brief startup indicator
     for (int i = 0; i < 3; i++) {
         leds.fillStrip(0, 0, 32, 0);  // Dim green on first strip
@@ -600,7 +1134,23 @@ void setup() {
 }
 
 void loop() {
+    telemetry.update(protocol, config.statusInterval, stats.framesReceived, Serial.available());
+
     if (protocol.processInput()) {
-        processPacket(protocol.getPacket());
+        const LtpPacket& pkt = protocol.getPacket();
+        latency.packetStart(pkt);
+#if LTP_TRACE_ENTRIES
+        trace.packetStart(pkt, protocol.getErrorStats());
+#endif
+        processPacket(pkt);
+        latency.packetDone();
+#if LTP_TRACE_ENTRIES
+        trace.packetDone(protocol.getErrorStats());
+#endif
     }
+
+    // Latest audio block for the spectrum and pulse animations
+    if (audio.update()) animation.setAudio(audio.getBands(), audio.getLevel(), audio.isBeat());
+
+    if (updateEffects()) showFrame();
 }
@@ -0,0 +1,194 @@
+/**
+ * LTP Serial Protocol v2 - Section Profiler
+ *
+ * Compile-time profiling scopes on the firmware hot paths: parser states,
+ * the packet handlers, pixel mapping, the LED driver's show(), the
+ * built-in animations, pixel shaders, visualizers and audio blocks. Build
+ * with -DLTP_PROFILE=1 (or define it before the includes) to enable them;
+ * otherwise LTP_PROFILE_SCOPE() expands to nothing and costs no code, RAM
+ * or time.
+ *
+ * Each section keeps a call count, total and maximum ticks. Ticks are:
+ *   Teensy (ARM)   DWT cycle counter, F_CPU Hz
+ *   AVR            Timer1 free-running at F_CPU / 8; a single call longer
+ *                  than 32 ms (16 MHz) wraps and is under-reported
+ *   Host build     std::chrono::steady_clock nanoseconds
+ *
+ * Times are inclusive: a handler that shows a frame also contains the
+ * driver's show(). The table is read with the CMD_PROFILE diagnostic
+ * command (0x90); the sketch calls LtpProfile::begin() from setup().
+ */
+
+#ifndef LTP_PROFILE_H
+#define LTP_PROFILE_H
+
+#include <Arduino.h>
+#include "protocol.h"
+
+#ifndef LTP_PROFILE
+#define LTP_PROFILE 0
+#endif
+
+#if defined(LTP_HOST_BUILD)
+#include <chrono>
+#endif
+
+// Section IDs as reported by CMD_PROFILE. Append new sections at the end so
+// IDs stay stable for host tools.
+enum LtpProfileSection : uint8_t {
+    PROF_PARSE_WAIT_START,      // One byte in each parser state (ParserState order)
+    PROF_PARSE_READ_FLAGS,
+    PROF_PARSE_READ_LENGTH_LOW,
+    PROF_PARSE_READ_LENGTH_HIGH,
+    PROF_PARSE_READ_CMD,
+    PROF_PARSE_READ_PAYLOAD,
+    PROF_PARSE_READ_CHECKSUM,
+    PROF_HANDLE_GET_INFO,
+    PROF_HANDLE_SHOW,
+    PROF_HANDLE_PIXEL_SET_ALL,
+    PROF_HANDLE_PIXEL_SET_RANGE,
+    PROF_HANDLE_PIXEL_FRAME,
+    PROF_HANDLE_SET_CONTROL,
+    PROF_HANDLE_GET_CONTROL,
+    PROF_HANDLE_GET_PIXELS,
+    PROF_MAP_PIXEL,
+    PROF_DRIVER_SHOW,
+    PROF_ANIMATION_RENDER,
+    PROF_SHADER_RENDER,
+    PROF_VIS_RENDER,
+    PROF_AUDIO_BLOCK,
+    PROF_SEQ_FRAME,
+    PROF_HANDLE_PIXEL_FILL,
+    PROF_LAYER_COMPOSITE,
+    PROF_HANDLE_SET_STRIP,
+    PROF_SECTION_COUNT
+};
+
+struct LtpProfileEntry {
+    uint32_t count;
+    uint64_t total;             // Ticks
+    uint32_t max;               // Ticks
+};
+
+// Tick source for the profiler and other cost measurements (audio.h)
+class LtpTicks {
+public:
+    // Start the tick source
+    static void begin() {
+#if defined(LTP_HOST_BUILD)
+        // steady_clock needs no setup
+#elif defined(__arm__) && defined(CORE_TEENSY)
+        ARM_DEMCR |= ARM_DEMCR_TRCENA;
+        ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+#elif defined(__AVR__)
+        TCCR1A = 0;
+        TCCR1B = _BV(CS11);     // Normal mode, clk/8
+#endif
+    }
+
+    static uint32_t ticks() {
+#if defined(LTP_HOST_BUILD)
+        return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#elif defined(__arm__) && defined(CORE_TEENSY)
+        return ARM_DWT_CYCCNT;
+#elif defined(__AVR__)
+        return TCNT1;
+#else
+        return micros();
+#endif
+    }
+
+    // Elapsed ticks since start, allowing for counter wrap
+    static uint32_t since(uint32_t start) {
+#if defined(__AVR__) && !defined(LTP_HOST_BUILD)
+        return (uint16_t)(TCNT1 - (uint16_t)start);
+#else
+        return ticks() - start;
+#endif
+    }
+
+    static uint32_t tickHz() {
+#if defined(LTP_HOST_BUILD)
+        return 1000000000UL;
+#elif defined(__arm__) && defined(CORE_TEENSY)
+        return F_CPU;
+#elif defined(__AVR__)
+        return F_CPU / 8;
+#else
+        return 1000000UL;
+#endif
+    }
+};
+
+#if LTP_PROFILE
+
+class LtpProfile {
+public:
+    static void begin() { LtpTicks::begin(); }
+    static uint32_t ticks() { return LtpTicks::ticks(); }
+    static uint32_t since(uint32_t start) { return LtpTicks::since(start); }
+    static uint32_t tickHz() { return LtpTicks::tickHz(); }
+
+    static LtpProfileEntry* table() {
+        static LtpProfileEntry entries[PROF_SECTION_COUNT];
+        return entries;
+    }
+
+    static void record(uint8_t section, uint32_t elapsed) {
+        LtpProfileEntry& e = table()[section];
+        e.count++;
+        e.total += elapsed;
+        if (elapsed > e.max) e.max = elapsed;
+    }
+
+    static void clear() {
+        memset(table(), 0, sizeof(LtpProfileEntry) * PROF_SECTION_COUNT);
+    }
+
+    // CMD_PROFILE response: tick rate, then every section that has been
+    // entered. Returns the length written (at most INFO_MAX_SIZE).
+    static uint16_t writeInfo(uint8_t* out) {
+        uint16_t n = 0;
+        n += putU32(out + n, tickHz());
+        uint8_t& sections = out[n++];
+        sections = 0;
+        for (uint8_t i = 0; i < PROF_SECTION_COUNT; i++) {
+            const LtpProfileEntry& e = table()[i];
+            if (e.count == 0) continue;
+            out[n++] = i;
+            n += putU32(out + n, e.count);
+            n += putU32(out + n, (uint32_t)e.total);
+            n += putU32(out + n, (uint32_t)(e.total >> 32));
+            n += putU32(out + n, e.max);
+            sections++;
+        }
+        return n;
+    }
+
+    static const uint16_t ENTRY_SIZE = 17;
+    static const uint16_t INFO_MAX_SIZE = 5 + ENTRY_SIZE * PROF_SECTION_COUNT;
+};
+
+// Times the enclosing block into one section
+class LtpProfileScope {
+public:
+    explicit LtpProfileScope(uint8_t section) : section(section), start(LtpProfile::ticks()) {}
+    ~LtpProfileScope() { LtpProfile::record(section, LtpProfile::since(start)); }
+
+private:
+    uint8_t section;
+    uint32_t start;
+};
+
+#define LTP_PROFILE_CONCAT_(a, b) a##b
+#define LTP_PROFILE_CONCAT(a, b) LTP_PROFILE_CONCAT_(a, b)
+#define LTP_PROFILE_SCOPE(section) LtpProfileScope LTP_PROFILE_CONCAT(ltpProfileScope_, __LINE__)(section)
+
+#else
+
+#define LTP_PROFILE_SCOPE(section) do {} while (0)
+
+#endif // LTP_PROFILE
+
+#endif // LTP_PROFILE_H
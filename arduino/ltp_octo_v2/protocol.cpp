@@ -3,16 +3,22 @@
  */
 
 #include "protocol.h"
+#include "profile.h"
 
 LtpProtocol::LtpProtocol(Stream& serial, uint16_t maxPayload)
     : serial(serial)
     , state(ParserState::WAIT_START)
     , payloadIndex(0)
     , runningChecksum(0)
+    , txChecksum(0)
     , maxPayload(min(maxPayload, (uint16_t)LTP_MAX_PAYLOAD))
     , lastByteTime(0)
+    , packetBytes(0)
+    , rxFull(false)
 {
     rxPacket.clear();
+    clearParserStats();
+    clearErrorStats();
 }
 
 void LtpProtocol::reset() {
@@ -22,110 +28,191 @@ void LtpProtocol::reset() {
     rxPacket.clear();
 }
 
+void LtpProtocol::dropPacket() {
+    parserStats.droppedBytes += packetBytes;
+    reset();
+}
+
+bool LtpProtocol::processByte(uint8_t byte) {
+    packetBytes++;
+    LTP_PROFILE_SCOPE(PROF_PARSE_WAIT_START + (uint8_t)state);
+
+    switch (state) {
+        case ParserState::WAIT_START:
+            if (byte == LTP_START_BYTE) {
+                rxPacket.clear();
+                rxPacket.firstByteMicros = micros();
+                runningChecksum = 0;
+                packetBytes = 1;
+                state = ParserState::READ_FLAGS;
+            } else {
+                parserStats.resyncBytes++;
+                packetBytes = 0;
+            }
+            break;
+
+        case ParserState::READ_FLAGS:
+            rxPacket.flags = byte;
+            runningChecksum ^= byte;
+            state = ParserState::READ_LENGTH_LOW;
+            break;
+
+        case ParserState::READ_LENGTH_LOW:
+            rxPacket.length = byte;
+            runningChecksum ^= byte;
+            state = ParserState::READ_LENGTH_HIGH;
+            break;
+
+        case ParserState::READ_LENGTH_HIGH:
+            rxPacket.length |= (uint16_t)byte << 8;
+            runningChecksum ^= byte;
+            if (rxPacket.length > maxPayload) {
+                // Payload too large, reset
+                parserStats.oversizePackets++;
+                dropPacket();
+            } else {
+                state = ParserState::READ_CMD;
+            }
+            break;
+
+        case ParserState::READ_CMD:
+            rxPacket.cmd = byte;
+            runningChecksum ^= byte;
+            payloadIndex = 0;
+            if (rxPacket.length > 0) {
+                state = ParserState::READ_PAYLOAD;
+            } else {
+                state = ParserState::READ_CHECKSUM;
+            }
+            break;
+
+        case ParserState::READ_PAYLOAD:
+            rxPacket.payload[payloadIndex++] = byte;
+            runningChecksum ^= byte;
+            if (payloadIndex >= rxPacket.length) {
+                state = ParserState::READ_CHECKSUM;
+            }
+            break;
+
+        case ParserState::READ_CHECKSUM:
+            rxPacket.checksum = byte;
+            state = ParserState::WAIT_START;
+            if (runningChecksum == byte) {
+                rxPacket.completeMicros = micros();
+                parserStats.packets++;
+                return true; // Valid packet received
+            }
+            // Checksum error - packet discarded
+            parserStats.checksumErrors++;
+            dropPacket();
+            break;
+    }
+
+    return false;
+}
+
+uint32_t LtpProtocol::benchParser(uint16_t payloadLength, uint16_t packets) {
+    if (payloadLength > maxPayload) payloadLength = maxPayload;
+    LtpParserStats saved = parserStats;
+    uint8_t header[5] = {
+        LTP_START_BYTE, 0, (uint8_t)(payloadLength & 0xFF), (uint8_t)(payloadLength >> 8), CMD_PIXEL_FRAME
+    };
+    reset();
+
+    uint32_t start = micros();
+    for (uint16_t p = 0; p < packets; p++) {
+        uint8_t check = 0;
+        for (uint8_t i = 0; i < sizeof(header); i++) {
+            processByte(header[i]);
+            if (i) check ^= header[i];
+        }
+        for (uint16_t i = 0; i < payloadLength; i++) {
+            uint8_t b = (uint8_t)(i + p);
+            processByte(b);
+            check ^= b;
+        }
+        processByte(check);
+    }
+    uint32_t elapsed = micros() - start;
+
+    reset();
+    parserStats = saved;
+    uint32_t bytes = (uint32_t)(payloadLength + 6) * packets;
+    return bytes ? (elapsed < 4000000UL ? elapsed * 1000 / bytes : elapsed / bytes * 1000) : 0;
+}
+
 bool LtpProtocol::processInput() {
     // Check for inter-byte timeout
     if (state != ParserState::WAIT_START && millis() - lastByteTime > INTER_BYTE_TIMEOUT) {
-        reset();
+        parserStats.timeouts++;
+        dropPacket();
     }
 
+#if LTP_RX_BUFFER_SIZE
+    // AVR holds one byte less than its buffer size
+    bool full = serial.available() >= LTP_RX_BUFFER_SIZE - 1;
+    if (full && !rxFull) parserStats.rxBufferFull++;
+    rxFull = full;
+#endif
+
     while (serial.available()) {
         uint8_t byte = serial.read();
         lastByteTime = millis();
-
-        switch (state) {
-            case ParserState::WAIT_START:
-                if (byte == LTP_START_BYTE) {
-                    rxPacket.clear();
-                    runningChecksum = 0;
-                    state = ParserState::READ_FLAGS;
-                }
-                break;
-
-            case ParserState::READ_FLAGS:
-                rxPacket.flags = byte;
-                runningChecksum ^= byte;
-                state = ParserState::READ_LENGTH_LOW;
-                break;
-
-            case ParserState::READ_LENGTH_LOW:
-                rxPacket.length = byte;
-                runningChecksum ^= byte;
-                state = ParserState::READ_LENGTH_HIGH;
-                break;
-
-            case ParserState::READ_LENGTH_HIGH:
-                rxPacket.length |= (uint16_t)byte << 8;
-                runningChecksum ^= byte;
-                if (rxPacket.length > maxPayload) {
-                    // Payload too large, reset
-                    reset();
-                } else {
-                    state = ParserState::READ_CMD;
-                }
-                break;
-
-            case ParserState::READ_CMD:
-                rxPacket.cmd = byte;
-                runningChecksum ^= byte;
-                payloadIndex = 0;
-                if (rxPacket.length > 0) {
-                    state = ParserState::READ_PAYLOAD;
-                } else {
-                    state = ParserState::READ_CHECKSUM;
-                }
-                break;
-
-            case ParserState::READ_PAYLOAD:
-                rxPacket.payload[payloadIndex++] = byte;
-                runningChecksum ^= byte;
-                if (payloadIndex >= rxPacket.length) {
-                    state = ParserState::READ_CHECKSUM;
-                }
-                break;
-
-            case ParserState::READ_CHECKSUM:
-                rxPacket.checksum = byte;
-                state = ParserState::WAIT_START;
-                if (runningChecksum == byte) {
-                    return true; // Valid packet received
-                }
-                // Checksum error - packet discarded
-                break;
-        }
+        if (processByte(byte)) return true;
     }
 
     return false;
 }
 
 void LtpProtocol::sendPacket(uint8_t cmd, const uint8_t* payload, uint16_t length, uint8_t flags) {
-    uint8_t checksum = 0;
+    beginPacket(cmd, length, flags);
+    writePayload(payload, length);
+    endPacket();
+}
 
+void LtpProtocol::beginPacket(uint8_t cmd, uint16_t length, uint8_t flags) {
     // Start byte
     serial.write(LTP_START_BYTE);
 
     // Flags (with RESPONSE flag set)
     uint8_t txFlags = flags | FLAG_RESPONSE;
     serial.write(txFlags);
-    checksum ^= txFlags;
+    txChecksum = txFlags;
 
     // Length (little-endian)
     serial.write((uint8_t)(length & 0xFF));
-    checksum ^= (uint8_t)(length & 0xFF);
+    txChecksum ^= (uint8_t)(length & 0xFF);
     serial.write((uint8_t)(length >> 8));
-    checksum ^= (uint8_t)(length >> 8);
+    txChecksum ^= (uint8_t)(length >> 8);
 
     // Command
     serial.write(cmd);
-    checksum ^= cmd;
+    txChecksum ^= cmd;
+}
 
-    // Payload
+void LtpProtocol::writePayload(const uint8_t* data, uint16_t length) {
     for (uint16_t i = 0; i < length; i++) {
-        serial.write(payload[i]);
-        checksum ^= payload[i];
+        serial.write(data[i]);
     }
+    txChecksum = LtpProtocol::checksum(data, length, txChecksum);
+}
 
-    // Checksum
-    serial.write(checksum);
+void LtpProtocol::endPacket() {
+    serial.write(txChecksum);
+}
+
+bool LtpProtocol::trySendPacket(uint8_t cmd, const uint8_t* payload, uint16_t length, uint8_t flags) {
+    // START, flags, length (2), cmd, payload, checksum
+    if (serial.availableForWrite() < (int)length + 6) return false;
+    sendPacket(cmd, payload, length, flags);
+    return true;
+}
+
+uint8_t LtpProtocol::checksum(const uint8_t* data, uint16_t length, uint8_t seed) {
+    for (uint16_t i = 0; i < length; i++) {
+        seed ^= data[i];
+    }
+    return seed;
 }
 
 void LtpProtocol::sendAck(uint8_t cmd, uint8_t seq) {
@@ -134,6 +221,53 @@ void LtpProtocol::sendAck(uint8_t cmd, uint8_t seq) {
 }
 
 void LtpProtocol::sendNak(uint8_t cmd, uint8_t errorCode) {
+    errorStats.nakTotal++;
+    errorStats.lastNakError = errorCode;
+    uint8_t i = 0;
+    while (i < errorStats.nakCommands && errorStats.naks[i].cmd != cmd) i++;
+    if (i == errorStats.nakCommands && i < LTP_NAK_SLOTS) {
+        errorStats.naks[i].cmd = cmd;
+        errorStats.naks[i].count = 0;
+        errorStats.nakCommands++;
+    }
+    if (i < errorStats.nakCommands) {
+        errorStats.naks[i].lastError = errorCode;
+        errorStats.naks[i].count++;
+    }
+
     uint8_t payload[2] = { cmd, errorCode };
     sendPacket(CMD_NAK, payload, 2, FLAG_ERROR);
 }
+
+void LtpProtocol::trackFrameNumber(uint16_t frame) {
+    if (errorStats.haveFrame) {
+        uint16_t gap = frame - errorStats.lastFrame - 1;
+        if (gap >= 0x8000) {
+            // Repeated or older number: the host restarted its count
+            errorStats.frameRestarts++;
+        } else {
+            errorStats.droppedFrames += gap;
+        }
+    }
+    errorStats.lastFrame = frame;
+    errorStats.haveFrame = true;
+}
+
+uint16_t LtpProtocol::writeErrorInfo(uint8_t* out) const {
+    uint16_t n = 0;
+    n += putU32(out + n, parserStats.packets);
+    n += putU32(out + n, parserStats.resyncBytes);
+    n += putU32(out + n, parserStats.droppedBytes);
+    n += putU16(out + n, parserStats.oversizePackets);
+    n += putU16(out + n, parserStats.timeouts);
+    n += putU32(out + n, errorStats.droppedFrames);
+    n += putU16(out + n, errorStats.frameRestarts);
+    n += putU16(out + n, errorStats.nakTotal);
+    out[n++] = errorStats.nakCommands;
+    for (uint8_t i = 0; i < errorStats.nakCommands; i++) {
+        out[n++] = errorStats.naks[i].cmd;
+        out[n++] = errorStats.naks[i].lastError;
+        n += putU16(out + n, errorStats.naks[i].count);
+    }
+    return n;
+}
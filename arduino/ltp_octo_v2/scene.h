@@ -0,0 +1,302 @@
+/**
+ * LTP Serial Protocol v2 - Scene Cache
+ *
+ * Complete frames kept on the device under a slot ID, so changing between
+ * fixed looks (house lights, intermission, emergency white) is one small
+ * SCENE_RECALL packet instead of a full frame on the link. The host stores
+ * the pixels as they are shown (SCENE_STORE) or uploads a frame in chunks
+ * (SCENE_UPLOAD), then recalls it at once or through a FADE_TO crossfade.
+ *
+ * Slots 0 to RamSlots-1 are held in RAM, in storage the sketch gives
+ * setStorage() for the strip's length (BYTES_PER_PIXEL, 3 per slot), and
+ * are lost at reset. The EepromSlots after them live in EEPROM from
+ * LTP_SCENE_EEPROM_ADDR, survive resets and are read straight from EEPROM
+ * when recalled, so they take no RAM. They share the EEPROM past that
+ * address equally, so a slot's place and size do not depend on the strip.
+ * Each EEPROM slot holds magic "LS", the pixel count (2), RGB per pixel
+ * and a sum of those bytes. Writing one costs about 3.3 ms per
+ * changed byte on AVR, and STORE and UPLOAD finish writing before they
+ * ACK: loop() stalls for about 1.6 s per 160 pixels, showing nothing new
+ * and keeping only the first 64 bytes that arrive meanwhile (the AVR RX
+ * buffer). Writing a little per loop() instead would need a RAM copy of
+ * the pixels, the RAM these slots exist to save, so hosts wait for the ACK
+ * before sending anything else.
+ *
+ * A scene covers pixels 0 to count-1, grows by contiguous uploads, and
+ * recalls black past its end, to the end of the strip. SCENE_RECALL is
+ * handled by the sketch, which stops whatever else is drawing: check() the
+ * slot, then recall() it or fade to it through getPixel().
+ */
+
+#ifndef LTP_SCENE_H
+#define LTP_SCENE_H
+
+#include <Arduino.h>
+#include "protocol.h"
+
+// EEPROM slots where the core provides EEPROM.h
+#ifndef LTP_SCENE_EEPROM
+#if defined(LTP_HOST_BUILD) || defined(CORE_TEENSY) || defined(__AVR__)
+#define LTP_SCENE_EEPROM    1
+#else
+#define LTP_SCENE_EEPROM    0
+#endif
+#endif
+
+#ifndef LTP_SCENE_EEPROM_ADDR
+#define LTP_SCENE_EEPROM_ADDR 0
+#endif
+
+#if LTP_SCENE_EEPROM
+#include <EEPROM.h>
+#endif
+
+template <uint8_t RamSlots, uint8_t EepromSlots>
+class LtpScenes {
+public:
+    LtpScenes() : frames(nullptr), capacity(0), strip(0), eepromPixels(0), eepromSlots(0) {
+        memset(counts, 0, sizeof(counts));
+    }
+
+    /**
+     * Keep the RAM slots for up to pixels pixels in storage
+     * (BYTES_PER_PIXEL each), emptying them. nullptr leaves the scene
+     * cache out when it has RAM slots.
+     */
+    void setStorage(uint8_t* storage, uint16_t pixels) {
+        frames = storage;
+        capacity = storage ? pixels : 0;
+        for (uint8_t id = 0; id < RamSlots; id++) counts[id] = 0;
+    }
+
+    // Find the EEPROM slots that fit and the scenes saved in them
+    void begin(uint16_t pixelCount) {
+        strip = pixelCount;
+#if LTP_SCENE_EEPROM
+        uint32_t room = (uint32_t)EEPROM.length() > LTP_SCENE_EEPROM_ADDR ?
+                        EEPROM.length() - LTP_SCENE_EEPROM_ADDR : 0;
+        uint32_t slotBytes = EepromSlots ? room / EepromSlots : 0;
+        uint32_t n = slotBytes > SAVE_HEADER + 1U ? (slotBytes - SAVE_HEADER - 1) / 3 : 0;
+        eepromPixels = n < 0xFFFF ? n : 0xFFFF;
+        eepromSlots = eepromPixels ? EepromSlots : 0;
+        for (uint8_t e = 0; e < eepromSlots; e++) counts[RamSlots + e] = loadCount(e);
+#endif
+    }
+
+    /**
+     * CMD_SCENE except SCENE_RECALL: operation byte, then the slot ID for
+     * STORE and DELETE, the slot ID, first pixel (2) and RGB per pixel for
+     * UPLOAD. STORE reads the shown colors through getPixel(index, r&, g&,
+     * b&). STORE, UPLOAD and DELETE reply ACK; INFO replies with a
+     * CMD_SCENE packet.
+     */
+    template <typename GetPixel>
+    void command(LtpProtocol& protocol, const LtpPacket& pkt, GetPixel getPixel) {
+        if (pkt.length < 1) {
+            protocol.sendNak(CMD_SCENE, ERR_INVALID_LENGTH);
+            return;
+        }
+        uint8_t err = ERR_OK;
+        switch (pkt.payload[0]) {
+            case SCENE_STORE:
+                err = store(pkt.payload + 1, pkt.length - 1, getPixel);
+                break;
+            case SCENE_UPLOAD:
+                err = upload(pkt.payload + 1, pkt.length - 1);
+                break;
+            case SCENE_DELETE:
+                err = remove(pkt.payload + 1, pkt.length - 1);
+                break;
+            case SCENE_INFO: {
+                uint8_t response[INFO_SIZE];
+                protocol.sendPacket(CMD_SCENE, response, writeInfo(response));
+                return;
+            }
+            default:
+                err = ERR_INVALID_PARAM;
+                break;
+        }
+        if (err != ERR_OK) {
+            protocol.sendNak(CMD_SCENE, err);
+        } else {
+            protocol.sendAck(CMD_SCENE);
+        }
+    }
+
+    // ERR_OK if slot id holds a scene, else the error code to NAK with
+    uint8_t check(uint8_t id) const {
+        if (slots() == 0) return ERR_NOT_SUPPORTED;
+        if (id >= slots() || counts[id] == 0) return ERR_INVALID_PARAM;
+        return ERR_OK;
+    }
+
+    // Color of a pixel in scene id (checked), black past the scene's end
+    void getPixel(uint8_t id, uint16_t index, uint8_t& r, uint8_t& g, uint8_t& b) const {
+        if (index >= counts[id]) {
+            r = g = b = 0;
+        } else if (id < RamSlots) {
+            const uint8_t* c = frame(id) + index * 3;
+            r = c[0];
+            g = c[1];
+            b = c[2];
+        } else {
+#if LTP_SCENE_EEPROM
+            int addr = dataAddr(id - RamSlots) + index * 3;
+            r = EEPROM.read(addr);
+            g = EEPROM.read(addr + 1);
+            b = EEPROM.read(addr + 2);
+#else
+            r = g = b = 0;
+#endif
+        }
+    }
+
+    // Write scene id (checked) to every pixel through setPixel(index, r, g, b)
+    template <typename SetPixel>
+    void recall(uint8_t id, SetPixel setPixel) const {
+        for (uint16_t i = 0; i < strip; i++) {
+            uint8_t r, g, b;
+            getPixel(id, i, r, g, b);
+            setPixel(i, r, g, b);
+        }
+    }
+
+    uint8_t slots() const { return RamSlots == 0 || capacity ? RamSlots + eepromSlots : 0; }
+    uint16_t size() const { return strip; }
+
+    // SCENE_INFO response: slots, pixels per scene, then per slot its
+    // storage (0 RAM, 1 EEPROM) and pixel count (0 = empty)
+    uint16_t writeInfo(uint8_t* out) const {
+        uint16_t pixels = strip;
+        if (RamSlots && capacity < pixels) pixels = capacity;
+        if (eepromSlots && eepromPixels < pixels) pixels = eepromPixels;
+        uint16_t n = 0;
+        out[n++] = slots();
+        n += putU16(out + n, slots() ? pixels : 0);
+        for (uint8_t id = 0; id < slots(); id++) {
+            out[n++] = id >= RamSlots;
+            n += putU16(out + n, counts[id]);
+        }
+        return n;
+    }
+
+    static const uint16_t INFO_SIZE = 3 + 3 * (RamSlots + EepromSlots);
+    static const uint16_t BYTES_PER_PIXEL = 3 * RamSlots;
+
+private:
+    static const uint8_t SAVE_HEADER = 4;
+    static const uint8_t SLOTS_SIZE = RamSlots + EepromSlots ? RamSlots + EepromSlots : 1;
+
+    uint8_t* frames;
+    uint16_t counts[SLOTS_SIZE];    // Pixels per slot, 0 = empty
+    uint16_t capacity;              // Pixels a RAM slot holds
+    uint16_t strip;                 // Pixels on the strip
+    uint16_t eepromPixels;          // Pixels an EEPROM slot holds
+    uint8_t eepromSlots;            // EEPROM slots that fit
+
+    uint8_t* frame(uint8_t id) const { return frames + (uint32_t)id * capacity * 3; }
+
+    // Pixels slot id can hold
+    uint16_t slotPixels(uint8_t id) const { return id < RamSlots ? capacity : eepromPixels; }
+
+    template <typename GetPixel>
+    uint8_t store(const uint8_t* data, uint16_t length, GetPixel getPixel) {
+        if (slots() == 0) return ERR_NOT_SUPPORTED;
+        if (length < 1) return ERR_INVALID_LENGTH;
+        uint8_t id = data[0];
+        if (id >= slots()) return ERR_INVALID_PARAM;
+        if (strip > slotPixels(id)) return ERR_BUFFER_OVERFLOW;
+        if (id < RamSlots) {
+            for (uint16_t i = 0; i < strip; i++) {
+                uint8_t* c = frame(id) + i * 3;
+                getPixel(i, c[0], c[1], c[2]);
+            }
+        } else {
+#if LTP_SCENE_EEPROM
+            uint8_t e = id - RamSlots;
+            invalidate(e);
+            for (uint16_t i = 0; i < strip; i++) {
+                uint8_t c[3];
+                getPixel(i, c[0], c[1], c[2]);
+                for (uint8_t k = 0; k < 3; k++) EEPROM.update(dataAddr(e) + i * 3 + k, c[k]);
+            }
+            seal(e, strip);
+#endif
+        }
+        counts[id] = strip;
+        return ERR_OK;
+    }
+
+    uint8_t upload(const uint8_t* data, uint16_t length) {
+        if (slots() == 0) return ERR_NOT_SUPPORTED;
+        if (length < 3 || (length - 3) % 3) return ERR_INVALID_LENGTH;
+        uint8_t id = data[0];
+        uint16_t first = data[1] | (data[2] << 8);
+        uint16_t n = (length - 3) / 3;
+        if (id >= slots() || first > counts[id]) return ERR_INVALID_PARAM;    // Scenes grow without gaps
+        uint16_t room = slotPixels(id);
+        if (first >= room || n > room - first) return ERR_PIXEL_OVERFLOW;
+        uint16_t count = first + n > counts[id] ? first + n : counts[id];
+        if (id < RamSlots) {
+            memcpy(frame(id) + first * 3, data + 3, n * 3);
+        } else {
+#if LTP_SCENE_EEPROM
+            uint8_t e = id - RamSlots;
+            invalidate(e);
+            for (uint16_t i = 0; i < n * 3; i++) EEPROM.update(dataAddr(e) + first * 3 + i, data[3 + i]);
+            seal(e, count);
+#endif
+        }
+        counts[id] = count;
+        return ERR_OK;
+    }
+
+    uint8_t remove(const uint8_t* data, uint16_t length) {
+        if (slots() == 0) return ERR_NOT_SUPPORTED;
+        if (length < 1) return ERR_INVALID_LENGTH;
+        uint8_t id = data[0];
+        if (id >= slots()) return ERR_INVALID_PARAM;
+#if LTP_SCENE_EEPROM
+        if (id >= RamSlots) invalidate(id - RamSlots);
+#endif
+        counts[id] = 0;
+        return ERR_OK;
+    }
+
+#if LTP_SCENE_EEPROM
+    int slotAddr(uint8_t e) const { return LTP_SCENE_EEPROM_ADDR + e * (SAVE_HEADER + eepromPixels * 3L + 1); }
+    int dataAddr(uint8_t e) const { return slotAddr(e) + SAVE_HEADER; }
+
+    // Pixels in EEPROM slot e, 0 unless it holds an intact scene that fits
+    uint16_t loadCount(uint8_t e) const {
+        int addr = slotAddr(e);
+        if (EEPROM.read(addr) != 'L' || EEPROM.read(addr + 1) != 'S') return 0;
+        uint16_t n = EEPROM.read(addr + 2) | (EEPROM.read(addr + 3) << 8);
+        if (n == 0 || n > eepromPixels) return 0;
+        return sum(e, n) == EEPROM.read(dataAddr(e) + n * 3) ? n : 0;
+    }
+
+    uint8_t sum(uint8_t e, uint16_t n) const {
+        uint8_t s = 0;
+        for (uint16_t i = 0; i < n * 3; i++) s += EEPROM.read(dataAddr(e) + i);
+        return s;
+    }
+
+    // Mark slot e empty before its pixels change, so a reset midway does
+    // not leave a half-written scene
+    void invalidate(uint8_t e) const {
+        EEPROM.update(slotAddr(e), 0xFF);
+    }
+
+    void seal(uint8_t e, uint16_t n) const {
+        int addr = slotAddr(e);
+        EEPROM.update(dataAddr(e) + n * 3, sum(e, n));
+        EEPROM.update(addr + 1, 'S');
+        EEPROM.update(addr + 2, n & 0xFF);
+        EEPROM.update(addr + 3, n >> 8);
+        EEPROM.update(addr, 'L');
+    }
+#endif
+};
+
+#endif // LTP_SCENE_H
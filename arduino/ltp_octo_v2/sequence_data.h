@@ -0,0 +1,70 @@
+// LSQ1 sequence: 960 pixels, 32 frames, 960 ms, 923 bytes
+// Generated by: python -m ltp_serial_cli PORT sequence build OUT.h
+
+#ifndef SEQUENCE_DATA_H
+#define SEQUENCE_DATA_H
+
+#include <Arduino.h>
+
+const uint8_t SEQUENCE_DATA[] PROGMEM = {
+    0x4C, 0x53, 0x51, 0x31, 0x10, 0x00, 0xC0, 0x03, 0x20, 0x00, 0x00, 0x00, 0xC0, 0x03, 0x00, 0x00,
+    0x2D, 0x00, 0x1E, 0x00, 0x01, 0x00, 0x81, 0xFF, 0x40, 0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00,
+    0x7F, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x7F,
+    0x00, 0x00, 0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x46, 0x00,
+    0x00, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x00, 0x81, 0x00, 0x00, 0x00, 0x37, 0x84, 0x03, 0x01,
+    0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x38,
+    0x04, 0x00, 0x00, 0x00, 0x38, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF,
+    0x40, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x74, 0x04, 0x00, 0x00, 0x00, 0x38, 0x84, 0x03, 0x01,
+    0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0xB0,
+    0x04, 0x00, 0x00, 0x00, 0x38, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF,
+    0x40, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0xEC, 0x04, 0x00, 0x00, 0x00, 0x38, 0x84, 0x03, 0x01,
+    0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x15, 0x00, 0x1E, 0x00, 0x00, 0xFF,
+    0x00, 0x29, 0x04, 0x00, 0x00, 0x00, 0x38, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10,
+    0x00, 0xFF, 0x40, 0x00, 0x15, 0x00, 0x1E, 0x00, 0x00, 0xFF, 0x00, 0x65, 0x04, 0x00, 0x00, 0x00,
+    0x38, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x15, 0x00,
+    0x1E, 0x00, 0x00, 0xFF, 0x00, 0xA1, 0x04, 0x00, 0x00, 0x00, 0x38, 0x84, 0x03, 0x01, 0x00, 0x0F,
+    0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x15, 0x00, 0x1E, 0x00, 0x00, 0xFF, 0x00, 0xDD,
+    0x04, 0x00, 0x00, 0x00, 0x38, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF,
+    0x40, 0x00, 0x17, 0x00, 0x1E, 0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0x1A, 0x04, 0x00, 0x00, 0x00,
+    0x38, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x17, 0x00,
+    0x1E, 0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0x56, 0x04, 0x00, 0x00, 0x00, 0x38, 0x84, 0x03, 0x01,
+    0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x17, 0x00, 0x1E, 0x00, 0x00, 0xFF,
+    0x00, 0xFF, 0x00, 0x92, 0x04, 0x00, 0x00, 0x00, 0x38, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00,
+    0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x17, 0x00, 0x1E, 0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xCE,
+    0x04, 0x00, 0x00, 0x00, 0x38, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF,
+    0x40, 0x00, 0x19, 0x00, 0x1E, 0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0x0B, 0x04, 0x00,
+    0x00, 0x00, 0x38, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00,
+    0x19, 0x00, 0x1E, 0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0x47, 0x04, 0x00, 0x00, 0x00,
+    0x38, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x36, 0x00,
+    0x1E, 0x00, 0x01, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x00,
+    0x00, 0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x00, 0x00,
+    0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x43, 0x00, 0x00, 0x00, 0x00, 0x84, 0x03, 0x01, 0x00,
+    0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x19, 0x00, 0x1E, 0x00, 0x00, 0xFF, 0x00,
+    0xFF, 0x00, 0xFF, 0x00, 0x87, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03,
+    0x01, 0x00, 0x34, 0x04, 0x00, 0x00, 0x00, 0x19, 0x00, 0x1E, 0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00,
+    0xFF, 0x00, 0x4B, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00,
+    0x38, 0x04, 0x00, 0x00, 0x00, 0x19, 0x00, 0x1E, 0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00,
+    0x0F, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x38, 0x04,
+    0x00, 0x00, 0x00, 0x17, 0x00, 0x1E, 0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xD2, 0x84, 0xFF, 0x40,
+    0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x38, 0x04, 0x00, 0x00, 0x00, 0x17,
+    0x00, 0x1E, 0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0x96, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00,
+    0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x38, 0x04, 0x00, 0x00, 0x00, 0x17, 0x00, 0x1E, 0x00, 0x00,
+    0xFF, 0x00, 0xFF, 0x00, 0x5A, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03,
+    0x01, 0x00, 0x38, 0x04, 0x00, 0x00, 0x00, 0x17, 0x00, 0x1E, 0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00,
+    0x1E, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x38, 0x04,
+    0x00, 0x00, 0x00, 0x15, 0x00, 0x1E, 0x00, 0x00, 0xFF, 0x00, 0xE1, 0x84, 0xFF, 0x40, 0x00, 0x3F,
+    0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x38, 0x04, 0x00, 0x00, 0x00, 0x15, 0x00, 0x1E,
+    0x00, 0x00, 0xFF, 0x00, 0xA5, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03,
+    0x01, 0x00, 0x38, 0x04, 0x00, 0x00, 0x00, 0x15, 0x00, 0x1E, 0x00, 0x00, 0xFF, 0x00, 0x69, 0x84,
+    0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x38, 0x04, 0x00, 0x00,
+    0x00, 0x15, 0x00, 0x1E, 0x00, 0x00, 0xFF, 0x00, 0x2D, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00,
+    0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x38, 0x04, 0x00, 0x00, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00,
+    0xF0, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x38, 0x04,
+    0x00, 0x00, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0xB4, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00,
+    0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x38, 0x04, 0x00, 0x00, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00,
+    0x78, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x38, 0x04,
+    0x00, 0x00, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x3C, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00,
+    0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x38, 0x04, 0x00, 0x00, 0x00,
+};
+
+#endif // SEQUENCE_DATA_H
@@ -0,0 +1,589 @@
+/**
+ * LTP Serial Protocol v2 - Pixel Shaders
+ *
+ * A small bytecode interpreter for effects the built-in animations do not
+ * cover. The host uploads a program with CMD_SHADER_LOAD (0x64); the
+ * firmware runs it once per pixel per frame and writes the RGB it leaves
+ * behind. Parameters can be changed while it runs with CMD_SHADER_PARAM
+ * (0x65), and ANIM_STOP stops it like any other animation.
+ *
+ * The machine is a stack of signed 16-bit integers. A program reads its
+ * inputs (pixel index, segment length, time, frame number, x/y/z and the
+ * matrix size, 8 host parameters), may keep values in 8 registers that
+ * carry from pixel to pixel within a frame, and stores red, green and blue
+ * (clamped to 0-255 when the pixel ends). Arithmetic wraps at 16 bits;
+ * MUL8 is an 8.8 fixed-point multiply and division by zero gives 0.
+ *
+ * Programs are sandboxed: SHADER_LOAD rejects unknown opcodes, truncated
+ * operands, bad variables and jumps that do not land on an instruction;
+ * at run time a stack overflow or underflow, or a pixel running more than
+ * the program's instruction budget, ends that pixel and counts a fault.
+ * Backward jumps are allowed, so the budget is what bounds a frame.
+ *
+ * The host package carries the assembler and a reference interpreter
+ * (ltp_serial_cli.shader) that must produce the same pixels; SHADER_TEST
+ * renders one frame into a hash instead of the LEDs to compare the two.
+ */
+
+#ifndef LTP_SHADER_H
+#define LTP_SHADER_H
+
+#include <Arduino.h>
+#include "protocol.h"
+#include "profile.h"
+
+// Frame rate when SHADER_LOAD leaves it at 0
+#ifndef LTP_SHADER_FPS
+#define LTP_SHADER_FPS      30
+#endif
+
+// Instructions one pixel may run when SHADER_LOAD leaves the budget at 0
+#ifndef LTP_SHADER_BUDGET
+#define LTP_SHADER_BUDGET   256
+#endif
+
+#ifndef LTP_SHADER_STACK
+#define LTP_SHADER_STACK    16
+#endif
+
+// Opcodes; operands follow the opcode byte, 16-bit ones little-endian
+enum LtpShaderOp : uint8_t {
+    SHADER_OP_END       = 0x00,     // End of pixel
+    SHADER_OP_PUSH8     = 0x01,     // u8: push 0-255
+    SHADER_OP_PUSH16    = 0x02,     // i16: push
+    SHADER_OP_LOAD      = 0x03,     // var: push variable
+    SHADER_OP_STORE     = 0x04,     // var: pop into register or output
+    SHADER_OP_DUP       = 0x05,
+    SHADER_OP_DROP      = 0x06,
+    SHADER_OP_SWAP      = 0x07,
+    SHADER_OP_OVER      = 0x08,
+    SHADER_OP_ADD       = 0x10,     // a b -> a+b
+    SHADER_OP_SUB       = 0x11,     // a b -> a-b
+    SHADER_OP_MUL       = 0x12,
+    SHADER_OP_DIV       = 0x13,     // Truncates; /0 = 0
+    SHADER_OP_MOD       = 0x14,     // Sign of a; %0 = 0
+    SHADER_OP_MUL8      = 0x15,     // (a*b) >> 8
+    SHADER_OP_NEG       = 0x16,
+    SHADER_OP_ABS       = 0x17,
+    SHADER_OP_MIN       = 0x18,
+    SHADER_OP_MAX       = 0x19,
+    SHADER_OP_SHL       = 0x1A,     // a << (b & 15)
+    SHADER_OP_SHR       = 0x1B,     // a >> (b & 15), arithmetic
+    SHADER_OP_AND       = 0x1C,
+    SHADER_OP_OR        = 0x1D,
+    SHADER_OP_XOR       = 0x1E,
+    SHADER_OP_NOT       = 0x1F,     // 1 if a == 0, else 0
+    SHADER_OP_EQ        = 0x20,     // 1 or 0
+    SHADER_OP_LT        = 0x21,
+    SHADER_OP_GT        = 0x22,
+    SHADER_OP_SIN8      = 0x28,     // (sin + 1) / 2 of a's low byte, 0-255
+    SHADER_OP_TRI8      = 0x29,     // Triangle wave of a's low byte, 0-255
+    SHADER_OP_HASH8     = 0x2A,     // Pseudo-random 0-255 from a
+    SHADER_OP_CLAMP8    = 0x2B,     // Clamp to 0-255
+    SHADER_OP_LERP8     = 0x2C,     // a b t (low bytes) -> a at t 0 to b at t 255
+    SHADER_OP_HSV       = 0x2D,     // h s v (low bytes) -> output RGB
+    SHADER_OP_RGB       = 0x2E,     // r g b -> output RGB
+    SHADER_OP_HYPOT     = 0x2F,     // a b -> sqrt(a*a + b*b), at most 32767
+    SHADER_OP_JMP       = 0x30,     // u16: jump to byte offset
+    SHADER_OP_JZ        = 0x31,     // u16: pop, jump if zero
+    SHADER_OP_JNZ       = 0x32,     // u16: pop, jump if not zero
+};
+
+// LOAD / STORE variables; only registers and outputs can be stored
+enum LtpShaderVar : uint8_t {
+    SHADER_VAR_INDEX    = 0x00,     // Pixel in the segment, 0-based
+    SHADER_VAR_COUNT    = 0x01,     // Segment length
+    SHADER_VAR_TIME     = 0x02,     // Milliseconds since start, wrapping
+    SHADER_VAR_FRAME    = 0x03,     // Frames since start, wrapping
+    SHADER_VAR_X        = 0x04,     // Column of the logical pixel, or its
+    SHADER_VAR_Y        = 0x05,     // row; coordinates from the table if it
+    SHADER_VAR_WIDTH    = 0x06,     // covers the pixel
+    SHADER_VAR_HEIGHT   = 0x07,
+    SHADER_VAR_Z        = 0x08,     // Table coordinate, else 0
+    SHADER_VAR_PARAM    = 0x10,     // 0x10-0x17: SHADER_PARAM values
+    SHADER_VAR_REG      = 0x20,     // 0x20-0x27: registers, 0 each frame
+    SHADER_VAR_RED      = 0x30,     // 0x30-0x32: output, 0 each pixel
+    SHADER_VAR_GREEN    = 0x31,
+    SHADER_VAR_BLUE     = 0x32,
+};
+
+#define LTP_SHADER_PARAMS   8
+#define LTP_SHADER_REGS     8
+
+template <uint16_t CodeSize>
+class LtpShader {
+public:
+    LtpShader() : codeLength(0), running(false), frames(0), renderMicros(0),
+                  lastSteps(0), maxPixelSteps(0), faults(0) {
+        memset(&settings, 0, sizeof(settings));
+        memset(params, 0, sizeof(params));
+    }
+
+    /**
+     * SHADER_LOAD payload: flags, fps, budget (2), start (2), count (2),
+     * test time (2), then the program. An empty program keeps the loaded
+     * one, so the flags and settings can change on their own. Returns
+     * ERR_OK or the error code to NAK with; on success the caller starts
+     * or tests it according to the flags.
+     */
+    uint8_t load(const uint8_t* payload, uint16_t length, uint16_t pixelCount, uint16_t width) {
+        if (length < HEADER_SIZE) return ERR_INVALID_LENGTH;
+        uint16_t newLength = length - HEADER_SIZE;
+        if (newLength > CodeSize) return ERR_BUFFER_OVERFLOW;
+        if (newLength == 0 && codeLength == 0) return ERR_INVALID_LENGTH;
+
+        Settings s;
+        s.fps = payload[1] ? payload[1] : LTP_SHADER_FPS;
+        s.budget = payload[2] | (payload[3] << 8);
+        if (s.budget == 0) s.budget = LTP_SHADER_BUDGET;
+        s.start = payload[4] | (payload[5] << 8);
+        s.count = payload[6] | (payload[7] << 8);
+        s.testTime = payload[8] | (payload[9] << 8);
+        if (s.start >= pixelCount) return ERR_PIXEL_OVERFLOW;
+        if (s.count == 0) s.count = pixelCount - s.start;
+        if (s.count > pixelCount - s.start) return ERR_PIXEL_OVERFLOW;
+        s.width = width ? width : pixelCount;
+        s.height = (pixelCount + s.width - 1) / s.width;
+
+        if (newLength > 0) {
+            if (!validate(payload + HEADER_SIZE, newLength)) return ERR_INVALID_PARAM;
+            memcpy(code, payload + HEADER_SIZE, newLength);
+            codeLength = newLength;
+        }
+        settings = s;
+        running = false;
+        return ERR_OK;
+    }
+
+    // Run the loaded program from time 0
+    void start() {
+        clock = 0;
+        usCarry = 0;
+        frames = 0;
+        faults = 0;
+        maxPixelSteps = 0;
+        lastRender = nextFrame = micros();
+        running = true;
+    }
+
+    void stop() { running = false; }
+
+    // Set the program's segment to black (ANIM_STOP option)
+    template <typename SetPixel>
+    void clear(SetPixel setPixel) {
+        for (uint16_t i = 0; i < settings.count; i++) setPixel(settings.start + i, 0, 0, 0);
+    }
+
+    /**
+     * SHADER_PARAM payload: first parameter, then one or more values
+     * (2 bytes each, signed). Returns ERR_OK or the error code to NAK with.
+     */
+    uint8_t setParams(const uint8_t* payload, uint16_t length) {
+        if (length < 3 || (length - 1) % 2) return ERR_INVALID_LENGTH;
+        uint8_t first = payload[0];
+        uint16_t n = (length - 1) / 2;
+        if (first >= LTP_SHADER_PARAMS || n > LTP_SHADER_PARAMS - first) return ERR_INVALID_PARAM;
+        for (uint16_t i = 0; i < n; i++) {
+            params[first + i] = (int16_t)(payload[1 + i * 2] | (payload[2 + i * 2] << 8));
+        }
+        return ERR_OK;
+    }
+
+    /**
+     * Render the next frame through setPixel(index, r, g, b) if one is due,
+     * taking x, y and z from getCoord(index, x&, y&, z&) for pixels in the
+     * coordinate table. Returns true when the caller should show it.
+     */
+    template <typename GetCoord, typename SetPixel>
+    bool update(uint32_t now, GetCoord getCoord, SetPixel setPixel) {
+        if (!running || (int32_t)(now - nextFrame) < 0) return false;
+        uint32_t interval = 1000000UL / settings.fps;
+        nextFrame += interval;
+        if ((int32_t)(now - nextFrame) >= 0) nextFrame = now + interval;
+
+        usCarry += now - lastRender;
+        lastRender = now;
+        uint32_t ms = usCarry / 1000;
+        usCarry -= ms * 1000;
+        clock += ms;
+
+        LTP_PROFILE_SCOPE(PROF_SHADER_RENDER);
+        uint32_t renderStart = micros();
+        FrameResult r = render((uint16_t)clock, (uint16_t)frames, getCoord, setPixel);
+        renderMicros = micros() - renderStart;
+        lastSteps = r.steps;
+        if (r.maxPixelSteps > maxPixelSteps) maxPixelSteps = r.maxPixelSteps;
+        faults += r.faults;
+        frames++;
+        return true;
+    }
+
+    /**
+     * SHADER_TEST: render frame 0 at the test time into a 32-bit FNV-1a hash
+     * of the RGB bytes instead of the LEDs. Reply: hash (4), instructions
+     * run (4), most run by one pixel (2), pixels faulted (2), render time
+     * in us (4).
+     */
+    template <typename GetCoord>
+    uint16_t test(uint8_t* out, GetCoord getCoord) {
+        uint32_t hash = 0x811C9DC5UL;
+        uint32_t renderStart = micros();
+        FrameResult r = render(settings.testTime, 0, getCoord, [&hash](uint16_t, uint8_t red, uint8_t green, uint8_t blue) {
+            hash = (hash ^ red) * 0x01000193UL;
+            hash = (hash ^ green) * 0x01000193UL;
+            hash = (hash ^ blue) * 0x01000193UL;
+        });
+        uint32_t elapsed = micros() - renderStart;
+        uint16_t n = 0;
+        n += putU32(out + n, hash);
+        n += putU32(out + n, r.steps);
+        n += putU16(out + n, r.maxPixelSteps);
+        n += putU16(out + n, r.faults > 0xFFFF ? 0xFFFF : r.faults);
+        n += putU32(out + n, elapsed);
+        return n;
+    }
+
+    bool isRunning() const { return running; }
+
+    // update() would render a frame at now
+    bool due(uint32_t now) const { return running && (int32_t)(now - nextFrame) >= 0; }
+
+    // ANIM_STATUS extension: running, program length, budget, fps, start,
+    // count, width, height, frames, last render time (us), instructions in
+    // the last frame, most in one pixel, pixels faulted, CodeSize, then the
+    // 8 parameters
+    uint16_t writeInfo(uint8_t* out) const {
+        uint16_t n = 0;
+        out[n++] = running;
+        n += putU16(out + n, codeLength);
+        n += putU16(out + n, settings.budget);
+        out[n++] = settings.fps;
+        n += putU16(out + n, settings.start);
+        n += putU16(out + n, settings.count);
+        n += putU16(out + n, settings.width);
+        n += putU16(out + n, settings.height);
+        n += putU32(out + n, frames);
+        n += putU32(out + n, renderMicros);
+        n += putU32(out + n, lastSteps);
+        n += putU16(out + n, maxPixelSteps);
+        n += putU32(out + n, faults);
+        n += putU16(out + n, CodeSize);
+        for (uint8_t i = 0; i < LTP_SHADER_PARAMS; i++) n += putU16(out + n, (uint16_t)params[i]);
+        return n;
+    }
+
+    static const uint8_t HEADER_SIZE = 10;
+    static const uint8_t TEST_SIZE = 16;
+    static const uint8_t INFO_SIZE = 50;
+
+private:
+    struct Settings {
+        uint16_t budget;
+        uint16_t start;
+        uint16_t count;
+        uint16_t width;
+        uint16_t height;
+        uint16_t testTime;
+        uint8_t fps;
+    };
+
+    struct FrameResult {
+        uint32_t steps;
+        uint32_t faults;
+        uint16_t maxPixelSteps;
+    };
+
+    uint8_t code[CodeSize];
+    uint16_t codeLength;
+    Settings settings;
+    int16_t params[LTP_SHADER_PARAMS];
+    int16_t regs[LTP_SHADER_REGS];
+    bool running;
+    uint32_t clock;             // Milliseconds since start
+    uint32_t usCarry;
+    uint32_t lastRender;
+    uint32_t nextFrame;
+    uint32_t frames;
+    uint32_t renderMicros;
+    uint32_t lastSteps;
+    uint16_t maxPixelSteps;
+    uint32_t faults;
+
+    // Operand bytes after each opcode, or -1 for an unknown opcode
+    static int8_t operandSize(uint8_t op) {
+        switch (op) {
+            case SHADER_OP_PUSH8:
+            case SHADER_OP_LOAD:
+            case SHADER_OP_STORE:
+                return 1;
+            case SHADER_OP_PUSH16:
+            case SHADER_OP_JMP:
+            case SHADER_OP_JZ:
+            case SHADER_OP_JNZ:
+                return 2;
+            case SHADER_OP_END:
+            case SHADER_OP_DUP:
+            case SHADER_OP_DROP:
+            case SHADER_OP_SWAP:
+            case SHADER_OP_OVER:
+            case SHADER_OP_EQ:
+            case SHADER_OP_LT:
+            case SHADER_OP_GT:
+            case SHADER_OP_SIN8:
+            case SHADER_OP_TRI8:
+            case SHADER_OP_HASH8:
+            case SHADER_OP_CLAMP8:
+            case SHADER_OP_LERP8:
+            case SHADER_OP_HSV:
+            case SHADER_OP_RGB:
+            case SHADER_OP_HYPOT:
+                return 0;
+            default:
+                return op >= SHADER_OP_ADD && op <= SHADER_OP_NOT ? 0 : -1;
+        }
+    }
+
+    static bool loadable(uint8_t var) {
+        return var <= SHADER_VAR_Z || storable(var) ||
+               (var >= SHADER_VAR_PARAM && var < SHADER_VAR_PARAM + LTP_SHADER_PARAMS);
+    }
+
+    static bool storable(uint8_t var) {
+        return (var >= SHADER_VAR_REG && var < SHADER_VAR_REG + LTP_SHADER_REGS) ||
+               (var >= SHADER_VAR_RED && var <= SHADER_VAR_BLUE);
+    }
+
+    // Check every instruction, then that every jump lands on one (or the end)
+    static bool validate(const uint8_t* program, uint16_t length) {
+        uint8_t starts[(CodeSize + 7) / 8];
+        memset(starts, 0, sizeof(starts));
+        for (uint16_t pc = 0; pc < length;) {
+            uint8_t op = program[pc];
+            int8_t size = operandSize(op);
+            if (size < 0 || pc + 1 + size > length) return false;
+            if (op == SHADER_OP_LOAD && !loadable(program[pc + 1])) return false;
+            if (op == SHADER_OP_STORE && !storable(program[pc + 1])) return false;
+            starts[pc >> 3] |= 1 << (pc & 7);
+            pc += 1 + size;
+        }
+        for (uint16_t pc = 0; pc < length; pc += 1 + operandSize(program[pc])) {
+            uint8_t op = program[pc];
+            if (op != SHADER_OP_JMP && op != SHADER_OP_JZ && op != SHADER_OP_JNZ) continue;
+            uint16_t target = program[pc + 1] | (program[pc + 2] << 8);
+            if (target > length) return false;
+            if (target < length && !(starts[target >> 3] & (1 << (target & 7)))) return false;
+        }
+        return true;
+    }
+
+    template <typename GetCoord, typename SetPixel>
+    FrameResult render(uint16_t time, uint16_t frame, GetCoord getCoord, SetPixel setPixel) {
+        FrameResult r = { 0, 0, 0 };
+        memset(regs, 0, sizeof(regs));
+        uint16_t x = settings.start % settings.width;
+        uint16_t y = settings.start / settings.width;
+        for (uint16_t i = 0; i < settings.count; i++) {
+            int16_t in[SHADER_VAR_Z + 1] = {
+                (int16_t)i, (int16_t)settings.count, (int16_t)time, (int16_t)frame,
+                (int16_t)x, (int16_t)y, (int16_t)settings.width, (int16_t)settings.height, 0
+            };
+            getCoord(settings.start + i, in[SHADER_VAR_X], in[SHADER_VAR_Y], in[SHADER_VAR_Z]);
+            int16_t rgb[3] = { 0, 0, 0 };
+            uint16_t steps = 0;
+            if (!run(in, rgb, steps)) r.faults++;
+            r.steps += steps;
+            if (steps > r.maxPixelSteps) r.maxPixelSteps = steps;
+            setPixel(settings.start + i, clamp8(rgb[0]), clamp8(rgb[1]), clamp8(rgb[2]));
+            if (++x == settings.width) {
+                x = 0;
+                y++;
+            }
+        }
+        return r;
+    }
+
+    // One pixel; false on a fault. steps counts the instructions run.
+    bool run(const int16_t* in, int16_t* rgb, uint16_t& steps) {
+        int16_t stack[LTP_SHADER_STACK];
+        uint8_t sp = 0;
+        uint16_t pc = 0;
+
+// Operands a (second from top) and b (top) for binary operations
+#define SHADER_NEED(n)  if (sp < (n)) return false
+#define SHADER_PUSH(v)  do { int16_t pushed = (int16_t)(v); if (sp == LTP_SHADER_STACK) return false; stack[sp++] = pushed; } while (0)
+#define SHADER_BINARY(expr) do { SHADER_NEED(2); int32_t a = stack[sp - 2], b = stack[sp - 1]; sp--; stack[sp - 1] = (int16_t)(expr); } while (0)
+#define SHADER_UNARY(expr)  do { SHADER_NEED(1); int32_t a = stack[sp - 1]; stack[sp - 1] = (int16_t)(expr); } while (0)
+
+        while (pc < codeLength) {
+            if (steps == settings.budget) return false;
+            steps++;
+            uint8_t op = code[pc++];
+            switch (op) {
+                case SHADER_OP_END:
+                    return true;
+                case SHADER_OP_PUSH8:
+                    SHADER_PUSH(code[pc]);
+                    pc++;
+                    break;
+                case SHADER_OP_PUSH16:
+                    SHADER_PUSH(code[pc] | (code[pc + 1] << 8));
+                    pc += 2;
+                    break;
+                case SHADER_OP_LOAD: {
+                    uint8_t var = code[pc++];
+                    int16_t v;
+                    if (var <= SHADER_VAR_Z) v = in[var];
+                    else if (var < SHADER_VAR_REG) v = params[var - SHADER_VAR_PARAM];
+                    else if (var < SHADER_VAR_RED) v = regs[var - SHADER_VAR_REG];
+                    else v = rgb[var - SHADER_VAR_RED];
+                    SHADER_PUSH(v);
+                    break;
+                }
+                case SHADER_OP_STORE: {
+                    uint8_t var = code[pc++];
+                    SHADER_NEED(1);
+                    int16_t v = stack[--sp];
+                    if (var < SHADER_VAR_RED) regs[var - SHADER_VAR_REG] = v;
+                    else rgb[var - SHADER_VAR_RED] = v;
+                    break;
+                }
+                case SHADER_OP_DUP:
+                    SHADER_NEED(1);
+                    SHADER_PUSH(stack[sp - 1]);
+                    break;
+                case SHADER_OP_DROP:
+                    SHADER_NEED(1);
+                    sp--;
+                    break;
+                case SHADER_OP_SWAP: {
+                    SHADER_NEED(2);
+                    int16_t t = stack[sp - 1];
+                    stack[sp - 1] = stack[sp - 2];
+                    stack[sp - 2] = t;
+                    break;
+                }
+                case SHADER_OP_OVER:
+                    SHADER_NEED(2);
+                    SHADER_PUSH(stack[sp - 2]);
+                    break;
+                case SHADER_OP_ADD:  SHADER_BINARY(a + b); break;
+                case SHADER_OP_SUB:  SHADER_BINARY(a - b); break;
+                case SHADER_OP_MUL:  SHADER_BINARY(a * b); break;
+                case SHADER_OP_DIV:  SHADER_BINARY(b ? a / b : 0); break;
+                case SHADER_OP_MOD:  SHADER_BINARY(b ? a % b : 0); break;
+                case SHADER_OP_MUL8: SHADER_BINARY((a * b) >> 8); break;
+                case SHADER_OP_NEG:  SHADER_UNARY(-a); break;
+                case SHADER_OP_ABS:  SHADER_UNARY(a < 0 ? -a : a); break;
+                case SHADER_OP_MIN:  SHADER_BINARY(a < b ? a : b); break;
+                case SHADER_OP_MAX:  SHADER_BINARY(a > b ? a : b); break;
+                case SHADER_OP_SHL:  SHADER_BINARY((uint32_t)a << (b & 15)); break;
+                case SHADER_OP_SHR:  SHADER_BINARY(a >> (b & 15)); break;
+                case SHADER_OP_AND:  SHADER_BINARY(a & b); break;
+                case SHADER_OP_OR:   SHADER_BINARY(a | b); break;
+                case SHADER_OP_XOR:  SHADER_BINARY(a ^ b); break;
+                case SHADER_OP_NOT:  SHADER_UNARY(a == 0); break;
+                case SHADER_OP_EQ:   SHADER_BINARY(a == b); break;
+                case SHADER_OP_LT:   SHADER_BINARY(a < b); break;
+                case SHADER_OP_GT:   SHADER_BINARY(a > b); break;
+                case SHADER_OP_SIN8:   SHADER_UNARY(sine8(a)); break;
+                case SHADER_OP_TRI8:   SHADER_UNARY(triangle8(a)); break;
+                case SHADER_OP_HASH8:  SHADER_UNARY(hash8(a)); break;
+                case SHADER_OP_CLAMP8: SHADER_UNARY(clamp8(a)); break;
+                case SHADER_OP_LERP8: {
+                    SHADER_NEED(3);
+                    uint8_t v = lerp8(stack[sp - 3], stack[sp - 2], stack[sp - 1]);
+                    sp -= 2;
+                    stack[sp - 1] = v;
+                    break;
+                }
+                case SHADER_OP_HSV:
+                    SHADER_NEED(3);
+                    sp -= 3;
+                    hsv(stack[sp], stack[sp + 1], stack[sp + 2], rgb);
+                    break;
+                case SHADER_OP_RGB:
+                    SHADER_NEED(3);
+                    sp -= 3;
+                    for (uint8_t c = 0; c < 3; c++) rgb[c] = stack[sp + c];
+                    break;
+                case SHADER_OP_HYPOT:  SHADER_BINARY(hypot16((uint32_t)(a * a) + (uint32_t)(b * b))); break;
+                case SHADER_OP_JMP:
+                    pc = code[pc] | (code[pc + 1] << 8);
+                    break;
+                case SHADER_OP_JZ:
+                case SHADER_OP_JNZ: {
+                    SHADER_NEED(1);
+                    bool zero = stack[--sp] == 0;
+                    if (zero == (op == SHADER_OP_JZ)) pc = code[pc] | (code[pc + 1] << 8);
+                    else pc += 2;
+                    break;
+                }
+            }
+        }
+
+#undef SHADER_NEED
+#undef SHADER_PUSH
+#undef SHADER_BINARY
+#undef SHADER_UNARY
+        return true;
+    }
+
+    static uint8_t clamp8(int16_t v) { return v < 0 ? 0 : v > 255 ? 255 : v; }
+
+    // Square root of a sum of two squares (at most 2^31), capped at 32767
+    static int16_t hypot16(uint32_t v) {
+        uint32_t root = 0;
+        uint32_t bit = 1UL << 30;
+        while (bit > v) bit >>= 2;
+        while (bit) {
+            if (v >= root + bit) {
+                v -= root + bit;
+                root = (root >> 1) + bit;
+            } else {
+                root >>= 1;
+            }
+            bit >>= 2;
+        }
+        return root > 0x7FFF ? 0x7FFF : root;
+    }
+
+    static uint8_t triangle8(uint8_t x) { return x < 128 ? x << 1 : (255 - x) << 1; }
+
+    // Same curve as the built-in animations' sine8()
+    static uint8_t sine8(uint8_t x) {
+        uint16_t s = triangle8(x + 64);
+        s += s >> 7;
+        uint32_t v = ((uint32_t)((s * s) >> 8) * (768 - 2 * s)) >> 8;
+        return v > 255 ? 255 : v;
+    }
+
+    static uint8_t hash8(uint16_t v) {
+        uint16_t h = v * 40503U;
+        h ^= h >> 8;
+        return h & 0xFF;
+    }
+
+    static uint8_t lerp8(uint8_t a, uint8_t b, uint8_t amount) {
+        uint16_t w = amount + (amount >> 7);
+        return ((uint16_t)a * (256 - w) + (uint16_t)b * w) >> 8;
+    }
+
+    // Hue, saturation and value as 0-255 bytes, six 43-step sectors
+    static void hsv(uint8_t h, uint8_t s, uint8_t v, int16_t* rgb) {
+        uint8_t sector = h / 43;
+        uint8_t rem = (h - sector * 43) * 6;
+        uint8_t p = (v * (255 - s)) >> 8;
+        uint8_t q = (v * (255 - ((s * rem) >> 8))) >> 8;
+        uint8_t t = (v * (255 - ((s * (255 - rem)) >> 8))) >> 8;
+        switch (sector) {
+            case 0:  rgb[0] = v; rgb[1] = t; rgb[2] = p; break;
+            case 1:  rgb[0] = q; rgb[1] = v; rgb[2] = p; break;
+            case 2:  rgb[0] = p; rgb[1] = v; rgb[2] = t; break;
+            case 3:  rgb[0] = p; rgb[1] = q; rgb[2] = v; break;
+            case 4:  rgb[0] = t; rgb[1] = p; rgb[2] = v; break;
+            default: rgb[0] = v; rgb[1] = p; rgb[2] = q; break;
+        }
+    }
+};
+
+#endif // LTP_SHADER_H
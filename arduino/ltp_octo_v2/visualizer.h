@@ -0,0 +1,329 @@
+/**
+ * LTP Serial Protocol v2 - Scalar Visualizers
+ *
+ * Bar graphs, VU meters and gauges rendered on the device from one value
+ * per bar, the firmware side of the host's BarGraph, MultiBar and VUMeter
+ * sources. VIS_CONFIG (0x67) sets up a segment once; each VIS_VALUE (0x68)
+ * then carries 1-4 bytes (0-255, one per bar) instead of a frame, so a
+ * 60 Hz meter costs a few bytes per update on the wire.
+ *
+ * The segment splits into up to 4 equal bars separated by a gap. Each bar
+ * fills from its start, its end (VIS_REVERSE), its middle (VIS_CENTER) or
+ * both ends (VIS_CENTER | VIS_REVERSE):
+ *
+ *   VIS_BAR     Fill in color 1, or color 1 to color 2 along the bar
+ *               (VIS_GRADIENT); a peak marker in white
+ *   VIS_METER   Segments in green, yellow and red zones, unlit ones dim,
+ *               the peak segment lit
+ *   VIS_GAUGE   Fill in the color the value maps to between color 1 and
+ *               color 2
+ *
+ * Levels are 8.8 fixed point, so the pixel at the edge of the fill is
+ * blended by how much of it is covered. A falling value can decay at a set
+ * rate and the peak can hold before it falls, which keeps rendering
+ * between updates; otherwise the sketch only renders when a value changes.
+ *
+ * The sketch calls update() once per loop() and shows the frame when it
+ * returns true.
+ */
+
+#ifndef LTP_VISUALIZER_H
+#define LTP_VISUALIZER_H
+
+#include <Arduino.h>
+#include "protocol.h"
+#include "profile.h"
+
+// Most frames rendered per second
+#ifndef LTP_VIS_FPS
+#define LTP_VIS_FPS         60
+#endif
+
+#define LTP_VIS_BARS        4
+
+class LtpVisualizer {
+public:
+    LtpVisualizer() : mode(VIS_OFF), frames(0), renderMicros(0) {
+        memset(&cfg, 0, sizeof(cfg));
+        memset(bars, 0, sizeof(bars));
+    }
+
+    /**
+     * VIS_CONFIG payload: mode, flags, start (2), count (2, 0 = to the last
+     * pixel), then optional bars, gap, meter segments, fall time and peak
+     * hold (1/10 s), meter yellow and red thresholds, color1 (3), color2
+     * (3), background (3). Mode VIS_OFF stops it and leaves the pixels.
+     * Returns ERR_OK or the error code to NAK with.
+     */
+    uint8_t configure(const uint8_t* payload, uint16_t length, uint16_t pixelCount) {
+        if (length < 1) return ERR_INVALID_LENGTH;
+        if (payload[0] == VIS_OFF) {
+            mode = VIS_OFF;
+            return ERR_OK;
+        }
+        if (length < 6) return ERR_INVALID_LENGTH;
+        if (payload[0] > VIS_GAUGE) return ERR_INVALID_PARAM;
+
+        Config c;
+        bool meter = payload[0] == VIS_METER;
+        c.flags = payload[1];
+        c.start = payload[2] | (payload[3] << 8);
+        c.count = payload[4] | (payload[5] << 8);
+        c.bars = length > 6 && payload[6] ? payload[6] : 1;
+        c.gap = length > 7 ? payload[7] : 1;
+        c.segments = length > 8 ? payload[8] : 10;
+        c.fall = length > 9 ? payload[9] : (meter ? 15 : 0);
+        c.hold = length > 10 ? payload[10] : (meter ? 10 : 0);
+        c.yellow = length > 11 && payload[11] ? payload[11] : 153;
+        c.red = length > 12 && payload[12] ? payload[12] : 217;
+        static const uint8_t GREEN[3] = { 0, 255, 0 };
+        static const uint8_t RED[3] = { 255, 0, 0 };
+        for (uint8_t i = 0; i < 3; i++) {
+            c.color1[i] = length > 15 ? payload[13 + i] : GREEN[i];
+            c.color2[i] = length > 18 ? payload[16 + i] : RED[i];
+            c.background[i] = length > 21 ? payload[19 + i] : 0;
+        }
+
+        if (c.bars > LTP_VIS_BARS) return ERR_INVALID_PARAM;
+        if (c.start >= pixelCount) return ERR_PIXEL_OVERFLOW;
+        if (c.count == 0) c.count = pixelCount - c.start;
+        if (c.count > pixelCount - c.start) return ERR_PIXEL_OVERFLOW;
+        if ((uint32_t)(c.bars - 1) * c.gap >= c.count) return ERR_INVALID_PARAM;
+        c.length = (c.count - (c.bars - 1) * c.gap) / c.bars;
+
+        cfg = c;
+        mode = payload[0];
+        memset(bars, 0, sizeof(bars));
+        clockMs = 0;
+        usCarry = 0;
+        frames = 0;
+        lastRender = micros();
+        nextFrame = lastRender;
+        dirty = true;
+        return ERR_OK;
+    }
+
+    // VIS_VALUE payload: one value (0-255) per bar, from the first
+    uint8_t setValues(const uint8_t* payload, uint16_t length) {
+        if (mode == VIS_OFF) return ERR_CONFIG;
+        if (length < 1 || length > cfg.bars) return ERR_INVALID_LENGTH;
+        for (uint8_t b = 0; b < length; b++) {
+            if (bars[b].value != payload[b]) dirty = true;
+            bars[b].value = payload[b];
+        }
+        return ERR_OK;
+    }
+
+    void stop() { mode = VIS_OFF; }
+
+    // Set the last configured segment to black (ANIM_STOP option)
+    template <typename SetPixel>
+    void clear(SetPixel setPixel) {
+        for (uint16_t i = 0; i < cfg.count; i++) setPixel(cfg.start + i, 0, 0, 0);
+    }
+
+    /**
+     * Render through setPixel(index, r, g, b) when a value changed or a
+     * level or peak is still falling, at most LTP_VIS_FPS times a second.
+     * Returns true when the caller should show the frame.
+     */
+    template <typename SetPixel>
+    bool update(uint32_t now, SetPixel setPixel) {
+        if (mode == VIS_OFF || (int32_t)(now - nextFrame) < 0) return false;
+
+        usCarry += now - lastRender;
+        lastRender = now;
+        uint32_t ms = usCarry / 1000;
+        usCarry -= ms * 1000;
+        clockMs += ms;
+
+        bool moving = false;
+        for (uint8_t b = 0; b < cfg.bars; b++) moving |= decay(bars[b], ms);
+        if (!dirty && !moving) return false;
+        dirty = false;
+        nextFrame = now + 1000000UL / LTP_VIS_FPS;
+
+        LTP_PROFILE_SCOPE(PROF_VIS_RENDER);
+        uint32_t renderStart = micros();
+        for (uint8_t b = 0; b < cfg.bars; b++) renderBar(b, setPixel);
+        // Gaps between bars and pixels left over from the split
+        uint16_t pitch = cfg.length + cfg.gap;
+        for (uint16_t i = cfg.length; i < cfg.count; i++) {
+            if (i % pitch < cfg.length && i < (uint32_t)cfg.bars * pitch) continue;
+            setPixel(cfg.start + i, cfg.background[0], cfg.background[1], cfg.background[2]);
+        }
+        renderMicros = micros() - renderStart;
+        frames++;
+        return true;
+    }
+
+    bool isRunning() const { return mode != VIS_OFF; }
+
+    // update() would look for bars to draw at now
+    bool due(uint32_t now) const { return mode != VIS_OFF && (int32_t)(now - nextFrame) >= 0; }
+
+    // ANIM_STATUS extension: mode, flags, bars, start, count, then per bar
+    // the value, the level shown and the peak, frames rendered and the last
+    // render time (us)
+    uint16_t writeInfo(uint8_t* out) const {
+        uint16_t n = 0;
+        out[n++] = mode;
+        out[n++] = cfg.flags;
+        out[n++] = cfg.bars;
+        n += putU16(out + n, cfg.start);
+        n += putU16(out + n, cfg.count);
+        for (uint8_t b = 0; b < LTP_VIS_BARS; b++) out[n++] = bars[b].value;
+        for (uint8_t b = 0; b < LTP_VIS_BARS; b++) out[n++] = bars[b].level >> 8;
+        for (uint8_t b = 0; b < LTP_VIS_BARS; b++) out[n++] = bars[b].peak >> 8;
+        n += putU32(out + n, frames);
+        n += putU32(out + n, renderMicros);
+        return n;
+    }
+
+    static const uint8_t INFO_SIZE = 27;
+
+private:
+    struct Config {
+        uint8_t flags;
+        uint16_t start;
+        uint16_t count;
+        uint16_t length;        // Pixels per bar
+        uint8_t bars;
+        uint8_t gap;
+        uint8_t segments;       // Meter segments per bar, 0 = one per pixel
+        uint8_t fall;           // Full-scale fall time, 1/10 s (0 = instant)
+        uint8_t hold;           // Peak hold, 1/10 s (0 = no peak)
+        uint8_t yellow;         // Meter zone thresholds
+        uint8_t red;
+        uint8_t color1[3];
+        uint8_t color2[3];
+        uint8_t background[3];
+    };
+
+    struct Bar {
+        uint8_t value;
+        uint16_t level;         // Shown, 8.8
+        uint16_t peak;          // 8.8
+        uint32_t peakMs;        // When the peak was last raised
+    };
+
+    Config cfg;
+    Bar bars[LTP_VIS_BARS];
+    uint8_t mode;
+    bool dirty;                 // A value changed since the last frame
+    uint32_t clockMs;
+    uint32_t usCarry;
+    uint32_t lastRender;
+    uint32_t nextFrame;
+    uint32_t frames;
+    uint32_t renderMicros;
+
+    // Amount (8.8) a falling level or peak drops in ms
+    uint16_t fallStep(uint32_t ms) const {
+        if (cfg.fall == 0) return 0xFFFF;
+        uint32_t step = ms * 0xFF00UL / (cfg.fall * 100UL);
+        return step > 0xFFFF ? 0xFFFF : step;
+    }
+
+    // Move the level towards the value and the peak after it; true while
+    // either still has to fall
+    bool decay(Bar& bar, uint32_t ms) {
+        uint16_t target = (uint16_t)bar.value << 8;
+        uint16_t step = fallStep(ms);
+        if (target >= bar.level) {
+            bar.level = target;
+        } else {
+            bar.level = bar.level - target > step ? bar.level - step : target;
+        }
+        if (cfg.hold == 0) {
+            bar.peak = 0;
+        } else if (bar.level >= bar.peak) {
+            bar.peak = bar.level;
+            bar.peakMs = clockMs;
+        } else if (clockMs - bar.peakMs >= cfg.hold * 100UL) {
+            bar.peak = bar.peak - bar.level > step ? bar.peak - step : bar.level;
+        }
+        return bar.level != target || (cfg.hold && bar.peak > bar.level);
+    }
+
+    // Pixel p of bar b counting from where it fills; two pixels for
+    // center and edge fills
+    template <typename SetPixel>
+    void place(SetPixel setPixel, uint8_t b, uint16_t p, const uint8_t* rgb) const {
+        uint16_t first = cfg.start + b * (cfg.length + cfg.gap);
+        uint16_t last = cfg.length - 1;
+        if (cfg.flags & VIS_CENTER) {
+            bool edges = cfg.flags & VIS_REVERSE;
+            uint16_t hi = edges ? last - p : cfg.length / 2 + p;
+            uint16_t lo = edges ? p : last / 2 - p;
+            setPixel(first + hi, rgb[0], rgb[1], rgb[2]);
+            setPixel(first + lo, rgb[0], rgb[1], rgb[2]);
+        } else {
+            uint16_t i = (cfg.flags & VIS_REVERSE) ? last - p : p;
+            setPixel(first + i, rgb[0], rgb[1], rgb[2]);
+        }
+    }
+
+    template <typename SetPixel>
+    void renderBar(uint8_t b, SetPixel setPixel) const {
+        const Bar& bar = bars[b];
+        uint16_t span = (cfg.flags & VIS_CENTER) ? (cfg.length + 1) / 2 : cfg.length;
+        uint16_t top = span > 1 ? span - 1 : 1;
+        if (mode == VIS_METER) {
+            renderMeter(b, span, setPixel);
+            return;
+        }
+        uint32_t fill = (uint32_t)bar.level * span / 255;              // Pixels, 8.8
+        uint16_t peakAt = cfg.hold && bar.peak ? ((uint32_t)(bar.peak >> 8) * top + 127) / 255 : 0xFFFF;
+        uint8_t color[3];
+        if (mode == VIS_GAUGE) mix(cfg.color1, cfg.color2, bar.level >> 8, color);
+        for (uint16_t p = 0; p < span; p++) {
+            uint32_t covered = fill > ((uint32_t)p << 8) ? fill - ((uint32_t)p << 8) : 0;
+            uint8_t rgb[3];
+            if (p == peakAt && covered < 256) {
+                rgb[0] = rgb[1] = rgb[2] = 255;
+            } else {
+                if (mode == VIS_BAR) {
+                    if (cfg.flags & VIS_GRADIENT) mix(cfg.color1, cfg.color2, (uint32_t)p * 255 / top, color);
+                    else memcpy(color, cfg.color1, 3);
+                }
+                mix(cfg.background, color, covered > 255 ? 255 : covered, rgb);
+            }
+            place(setPixel, b, p, rgb);
+        }
+    }
+
+    // Segments of span / segments pixels, the last pixel of each a gap
+    template <typename SetPixel>
+    void renderMeter(uint8_t b, uint16_t span, SetPixel setPixel) const {
+        const Bar& bar = bars[b];
+        uint16_t n = cfg.segments && cfg.segments < span ? cfg.segments : span;
+        uint16_t size = span / n;
+        uint16_t lit = ((uint32_t)bar.level * n / 255) >> 8;
+        uint16_t peakSeg = cfg.hold && bar.peak ? ((uint32_t)(bar.peak >> 8) * (n - 1) + 127) / 255 : 0xFFFF;
+        for (uint16_t p = 0; p < span; p++) {
+            uint16_t s = p / size;
+            uint8_t rgb[3];
+            if (s >= n || (size > 1 && p % size == size - 1)) {
+                memcpy(rgb, cfg.background, 3);
+            } else {
+                uint8_t pos = n > 1 ? (uint32_t)s * 255 / (n - 1) : 0;
+                rgb[0] = pos > cfg.yellow ? 255 : 0;
+                rgb[1] = pos <= cfg.red ? 255 : 0;
+                rgb[2] = 0;
+                if (s >= lit && s != peakSeg) {
+                    for (uint8_t c = 0; c < 3; c++) rgb[c] >>= 3;
+                }
+            }
+            place(setPixel, b, p, rgb);
+        }
+    }
+
+    // a at amount 0 to b at amount 255
+    static void mix(const uint8_t* a, const uint8_t* b, uint8_t amount, uint8_t* out) {
+        uint16_t w = amount + (amount >> 7);
+        for (uint8_t c = 0; c < 3; c++) out[c] = ((uint16_t)a[c] * (256 - w) + (uint16_t)b[c] * w) >> 8;
+    }
+};
+
+#endif // LTP_VISUALIZER_H
@@ -0,0 +1,540 @@
+/**
+ * LTP Serial Protocol v2 - Built-in Animations
+ *
+ * Patterns rendered on the device, so a controller keeps running without a
+ * host streaming frames: solid, rainbow, chase, cylon, breathe, sparkle and
+ * fire, the same set (and at default parameters, the same look) as the
+ * host's virtual sources, plus sweep and radial, which run over the pixels'
+ * positions in the coordinate table (coords.h), and spectrum and pulse,
+ * which follow the audio engine (audio.h) through setAudio() and stay dark
+ * on firmware without one. Started with CMD_ANIM_START
+ * (0x60), stopped with CMD_ANIM_STOP (0x61) and read back with
+ * CMD_ANIM_STATUS (0x62).
+ *
+ * Rendering is integer only: positions are 8.8 fixed point, colors come
+ * from small PROGMEM palettes and time is a millisecond clock scaled by the
+ * speed parameter (16 = the host pattern's default rate), so AVR boards run
+ * them without floating point.
+ *
+ * An animation covers one segment of the logical pixels; the host may keep
+ * streaming to the pixels outside it. Sparkle and fire keep one byte of
+ * state per pixel, in storage the sketch gives setStorage() for the
+ * strip's length, and only animate the pixels it holds.
+ *
+ * The sketch dispatches the three commands here and calls update() once
+ * per loop(), showing the frame when it returns true.
+ */
+
+#ifndef LTP_ANIMATION_H
+#define LTP_ANIMATION_H
+
+#include <Arduino.h>
+#include "protocol.h"
+#include "profile.h"
+
+// Frame rate when ANIM_START leaves it at 0
+#ifndef LTP_ANIMATION_FPS
+#define LTP_ANIMATION_FPS   30
+#endif
+
+// ANIM_START parameters, in payload order
+struct LtpAnimParams {
+    uint8_t pattern;
+    uint8_t speed;              // 16 = default rate
+    uint8_t size;               // Per pattern: wavelength, length, width, ...
+    uint8_t intensity;          // Per pattern: saturation, spacing, fade, ...
+    uint8_t palette;
+    uint8_t color1[3];
+    uint8_t color2[3];          // Background / gradient end
+    uint16_t start;
+    uint16_t count;
+    uint8_t fps;
+};
+
+// Per pattern: size, intensity, palette, color1
+const uint8_t LTP_ANIM_DEFAULTS[ANIM_PATTERN_COUNT][6] PROGMEM = {
+    {   0,   0, PALETTE_RAINBOW, 255, 255, 255 },   // Solid
+    {  10, 255, PALETTE_RAINBOW, 255, 255, 255 },   // Rainbow: one repeat, full saturation
+    {   5,  10, PALETTE_RAINBOW, 255, 255, 255 },   // Chase: length 5, spacing 10
+    {   5, 204, PALETTE_RAINBOW, 255,   0,   0 },   // Cylon: width 5, fade 0.8
+    {   0,   0, PALETTE_RAINBOW, 255, 255, 255 },   // Breathe: sine, off at minimum
+    { 230,  13, PALETTE_RAINBOW, 255, 255, 255 },   // Sparkle: fade 0.9, density 0.05
+    {  55, 120, PALETTE_FIRE,    255, 255, 255 },   // Fire: cooling 55, sparking 120
+    {  32,   0, PALETTE_RAINBOW, 255, 255, 255 },   // Sweep: band 1/8 of the extent along x
+    {   2, 255, PALETTE_RAINBOW, 255, 255, 255 },   // Radial: two rings, full saturation
+    {  10,   0, PALETTE_RAINBOW, 255, 255, 255 },   // Spectrum: palette once, dark at silence
+    {  30, 128, PALETTE_RAINBOW, 255, 255, 255 },   // Pulse: 300 ms flash, half-level glow
+};
+
+// Per palette: color count, then evenly spaced RGB stops
+const uint8_t LTP_ANIM_PALETTES[PALETTE_COUNT][1 + 8 * 3] PROGMEM = {
+    { 8, 0xFF,0x00,0x00, 0xFF,0x7F,0x00, 0xFF,0xFF,0x00, 0x00,0xFF,0x00,
+         0x00,0x00,0xFF, 0x4B,0x00,0x82, 0x94,0x00,0xD3, 0xFF,0x00,0x00 },
+    { 6, 0x00,0x00,0x00, 0x80,0x00,0x00, 0xFF,0x00,0x00, 0xFF,0x80,0x00,
+         0xFF,0xFF,0x00, 0xFF,0xFF,0x80 },
+    { 5, 0x00,0x00,0x20, 0x00,0x00,0x80, 0x00,0x80,0xFF, 0x80,0xC8,0xFF,
+         0xFF,0xFF,0xFF },
+    { 6, 0x00,0x00,0x20, 0x00,0x20,0x40, 0x00,0x40,0x80, 0x00,0x80,0xC0,
+         0x00,0xC0,0xC0, 0x40,0xE0,0xD0 },
+    { 6, 0x00,0x20,0x00, 0x00,0x40,0x00, 0x20,0x80,0x00, 0x40,0xC0,0x20,
+         0x80,0x60,0x00, 0x40,0x30,0x00 },
+    { 6, 0x00,0x00,0x00, 0x80,0x00,0x00, 0xFF,0x00,0x00, 0xFF,0x80,0x00,
+         0xFF,0xFF,0x00, 0xFF,0xFF,0xFF },
+};
+
+class LtpAnimation {
+public:
+    LtpAnimation() : running(false), frames(0), renderMicros(0), rng(0x2545F491UL),
+                     state(nullptr), stateCapacity(0), audioLevel(0), beatCount(0), beatAt(0) {
+        memset(&params, 0, sizeof(params));
+        memset(audioBands, 0, sizeof(audioBands));
+    }
+
+    /**
+     * Keep sparkle and fire state for up to pixels pixels in storage
+     * (BYTES_PER_PIXEL each), stopping the animation. nullptr leaves those
+     * two patterns dark.
+     */
+    void setStorage(uint8_t* storage, uint16_t pixels) {
+        stop();
+        state = storage;
+        stateCapacity = storage ? pixels : 0;
+    }
+
+    /**
+     * ANIM_START payload: pattern, then optional speed, size, intensity,
+     * palette, color1 (3), color2 (3), start (2), count (2), fps. Omitted
+     * fields take the pattern's defaults; count 0 runs to the last pixel.
+     * Returns ERR_OK or the error code to NAK with.
+     */
+    uint8_t start(const uint8_t* payload, uint16_t length, uint16_t pixelCount) {
+        if (length < 1) return ERR_INVALID_LENGTH;
+        if (payload[0] >= ANIM_PATTERN_COUNT) return ERR_INVALID_PARAM;
+
+        LtpAnimParams p;
+        const uint8_t* d = LTP_ANIM_DEFAULTS[payload[0]];
+        p.pattern = payload[0];
+        p.speed = length > 1 && payload[1] ? payload[1] : 16;
+        p.size = length > 2 ? payload[2] : pgm_read_byte(d);
+        p.intensity = length > 3 ? payload[3] : pgm_read_byte(d + 1);
+        p.palette = length > 4 ? payload[4] : pgm_read_byte(d + 2);
+        for (uint8_t c = 0; c < 3; c++) {
+            p.color1[c] = length > 7 ? payload[5 + c] : pgm_read_byte(d + 3 + c);
+            p.color2[c] = length > 10 ? payload[8 + c] : 0;
+        }
+        p.start = length > 12 ? payload[11] | (payload[12] << 8) : 0;
+        p.count = length > 14 ? payload[13] | (payload[14] << 8) : 0;
+        p.fps = length > 15 && payload[15] ? payload[15] : LTP_ANIMATION_FPS;
+
+        if (p.palette >= PALETTE_COUNT && p.palette != PALETTE_GRADIENT) return ERR_INVALID_PARAM;
+        if (p.start >= pixelCount) return ERR_PIXEL_OVERFLOW;
+        if (p.count == 0) p.count = pixelCount - p.start;
+        if (p.count > pixelCount - p.start) return ERR_PIXEL_OVERFLOW;
+
+        params = p;
+        if (state) memset(state, 0, stateCapacity);
+        clock = 0;
+        usCarry = 0;
+        frames = 0;
+        lastRender = nextFrame = micros();
+        rng ^= lastRender;
+        if (rng == 0) rng = 0x2545F491UL;
+        running = true;
+        return ERR_OK;
+    }
+
+    void stop() { running = false; }
+
+    // Set the segment of the last animation to black (ANIM_STOP option)
+    template <typename SetPixel>
+    void clear(SetPixel setPixel) {
+        for (uint16_t i = 0; i < params.count; i++) setPixel(params.start + i, 0, 0, 0);
+    }
+
+    /**
+     * Render the next frame through setPixel(index, r, g, b) if one is due,
+     * placing pixels for the spatial patterns through
+     * getCoord(index, x&, y&, z&), which leaves them alone (position = the
+     * pixel's place in the segment) for pixels without coordinates.
+     * Returns true when the caller should show it. Frames keep their
+     * cadence but are not made up after a stall.
+     */
+    template <typename GetCoord, typename SetPixel>
+    bool update(uint32_t now, GetCoord getCoord, SetPixel setPixel) {
+        if (!running || (int32_t)(now - nextFrame) < 0) return false;
+        uint32_t interval = 1000000UL / params.fps;
+        nextFrame += interval;
+        if ((int32_t)(now - nextFrame) >= 0) nextFrame = now + interval;
+
+        // Pattern time: milliseconds x speed, 16 per ms at the default rate
+        usCarry += now - lastRender;
+        lastRender = now;
+        uint32_t ms = usCarry / 1000;
+        usCarry -= ms * 1000;
+        clock += ms * params.speed;
+
+        LTP_PROFILE_SCOPE(PROF_ANIMATION_RENDER);
+        uint32_t renderStart = micros();
+        uint32_t t = clock >> 4;
+        switch (params.pattern) {
+            case ANIM_SOLID:    renderSolid(setPixel); break;
+            case ANIM_RAINBOW:  renderRainbow(t, setPixel); break;
+            case ANIM_CHASE:    renderChase(t, setPixel); break;
+            case ANIM_CYLON:    renderCylon(t, setPixel); break;
+            case ANIM_BREATHE:  renderBreathe(t, setPixel); break;
+            case ANIM_SPARKLE:  renderSparkle(setPixel); break;
+            case ANIM_FIRE:     renderFire(setPixel); break;
+            case ANIM_SWEEP:    renderSweep(t, getCoord, setPixel); break;
+            case ANIM_RADIAL:   renderRadial(t, getCoord, setPixel); break;
+            case ANIM_SPECTRUM: renderSpectrum(setPixel); break;
+            case ANIM_PULSE:    renderPulse(t, setPixel); break;
+        }
+        renderMicros = micros() - renderStart;
+        frames++;
+        return true;
+    }
+
+    bool isRunning() const { return running; }
+
+    // update() would render a frame at now
+    bool due(uint32_t now) const { return running && (int32_t)(now - nextFrame) >= 0; }
+
+    // Latest audio analysis: AUDIO_BANDS band levels, the overall level and
+    // whether the block held a beat
+    void setAudio(const uint8_t* bands, uint8_t level, bool beat) {
+        memcpy(audioBands, bands, AUDIO_BANDS);
+        audioLevel = level;
+        if (beat) {
+            beatAt = clock;
+            beatCount++;
+        }
+    }
+
+    // ANIM_STATUS response: running, the ANIM_START parameters as applied,
+    // frames rendered, last render time (us) and the pixels with state
+    uint16_t writeInfo(uint8_t* out) const {
+        uint16_t n = 0;
+        out[n++] = running;
+        out[n++] = params.pattern;
+        out[n++] = params.speed;
+        out[n++] = params.size;
+        out[n++] = params.intensity;
+        out[n++] = params.palette;
+        for (uint8_t c = 0; c < 3; c++) out[n++] = params.color1[c];
+        for (uint8_t c = 0; c < 3; c++) out[n++] = params.color2[c];
+        n += putU16(out + n, params.start);
+        n += putU16(out + n, params.count);
+        out[n++] = params.fps;
+        n += putU32(out + n, frames);
+        n += putU32(out + n, renderMicros);
+        n += putU16(out + n, stateCapacity);
+        return n;
+    }
+
+    static const uint8_t INFO_SIZE = 27;
+    static const uint8_t BYTES_PER_PIXEL = 1;
+
+private:
+    LtpAnimParams params;
+    bool running;
+    uint32_t clock;             // Pattern time, 1/16 ms at the default speed
+    uint32_t usCarry;
+    uint32_t lastRender;
+    uint32_t nextFrame;
+    uint32_t frames;
+    uint32_t renderMicros;
+    uint32_t rng;
+    uint8_t* state;             // Sparkle brightness / fire heat
+    uint16_t stateCapacity;     // Pixels state holds
+    uint8_t audioBands[AUDIO_BANDS];
+    uint8_t audioLevel;
+    uint8_t beatCount;
+    uint32_t beatAt;            // Pattern time of the last beat
+
+    uint8_t random8() {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return rng >> 24;
+    }
+
+    static uint8_t scale8(uint8_t v, uint8_t scale) { return ((uint16_t)v * (scale + 1)) >> 8; }
+
+    // a at amount 0 to b at amount 255
+    static uint8_t lerp8(uint8_t a, uint8_t b, uint8_t amount) {
+        uint16_t w = amount + (amount >> 7);
+        return ((uint16_t)a * (256 - w) + (uint16_t)b * w) >> 8;
+    }
+
+    static uint8_t triangle8(uint8_t x) { return x < 128 ? x << 1 : (255 - x) << 1; }
+
+    // (sin + 1) / 2 over one period, from a cubic ease of the triangle
+    static uint8_t sine8(uint8_t x) {
+        uint16_t s = triangle8(x + 64);
+        s += s >> 7;
+        uint32_t v = ((uint32_t)((s * s) >> 8) * (768 - 2 * s)) >> 8;
+        return v > 255 ? 255 : v;
+    }
+
+    // Position in the period as 0-65535
+    static uint16_t phase16(uint32_t t, uint32_t period) {
+        uint32_t p = t % period;
+        return period <= 0x10000UL ? (p << 16) / period : p / ((period >> 16) + 1);
+    }
+
+    void paletteColor(uint8_t pos, uint8_t* rgb) const {
+        if (params.palette == PALETTE_GRADIENT) {
+            for (uint8_t c = 0; c < 3; c++) rgb[c] = lerp8(params.color1[c], params.color2[c], pos);
+            return;
+        }
+        const uint8_t* pal = LTP_ANIM_PALETTES[params.palette];
+        uint16_t t = (uint16_t)pos * (pgm_read_byte(pal) - 1);
+        const uint8_t* stop = pal + 1 + (t >> 8) * 3;
+        for (uint8_t c = 0; c < 3; c++) rgb[c] = lerp8(pgm_read_byte(stop + c), pgm_read_byte(stop + 3 + c), t & 0xFF);
+    }
+
+    // Toward gray when intensity (saturation) is below 255
+    void saturate(uint8_t* rgb) const {
+        if (params.intensity == 255) return;
+        uint8_t gray = ((uint16_t)rgb[0] + rgb[1] + rgb[2]) * 85 >> 8;
+        for (uint8_t c = 0; c < 3; c++) rgb[c] = lerp8(gray, rgb[c], params.intensity);
+    }
+
+    // Position of pixel i of the segment from the coordinate table
+    template <typename GetCoord>
+    void position(GetCoord getCoord, uint16_t i, int16_t* xyz) const {
+        xyz[0] = i;
+        xyz[1] = xyz[2] = 0;
+        getCoord(params.start + i, xyz[0], xyz[1], xyz[2]);
+    }
+
+    static uint16_t sqrt32(uint32_t v) {
+        uint32_t root = 0;
+        uint32_t bit = 1UL << 30;
+        while (bit > v) bit >>= 2;
+        while (bit) {
+            if (v >= root + bit) {
+                v -= root + bit;
+                root = (root >> 1) + bit;
+            } else {
+                root >>= 1;
+            }
+            bit >>= 2;
+        }
+        return root;
+    }
+
+    template <typename SetPixel>
+    void blendPixel(SetPixel setPixel, uint16_t i, uint8_t amount) const {
+        setPixel(params.start + i,
+                 lerp8(params.color2[0], params.color1[0], amount),
+                 lerp8(params.color2[1], params.color1[1], amount),
+                 lerp8(params.color2[2], params.color1[2], amount));
+    }
+
+    template <typename SetPixel>
+    void renderSolid(SetPixel setPixel) const {
+        for (uint16_t i = 0; i < params.count; i++) {
+            setPixel(params.start + i, params.color1[0], params.color1[1], params.color1[2]);
+        }
+    }
+
+    // size: palette repeats over the segment in tenths; intensity: saturation
+    template <typename SetPixel>
+    void renderRainbow(uint32_t t, SetPixel setPixel) const {
+        uint32_t step = ((uint32_t)params.size << 24) / (10UL * params.count);
+        uint32_t pos = (uint32_t)(phase16(t, 2000) >> 8) << 16;
+        for (uint16_t i = 0; i < params.count; i++, pos += step) {
+            uint8_t rgb[3];
+            paletteColor(pos >> 16, rgb);
+            saturate(rgb);
+            setPixel(params.start + i, rgb[0], rgb[1], rgb[2]);
+        }
+    }
+
+    // size: lit length; intensity: gap between repeats (0 = one pass)
+    template <typename SetPixel>
+    void renderChase(uint32_t t, SetPixel setPixel) const {
+        uint16_t length = params.size ? params.size : 1;
+        uint32_t period = length + (params.intensity ? params.intensity : params.count);
+        uint32_t length88 = (uint32_t)length << 8;
+        uint32_t period88 = period << 8;
+        uint32_t head = ((uint32_t)phase16(t, period * 50) * period) >> 8;   // 20 px/s
+        uint32_t d = (period88 - head) % period88;                          // Distance behind the head
+        for (uint16_t i = 0; i < params.count; i++) {
+            if (d < length88) {
+                blendPixel(setPixel, i, 255 - d / (2 * length));
+            } else {
+                blendPixel(setPixel, i, 0);
+            }
+            d += 256;
+            if (d >= period88) d -= period88;
+        }
+    }
+
+    // size: eye width; intensity: fade towards its edges
+    template <typename SetPixel>
+    void renderCylon(uint32_t t, SetPixel setPixel) const {
+        uint16_t width = params.size ? params.size : 1;
+        uint32_t width88 = (uint32_t)width << 8;
+        uint16_t phase = phase16(t, (uint32_t)params.count * 400 / 3 + 1);    // 15 px/s each way
+        uint32_t sweep = phase < 0x8000 ? (uint32_t)phase << 1 : (uint32_t)(0xFFFF - phase) << 1;
+        uint32_t center = (sweep * (params.count - 1)) >> 8;
+        for (uint16_t i = 0; i < params.count; i++) {
+            uint32_t x = (uint32_t)i << 8;
+            uint32_t dist = x > center ? x - center : center - x;
+            if (dist < width88) {
+                blendPixel(setPixel, i, 255 - (((dist / width) * params.intensity) >> 8));
+            } else {
+                blendPixel(setPixel, i, 0);
+            }
+        }
+    }
+
+    // size: waveform (0 sine, 1 triangle, 2 square, 3 sawtooth);
+    // intensity: minimum brightness
+    template <typename SetPixel>
+    void renderBreathe(uint32_t t, SetPixel setPixel) const {
+        uint8_t phase = phase16(t, 1000) >> 8;
+        uint8_t wave;
+        switch (params.size) {
+            case 1:  wave = triangle8(phase); break;
+            case 2:  wave = phase < 128 ? 255 : 0; break;
+            case 3:  wave = phase; break;
+            default: wave = sine8(phase); break;
+        }
+        uint8_t level = lerp8(params.intensity, 255, wave);
+        uint8_t r = scale8(params.color1[0], level);
+        uint8_t g = scale8(params.color1[1], level);
+        uint8_t b = scale8(params.color1[2], level);
+        for (uint16_t i = 0; i < params.count; i++) setPixel(params.start + i, r, g, b);
+    }
+
+    // size: fade per frame (brightness x size / 256); intensity: chance
+    // per pixel and frame of a new sparkle (/ 256)
+    template <typename SetPixel>
+    void renderSparkle(SetPixel setPixel) {
+        uint16_t n = params.count < stateCapacity ? params.count : stateCapacity;
+        for (uint16_t i = 0; i < params.count; i++) {
+            uint8_t level = 0;
+            if (i < n) {
+                level = scale8(state[i], params.size);
+                if (random8() < params.intensity) level = 255;
+                state[i] = level;
+            }
+            blendPixel(setPixel, i, level);
+        }
+    }
+
+    // Fire2012: size is cooling, intensity the chance of a new spark
+    template <typename SetPixel>
+    void renderFire(SetPixel setPixel) {
+        uint16_t n = params.count < stateCapacity ? params.count : stateCapacity;
+        for (uint16_t i = 0; i < n; i++) {
+            uint8_t cool = scale8(random8(), params.size);
+            state[i] = state[i] > cool ? state[i] - cool : 0;
+        }
+        for (uint16_t i = n; i > 2; i--) {
+            state[i - 1] = ((uint16_t)state[i - 2] + 2 * state[i - 3]) * 171 >> 9;
+        }
+        if (n > 0 && random8() < params.intensity) {
+            uint8_t y = random8() % (n < 8 ? n : 8);
+            uint16_t heat = state[y] + 153 + random8() % 103;
+            state[y] = heat > 255 ? 255 : heat;
+        }
+        for (uint16_t i = 0; i < params.count; i++) {
+            uint8_t rgb[3] = {0, 0, 0};
+            if (i < n) paletteColor(state[i], rgb);
+            setPixel(params.start + i, rgb[0], rgb[1], rgb[2]);
+        }
+    }
+
+    // A band moving across the segment's extent, one pass per 2 s.
+    // size: band width (/ 256 of the extent); intensity: axis (0 x, 1 y, 2 z)
+    template <typename GetCoord, typename SetPixel>
+    void renderSweep(uint32_t t, GetCoord getCoord, SetPixel setPixel) const {
+        uint8_t axis = params.intensity < 3 ? params.intensity : 0;
+        int16_t xyz[3];
+        int32_t low = 0x7FFF, high = -0x8000;
+        for (uint16_t i = 0; i < params.count; i++) {
+            position(getCoord, i, xyz);
+            if (xyz[axis] < low) low = xyz[axis];
+            if (xyz[axis] > high) high = xyz[axis];
+        }
+        uint32_t width = ((uint32_t)(high - low) * params.size) >> 8;
+        if (width == 0) width = 1;
+        // The band enters before low and leaves after high
+        int32_t center = low - (int32_t)width +
+                         (int32_t)(((uint32_t)phase16(t, 2000) * (high - low + 2 * width)) >> 16);
+        for (uint16_t i = 0; i < params.count; i++) {
+            position(getCoord, i, xyz);
+            uint32_t dist = xyz[axis] > center ? xyz[axis] - center : center - xyz[axis];
+            blendPixel(setPixel, i, dist < width ? 255 - dist * 255 / width : 0);
+        }
+    }
+
+    // Palette rings moving out from the origin, one ring per second.
+    // size: rings out to the farthest pixel; intensity: saturation
+    template <typename GetCoord, typename SetPixel>
+    void renderRadial(uint32_t t, GetCoord getCoord, SetPixel setPixel) const {
+        int16_t xyz[3];
+        uint16_t farthest = 1;
+        for (uint16_t i = 0; i < params.count; i++) {
+            position(getCoord, i, xyz);
+            uint16_t d = distance(xyz);
+            if (d > farthest) farthest = d;
+        }
+        uint8_t scroll = phase16(t, 1000) >> 8;
+        for (uint16_t i = 0; i < params.count; i++) {
+            position(getCoord, i, xyz);
+            uint8_t rgb[3];
+            paletteColor((uint8_t)(((uint32_t)distance(xyz) * params.size * 256) / farthest) - scroll, rgb);
+            saturate(rgb);
+            setPixel(params.start + i, rgb[0], rgb[1], rgb[2]);
+        }
+    }
+
+    // Band levels across the segment, low to high, each pixel between the
+    // two nearest bands. size: palette repeats in tenths; intensity:
+    // brightness at silence
+    template <typename SetPixel>
+    void renderSpectrum(SetPixel setPixel) const {
+        uint32_t last = params.count > 1 ? params.count - 1 : 1;
+        uint32_t step = ((uint32_t)params.size << 24) / (10UL * params.count);
+        uint32_t pos = 0;
+        for (uint16_t i = 0; i < params.count; i++, pos += step) {
+            uint16_t band88 = (uint32_t)i * ((AUDIO_BANDS - 1) << 8) / last;
+            uint8_t b = band88 >> 8;
+            uint8_t v = b + 1 < AUDIO_BANDS ? lerp8(audioBands[b], audioBands[b + 1], band88 & 0xFF) : audioBands[b];
+            uint8_t level = lerp8(params.intensity, 255, v);
+            uint8_t rgb[3];
+            paletteColor(pos >> 16, rgb);
+            setPixel(params.start + i, scale8(rgb[0], level), scale8(rgb[1], level), scale8(rgb[2], level));
+        }
+    }
+
+    // The segment flashes on each beat and glows with the level between
+    // them, stepping through the palette every beat. size: flash decay in
+    // 10 ms; intensity: how much the level lights it
+    template <typename SetPixel>
+    void renderPulse(uint32_t t, SetPixel setPixel) const {
+        uint32_t since = t - (beatAt >> 4);
+        uint32_t decay = params.size ? params.size * 10UL : 1;
+        uint8_t level = beatCount && since < decay ? 255 - since * 255 / decay : 0;
+        uint8_t glow = scale8(audioLevel, params.intensity);
+        if (glow > level) level = glow;
+        uint8_t rgb[3];
+        paletteColor(beatCount * 40, rgb);
+        for (uint16_t i = 0; i < params.count; i++) {
+            setPixel(params.start + i, scale8(rgb[0], level), scale8(rgb[1], level), scale8(rgb[2], level));
+        }
+    }
+
+    static uint16_t distance(const int16_t* xyz) {
+        uint32_t sum = 0;
+        for (uint8_t c = 0; c < 3; c++) sum += (uint32_t)((int32_t)xyz[c] * xyz[c]);
+        return sqrt32(sum);
+    }
+};
+
+#endif // LTP_ANIMATION_H
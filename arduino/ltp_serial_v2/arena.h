@@ -0,0 +1,62 @@
+/**
+ * LTP Serial Protocol v2 - Static Memory Arena
+ *
+ * One statically sized block of RAM that the runtime layout is carved from
+ * instead of the heap: the LED driver's pixel storage (or palette indices,
+ * or span table) comes out of it at boot, followed by the effect buffers
+ * sized to the strip, and SET_STRIP carves it again for a new strip length
+ * without reflashing. Allocation only moves a pointer up, and reset()
+ * releases everything at once, so nothing fragments and the RAM a build
+ * uses is fixed at compile time: a layout that does not fit is refused
+ * before anything is changed, never half-applied by a failed new.
+ *
+ * GET_INFO INFO_MEMORY reports the arena's size, use (the strip's and the
+ * effects' share) and the longest strip it can hold.
+ */
+
+#ifndef LTP_ARENA_H
+#define LTP_ARENA_H
+
+#include <Arduino.h>
+
+// Allocations start on this boundary so tables of 16- and 32-bit fields
+// can live in the arena (2 bytes on AVR, 8 on 64-bit hosts)
+#ifndef LTP_ARENA_ALIGN
+#define LTP_ARENA_ALIGN     sizeof(void*)
+#endif
+
+template <uint16_t Size>
+class LtpArena {
+public:
+    LtpArena() : top(0), peak(0) {}
+
+    /**
+     * Carve bytes from the arena; nullptr when they do not fit. Memory
+     * stays allocated until reset().
+     */
+    uint8_t* alloc(uint32_t bytes) {
+        if (bytes == 0) return nullptr;
+        uint16_t at = (top + LTP_ARENA_ALIGN - 1) / LTP_ARENA_ALIGN * LTP_ARENA_ALIGN;
+        if (at > Size || bytes > (uint32_t)(Size - at)) return nullptr;
+        top = at + bytes;
+        if (top > peak) peak = top;
+        return storage + at;
+    }
+
+    // Release every allocation, to lay the arena out again
+    void reset() {
+        top = 0;
+    }
+
+    uint16_t size() const { return Size; }
+    uint16_t used() const { return top; }
+    uint16_t available() const { return Size - top; }
+    uint16_t highWater() const { return peak; }
+
+private:
+    alignas(LTP_ARENA_ALIGN) uint8_t storage[Size ? Size : 1];
+    uint16_t top;               // First free byte
+    uint16_t peak;              // Most ever in use
+};
+
+#endif // LTP_ARENA_H
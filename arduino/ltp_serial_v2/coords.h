@@ -0,0 +1,263 @@
+/**
+ * LTP Serial Protocol v2 - Coordinate Table
+ *
+ * A per-pixel x/y/z table for effects rendered on the device, so spatial
+ * patterns (plane sweeps, radial waves) over a sculpture run without the
+ * host streaming frames. The host uploads it once with CMD_COORDS (0x66),
+ * usually from its topology, and may save it to EEPROM; the sketch loads
+ * the saved table at startup.
+ *
+ * Coordinates are signed integers in whatever units the host chose, stored
+ * as Coord (int8_t or int16_t) in storage the sketch gives setStorage()
+ * for the strip's length (BYTES_PER_PIXEL each); without storage COORDS
+ * replies NOT_SUPPORTED. The table covers pixels 0 to count-1; the built-in
+ * animations and pixel shaders fall back to their own layout for the rest.
+ *
+ * The EEPROM copy starts at LTP_COORDS_EEPROM_ADDR: magic "LC", bits per
+ * coordinate, pixel count (2), then the table and a sum of its bytes.
+ */
+
+#ifndef LTP_COORDS_H
+#define LTP_COORDS_H
+
+#include <Arduino.h>
+#include "protocol.h"
+
+// EEPROM persistence where the core provides EEPROM.h
+#ifndef LTP_COORDS_EEPROM
+#if defined(LTP_HOST_BUILD) || defined(CORE_TEENSY) || defined(__AVR__)
+#define LTP_COORDS_EEPROM   1
+#else
+#define LTP_COORDS_EEPROM   0
+#endif
+#endif
+
+#ifndef LTP_COORDS_EEPROM_ADDR
+#define LTP_COORDS_EEPROM_ADDR 0
+#endif
+
+#if LTP_COORDS_EEPROM
+#include <EEPROM.h>
+#endif
+
+template <typename Coord>
+class LtpCoords {
+public:
+    LtpCoords() : table(nullptr), capacity(0), count(0), saved(0), limit(0) { clearBounds(); }
+
+    /**
+     * Keep the table for up to pixels pixels in storage (BYTES_PER_PIXEL
+     * each), emptying it; begin() loads the saved one again. nullptr
+     * leaves the table out.
+     */
+    void setStorage(uint8_t* storage, uint16_t pixels) {
+        table = (Coord(*)[3])storage;
+        capacity = storage ? pixels : 0;
+        count = 0;
+        clearBounds();
+    }
+
+    // Load the saved table, if there is one that fits pixelCount
+    void begin(uint16_t pixelCount) {
+        limit = pixelCount < capacity ? pixelCount : capacity;
+#if LTP_COORDS_EEPROM
+        if (capacity == 0 || EEPROM.read(LTP_COORDS_EEPROM_ADDR) != 'L' ||
+            EEPROM.read(LTP_COORDS_EEPROM_ADDR + 1) != 'C' ||
+            EEPROM.read(LTP_COORDS_EEPROM_ADDR + 2) != BITS) return;
+        uint16_t n = EEPROM.read(LTP_COORDS_EEPROM_ADDR + 3) | (EEPROM.read(LTP_COORDS_EEPROM_ADDR + 4) << 8);
+        if (n > limit || SAVE_HEADER + n * 3 * sizeof(Coord) + 1 > (uint32_t)EEPROM.length()) return;
+        uint8_t* bytes = (uint8_t*)table;
+        uint8_t sum = 0;
+        for (uint16_t i = 0; i < n * 3 * sizeof(Coord); i++) {
+            bytes[i] = EEPROM.read(LTP_COORDS_EEPROM_ADDR + SAVE_HEADER + i);
+            sum += bytes[i];
+        }
+        if (sum != EEPROM.read(LTP_COORDS_EEPROM_ADDR + SAVE_HEADER + n * 3 * sizeof(Coord))) return;
+        count = saved = n;
+        updateBounds();
+#endif
+    }
+
+    /**
+     * CMD_COORDS: operation byte, then for COORDS_WRITE the first pixel (2)
+     * and x, y, z (2 bytes each, signed) per pixel, for COORDS_READ the
+     * first pixel and count (2 each). WRITE, CLEAR and SAVE reply ACK; INFO
+     * and READ reply with a CMD_COORDS packet.
+     */
+    void command(LtpProtocol& protocol, const LtpPacket& pkt) {
+        if (pkt.length < 1) {
+            protocol.sendNak(CMD_COORDS, ERR_INVALID_LENGTH);
+            return;
+        }
+        uint8_t err = ERR_OK;
+        switch (pkt.payload[0]) {
+            case COORDS_WRITE:
+                err = write(pkt.payload + 1, pkt.length - 1);
+                break;
+            case COORDS_CLEAR:
+                count = 0;
+                clearBounds();
+                break;
+            case COORDS_SAVE:
+                err = save();
+                break;
+            case COORDS_INFO: {
+                uint8_t response[INFO_SIZE];
+                protocol.sendPacket(CMD_COORDS, response, writeInfo(response));
+                return;
+            }
+            case COORDS_READ:
+                read(protocol, pkt.payload + 1, pkt.length - 1);
+                return;
+            default:
+                err = ERR_INVALID_PARAM;
+                break;
+        }
+        if (err != ERR_OK) {
+            protocol.sendNak(CMD_COORDS, err);
+        } else {
+            protocol.sendAck(CMD_COORDS);
+        }
+    }
+
+    // Coordinates of a logical pixel; false (x, y, z untouched) past the table
+    bool lookup(uint16_t index, int16_t& x, int16_t& y, int16_t& z) const {
+        if (index >= count) return false;
+        x = table[index][0];
+        y = table[index][1];
+        z = table[index][2];
+        return true;
+    }
+
+    uint16_t size() const { return count; }
+
+    static const uint8_t INFO_SIZE = 22;
+    static const uint8_t BITS = sizeof(Coord) * 8;
+    static const uint8_t BYTES_PER_PIXEL = 3 * sizeof(Coord);
+
+private:
+    static const uint8_t SAVE_HEADER = 5;
+
+    Coord (*table)[3];
+    uint16_t capacity;          // Pixels the storage holds
+    uint16_t count;             // Pixels 0..count-1 have coordinates
+    uint16_t saved;             // Pixels in the EEPROM copy
+    uint16_t limit;             // Pixels the table may cover
+    int16_t low[3];
+    int16_t high[3];
+
+    uint8_t write(const uint8_t* data, uint16_t length) {
+        if (capacity == 0) return ERR_NOT_SUPPORTED;
+        if (length < 2 || (length - 2) % 6) return ERR_INVALID_LENGTH;
+        uint16_t first = data[0] | (data[1] << 8);
+        uint16_t n = (length - 2) / 6;
+        if (first > count) return ERR_INVALID_PARAM;       // Tables grow without gaps
+        if (first + n > limit) return ERR_PIXEL_OVERFLOW;
+        const uint8_t* p = data + 2;
+        for (uint16_t i = 0; i < n * 3; i++, p += 2) {
+            int16_t v = (int16_t)(p[0] | (p[1] << 8));
+            if (v < COORD_MIN || v > COORD_MAX) return ERR_INVALID_PARAM;
+        }
+        p = data + 2;
+        for (uint16_t i = 0; i < n; i++) {
+            for (uint8_t c = 0; c < 3; c++, p += 2) table[first + i][c] = (int16_t)(p[0] | (p[1] << 8));
+        }
+        if (first + n > count) count = first + n;
+        updateBounds();
+        return ERR_OK;
+    }
+
+    uint8_t save() {
+#if LTP_COORDS_EEPROM
+        if (capacity == 0) return ERR_NOT_SUPPORTED;
+        uint16_t bytes = count * 3 * sizeof(Coord);
+        if ((uint32_t)SAVE_HEADER + bytes + 1 > (uint32_t)EEPROM.length()) return ERR_BUFFER_OVERFLOW;
+        const uint8_t* data = (const uint8_t*)table;
+        uint8_t sum = 0;
+        for (uint16_t i = 0; i < bytes; i++) {
+            EEPROM.update(LTP_COORDS_EEPROM_ADDR + SAVE_HEADER + i, data[i]);
+            sum += data[i];
+        }
+        EEPROM.update(LTP_COORDS_EEPROM_ADDR + SAVE_HEADER + bytes, sum);
+        EEPROM.update(LTP_COORDS_EEPROM_ADDR + 3, count & 0xFF);
+        EEPROM.update(LTP_COORDS_EEPROM_ADDR + 4, count >> 8);
+        EEPROM.update(LTP_COORDS_EEPROM_ADDR + 2, BITS);
+        EEPROM.update(LTP_COORDS_EEPROM_ADDR + 1, 'C');
+        EEPROM.update(LTP_COORDS_EEPROM_ADDR, 'L');
+        saved = count;
+        return ERR_OK;
+#else
+        return ERR_NOT_SUPPORTED;
+#endif
+    }
+
+    // Pixels in the table and its capacity, pixels saved and the EEPROM
+    // capacity in pixels, bits per coordinate, then the bounds
+    uint16_t writeInfo(uint8_t* out) const {
+        uint16_t n = 0;
+        n += putU16(out + n, count);
+        n += putU16(out + n, limit);
+        n += putU16(out + n, saved);
+        n += putU16(out + n, eepromPixels());
+        out[n++] = BITS;
+        out[n++] = 0;
+        for (uint8_t c = 0; c < 3; c++) {
+            n += putU16(out + n, (uint16_t)low[c]);
+            n += putU16(out + n, (uint16_t)high[c]);
+        }
+        return n;
+    }
+
+    // First pixel and count requested; replies with the first pixel and
+    // x, y, z of each pixel up to the end of the table
+    void read(LtpProtocol& protocol, const uint8_t* data, uint16_t length) {
+        if (length < 4) {
+            protocol.sendNak(CMD_COORDS, ERR_INVALID_LENGTH);
+            return;
+        }
+        uint16_t first = data[0] | (data[1] << 8);
+        uint16_t n = data[2] | (data[3] << 8);
+        if (first > count) first = count;
+        if (n > count - first) n = count - first;
+        if (n > (LTP_MAX_PAYLOAD - 2) / 6) n = (LTP_MAX_PAYLOAD - 2) / 6;
+        uint8_t header[2];
+        putU16(header, first);
+        protocol.beginPacket(CMD_COORDS, 2 + n * 6);
+        protocol.writePayload(header, 2);
+        for (uint16_t i = 0; i < n; i++) {
+            uint8_t xyz[6];
+            for (uint8_t c = 0; c < 3; c++) putU16(xyz + c * 2, (uint16_t)(int16_t)table[first + i][c]);
+            protocol.writePayload(xyz, 6);
+        }
+        protocol.endPacket();
+    }
+
+    uint16_t eepromPixels() const {
+#if LTP_COORDS_EEPROM
+        uint32_t space = EEPROM.length() > SAVE_HEADER + 1 ? EEPROM.length() - SAVE_HEADER - 1 : 0;
+        uint32_t n = space / (3 * sizeof(Coord));
+        return n < capacity ? n : capacity;
+#else
+        return 0;
+#endif
+    }
+
+    void clearBounds() {
+        for (uint8_t c = 0; c < 3; c++) low[c] = high[c] = 0;
+    }
+
+    void updateBounds() {
+        clearBounds();
+        for (uint16_t i = 0; i < count; i++) {
+            for (uint8_t c = 0; c < 3; c++) {
+                if (i == 0 || table[i][c] < low[c]) low[c] = table[i][c];
+                if (i == 0 || table[i][c] > high[c]) high[c] = table[i][c];
+            }
+        }
+    }
+
+    static const int16_t COORD_MIN = sizeof(Coord) == 1 ? -128 : -32768;
+    static const int16_t COORD_MAX = sizeof(Coord) == 1 ? 127 : 32767;
+};
+
+#endif // LTP_COORDS_H
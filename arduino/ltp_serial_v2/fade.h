@@ -0,0 +1,327 @@
+/**
+ * LTP Serial Protocol v2 - Keyframe Fades
+ *
+ * FADE_TO (0x63) takes a range of pixels from what they show now to a
+ * target frame (FADE_FRAME), or scales them through a brightness ramp
+ * (FADE_LEVEL), over a duration and along an easing curve. The firmware
+ * renders the frames in between, so a 5 s crossfade costs one packet on the
+ * wire instead of 300 frames.
+ *
+ * Keyframes queue up to Keyframes deep. Each one starts from the pixels as
+ * they are when it begins (normally the previous keyframe's end), read back
+ * from the LED driver. Interpolation is 16-bit fixed point:
+ *
+ *   out = (from x (65536 - w) + to x w) >> 16,   w = ease(elapsed / duration)
+ *
+ * One FADE_FRAME packet carries (LTP_MAX_PAYLOAD - 9) / 3 targets: 338
+ * pixels with the 1024-byte packet buffer. Longer targets go in several
+ * packets, each but the last flagged FADE_CONTINUED; the keyframe waits in
+ * the queue until its last part arrives, so the parts fade as one.
+ *
+ * RAM is 3 bytes per pixel for the starting colors plus 3 per pixel for
+ * each queued keyframe's target (BYTES_PER_PIXEL), in storage the sketch
+ * gives setStorage() for the strip's length. Without storage (AVR) fades
+ * are left out and FADE_TO replies NOT_SUPPORTED. That includes
+ * FADE_LEVEL: it scales the starting colors, not the ones on show, because
+ * rescaling the last frame would compound its rounding every frame and
+ * could never bring a pixel back up from 0.
+ *
+ * The sketch calls update() once per loop() and shows the frame when it
+ * returns true.
+ */
+
+#ifndef LTP_FADE_H
+#define LTP_FADE_H
+
+#include <Arduino.h>
+#include "protocol.h"
+
+// Frames rendered per second while a fade runs
+#ifndef LTP_FADE_FPS
+#define LTP_FADE_FPS        50
+#endif
+
+template <uint8_t Keyframes>
+class LtpFade {
+public:
+    LtpFade() : buffer(nullptr), capacity(0), head(0), queued(0), active(false), elapsedMs(0) {}
+
+    /**
+     * Keep starting colors and targets for up to pixels pixels in storage
+     * (BYTES_PER_PIXEL each), dropping any keyframes; nullptr leaves fades
+     * out.
+     */
+    void setStorage(uint8_t* storage, uint16_t pixels) {
+        stop();
+        buffer = storage;
+        capacity = storage ? pixels : 0;
+    }
+
+    /**
+     * FADE_TO payload: mode, easing, flags, duration (4 bytes, ms), start
+     * pixel (2); then for FADE_FRAME the target RGB of each pixel, for
+     * FADE_LEVEL the pixel count (2, 0 = to the end) and the from and to
+     * levels (0-255). The packet after one flagged FADE_CONTINUED must be
+     * a FADE_FRAME carrying more of that keyframe's targets, from the pixel
+     * after its last; its duration, easing and replace flag are ignored.
+     * Returns ERR_OK or the error code to NAK with.
+     */
+    uint8_t queue(const uint8_t* payload, uint16_t length, uint16_t pixelCount) {
+        if (capacity == 0) return ERR_NOT_SUPPORTED;
+        if (length < HEADER_SIZE) return ERR_INVALID_LENGTH;
+
+        uint8_t mode = payload[0];
+        uint8_t easing = payload[1];
+        uint8_t flags = payload[2];
+        uint16_t start = payload[7] | (payload[8] << 8);
+        if (mode > FADE_LEVEL || easing > FADE_EASE_IN_OUT) return ERR_INVALID_PARAM;
+
+        uint16_t count;
+        if (mode == FADE_FRAME) {
+            if (length == HEADER_SIZE || (length - HEADER_SIZE) % 3) return ERR_INVALID_LENGTH;
+            count = (length - HEADER_SIZE) / 3;
+        } else {
+            if (length < HEADER_SIZE + 4) return ERR_INVALID_LENGTH;
+            count = payload[9] | (payload[10] << 8);
+            if (count == 0 && start < pixelCount) count = pixelCount - start;
+        }
+        if (queued && keyframes[last()].continued) {
+            return append(mode, payload + HEADER_SIZE, start, count, pixelCount, flags);
+        }
+        if (start >= pixelCount || count > pixelCount - start) return ERR_PIXEL_OVERFLOW;
+        if (count > capacity) return ERR_BUFFER_OVERFLOW;
+
+        if (flags & FADE_REPLACE) stop();
+        if (queued == Keyframes) return ERR_BUSY;
+
+        uint8_t slot = (head + queued) % Keyframes;
+        Keyframe& k = keyframes[slot];
+        k.mode = mode;
+        k.easing = easing;
+        k.durationMs = (uint32_t)payload[3] | ((uint32_t)payload[4] << 8) |
+                       ((uint32_t)payload[5] << 16) | ((uint32_t)payload[6] << 24);
+        k.start = start;
+        k.count = count;
+        k.continued = (mode == FADE_FRAME) && (flags & FADE_CONTINUED);
+        if (mode == FADE_FRAME) {
+            memcpy(target(slot), payload + HEADER_SIZE, count * 3);
+        } else {
+            k.fromLevel = payload[11];
+            k.toLevel = payload[12];
+        }
+        queued++;
+        return ERR_OK;
+    }
+
+    /**
+     * Queue a FADE_FRAME keyframe over pixels start..start+count-1 whose
+     * target colors come from getTarget(index, r&, g&, b&) rather than a
+     * packet (frames held on the device, such as recalled scenes). Returns
+     * ERR_OK or the error code to NAK with.
+     */
+    template <typename GetPixel>
+    uint8_t queueFrame(uint32_t durationMs, uint8_t easing, uint8_t flags,
+                       uint16_t start, uint16_t count, GetPixel getTarget) {
+        if (capacity == 0) return ERR_NOT_SUPPORTED;
+        if (easing > FADE_EASE_IN_OUT) return ERR_INVALID_PARAM;
+        if (count > capacity) return ERR_BUFFER_OVERFLOW;
+
+        if (flags & FADE_REPLACE) stop();
+        if (queued == Keyframes) return ERR_BUSY;
+
+        uint8_t slot = (head + queued) % Keyframes;
+        Keyframe& k = keyframes[slot];
+        k.mode = FADE_FRAME;
+        k.easing = easing;
+        k.durationMs = durationMs;
+        k.start = start;
+        k.count = count;
+        k.continued = false;
+        uint8_t* to = target(slot);
+        for (uint16_t i = 0; i < count; i++) {
+            getTarget(start + i, to[i * 3], to[i * 3 + 1], to[i * 3 + 2]);
+        }
+        queued++;
+        return ERR_OK;
+    }
+
+    // Drop the running and queued keyframes; the pixels keep their colors
+    void stop() {
+        queued = 0;
+        active = false;
+    }
+
+    /**
+     * Render the running keyframe through setPixel(index, r, g, b) if a
+     * frame is due, reading the starting colors through
+     * getPixel(index, r&, g&, b&) when a keyframe begins. Returns true when
+     * the caller should show the frame. The last frame of a keyframe is its
+     * exact target.
+     */
+    template <typename GetPixel, typename SetPixel>
+    bool update(uint32_t now, GetPixel getPixel, SetPixel setPixel) {
+        if (queued == 0) return false;
+        if (!active) {
+            if (keyframes[head].continued) return false;
+            begin(now, getPixel);
+        } else if ((int32_t)(now - nextFrame) < 0) {
+            return false;
+        }
+        nextFrame += 1000000UL / LTP_FADE_FPS;
+        if ((int32_t)(now - nextFrame) >= 0) nextFrame = now + 1000000UL / LTP_FADE_FPS;
+
+        usCarry += now - lastTick;
+        lastTick = now;
+        elapsedMs += usCarry / 1000;
+        usCarry %= 1000;
+
+        const Keyframe& k = keyframes[head];
+        bool done = elapsedMs >= k.durationMs;
+        uint32_t w = done ? 0x10000UL : ease(progress16(elapsedMs, k.durationMs), k.easing);
+        render(k, target(head), w, setPixel);
+        if (done) {
+            head = (head + 1) % Keyframes;
+            queued--;
+            active = false;
+        }
+        return true;
+    }
+
+    bool isRunning() const { return queued != 0; }
+
+    // update() would render a frame at now
+    bool due(uint32_t now) const {
+        if (queued == 0) return false;
+        if (!active) return !keyframes[head].continued;
+        return (int32_t)(now - nextFrame) >= 0;
+    }
+
+    // ANIM_STATUS extension: keyframes queued (running one included),
+    // queue capacity, the running keyframe's progress (0-65535) and the
+    // most pixels one keyframe can cover
+    uint16_t writeInfo(uint8_t* out) const {
+        uint16_t progress = 0;
+        if (active) progress = elapsedMs >= keyframes[head].durationMs ? 0xFFFF : progress16(elapsedMs, keyframes[head].durationMs);
+        out[0] = queued;
+        out[1] = Keyframes;
+        out[2] = progress & 0xFF;
+        out[3] = progress >> 8;
+        out[4] = capacity & 0xFF;
+        out[5] = capacity >> 8;
+        return INFO_SIZE;
+    }
+
+    static const uint8_t HEADER_SIZE = 9;
+    static const uint8_t INFO_SIZE = 6;
+    static const uint8_t BYTES_PER_PIXEL = 3 * (Keyframes + 1);
+
+private:
+    struct Keyframe {
+        uint32_t durationMs;
+        uint16_t start;
+        uint16_t count;
+        uint8_t mode;
+        uint8_t easing;
+        uint8_t fromLevel;
+        uint8_t toLevel;
+        bool continued;             // More of its targets still to come
+    };
+
+    Keyframe keyframes[Keyframes];
+    uint8_t* buffer;                // Keyframes' targets, then the starting colors
+    uint16_t capacity;              // Pixels the buffer holds
+    uint8_t head;
+    uint8_t queued;
+    bool active;                    // Head keyframe has begun
+    uint32_t elapsedMs;
+    uint32_t usCarry;
+    uint32_t lastTick;
+    uint32_t nextFrame;
+
+    uint8_t last() const { return (head + queued - 1) % Keyframes; }
+
+    uint8_t* target(uint8_t slot) const { return buffer + (uint32_t)slot * capacity * 3; }
+    uint8_t* startColors() const { return buffer + (uint32_t)Keyframes * capacity * 3; }
+
+    // Add the next part's targets to the last keyframe, which was flagged
+    // FADE_CONTINUED; any error drops the keyframe so the queue moves on
+    uint8_t append(uint8_t mode, const uint8_t* data, uint16_t start, uint16_t count,
+                   uint16_t pixelCount, uint8_t flags) {
+        Keyframe& k = keyframes[last()];
+        uint8_t err = ERR_OK;
+        if (mode != FADE_FRAME || start != k.start + k.count) err = ERR_INVALID_PARAM;
+        else if (start >= pixelCount || count > pixelCount - start) err = ERR_PIXEL_OVERFLOW;
+        else if (count > capacity - k.count) err = ERR_BUFFER_OVERFLOW;
+        if (err != ERR_OK) {
+            queued--;
+            return err;
+        }
+        memcpy(target(last()) + k.count * 3, data, count * 3);
+        k.count += count;
+        k.continued = flags & FADE_CONTINUED;
+        return ERR_OK;
+    }
+
+    template <typename GetPixel>
+    void begin(uint32_t now, GetPixel getPixel) {
+        const Keyframe& k = keyframes[head];
+        uint8_t* from = startColors();
+        for (uint16_t i = 0; i < k.count; i++) {
+            getPixel(k.start + i, from[i * 3], from[i * 3 + 1], from[i * 3 + 2]);
+        }
+        active = true;
+        elapsedMs = 0;
+        usCarry = 0;
+        lastTick = nextFrame = now;
+    }
+
+    template <typename SetPixel>
+    void render(const Keyframe& k, const uint8_t* to, uint32_t w, SetPixel setPixel) const {
+        const uint8_t* from = startColors();
+        uint32_t v = 0x10000UL - w;
+        if (k.mode == FADE_LEVEL) {
+            uint16_t level = ((uint32_t)k.fromLevel * v + (uint32_t)k.toLevel * w) >> 16;
+            for (uint16_t i = 0; i < k.count; i++) {
+                const uint8_t* c = from + i * 3;
+                setPixel(k.start + i, (c[0] * (level + 1)) >> 8, (c[1] * (level + 1)) >> 8, (c[2] * (level + 1)) >> 8);
+            }
+            return;
+        }
+        for (uint16_t i = 0; i < k.count; i++) {
+            const uint8_t* a = from + i * 3;
+            const uint8_t* b = to + i * 3;
+            setPixel(k.start + i,
+                     (a[0] * v + b[0] * w) >> 16,
+                     (a[1] * v + b[1] * w) >> 16,
+                     (a[2] * v + b[2] * w) >> 16);
+        }
+    }
+
+    // Elapsed part of the duration as 0-65535
+    static uint16_t progress16(uint32_t elapsed, uint32_t duration) {
+        while (duration > 0xFFFF) {
+            duration >>= 1;
+            elapsed >>= 1;
+        }
+        uint32_t p = (elapsed << 16) / duration;
+        return p > 0xFFFF ? 0xFFFF : p;
+    }
+
+    static uint16_t ease(uint16_t p, uint8_t easing) {
+        switch (easing) {
+            case FADE_EASE_IN:
+                return ((uint32_t)p * p) >> 16;
+            case FADE_EASE_OUT:
+                return 0xFFFF - (((uint32_t)(0xFFFF - p) * (0xFFFF - p)) >> 16);
+            case FADE_EASE_IN_OUT: {
+                // Smoothstep, 3p^2 - 2p^3
+                uint32_t p2 = ((uint32_t)p * p) >> 16;
+                return (p2 * ((3 * 0x10000UL - 2 * (uint32_t)p) >> 2)) >> 14;
+            }
+            default:
+                return p;
+        }
+    }
+};
+
+#endif // LTP_FADE_H
@@ -0,0 +1,139 @@
+/**
+ * LTP Serial Protocol v2 - Frame Latency Histograms
+ *
+ * micros() timestamps for each displayed frame, taken at:
+ *   first byte      START byte of the frame's first pixel or SHOW packet
+ *   checksum        that packet's checksum verified
+ *   handler done    last pixel handler before the show returned
+ *   show start/done around the LED driver's show()
+ *
+ * Receive-to-show latency (first byte to show done) and show duration are
+ * kept in fixed log2 histograms and reported through GET_INFO type
+ * INFO_LATENCY, so p50/p99 can be read from a running controller. Only
+ * frames started by a host packet have a receive-to-show latency; frames
+ * the device draws itself (animations, fades, shaders, scenes) count in
+ * the show duration histogram alone, as does the time of every show.
+ *
+ * The sketch calls packetStart()/packetDone() around processPacket() and
+ * showStart()/showDone() around every leds.show() that displays a frame.
+ */
+
+#ifndef LTP_LATENCY_H
+#define LTP_LATENCY_H
+
+#include <Arduino.h>
+#include "protocol.h"
+
+// Bucket 0 counts 0-1 us, bucket n counts 2^n to 2^(n+1)-1 us; the last
+// bucket also takes everything longer (>= 524 ms with 20 buckets)
+#ifndef LTP_LATENCY_BUCKETS
+#define LTP_LATENCY_BUCKETS 20
+#endif
+
+// Timestamps of one frame (micros())
+struct LtpFrameTiming {
+    uint32_t firstByte;
+    uint32_t checksum;
+    uint32_t handlerDone;
+    uint32_t showStart;
+    uint32_t showDone;
+};
+
+// Saturating log2 histogram of microsecond durations
+struct LtpHistogram {
+    uint16_t counts[LTP_LATENCY_BUCKETS];
+
+    void add(uint32_t us) {
+        uint8_t bucket = 0;
+        while (us > 1 && bucket < LTP_LATENCY_BUCKETS - 1) {
+            us >>= 1;
+            bucket++;
+        }
+        if (counts[bucket] != 0xFFFF) counts[bucket]++;
+    }
+};
+
+class LtpLatency {
+public:
+    LtpLatency() { clear(); }
+
+    void clear() {
+        memset(&receiveToShow, 0, sizeof(receiveToShow));
+        memset(&showTime, 0, sizeof(showTime));
+        memset(&last, 0, sizeof(last));
+        frames = 0;
+        pending = false;
+        inPacket = false;
+        packetCmd = 0;
+    }
+
+    // Before dispatching a received packet
+    void packetStart(const LtpPacket& pkt) {
+        inPacket = true;
+        packetCmd = pkt.cmd;
+        if (!pending && (isPixelCommand(pkt.cmd) || pkt.cmd == CMD_SHOW)) {
+            pending = true;
+            current.firstByte = pkt.firstByteMicros;
+            current.checksum = pkt.completeMicros;
+            current.handlerDone = pkt.completeMicros;
+        }
+    }
+
+    // After the packet's handler returned
+    void packetDone() {
+        inPacket = false;
+        if (pending && isPixelCommand(packetCmd)) current.handlerDone = micros();
+    }
+
+    void showStart() {
+        uint32_t now = micros();
+        if (pending && inPacket && isPixelCommand(packetCmd)) {
+            current.handlerDone = now;  // Auto-show from inside the handler
+        }
+        current.showStart = now;
+    }
+
+    // Frames not started by a host packet (a local effect) only add their
+    // show time
+    void showDone() {
+        current.showDone = micros();
+        showTime.add(current.showDone - current.showStart);
+        if (!pending) return;
+        receiveToShow.add(current.showDone - current.firstByte);
+        last = current;
+        frames++;
+        pending = false;
+    }
+
+    // INFO_LATENCY response: bucket count, frames, last frame offsets from
+    // its first byte, then both histograms. Returns the length written.
+    uint16_t writeInfo(uint8_t* out) const {
+        uint16_t n = 0;
+        out[n++] = LTP_LATENCY_BUCKETS;
+        n += putU32(out + n, frames);
+        n += putU32(out + n, last.checksum - last.firstByte);
+        n += putU32(out + n, last.handlerDone - last.firstByte);
+        n += putU32(out + n, last.showStart - last.firstByte);
+        n += putU32(out + n, last.showDone - last.firstByte);
+        for (uint8_t i = 0; i < LTP_LATENCY_BUCKETS; i++) n += putU16(out + n, receiveToShow.counts[i]);
+        for (uint8_t i = 0; i < LTP_LATENCY_BUCKETS; i++) n += putU16(out + n, showTime.counts[i]);
+        return n;
+    }
+
+    static const uint16_t INFO_SIZE = 21 + 4 * LTP_LATENCY_BUCKETS;
+
+    LtpHistogram receiveToShow;
+    LtpHistogram showTime;
+    LtpFrameTiming last;            // Last host frame
+    uint32_t frames;                // Host frames in receiveToShow
+
+private:
+    LtpFrameTiming current;
+    bool pending;       // A frame has started but not been shown
+    bool inPacket;
+    uint8_t packetCmd;
+
+    static bool isPixelCommand(uint8_t cmd) { return (cmd & 0xF0) == 0x30; }
+};
+
+#endif // LTP_LATENCY_H
@@ -9,6 +9,7 @@
 
 #include <Arduino.h>
 #include "protocol.h"
+#include "profile.h"
 
 class LedDriver {
 public:
@@ -27,12 +28,31 @@ public:
     // Push pixel buffer to LEDs
     virtual void show() = 0;
 
+    // Lay the strip out again as count pixels, cleared. Drivers that need
+    // storage take it from the caller (the sketch's arena, arena.h), at
+    // least the storageBytes(count) the driver class declares, and have no
+    // pixels without it; the rest keep their own and ignore it.
+    virtual void setStorage(uint8_t* storage, uint16_t count) {
+        numPixels = count;
+        clear();
+    }
+
     // Get pixel buffer for direct manipulation
     virtual uint8_t* getPixelBuffer() = 0;
 
+    // Copy count pixels from start in the buffer's native byte format (for
+    // GET_PIXELS); drivers that keep no such buffer expand their own storage
+    virtual void readBuffer(uint16_t start, uint16_t count, uint8_t* out) {
+        memcpy(out, getPixelBuffer() + start * bytesPerPixel, count * bytesPerPixel);
+    }
+
     // Set a single pixel (RGB order, driver converts internally)
     virtual void setPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b) = 0;
 
+    // Read a pixel back in RGB order, brightness scaling undone (to the
+    // nearest value; chips with fewer bits per channel lose the low bits)
+    virtual void getPixel(uint16_t index, uint8_t& r, uint8_t& g, uint8_t& b) = 0;
+
     // Set a single pixel with white channel (RGBW strips)
     virtual void setPixelW(uint16_t index, uint8_t r, uint8_t g, uint8_t b, uint8_t w) {
         setPixel(index, r, g, b); // Default: ignore white
@@ -82,6 +102,13 @@ protected:
     uint8_t scale8(uint8_t value) const {
         return ((uint16_t)value * (uint16_t)(brightness + 1)) >> 8;
     }
+
+    // Inverse of scale8(), for reading pixels back
+    uint8_t unscale8(uint8_t value) const {
+        if (brightness == 255) return value;
+        uint16_t v = ((uint16_t)value * 256 + brightness / 2) / (brightness + 1);
+        return v > 255 ? 255 : v;
+    }
 };
 
 #endif // LTP_LED_DRIVER_H
@@ -26,33 +26,37 @@ public:
     /**
      * Constructor
      * @param numPixels Number of LEDs in the strip
+     * @param storage storageBytes(numPixels) bytes for the pixels, which
+     *        must outlive the driver (nullptr: no pixels)
      * @param dataPin MOSI pin
      * @param clockPin SCK pin
      * @param useHardwareSPI Use hardware SPI (faster) or bit-bang
      */
-    LedDriverAPA102(uint16_t numPixels, uint8_t dataPin = 11, uint8_t clockPin = 13, bool useHardwareSPI = true)
+    LedDriverAPA102(uint16_t numPixels, uint8_t* storage, uint8_t dataPin = 11, uint8_t clockPin = 13,
+                    bool useHardwareSPI = true)
         : LedDriver(numPixels, COLOR_RGB)  // We'll handle BGR conversion internally
         , dataPin(dataPin)
         , clockPin(clockPin)
         , useHardwareSPI(useHardwareSPI)
         , pixelBuffer(nullptr)
     {
-        // 4 bytes per pixel: brightness + B + G + R
-        pixelBuffer = new uint8_t[numPixels * 4];
-        if (pixelBuffer) {
-            // Initialize with brightness byte set (0xE0 = max brightness prefix)
-            for (uint16_t i = 0; i < numPixels; i++) {
-                pixelBuffer[i * 4] = 0xE0 | 31; // Global brightness = 31 (max)
-                pixelBuffer[i * 4 + 1] = 0;     // B
-                pixelBuffer[i * 4 + 2] = 0;     // G
-                pixelBuffer[i * 4 + 3] = 0;     // R
-            }
-        }
+        setStorage(storage, numPixels);
     }
 
-    ~LedDriverAPA102() {
-        if (pixelBuffer) {
-            delete[] pixelBuffer;
+    // 4 bytes per pixel: brightness + B + G + R
+    static constexpr uint32_t storageBytes(uint16_t count) {
+        return count * 4UL;
+    }
+
+    void setStorage(uint8_t* storage, uint16_t count) override {
+        pixelBuffer = storage;
+        numPixels = storage ? count : 0;
+        // Initialize with brightness byte set (0xE0 = max brightness prefix)
+        for (uint16_t i = 0; i < numPixels; i++) {
+            pixelBuffer[i * 4] = 0xE0 | 31; // Global brightness = 31 (max)
+            pixelBuffer[i * 4 + 1] = 0;     // B
+            pixelBuffer[i * 4 + 2] = 0;     // G
+            pixelBuffer[i * 4 + 3] = 0;     // R
         }
     }
 
@@ -71,6 +75,7 @@ public:
     }
 
     void show() override {
+        LTP_PROFILE_SCOPE(PROF_DRIVER_SHOW);
         if (!pixelBuffer) return;
 
         // Start frame: 32 bits of zeros
@@ -111,6 +116,16 @@ public:
         pixelBuffer[offset + 3] = scale8(r);
     }
 
+    void getPixel(uint16_t index, uint8_t& r, uint8_t& g, uint8_t& b) override {
+        r = g = b = 0;
+        if (index >= numPixels || !pixelBuffer) return;
+
+        uint16_t offset = index * 4;
+        b = unscale8(pixelBuffer[offset + 1]);
+        g = unscale8(pixelBuffer[offset + 2]);
+        r = unscale8(pixelBuffer[offset + 3]);
+    }
+
     void clear() override {
         if (!pixelBuffer) return;
         for (uint16_t i = 0; i < numPixels; i++) {
@@ -23,28 +23,32 @@ public:
     /**
      * Constructor for hardware SPI
      * @param numPixels Number of LEDs in the strip
+     * @param storage storageBytes(numPixels) bytes for the pixels, which
+     *        must outlive the driver (nullptr: no pixels)
      * @param dataPin MOSI pin (usually 11 on Uno, 51 on Mega)
      * @param clockPin SCK pin (usually 13 on Uno, 52 on Mega)
      * @param useHardwareSPI Use hardware SPI (faster) or bit-bang
      */
-    LedDriverLPD8806(uint16_t numPixels, uint8_t dataPin = 11, uint8_t clockPin = 13, bool useHardwareSPI = true)
+    LedDriverLPD8806(uint16_t numPixels, uint8_t* storage, uint8_t dataPin = 11, uint8_t clockPin = 13,
+                     bool useHardwareSPI = true)
         : LedDriver(numPixels, COLOR_GRB)
         , dataPin(dataPin)
         , clockPin(clockPin)
         , useHardwareSPI(useHardwareSPI)
         , pixelBuffer(nullptr)
     {
-        // Allocate pixel buffer (3 bytes per pixel for GRB)
-        pixelBuffer = new uint8_t[numPixels * 3];
-        if (pixelBuffer) {
-            memset(pixelBuffer, 0x80, numPixels * 3); // LPD8806 off = 0x80
-        }
+        setStorage(storage, numPixels);
     }
 
-    ~LedDriverLPD8806() {
-        if (pixelBuffer) {
-            delete[] pixelBuffer;
-        }
+    // 3 bytes per pixel for GRB
+    static constexpr uint32_t storageBytes(uint16_t count) {
+        return count * 3UL;
+    }
+
+    void setStorage(uint8_t* storage, uint16_t count) override {
+        pixelBuffer = storage;
+        numPixels = storage ? count : 0;
+        clear();
     }
 
     void begin() override {
@@ -65,6 +69,7 @@ public:
     }
 
     void show() override {
+        LTP_PROFILE_SCOPE(PROF_DRIVER_SHOW);
         if (!pixelBuffer) return;
 
         if (useHardwareSPI) {
@@ -97,6 +102,16 @@ public:
         pixelBuffer[offset + 2] = 0x80 | (scale8(b) >> 1); // B
     }
 
+    void getPixel(uint16_t index, uint8_t& r, uint8_t& g, uint8_t& b) override {
+        r = g = b = 0;
+        if (index >= numPixels || !pixelBuffer) return;
+
+        uint16_t offset = index * 3;
+        g = unscale8(expand7(pixelBuffer[offset + 0]));
+        r = unscale8(expand7(pixelBuffer[offset + 1]));
+        b = unscale8(expand7(pixelBuffer[offset + 2]));
+    }
+
     void clear() override {
         if (!pixelBuffer) return;
         // LPD8806 "off" is 0x80 (high bit set, value 0)
@@ -113,6 +128,12 @@ private:
     bool useHardwareSPI;
     uint8_t* pixelBuffer;
 
+    // 7-bit channel back to 8 bits (0x7F -> 0xFF)
+    static uint8_t expand7(uint8_t v) {
+        v &= 0x7F;
+        return (v << 1) | (v >> 6);
+    }
+
     void writeByte(uint8_t b) {
         // Bit-bang SPI, MSB first
         for (uint8_t bit = 0x80; bit; bit >>= 1) {
@@ -0,0 +1,287 @@
+/**
+ * LTP Serial Protocol v2 - LPD8806 Palette LED Driver
+ *
+ * LPD8806 driver that stores a palette index per pixel instead of three
+ * color bytes, for strips longer than an RGB buffer fits in RAM: 4-bit
+ * indices take half a byte per pixel (about 1,500 pixels in the ~750 bytes
+ * an Uno has left beside its packet buffer and state), 8-bit indices one
+ * byte. Colors come from a palette of Colors entries held
+ * in the chip's native GRB bytes and are expanded only while show()
+ * streams the strip out, so a palette change (or rotate()) recolors every
+ * pixel using it without a single pixel write.
+ *
+ * setPixel() stores the palette entry nearest the color (exact matches
+ * first), so every command that draws RGB still works, quantized to the
+ * palette; setIndex() writes an index directly. Entries take the
+ * brightness when they are set, as the RGB driver's pixels do. There is no
+ * raw pixel buffer: getPixelBuffer() returns nullptr, and readBuffer()
+ * expands the native bytes for readback. The indices live in storage the
+ * caller provides (storageBytes()); the palette is part of the driver.
+ *
+ * The default palette is black, white, then hues around the color wheel.
+ */
+
+#ifndef LTP_LED_DRIVER_LPD8806_PALETTE_H
+#define LTP_LED_DRIVER_LPD8806_PALETTE_H
+
+#include "led_driver.h"
+#include <SPI.h>
+
+template <uint8_t Bits, uint16_t Colors = (1 << Bits)>
+class LedDriverLPD8806Palette : public LedDriver {
+public:
+    static_assert(Bits == 4 || Bits == 8, "Palette indices are 4 or 8 bits");
+    static_assert(Colors >= 2 && Colors <= (1 << Bits), "Colors must fit the index width");
+
+    static const uint8_t INDEX_BITS = Bits;
+    static const uint16_t PALETTE_COLORS = Colors;
+
+    LedDriverLPD8806Palette(uint16_t numPixels, uint8_t* storage, uint8_t dataPin = 11, uint8_t clockPin = 13,
+                            bool useHardwareSPI = true)
+        : LedDriver(numPixels, COLOR_GRB)
+        , dataPin(dataPin)
+        , clockPin(clockPin)
+        , useHardwareSPI(useHardwareSPI)
+        , indices(nullptr)
+    {
+        uint8_t* c = palette;
+        for (uint16_t e = 0; e < Colors; e++, c += 3) {
+            uint8_t r, g, b;
+            defaultColor(e, r, g, b);
+            toNative(c, r, g, b);
+        }
+        setStorage(storage, numPixels);
+    }
+
+    // Index bytes for count pixels
+    static constexpr uint32_t storageBytes(uint16_t count) {
+        return Bits == 8 ? count : (count + 1UL) / 2;
+    }
+
+    // Every pixel starts at entry 0 (black unless it was changed)
+    void setStorage(uint8_t* storage, uint16_t count) override {
+        indices = storage;
+        numPixels = storage ? count : 0;
+        if (indices) memset(indices, 0, indexBytes());
+    }
+
+    void begin() override {
+        if (useHardwareSPI) {
+            SPI.begin();
+            SPI.setBitOrder(MSBFIRST);
+            SPI.setDataMode(SPI_MODE0);
+            SPI.setClockDivider(SPI_CLOCK_DIV8); // 2 MHz on 16 MHz Arduino
+        } else {
+            pinMode(dataPin, OUTPUT);
+            pinMode(clockPin, OUTPUT);
+            digitalWrite(dataPin, LOW);
+            digitalWrite(clockPin, LOW);
+        }
+        writeLatch();
+    }
+
+    void show() override {
+        LTP_PROFILE_SCOPE(PROF_DRIVER_SHOW);
+        if (!indices) return;
+
+        for (uint16_t i = 0; i < numPixels; i++) {
+            const uint8_t* c = palette + getIndex(i) * 3;
+            writeByte3(c);
+        }
+        writeLatch();
+    }
+
+    uint8_t* getPixelBuffer() override {
+        return nullptr;
+    }
+
+    void readBuffer(uint16_t start, uint16_t count, uint8_t* out) override {
+        for (uint16_t i = start; i < start + count; i++, out += 3) {
+            memcpy(out, palette + getIndex(i) * 3, 3);
+        }
+    }
+
+    void setPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b) override {
+        if (index >= numPixels || !indices) return;
+        setIndex(index, nearest(r, g, b));
+    }
+
+    void getPixel(uint16_t index, uint8_t& r, uint8_t& g, uint8_t& b) override {
+        r = g = b = 0;
+        if (index >= numPixels || !indices) return;
+        getPaletteColor(getIndex(index), r, g, b);
+    }
+
+    void clear() override {
+        fill(0, 0, 0);
+    }
+
+    void fill(uint8_t r, uint8_t g, uint8_t b) override {
+        if (!indices) return;
+        uint8_t e = nearest(r, g, b);
+        memset(indices, Bits == 4 ? e * 0x11 : e, indexBytes());
+    }
+
+    // Palette entry of a pixel; 4-bit indices pack the even pixel in the
+    // high nibble
+    uint8_t getIndex(uint16_t index) const {
+        if (Bits == 8) return indices[index];
+        uint8_t packed = indices[index >> 1];
+        return index & 1 ? packed & 0x0F : packed >> 4;
+    }
+
+    void setIndex(uint16_t index, uint8_t entry) {
+        if (index >= numPixels || !indices || entry >= Colors) return;
+        if (Bits == 8) {
+            indices[index] = entry;
+        } else if (index & 1) {
+            indices[index >> 1] = (indices[index >> 1] & 0xF0) | entry;
+        } else {
+            indices[index >> 1] = (indices[index >> 1] & 0x0F) | (entry << 4);
+        }
+    }
+
+    void setPaletteColor(uint16_t entry, uint8_t r, uint8_t g, uint8_t b) {
+        if (entry >= Colors) return;
+        toNative(palette + entry * 3, r, g, b);
+    }
+
+    void getPaletteColor(uint16_t entry, uint8_t& r, uint8_t& g, uint8_t& b) const {
+        r = g = b = 0;
+        if (entry >= Colors) return;
+        const uint8_t* c = palette + entry * 3;
+        g = unscale8(expand7(c[0]));
+        r = unscale8(expand7(c[1]));
+        b = unscale8(expand7(c[2]));
+    }
+
+    /**
+     * Rotate entries first to first + count - 1 by steps: entry e takes the
+     * color entry e - steps had, wrapping within the range.
+     */
+    void rotate(uint16_t first, uint16_t count, int16_t steps) {
+        if (first >= Colors || count < 2) return;
+        if (count > Colors - first) count = Colors - first;
+        int16_t k = steps % (int16_t)count;
+        if (k < 0) k += count;
+        if (k == 0) return;
+        // Right rotation by k as three reversals
+        uint8_t* base = palette + first * 3;
+        reverse(base, 0, count);
+        reverse(base, 0, k);
+        reverse(base, k, count);
+    }
+
+    // Entry closest to a color (sum of channel differences on the wire)
+    uint8_t nearest(uint8_t r, uint8_t g, uint8_t b) const {
+        uint8_t want[3];
+        toNative(want, r, g, b);
+        uint16_t best = 0;
+        uint16_t bestDist = 0xFFFF;
+        const uint8_t* c = palette;
+        for (uint16_t e = 0; e < Colors; e++, c += 3) {
+            uint16_t dist = absDiff(c[0], want[0]) + absDiff(c[1], want[1]) + absDiff(c[2], want[2]);
+            if (dist < bestDist) {
+                bestDist = dist;
+                best = e;
+                if (dist == 0) break;
+            }
+        }
+        return best;
+    }
+
+    uint8_t getLedType() const override {
+        return LED_TYPE_LPD8806;
+    }
+
+    uint16_t indexBytes() const {
+        return storageBytes(numPixels);
+    }
+
+private:
+    uint8_t dataPin;
+    uint8_t clockPin;
+    bool useHardwareSPI;
+    uint8_t* indices;
+    uint8_t palette[Colors * 3];    // Native GRB bytes, brightness applied
+
+    void writeByte3(const uint8_t* c) {
+        if (useHardwareSPI) {
+            SPI.transfer(c[0]);
+            SPI.transfer(c[1]);
+            SPI.transfer(c[2]);
+        } else {
+            writeByte(c[0]);
+            writeByte(c[1]);
+            writeByte(c[2]);
+        }
+    }
+
+    // Brightness-scaled 7-bit GRB with the high bit set, as the chip takes it
+    void toNative(uint8_t* c, uint8_t r, uint8_t g, uint8_t b) const {
+        c[0] = 0x80 | (scale8(g) >> 1);
+        c[1] = 0x80 | (scale8(r) >> 1);
+        c[2] = 0x80 | (scale8(b) >> 1);
+    }
+
+    // 7-bit channel back to 8 bits (0x7F -> 0xFF)
+    static uint8_t expand7(uint8_t v) {
+        v &= 0x7F;
+        return (v << 1) | (v >> 6);
+    }
+
+    void writeByte(uint8_t b) {
+        // Bit-bang SPI, MSB first
+        for (uint8_t bit = 0x80; bit; bit >>= 1) {
+            digitalWrite(dataPin, (b & bit) ? HIGH : LOW);
+            digitalWrite(clockPin, HIGH);
+            digitalWrite(clockPin, LOW);
+        }
+    }
+
+    void writeLatch() {
+        // LPD8806 needs (numPixels + 31) / 32 zero bytes as latch
+        uint16_t latchBytes = (numPixels + 31) / 32;
+        for (uint16_t i = 0; i < latchBytes; i++) {
+            if (useHardwareSPI) SPI.transfer(0);
+            else writeByte(0);
+        }
+    }
+
+    static uint8_t absDiff(uint8_t a, uint8_t b) {
+        return a > b ? a - b : b - a;
+    }
+
+    // Reverse entries [from, to) of a 3-byte-per-entry table
+    static void reverse(uint8_t* table, uint16_t from, uint16_t to) {
+        while (from + 1 < to) {
+            to--;
+            for (uint8_t k = 0; k < 3; k++) {
+                uint8_t t = table[from * 3 + k];
+                table[from * 3 + k] = table[to * 3 + k];
+                table[to * 3 + k] = t;
+            }
+            from++;
+        }
+    }
+
+    // Black, white, then full-saturation hues evenly around the wheel
+    static void defaultColor(uint16_t entry, uint8_t& r, uint8_t& g, uint8_t& b) {
+        if (entry < 2) {
+            r = g = b = entry ? 255 : 0;
+            return;
+        }
+        uint16_t hue = (uint32_t)(entry - 2) * 1536 / (Colors - 2);   // 6 segments of 256
+        uint8_t x = hue & 0xFF;
+        switch (hue >> 8) {
+            case 0:  r = 255;     g = x;       b = 0;       break;
+            case 1:  r = 255 - x; g = 255;     b = 0;       break;
+            case 2:  r = 0;       g = 255;     b = x;       break;
+            case 3:  r = 0;       g = 255 - x; b = 255;     break;
+            case 4:  r = x;       g = 0;       b = 255;     break;
+            default: r = 255;     g = 0;       b = 255 - x; break;
+        }
+    }
+};
+
+#endif // LTP_LED_DRIVER_LPD8806_PALETTE_H
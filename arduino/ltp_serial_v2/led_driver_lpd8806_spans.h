@@ -0,0 +1,384 @@
+/**
+ * LTP Serial Protocol v2 - LPD8806 Display-List LED Driver
+ *
+ * LPD8806 driver with no pixel buffer: the strip is a list of up to
+ * MaxSpans spans, each a run of pixels drawn as one primitive, and show()
+ * computes every pixel from its span while clocking it out. RAM is set by
+ * the span count (23 bytes each on AVR, in storage the caller provides:
+ * storageBytes()), not the strip length, so long
+ * architectural runs of blocky content fit a small MCU; show() costs the
+ * same per pixel as the RGB driver, plus one step per span.
+ *
+ *   SPAN_SOLID    one color (PIXEL_SET_ALL, PIXEL_SET_RANGE, setPixel())
+ *   SPAN_RAMP     color 0 stepping toward color 1, one segment of a
+ *                 PIXEL_FILL gradient, interpolated as fill.h does
+ *   SPAN_PATTERN  up to PATTERN_COLORS colors, width pixels each, repeated
+ *
+ * Spans are kept sorted and never overlap: a new span trims or splits the
+ * ones beneath it, and solid spans merge with equal neighbours, so
+ * setPixel() writes of blocky content collapse into a few runs. Pixels no
+ * span covers are black. A write that needs more spans than are free is
+ * dropped and counted (droppedSpans()); per-pixel content such as a rainbow
+ * does not fit.
+ *
+ * Spans keep RGB and brightness is applied as show() sends them, so a
+ * brightness change recolors everything at the next show. There is no raw
+ * pixel buffer: getPixelBuffer() returns nullptr, and readBuffer()
+ * computes the native bytes for readback.
+ */
+
+#ifndef LTP_LED_DRIVER_LPD8806_SPANS_H
+#define LTP_LED_DRIVER_LPD8806_SPANS_H
+
+#include "led_driver.h"
+#include "fill.h"
+#include <SPI.h>
+
+#define SPAN_SOLID          0
+#define SPAN_RAMP           1
+#define SPAN_PATTERN        2
+
+template <uint8_t MaxSpans>
+class LedDriverLPD8806Spans : public LedDriver {
+public:
+    static const uint8_t MAX_SPANS = MaxSpans;
+    static const uint8_t PATTERN_COLORS = 4;
+
+    struct Span {
+        uint16_t start;             // First pixel
+        uint16_t end;               // One past the last pixel
+        uint16_t origin;            // First pixel as drawn, before trimming
+        uint16_t length;            // Ramp: pixels as drawn; pattern: phase at origin
+        uint8_t type;
+        uint8_t width;              // Pattern: pixels per color
+        uint8_t colors;             // Pattern: entries of c used
+        uint8_t c[PATTERN_COLORS][3];
+    };
+
+    LedDriverLPD8806Spans(uint16_t numPixels, uint8_t* storage, uint8_t dataPin = 11, uint8_t clockPin = 13,
+                          bool useHardwareSPI = true)
+        : LedDriver(numPixels, COLOR_GRB)
+        , dataPin(dataPin)
+        , clockPin(clockPin)
+        , useHardwareSPI(useHardwareSPI)
+        , spans(nullptr)
+        , capacity(0)
+        , count(0)
+        , dropped(0)
+    {
+        setStorage(storage, numPixels);
+    }
+
+    // The span table, whatever the strip length
+    static constexpr uint32_t storageBytes(uint16_t pixels) {
+        return MaxSpans * (uint32_t)sizeof(Span);
+    }
+
+    void setStorage(uint8_t* storage, uint16_t n) override {
+        spans = reinterpret_cast<Span*>(storage);
+        capacity = storage ? MaxSpans : 0;
+        numPixels = storage ? n : 0;
+        count = 0;
+    }
+
+    void begin() override {
+        if (useHardwareSPI) {
+            SPI.begin();
+            SPI.setBitOrder(MSBFIRST);
+            SPI.setDataMode(SPI_MODE0);
+            SPI.setClockDivider(SPI_CLOCK_DIV8); // 2 MHz on 16 MHz Arduino
+        } else {
+            pinMode(dataPin, OUTPUT);
+            pinMode(clockPin, OUTPUT);
+            digitalWrite(dataPin, LOW);
+            digitalWrite(clockPin, LOW);
+        }
+        writeLatch();
+    }
+
+    void show() override {
+        LTP_PROFILE_SCOPE(PROF_DRIVER_SHOW);
+        static const uint8_t BLACK[3] = { 0x80, 0x80, 0x80 };
+        uint16_t i = 0;
+        for (uint8_t s = 0; s < count; s++) {
+            const Span& span = spans[s];
+            for (; i < span.start; i++) writeNative(BLACK);
+            writeSpan(span);
+            i = span.end;
+        }
+        for (; i < numPixels; i++) writeNative(BLACK);
+        writeLatch();
+    }
+
+    uint8_t* getPixelBuffer() override {
+        return nullptr;
+    }
+
+    void readBuffer(uint16_t start, uint16_t n, uint8_t* out) override {
+        for (uint16_t i = start; i < start + n; i++, out += 3) {
+            uint8_t r, g, b;
+            getPixel(i, r, g, b);
+            toNative(out, r, g, b);
+        }
+    }
+
+    void setPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b) override {
+        uint8_t c[3] = { r, g, b };
+        solid(index, index + 1, c);
+    }
+
+    void getPixel(uint16_t index, uint8_t& r, uint8_t& g, uint8_t& b) override {
+        r = g = b = 0;
+        const Span* span = find(index);
+        if (!span) return;
+        uint8_t c[3];
+        colorAt(*span, index, c);
+        r = c[0];
+        g = c[1];
+        b = c[2];
+    }
+
+    void clear() override {
+        count = 0;
+    }
+
+    void fill(uint8_t r, uint8_t g, uint8_t b) override {
+        count = 0;
+        fillRange(0, numPixels, r, g, b);
+    }
+
+    void fillRange(uint16_t start, uint16_t end, uint8_t r, uint8_t g, uint8_t b) override {
+        uint8_t c[3] = { r, g, b };
+        solid(start, end, c);
+    }
+
+    uint8_t getLedType() const override {
+        return LED_TYPE_LPD8806;
+    }
+
+    // Primitives, as LtpFill::draw() hands them over
+
+    void solid(uint16_t start, uint16_t end, const uint8_t* c) {
+        Span span = make(SPAN_SOLID, start, end);
+        memcpy(span.c[0], c, 3);
+        paint(span);
+    }
+
+    void ramp(uint16_t start, uint16_t end, const uint8_t* c0, const uint8_t* c1) {
+        Span span = make(SPAN_RAMP, start, end);
+        span.length = end - start;
+        memcpy(span.c[0], c0, 3);
+        memcpy(span.c[1], c1, 3);
+        paint(span);
+    }
+
+    void pattern(uint16_t start, uint16_t end, uint8_t width, uint16_t phase,
+                 const uint8_t* table, uint16_t colors) {
+        if (colors > PATTERN_COLORS) {
+            // Too many colors for one span: a solid span per run
+            uint16_t c = phase / width;
+            uint16_t run = width - phase % width;
+            for (uint16_t i = start; i < end; i += run, run = width) {
+                solid(i, end - i > run ? i + run : end, table + c * 3);
+                if (++c == colors) c = 0;
+            }
+            return;
+        }
+        Span span = make(SPAN_PATTERN, start, end);
+        span.length = phase;
+        span.width = width;
+        span.colors = colors;
+        memcpy(span.c, table, colors * 3);
+        paint(span);
+    }
+
+    // Spans in use, and by type
+    uint8_t spanCount() const {
+        return count;
+    }
+
+    uint8_t spanCount(uint8_t type) const {
+        uint8_t n = 0;
+        for (uint8_t s = 0; s < count; s++) n += spans[s].type == type;
+        return n;
+    }
+
+    // Spans dropped for lack of room
+    uint32_t droppedSpans() const {
+        return dropped;
+    }
+
+    void clearDropped() {
+        dropped = 0;
+    }
+
+private:
+    uint8_t dataPin;
+    uint8_t clockPin;
+    bool useHardwareSPI;
+    Span* spans;                    // Sorted by start, not overlapping
+    uint8_t capacity;               // MaxSpans, or 0 without storage
+    uint8_t count;
+    uint32_t dropped;
+
+    Span make(uint8_t type, uint16_t start, uint16_t end) const {
+        Span span;
+        memset(&span, 0, sizeof(span));
+        span.type = type;
+        span.start = span.origin = start;
+        span.end = end < numPixels ? end : numPixels;
+        return span;
+    }
+
+    static bool sameSolid(const Span& a, const Span& b) {
+        return a.type == SPAN_SOLID && b.type == SPAN_SOLID && memcmp(a.c[0], b.c[0], 3) == 0;
+    }
+
+    // Lay span over the list: the spans it covers are trimmed, split or
+    // removed, then equal solid neighbours merged
+    void paint(const Span& span) {
+        if (span.start >= span.end) return;
+
+        // Spans lo to hi - 1 overlap the new one
+        uint8_t lo = 0;
+        while (lo < count && spans[lo].end <= span.start) lo++;
+        uint8_t hi = lo;
+        while (hi < count && spans[hi].start < span.end) hi++;
+
+        // Already drawn, as when an animation rewrites a solid run
+        if (hi == lo + 1 && sameSolid(spans[lo], span) &&
+            spans[lo].start <= span.start && spans[lo].end >= span.end) return;
+
+        bool left = lo < hi && spans[lo].start < span.start;
+        bool right = lo < hi && spans[hi - 1].end > span.end;
+        uint8_t replace = left + 1 + right;
+        if (count - (hi - lo) + replace > capacity) {
+            dropped++;
+            return;
+        }
+
+        Span rest = span;
+        if (right) {
+            rest = spans[hi - 1];
+            rest.start = span.end;
+        }
+        if (left) spans[lo].end = span.start;
+        memmove(&spans[lo + replace], &spans[hi], (count - hi) * sizeof(Span));
+        count = count - (hi - lo) + replace;
+        uint8_t at = lo + left;
+        spans[at] = span;
+        if (right) spans[at + 1] = rest;
+
+        if (at + 1 < count && spans[at + 1].start == span.end && sameSolid(spans[at], spans[at + 1])) {
+            spans[at].end = spans[at + 1].end;
+            remove(at + 1);
+        }
+        if (at > 0 && spans[at - 1].end == span.start && sameSolid(spans[at - 1], spans[at])) {
+            spans[at - 1].end = spans[at].end;
+            remove(at);
+        }
+    }
+
+    void remove(uint8_t s) {
+        memmove(&spans[s], &spans[s + 1], (count - s - 1) * sizeof(Span));
+        count--;
+    }
+
+    const Span* find(uint16_t index) const {
+        uint8_t lo = 0, hi = count;
+        while (lo < hi) {
+            uint8_t mid = (lo + hi) / 2;
+            if (spans[mid].end <= index) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo < count && spans[lo].start <= index ? &spans[lo] : nullptr;
+    }
+
+    // Pattern entry and pixels left in it at index
+    static void patternAt(const Span& span, uint16_t index, uint8_t& entry, uint8_t& left) {
+        uint32_t p = ((uint32_t)span.length + (index - span.origin)) % ((uint16_t)span.width * span.colors);
+        entry = p / span.width;
+        left = span.width - p % span.width;
+    }
+
+    void colorAt(const Span& span, uint16_t index, uint8_t* c) const {
+        if (span.type == SPAN_RAMP) {
+            int32_t acc[3], step[3];
+            LtpFill::rampStart(span.c[0], span.c[1], span.length, index - span.origin, acc, step);
+            for (uint8_t k = 0; k < 3; k++) c[k] = acc[k] >> 16;
+        } else if (span.type == SPAN_PATTERN) {
+            uint8_t entry, left;
+            patternAt(span, index, entry, left);
+            memcpy(c, span.c[entry], 3);
+        } else {
+            memcpy(c, span.c[0], 3);
+        }
+    }
+
+    void writeSpan(const Span& span) {
+        uint8_t n[3];
+        if (span.type == SPAN_SOLID) {
+            toNative(n, span.c[0][0], span.c[0][1], span.c[0][2]);
+            for (uint16_t i = span.start; i < span.end; i++) writeNative(n);
+        } else if (span.type == SPAN_RAMP) {
+            int32_t acc[3], step[3];
+            LtpFill::rampStart(span.c[0], span.c[1], span.length, span.start - span.origin, acc, step);
+            for (uint16_t i = span.start; i < span.end; i++) {
+                toNative(n, acc[0] >> 16, acc[1] >> 16, acc[2] >> 16);
+                writeNative(n);
+                for (uint8_t k = 0; k < 3; k++) acc[k] += step[k];
+            }
+        } else {
+            uint8_t entry, left;
+            patternAt(span, span.start, entry, left);
+            toNative(n, span.c[entry][0], span.c[entry][1], span.c[entry][2]);
+            for (uint16_t i = span.start; i < span.end; i++) {
+                writeNative(n);
+                if (--left == 0) {
+                    if (++entry == span.colors) entry = 0;
+                    left = span.width;
+                    toNative(n, span.c[entry][0], span.c[entry][1], span.c[entry][2]);
+                }
+            }
+        }
+    }
+
+    // Brightness-scaled 7-bit GRB with the high bit set, as the chip takes it
+    void toNative(uint8_t* n, uint8_t r, uint8_t g, uint8_t b) const {
+        n[0] = 0x80 | (scale8(g) >> 1);
+        n[1] = 0x80 | (scale8(r) >> 1);
+        n[2] = 0x80 | (scale8(b) >> 1);
+    }
+
+    void writeNative(const uint8_t* n) {
+        if (useHardwareSPI) {
+            SPI.transfer(n[0]);
+            SPI.transfer(n[1]);
+            SPI.transfer(n[2]);
+        } else {
+            writeByte(n[0]);
+            writeByte(n[1]);
+            writeByte(n[2]);
+        }
+    }
+
+    void writeByte(uint8_t b) {
+        // Bit-bang SPI, MSB first
+        for (uint8_t bit = 0x80; bit; bit >>= 1) {
+            digitalWrite(dataPin, (b & bit) ? HIGH : LOW);
+            digitalWrite(clockPin, HIGH);
+            digitalWrite(clockPin, LOW);
+        }
+    }
+
+    void writeLatch() {
+        // LPD8806 needs (numPixels + 31) / 32 zero bytes as latch
+        uint16_t latchBytes = (numPixels + 31) / 32;
+        for (uint16_t i = 0; i < latchBytes; i++) {
+            if (useHardwareSPI) SPI.transfer(0);
+            else writeByte(0);
+        }
+    }
+};
+
+#endif // LTP_LED_DRIVER_LPD8806_SPANS_H
@@ -29,14 +29,25 @@ public:
     /**
      * Constructor
      * @param numPixels Number of LEDs in the strip
+     * @param storage Unused: the NeoPixel library allocates its own buffer
      * @param pin Data pin
      * @param type NeoPixel type (NEO_GRB + NEO_KHZ800 for WS2812B)
      */
-    LedDriverWS2812(uint16_t numPixels, uint8_t pin, neoPixelType type = NEO_GRB + NEO_KHZ800)
+    LedDriverWS2812(uint16_t numPixels, uint8_t* storage, uint8_t pin, neoPixelType type = NEO_GRB + NEO_KHZ800)
         : LedDriver(numPixels, COLOR_GRB)
         , strip(numPixels, pin, type)
     {}
 
+    static constexpr uint32_t storageBytes(uint16_t count) {
+        return 0;
+    }
+
+    void setStorage(uint8_t* storage, uint16_t count) override {
+        strip.updateLength(count);
+        numPixels = strip.numPixels();
+        strip.clear();
+    }
+
     void begin() override {
         strip.begin();
         strip.clear();
@@ -44,6 +55,7 @@ public:
     }
 
     void show() override {
+        LTP_PROFILE_SCOPE(PROF_DRIVER_SHOW);
         strip.setBrightness(brightness);
         strip.show();
     }
@@ -58,6 +70,14 @@ public:
         }
     }
 
+    void getPixel(uint16_t index, uint8_t& r, uint8_t& g, uint8_t& b) override {
+        // Adafruit_NeoPixel undoes its own brightness scaling
+        uint32_t c = index < numPixels ? strip.getPixelColor(index) : 0;
+        r = (c >> 16) & 0xFF;
+        g = (c >> 8) & 0xFF;
+        b = c & 0xFF;
+    }
+
     void clear() override {
         strip.clear();
     }
@@ -75,16 +95,21 @@ private:
 // Stub driver when NeoPixel library is not installed
 class LedDriverWS2812 : public LedDriver {
 public:
-    LedDriverWS2812(uint16_t numPixels, uint8_t pin, uint8_t type = 0)
+    LedDriverWS2812(uint16_t numPixels, uint8_t* storage, uint8_t pin, uint8_t type = 0)
         : LedDriver(numPixels, COLOR_GRB)
         , pixelBuffer(nullptr)
     {
-        pixelBuffer = new uint8_t[numPixels * 3];
-        if (pixelBuffer) memset(pixelBuffer, 0, numPixels * 3);
+        setStorage(storage, numPixels);
     }
 
-    ~LedDriverWS2812() {
-        if (pixelBuffer) delete[] pixelBuffer;
+    static constexpr uint32_t storageBytes(uint16_t count) {
+        return count * 3UL;
+    }
+
+    void setStorage(uint8_t* storage, uint16_t count) override {
+        pixelBuffer = storage;
+        numPixels = storage ? count : 0;
+        if (pixelBuffer) memset(pixelBuffer, 0, numPixels * 3);
     }
 
     void begin() override {
@@ -108,6 +133,16 @@ public:
         }
     }
 
+    void getPixel(uint16_t index, uint8_t& r, uint8_t& g, uint8_t& b) override {
+        r = g = b = 0;
+        if (index < numPixels && pixelBuffer) {
+            uint16_t offset = index * 3;
+            g = pixelBuffer[offset + 0];
+            r = pixelBuffer[offset + 1];
+            b = pixelBuffer[offset + 2];
+        }
+    }
+
     uint8_t getLedType() const override {
         return LED_TYPE_WS2812;
     }
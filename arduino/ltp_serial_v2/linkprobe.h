@@ -0,0 +1,166 @@
+/**
+ * LTP Serial Protocol v2 - Link Probe
+ *
+ * Handlers for the CMD_ECHO (0x93) and CMD_SINK (0x94) diagnostic
+ * commands, which measure the link itself rather than the LEDs:
+ *
+ *   ECHO   replies at once with the request's arrival time and N bytes of
+ *          payload, so the host can time round trips and, with large
+ *          replies, device-to-host throughput
+ *   SINK   swallows data packets without replying and, on request,
+ *          reports how many bytes arrived over how long, sequence gaps and
+ *          the parser errors seen meanwhile: host-to-device throughput
+ *          and loss as measured on the device
+ *
+ * The ECHO reply is streamed from the request payload, so it needs no
+ * buffer beyond the received packet. Both only use the protocol object;
+ * the sketch dispatches the two commands to a global LtpLinkProbe.
+ */
+
+#ifndef LTP_LINKPROBE_H
+#define LTP_LINKPROBE_H
+
+#include <Arduino.h>
+#include "protocol.h"
+
+class LtpLinkProbe {
+public:
+    LtpLinkProbe() : active(false) { memset(&counters, 0, sizeof(counters)); }
+
+    /**
+     * ECHO request: reply length (2 bytes, 0 = echo the data back), then
+     * optional data. Reply: micros() at the request's START byte and when
+     * the reply started, then the reply length in bytes, repeating the data
+     * (or a counting pattern if there is none).
+     */
+    void echo(LtpProtocol& protocol, const LtpPacket& pkt) {
+        uint16_t dataLength = pkt.length > 2 ? pkt.length - 2 : 0;
+        const uint8_t* data = pkt.payload + 2;
+        uint16_t replyLength = pkt.length >= 2 ? (pkt.payload[0] | (pkt.payload[1] << 8)) : 0;
+        if (replyLength == 0) replyLength = dataLength;
+        if (replyLength > LTP_MAX_PAYLOAD - ECHO_HEADER_SIZE) replyLength = LTP_MAX_PAYLOAD - ECHO_HEADER_SIZE;
+
+        uint8_t header[ECHO_HEADER_SIZE];
+        putU32(header, pkt.firstByteMicros);
+        putU32(header + 4, micros());
+        protocol.beginPacket(CMD_ECHO, ECHO_HEADER_SIZE + replyLength);
+        protocol.writePayload(header, ECHO_HEADER_SIZE);
+
+        uint8_t pattern[16];
+        if (dataLength == 0) {
+            for (uint8_t i = 0; i < sizeof(pattern); i++) pattern[i] = i;
+            data = pattern;
+            dataLength = sizeof(pattern);
+        }
+        while (replyLength > 0) {
+            uint16_t chunk = min(replyLength, dataLength);
+            protocol.writePayload(data, chunk);
+            replyLength -= chunk;
+        }
+        protocol.endPacket();
+    }
+
+    /**
+     * SINK request: operation byte, then for SINK_DATA a sequence number
+     * (2 bytes) and any filler. SINK_START resets the counters and
+     * SINK_REPORT reads them; both reply with the report. Data packets are
+     * never answered. Data before the first START starts the count.
+     */
+    void sink(LtpProtocol& protocol, const LtpPacket& pkt) {
+        if (pkt.length < 1) {
+            protocol.sendNak(CMD_SINK, ERR_INVALID_LENGTH);
+            return;
+        }
+
+        switch (pkt.payload[0]) {
+            case SINK_DATA:
+                if (!active) start(protocol);
+                sinkData(pkt);
+                return;
+
+            case SINK_START:
+                start(protocol);
+                break;
+
+            case SINK_REPORT:
+                break;
+
+            default:
+                protocol.sendNak(CMD_SINK, ERR_INVALID_PARAM);
+                return;
+        }
+
+        uint8_t response[REPORT_SIZE];
+        uint16_t respLen = writeReport(protocol, response);
+        protocol.sendPacket(CMD_SINK, response, respLen);
+    }
+
+    static const uint8_t SINK_DATA = 0x00;
+    static const uint8_t SINK_START = 0x01;
+    static const uint8_t SINK_REPORT = 0x02;
+
+    static const uint8_t ECHO_HEADER_SIZE = 8;
+    static const uint8_t REPORT_SIZE = 26;
+
+private:
+    struct SinkCounters {
+        uint32_t packets;
+        uint32_t bytes;             // Wire bytes, framing included
+        uint32_t lost;              // Packets missing from the sequence
+        uint32_t firstByte;         // START byte of the first data packet
+        uint32_t lastComplete;      // Checksum of the latest data packet
+        uint16_t nextSeq;
+        uint16_t parserErrors[3];   // Checksum; oversize + timeouts; RX buffer full
+    };
+
+    SinkCounters counters;
+    bool active;
+
+    void start(LtpProtocol& protocol) {
+        const LtpParserStats& ps = protocol.getParserStats();
+        memset(&counters, 0, sizeof(counters));
+        counters.parserErrors[0] = ps.checksumErrors;
+        counters.parserErrors[1] = ps.oversizePackets + ps.timeouts;
+        counters.parserErrors[2] = ps.rxBufferFull;
+        active = true;
+    }
+
+    void sinkData(const LtpPacket& pkt) {
+        uint16_t seq = pkt.length >= 3 ? (pkt.payload[1] | (pkt.payload[2] << 8)) : counters.nextSeq;
+        if (counters.packets == 0) {
+            counters.firstByte = pkt.firstByteMicros;
+        } else {
+            uint16_t gap = seq - counters.nextSeq;
+            if (gap < 0x8000) counters.lost += gap;     // Older numbers are repeats
+        }
+        counters.nextSeq = seq + 1;
+        counters.packets++;
+        counters.bytes += pkt.length + 6;
+        counters.lastComplete = pkt.completeMicros;
+    }
+
+    // Packets, bytes, elapsed us, bytes/s, lost, then parser error deltas
+    uint16_t writeReport(LtpProtocol& protocol, uint8_t* out) const {
+        const LtpParserStats& ps = protocol.getParserStats();
+        uint32_t elapsed = counters.packets ? counters.lastComplete - counters.firstByte : 0;
+        uint16_t n = 0;
+        n += putU32(out + n, counters.packets);
+        n += putU32(out + n, counters.bytes);
+        n += putU32(out + n, elapsed);
+        n += putU32(out + n, bytesPerSecond(counters.bytes, elapsed));
+        n += putU32(out + n, counters.lost);
+        n += putU16(out + n, (uint16_t)(ps.checksumErrors - counters.parserErrors[0]));
+        n += putU16(out + n, (uint16_t)(ps.oversizePackets + ps.timeouts - counters.parserErrors[1]));
+        n += putU16(out + n, (uint16_t)(ps.rxBufferFull - counters.parserErrors[2]));
+        return n;
+    }
+
+    static uint32_t bytesPerSecond(uint32_t bytes, uint32_t us) {
+        if (us < 1000) return 0;    // Too short to measure
+        // Millisecond resolution avoids 64-bit division (large on AVR)
+        uint32_t ms = us / 1000;
+        return bytes < 4000000UL ? bytes * 1000 / ms : bytes / ms * 1000;
+    }
+};
+
+#endif // LTP_LINKPROBE_H
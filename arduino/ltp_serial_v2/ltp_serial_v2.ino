@@ -15,19 +15,113 @@
  */
 
 #include "protocol.h"
+#include "latency.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "selfbench.h"
+#include "linkprobe.h"
+#include "animation.h"
+#include "fade.h"
+#include "shader.h"
+#include "fill.h"
+#include "coords.h"
+#include "visualizer.h"
+// Saved scenes follow the COORDS table in EEPROM, where there is one
+#if !defined(__AVR__) || defined(LTP_HOST_BUILD)
+#define LTP_SCENE_EEPROM_ADDR 1024
+#endif
+#include "scene.h"
+#include "sequence.h"
+#include "sequence_data.h"
+#include "profile.h"
+#include "arena.h"
 #include "led_driver.h"
 #include "led_driver_lpd8806.h"
+#include "led_driver_lpd8806_palette.h"
+#include "led_driver_lpd8806_spans.h"
+#include "palette.h"
 
 // ============================================================================
 // CONFIGURATION - Modify these for your setup
 // ============================================================================
 
-// LED strip configuration
+// LED strip configuration (the length at boot; SET_STRIP can change it)
+#ifndef NUM_PIXELS
 #define NUM_PIXELS          160
+#endif
 #define DATA_PIN            11
 #define CLOCK_PIN           13
 #define USE_HARDWARE_SPI    true
 
+// Pixel storage: 0 keeps 3 bytes per pixel; 4 or 8 keeps a palette index
+// per pixel (CMD_PALETTE) for strips too long for RGB in RAM, e.g.
+// NUM_PIXELS 1500 in 750 bytes at 4 bits on an Uno
+#ifndef LTP_PALETTE_BITS
+#define LTP_PALETTE_BITS    0
+#endif
+
+// Or no pixel storage at all: a display list of this many spans (23 bytes
+// each on AVR, so about 32 on an Uno) computed as show() sends them, for
+// long strips of blocky content (CMD_DISPLAY_LIST); 0 = off
+#ifndef LTP_DISPLAY_LIST
+#define LTP_DISPLAY_LIST    0
+#endif
+
+#if LTP_PALETTE_BITS && LTP_DISPLAY_LIST
+#error "LTP_PALETTE_BITS and LTP_DISPLAY_LIST are alternatives; set one"
+#endif
+
+// Static arena the strip's storage is carved from instead of the heap
+// (arena.h), followed by the effect buffers sized to the strip; at least
+// what the boot strip's layout needs. SET_STRIP lays out any strip whose
+// layout fits: an Uno's 160 pixels can grow to 240, a Mega gets room for
+// 1,000 RGB pixels, other boards for about 440 with every effect
+#ifndef LTP_ARENA_SIZE
+#if defined(__AVR_ATmega2560__) && !defined(LTP_HOST_BUILD)
+#define LTP_ARENA_SIZE      3072
+#elif defined(__AVR__) && !defined(LTP_HOST_BUILD)
+#define LTP_ARENA_SIZE      720
+#else
+#define LTP_ARENA_SIZE      16384
+#endif
+#endif
+
+// FADE_TO, COORDS and RAM scene buffers in the arena, 33 bytes per pixel;
+// off on AVR, whose RAM goes to the pixels: FADE_TO and COORDS then NAK
+// NOT_SUPPORTED and scenes are kept in EEPROM only
+#ifndef LTP_EFFECT_BUFFERS
+#if defined(__AVR__) && !defined(LTP_HOST_BUILD)
+#define LTP_EFFECT_BUFFERS  0
+#else
+#define LTP_EFFECT_BUFFERS  1
+#endif
+#endif
+
+// Optional engines, 1 = built in. They default to off where RAM is small
+// (LTP_SMALL_RAM, protocol.h) and their commands then NAK NOT_SUPPORTED;
+// turn one on there at the cost of pixels
+#ifndef LTP_ANIMATION
+#define LTP_ANIMATION       !LTP_SMALL_RAM  // ANIM_START patterns
+#endif
+#ifndef LTP_SHADER
+#define LTP_SHADER          !LTP_SMALL_RAM  // SHADER_LOAD programs
+#endif
+#ifndef LTP_VISUALIZER
+#define LTP_VISUALIZER      !LTP_SMALL_RAM  // VIS_CONFIG bar graphs
+#endif
+#ifndef LTP_SEQUENCE
+#define LTP_SEQUENCE        !LTP_SMALL_RAM  // SEQUENCE playback
+#endif
+#ifndef LTP_LATENCY
+#define LTP_LATENCY         !LTP_SMALL_RAM  // GET_INFO latency histograms
+#endif
+#ifndef LTP_TELEMETRY
+#define LTP_TELEMETRY       !LTP_SMALL_RAM  // STATUS_UPDATE telemetry
+#endif
+#ifndef LTP_LINK_PROBE
+#define LTP_LINK_PROBE      !LTP_SMALL_RAM  // ECHO and SINK
+#endif
+
 // Serial configuration
 #define SERIAL_BAUD         115200
 
@@ -45,7 +139,55 @@
 // ============================================================================
 
 // LED driver - change this line to use a different LED chip
-LedDriverLPD8806 leds(NUM_PIXELS, DATA_PIN, CLOCK_PIN, USE_HARDWARE_SPI);
+#if LTP_PALETTE_BITS
+typedef LedDriverLPD8806Palette<LTP_PALETTE_BITS> StripDriver;
+
+// PALETTE colors, indices and palette rotation
+LtpPalette palette;
+#elif LTP_DISPLAY_LIST
+typedef LedDriverLPD8806Spans<LTP_DISPLAY_LIST> StripDriver;
+#else
+typedef LedDriverLPD8806 StripDriver;
+#endif
+
+// Built-in animations (CMD_ANIM_*); sparkle and fire keep a byte per pixel
+#if LTP_ANIMATION
+LtpAnimation animation;
+#endif
+
+// FADE_TO keyframes: a copy of the strip plus one per queued keyframe
+LtpFade<LTP_EFFECT_BUFFERS ? 4 : 1> fade;
+
+// COORDS table for spatial animations and shaders, 6 bytes per pixel
+LtpCoords<int16_t> coords;
+
+// SCENE slots: 4 in RAM with the effect buffers, and 2 in EEPROM (512 bytes
+// each of an Uno's 1 KB)
+LtpScenes<LTP_EFFECT_BUFFERS ? 4 : 0, 2> scenes;
+
+// Rounded up to where the arena starts the next allocation
+constexpr uint32_t arenaBlock(uint32_t bytes) {
+    return (bytes + LTP_ARENA_ALIGN - 1) / LTP_ARENA_ALIGN * LTP_ARENA_ALIGN;
+}
+
+// Arena bytes a strip of pixels lays out: its storage, then the effect
+// buffers the build has
+constexpr uint32_t layoutBytes(uint32_t pixels) {
+    return arenaBlock(StripDriver::storageBytes(pixels)) +
+           (LTP_ANIMATION ? arenaBlock(pixels * LtpAnimation::BYTES_PER_PIXEL) : 0) +
+           (LTP_EFFECT_BUFFERS ? arenaBlock(pixels * decltype(fade)::BYTES_PER_PIXEL) +
+                                 arenaBlock(pixels * decltype(coords)::BYTES_PER_PIXEL) +
+                                 arenaBlock(pixels * decltype(scenes)::BYTES_PER_PIXEL) : 0);
+}
+
+static_assert(layoutBytes(NUM_PIXELS) <= 0xFFFF, "NUM_PIXELS needs more than 64 KB");
+const uint16_t BOOT_LAYOUT = layoutBytes(NUM_PIXELS);
+
+// Pixel storage and effect buffers for the strip, laid out again by SET_STRIP
+LtpArena<(LTP_ARENA_SIZE > BOOT_LAYOUT ? LTP_ARENA_SIZE : BOOT_LAYOUT)> arena;
+
+StripDriver leds(NUM_PIXELS, arena.alloc(StripDriver::storageBytes(NUM_PIXELS)), DATA_PIN, CLOCK_PIN,
+                 USE_HARDWARE_SPI);
 
 // Protocol handler
 LtpProtocol protocol(Serial, MAX_PAYLOAD_SIZE);
@@ -65,14 +207,56 @@ struct {
     uint32_t framesReceived = 0;
     uint32_t framesDisplayed = 0;
     uint32_t bytesReceived = 0;
-    uint16_t checksumErrors = 0;
-    uint16_t bufferOverflows = 0;
     uint32_t startTime = 0;
 } stats;
 
-// Control definitions
+#if LTP_LATENCY
+// Per-frame latency histograms (GET_INFO INFO_LATENCY)
+LtpLatency latency;
+#endif
+
+#if LTP_TELEMETRY
+// STATUS_UPDATE telemetry every config.statusInterval seconds
+LtpTelemetry telemetry;
+#endif
+
+#if LTP_TRACE_ENTRIES
+// Last packets handled (CMD_TRACE)
+LtpTrace trace;
+#endif
+
+#if LTP_LINK_PROBE
+// ECHO / SINK link measurements
+LtpLinkProbe linkProbe;
+#endif
+
+
+// SHADER_LOAD programs, bytes of bytecode
+#if defined(__AVR__) && !defined(LTP_HOST_BUILD)
+typedef LtpShader<128> Shader;
+#else
+typedef LtpShader<256> Shader;
+#endif
+#if LTP_SHADER
+Shader shader;
+#endif
+
+#if LTP_VISUALIZER
+// VIS_CONFIG bar graphs and meters driven by VIS_VALUE
+LtpVisualizer visualizer;
+#endif
+
+// SEQUENCE playback of the sketch's PROGMEM sequence (sequence_data.h); no
+// SD card, whose block buffers would not fit the Uno's RAM
+#if LTP_SEQUENCE
+LtpSequence<0> sequence;
+#endif
+
 #define NUM_CONTROLS 6
 
+// Extended capabilities: animations and shaders when built in
+#define CAPS_2 (CAPS_PIXEL_READBACK | (LTP_ANIMATION ? CAPS_ANIMATION : 0) | (LTP_SHADER ? CAPS_SHADER : 0))
+
 // ============================================================================
 // PROTOCOL HANDLERS
 // ============================================================================
@@ -84,18 +268,222 @@ void sendHello() {
     payload[2] = (FIRMWARE_VERSION_MAJOR << 4) | FIRMWARE_VERSION_MINOR; // BCD
     payload[3] = 0; // BCD low byte
     payload[4] = 1; // Strip count
-    payload[5] = NUM_PIXELS & 0xFF;
-    payload[6] = NUM_PIXELS >> 8;
+    payload[5] = leds.getNumPixels() & 0xFF;
+    payload[6] = leds.getNumPixels() >> 8;
     payload[7] = leds.getColorFormat();
     payload[8] = CAPS_BRIGHTNESS | CAPS_EXTENDED; // Caps byte 1
-    payload[9] = CAPS_PIXEL_READBACK; // Caps byte 2 (extended)
+    payload[9] = CAPS_2; // Caps byte 2 (extended)
     payload[10] = NUM_CONTROLS; // Control count
     payload[11] = 0; // Input count (no inputs in this example)
 
     protocol.sendPacket(CMD_HELLO, payload, 12);
 }
 
+void sendLatencyInfo(bool clear) {
+#if LTP_LATENCY
+    uint8_t response[LtpLatency::INFO_SIZE];
+    uint16_t respLen = latency.writeInfo(response);
+    protocol.sendPacket(CMD_INFO_RESPONSE, response, respLen);
+    if (clear) latency.clear();
+#else
+    protocol.sendNak(CMD_GET_INFO, ERR_NOT_SUPPORTED);
+#endif
+}
+
+void sendStatsInfo() {
+    uint8_t response[20 + LtpProtocol::ERROR_INFO_MAX_SIZE];
+    uint16_t respLen = 0;
+    const LtpParserStats& ps = protocol.getParserStats();
+    uint32_t uptime = (millis() - stats.startTime) / 1000;
+
+    // Frames received (4 bytes)
+    response[respLen++] = stats.framesReceived & 0xFF;
+    response[respLen++] = (stats.framesReceived >> 8) & 0xFF;
+    response[respLen++] = (stats.framesReceived >> 16) & 0xFF;
+    response[respLen++] = (stats.framesReceived >> 24) & 0xFF;
+    // Frames displayed (4 bytes)
+    response[respLen++] = stats.framesDisplayed & 0xFF;
+    response[respLen++] = (stats.framesDisplayed >> 8) & 0xFF;
+    response[respLen++] = (stats.framesDisplayed >> 16) & 0xFF;
+    response[respLen++] = (stats.framesDisplayed >> 24) & 0xFF;
+    // Bytes received (4 bytes)
+    response[respLen++] = stats.bytesReceived & 0xFF;
+    response[respLen++] = (stats.bytesReceived >> 8) & 0xFF;
+    response[respLen++] = (stats.bytesReceived >> 16) & 0xFF;
+    response[respLen++] = (stats.bytesReceived >> 24) & 0xFF;
+    // Checksum errors (2 bytes)
+    response[respLen++] = ps.checksumErrors & 0xFF;
+    response[respLen++] = ps.checksumErrors >> 8;
+    // Buffer overflows: times the serial RX buffer filled (2 bytes)
+    response[respLen++] = ps.rxBufferFull & 0xFF;
+    response[respLen++] = ps.rxBufferFull >> 8;
+    // Uptime (4 bytes, seconds)
+    response[respLen++] = uptime & 0xFF;
+    response[respLen++] = (uptime >> 8) & 0xFF;
+    response[respLen++] = (uptime >> 16) & 0xFF;
+    response[respLen++] = (uptime >> 24) & 0xFF;
+    // Extended: parser discards, dropped frames, NAKs per command
+    respLen += protocol.writeErrorInfo(response + respLen);
+    protocol.sendPacket(CMD_INFO_RESPONSE, response, respLen);
+}
+
+// Display the pixel buffer as a frame
+void showFrame() {
+#if LTP_LATENCY
+    latency.showStart();
+#endif
+    uint32_t start = micros();
+    leds.show();
+#if LTP_TELEMETRY
+    telemetry.frameShown(micros() - start);
+#else
+    (void)start;
+#endif
+#if LTP_LATENCY
+    latency.showDone();
+#endif
+    stats.framesDisplayed++;
+}
+
+// Pixel writer for the animation renderer
+void setLedPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b) {
+    leds.setPixel(index, r, g, b);
+}
+
+// Pixel reader for fades starting from the current colors
+void getLedPixel(uint16_t index, uint8_t& r, uint8_t& g, uint8_t& b) {
+    leds.getPixel(index, r, g, b);
+}
+
+// Pixel position for spatial animations and shaders
+bool getLedCoord(uint16_t index, int16_t& x, int16_t& y, int16_t& z) {
+    return coords.lookup(index, x, y, z);
+}
+
+// What draws on the strip, for stopEffects()
+#define FX_ANIMATION        0x01
+#define FX_FADE             0x02
+#define FX_SHADER           0x04
+#define FX_VISUALIZER       0x08
+#define FX_SEQUENCE         0x10
+#define FX_PALETTE          0x20    // Palette rotation
+#define FX_ALL              0x3F
+
+// Stop the effects in `which` that the build has; whatever starts drawing
+// stops the ones that would overwrite it
+void stopEffects(uint8_t which) {
+#if LTP_ANIMATION
+    if (which & FX_ANIMATION) animation.stop();
+#endif
+    if (which & FX_FADE) fade.stop();
+#if LTP_SHADER
+    if (which & FX_SHADER) shader.stop();
+#endif
+#if LTP_VISUALIZER
+    if (which & FX_VISUALIZER) visualizer.stop();
+#endif
+#if LTP_SEQUENCE
+    if (which & FX_SEQUENCE) sequence.stop();
+#endif
+#if LTP_PALETTE_BITS
+    if (which & FX_PALETTE) palette.stop();
+#endif
+}
+
+// Next animation, fade, shader, visualizer, sequence or palette rotation
+// frame, for those running and due; true if any drew
+bool updateEffects() {
+    bool rendered = false;
+#if LTP_ANIMATION
+    rendered |= animation.update(micros(), getLedCoord, setLedPixel);
+#endif
+    rendered |= fade.update(micros(), getLedPixel, setLedPixel);
+#if LTP_SHADER
+    rendered |= shader.update(micros(), getLedCoord, setLedPixel);
+#endif
+#if LTP_VISUALIZER
+    rendered |= visualizer.update(micros(), setLedPixel);
+#endif
+#if LTP_SEQUENCE
+    rendered |= sequence.update(micros(), setLedPixel);
+#endif
+#if LTP_PALETTE_BITS
+    rendered |= palette.update(micros(), leds);
+#endif
+    return rendered;
+}
+
+// Whether updateEffects() would draw now, without drawing
+bool effectsDue() {
+    uint32_t now = micros();
+    bool due = fade.due(now);
+#if LTP_ANIMATION
+    due |= animation.due(now);
+#endif
+#if LTP_SHADER
+    due |= shader.due(now);
+#endif
+#if LTP_VISUALIZER
+    due |= visualizer.due(now);
+#endif
+#if LTP_SEQUENCE
+    due |= sequence.due(now);
+#endif
+#if LTP_PALETTE_BITS
+    due |= palette.due(now);
+#endif
+    return due;
+}
+
+// A pass of loop() with nothing to handle, for BENCH: telemetry, the
+// receive check and the effects' due checks, but no packet or frame
+bool benchIdlePass() {
+#if LTP_TELEMETRY
+    telemetry.update(protocol, config.statusInterval, stats.framesReceived, Serial.available());
+#endif
+    bool input = Serial.available() > 0;
+    return effectsDue() || input;
+}
+
+// Spans the display list had no room for so far; pixel data commands that
+// add to it NAK with BUFFER_OVERFLOW
+uint32_t droppedSpans() {
+#if LTP_DISPLAY_LIST
+    return leds.droppedSpans();
+#else
+    return 0;
+#endif
+}
+
+// Longest strip whose layout fits the arena
+uint16_t longestStrip() {
+    uint16_t lo = 0, hi = 0xFFFF;
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo + 1) / 2;
+        if (layoutBytes(mid) <= arena.size()) lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+
+// INFO_MEMORY: arena size, bytes used, free and at most used, strip pixels,
+// longest strip that fits, then of the bytes used the strip's storage and
+// the effect buffers
+uint16_t writeMemoryInfo(uint8_t* out) {
+    uint16_t stripBytes = StripDriver::storageBytes(leds.getNumPixels());
+    uint16_t values[8] = { arena.size(), arena.used(), arena.available(), arena.highWater(),
+                           leds.getNumPixels(), longestStrip(), stripBytes,
+                           (uint16_t)(arena.used() - stripBytes) };
+    for (uint8_t k = 0; k < 8; k++) {
+        out[k * 2] = values[k] & 0xFF;
+        out[k * 2 + 1] = values[k] >> 8;
+    }
+    return sizeof(values);
+}
+
 void handleGetInfo(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_GET_INFO);
+
     if (length < 1) {
         protocol.sendNak(CMD_GET_INFO, ERR_INVALID_LENGTH);
         return;
@@ -112,11 +500,11 @@ void handleGetInfo(const uint8_t* payload, uint16_t length) {
             response[respLen++] = (FIRMWARE_VERSION_MAJOR << 4) | FIRMWARE_VERSION_MINOR;
             response[respLen++] = 0;
             response[respLen++] = 1; // Strip count
-            response[respLen++] = NUM_PIXELS & 0xFF;
-            response[respLen++] = NUM_PIXELS >> 8;
+            response[respLen++] = leds.getNumPixels() & 0xFF;
+            response[respLen++] = leds.getNumPixels() >> 8;
             response[respLen++] = leds.getColorFormat();
             response[respLen++] = CAPS_BRIGHTNESS | CAPS_EXTENDED;
-            response[respLen++] = CAPS_PIXEL_READBACK;
+            response[respLen++] = CAPS_2;
             response[respLen++] = NUM_CONTROLS;
             // Device name (null-terminated, max 16 bytes)
             {
@@ -140,8 +528,8 @@ void handleGetInfo(const uint8_t* payload, uint16_t length) {
             response[respLen++] = 1; // Strip count
             // Strip 0 definition
             response[respLen++] = 0; // Strip ID
-            response[respLen++] = NUM_PIXELS & 0xFF;
-            response[respLen++] = NUM_PIXELS >> 8;
+            response[respLen++] = leds.getNumPixels() & 0xFF;
+            response[respLen++] = leds.getNumPixels() >> 8;
             response[respLen++] = leds.getColorFormat();
             response[respLen++] = leds.getLedType();
             response[respLen++] = DATA_PIN;
@@ -160,35 +548,16 @@ void handleGetInfo(const uint8_t* payload, uint16_t length) {
             break;
 
         case INFO_STATS:
-            // Frames received (4 bytes)
-            response[respLen++] = stats.framesReceived & 0xFF;
-            response[respLen++] = (stats.framesReceived >> 8) & 0xFF;
-            response[respLen++] = (stats.framesReceived >> 16) & 0xFF;
-            response[respLen++] = (stats.framesReceived >> 24) & 0xFF;
-            // Frames displayed (4 bytes)
-            response[respLen++] = stats.framesDisplayed & 0xFF;
-            response[respLen++] = (stats.framesDisplayed >> 8) & 0xFF;
-            response[respLen++] = (stats.framesDisplayed >> 16) & 0xFF;
-            response[respLen++] = (stats.framesDisplayed >> 24) & 0xFF;
-            // Bytes received (4 bytes)
-            response[respLen++] = stats.bytesReceived & 0xFF;
-            response[respLen++] = (stats.bytesReceived >> 8) & 0xFF;
-            response[respLen++] = (stats.bytesReceived >> 16) & 0xFF;
-            response[respLen++] = (stats.bytesReceived >> 24) & 0xFF;
-            // Checksum errors (2 bytes)
-            response[respLen++] = stats.checksumErrors & 0xFF;
-            response[respLen++] = stats.checksumErrors >> 8;
-            // Buffer overflows (2 bytes)
-            response[respLen++] = stats.bufferOverflows & 0xFF;
-            response[respLen++] = stats.bufferOverflows >> 8;
-            // Uptime (4 bytes, seconds)
-            {
-                uint32_t uptime = (millis() - stats.startTime) / 1000;
-                response[respLen++] = uptime & 0xFF;
-                response[respLen++] = (uptime >> 8) & 0xFF;
-                response[respLen++] = (uptime >> 16) & 0xFF;
-                response[respLen++] = (uptime >> 24) & 0xFF;
-            }
+            sendStatsInfo();
+            return;
+
+        case INFO_LATENCY:
+            // Optional second byte: bit 0 clears the histograms after reading
+            sendLatencyInfo(length >= 2 && (payload[1] & 0x01));
+            return;
+
+        case INFO_MEMORY:
+            respLen = writeMemoryInfo(response);
             break;
 
         default:
@@ -200,8 +569,11 @@ void handleGetInfo(const uint8_t* payload, uint16_t length) {
 }
 
 void handleShow(const uint8_t* payload, uint16_t length) {
-    leds.show();
-    stats.framesDisplayed++;
+    LTP_PROFILE_SCOPE(PROF_HANDLE_SHOW);
+
+    if (length >= 2) protocol.trackFrameNumber(payload[0] | (payload[1] << 8));
+
+    showFrame();
 
     // Frame acknowledgment if enabled
     if (config.frameAck && length >= 2) {
@@ -216,6 +588,8 @@ void handleShow(const uint8_t* payload, uint16_t length) {
 }
 
 void handlePixelSetAll(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_PIXEL_SET_ALL);
+
     if (length < 4) {
         protocol.sendNak(CMD_PIXEL_SET_ALL, ERR_INVALID_LENGTH);
         return;
@@ -235,12 +609,13 @@ void handlePixelSetAll(const uint8_t* payload, uint16_t length) {
     stats.framesReceived++;
 
     if (config.autoShow) {
-        leds.show();
-        stats.framesDisplayed++;
+        showFrame();
     }
 }
 
 void handlePixelSetRange(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_PIXEL_SET_RANGE);
+
     if (length < 8) {
         protocol.sendNak(CMD_PIXEL_SET_RANGE, ERR_INVALID_LENGTH);
         return;
@@ -258,21 +633,79 @@ void handlePixelSetRange(const uint8_t* payload, uint16_t length) {
     uint8_t g = payload[6];
     uint8_t b = payload[7];
 
-    if (start >= NUM_PIXELS || end > NUM_PIXELS) {
+    if (start >= leds.getNumPixels() || end > leds.getNumPixels()) {
         protocol.sendNak(CMD_PIXEL_SET_RANGE, ERR_PIXEL_OVERFLOW);
         return;
     }
 
+    uint32_t dropped = droppedSpans();
     leds.fillRange(start, end, r, g, b);
+    if (droppedSpans() != dropped) {
+        protocol.sendNak(CMD_PIXEL_SET_RANGE, ERR_BUFFER_OVERFLOW);
+        return;
+    }
+    stats.framesReceived++;
+
+    if (config.autoShow) {
+        showFrame();
+    }
+}
+
+// PIXEL_FILL: strip, start (2), end (2, exclusive) as PIXEL_SET_RANGE, then
+// the fill operation and its parameters (fill.h)
+void handlePixelFill(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_PIXEL_FILL);
+
+    if (length < 6) {
+        protocol.sendNak(CMD_PIXEL_FILL, ERR_INVALID_LENGTH);
+        return;
+    }
+
+    uint8_t stripId = payload[0];
+    if (stripId != 0) {
+        protocol.sendNak(CMD_PIXEL_FILL, ERR_INVALID_PARAM);
+        return;
+    }
+
+    uint16_t start = payload[1] | ((uint16_t)payload[2] << 8);
+    uint16_t end = payload[3] | ((uint16_t)payload[4] << 8);
+    if (start >= leds.getNumPixels() || end > leds.getNumPixels()) {
+        protocol.sendNak(CMD_PIXEL_FILL, ERR_PIXEL_OVERFLOW);
+        return;
+    }
+
+    uint32_t dropped = droppedSpans();
+#if LTP_DISPLAY_LIST
+    // Runs straight into the display list: a gradient segment is one span
+    uint8_t err = LtpFill::draw(payload + 5, length - 5, start, end, leds);
+#else
+    uint8_t err = LtpFill::render(payload + 5, length - 5, start, end, setLedPixel);
+#endif
+    if (err == ERR_OK && droppedSpans() != dropped) err = ERR_BUFFER_OVERFLOW;
+    if (err != ERR_OK) {
+        protocol.sendNak(CMD_PIXEL_FILL, err);
+        return;
+    }
     stats.framesReceived++;
 
     if (config.autoShow) {
-        leds.show();
-        stats.framesDisplayed++;
+        showFrame();
+    }
+}
+
+// Copy PIXEL_FRAME color data into the strip
+void copyPixels(uint16_t start, const uint8_t* pixelData, uint16_t count) {
+    uint8_t bpp = leds.getBytesPerPixel();
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t offset = i * bpp;
+        leds.setPixel(start + i, pixelData[offset], pixelData[offset + 1], pixelData[offset + 2]);
     }
 }
 
 void handlePixelFrame(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_PIXEL_FRAME);
+
     if (length < 5) {
         protocol.sendNak(CMD_PIXEL_FRAME, ERR_INVALID_LENGTH);
         return;
@@ -295,30 +728,90 @@ void handlePixelFrame(const uint8_t* payload, uint16_t length) {
         return;
     }
 
-    if (start + count > NUM_PIXELS) {
+    if (start + count > leds.getNumPixels()) {
         protocol.sendNak(CMD_PIXEL_FRAME, ERR_PIXEL_OVERFLOW);
         return;
     }
 
-    // Copy pixel data
-    const uint8_t* pixelData = payload + dataOffset;
-    uint8_t bpp = leds.getBytesPerPixel();
-
-    for (uint16_t i = 0; i < count; i++) {
-        uint16_t offset = i * bpp;
-        leds.setPixel(start + i, pixelData[offset], pixelData[offset + 1], pixelData[offset + 2]);
+    uint32_t dropped = droppedSpans();
+    copyPixels(start, payload + dataOffset, count);
+    if (droppedSpans() != dropped) {
+        protocol.sendNak(CMD_PIXEL_FRAME, ERR_BUFFER_OVERFLOW);
+        return;
     }
 
     stats.framesReceived++;
     stats.bytesReceived += expectedBytes;
 
     if (config.autoShow) {
-        leds.show();
-        stats.framesDisplayed++;
+        showFrame();
+    }
+}
+
+// Carve the empty arena into the strip's storage and the effect buffers
+// sized to it, then load what the effects saved for that length
+void carveStrip(uint16_t pixels) {
+    arena.reset();
+    leds.setStorage(arena.alloc(StripDriver::storageBytes(pixels)), pixels);
+#if LTP_ANIMATION
+    animation.setStorage(arena.alloc(pixels * LtpAnimation::BYTES_PER_PIXEL), pixels);
+#endif
+#if LTP_EFFECT_BUFFERS
+    fade.setStorage(arena.alloc(pixels * decltype(fade)::BYTES_PER_PIXEL), pixels);
+    coords.setStorage(arena.alloc(pixels * decltype(coords)::BYTES_PER_PIXEL), pixels);
+    scenes.setStorage(arena.alloc(pixels * decltype(scenes)::BYTES_PER_PIXEL), pixels);
+#endif
+    coords.begin(pixels);
+    scenes.begin(pixels);
+#if LTP_SEQUENCE
+    sequence.begin(SEQUENCE_DATA, sizeof(SEQUENCE_DATA), 0, pixels);
+#endif
+}
+
+// Lay the arena out again for a strip pixels long; false, with nothing
+// changed, when it does not fit. What drew on the old layout stops and the
+// strip is blanked, at its old length first
+bool layoutStrip(uint16_t pixels) {
+    if (layoutBytes(pixels) > arena.size()) return false;
+
+    stopEffects(FX_ALL);
+    leds.clear();
+    leds.show();
+
+    carveStrip(pixels);
+    showFrame();
+    return true;
+}
+
+// SET_STRIP: strip ID, pixel count (2), color format, LED type, data pin,
+// clock pin, flags. Only the length can change here; the rest must match
+// INFO_STRIPS
+void handleSetStrip(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_SET_STRIP);
+    if (length < 8) {
+        protocol.sendNak(CMD_SET_STRIP, ERR_INVALID_LENGTH);
+        return;
+    }
+    uint16_t pixels = payload[1] | ((uint16_t)payload[2] << 8);
+    if (payload[0] != 0 || pixels == 0) {
+        protocol.sendNak(CMD_SET_STRIP, ERR_INVALID_PARAM);
+        return;
     }
+    if (payload[3] != leds.getColorFormat() || payload[4] != leds.getLedType() ||
+        payload[5] != DATA_PIN || payload[6] != CLOCK_PIN) {
+        protocol.sendNak(CMD_SET_STRIP, ERR_NOT_SUPPORTED);
+        return;
+    }
+    if (!layoutStrip(pixels)) {
+        protocol.sendNak(CMD_SET_STRIP, ERR_BUFFER_OVERFLOW);
+        return;
+    }
+    protocol.sendAck(CMD_SET_STRIP);
 }
 
 void handleSetControl(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_SET_CONTROL);
+
     if (length < 2) {
         protocol.sendNak(CMD_SET_CONTROL, ERR_INVALID_LENGTH);
         return;
@@ -356,10 +849,15 @@ void handleSetControl(const uint8_t* payload, uint16_t length) {
             break;
 
         case CTRL_ID_STATUS_INTERVAL:
+#if LTP_TELEMETRY
             if (length >= 3) {
                 config.statusInterval = payload[1] | ((uint16_t)payload[2] << 8);
             }
             break;
+#else
+            protocol.sendNak(CMD_SET_CONTROL, ERR_NOT_SUPPORTED);
+            return;
+#endif
 
         default:
             protocol.sendNak(CMD_SET_CONTROL, ERR_INVALID_PARAM);
@@ -370,6 +868,8 @@ void handleSetControl(const uint8_t* payload, uint16_t length) {
 }
 
 void handleGetControl(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_GET_CONTROL);
+
     if (length < 1) {
         protocol.sendNak(CMD_GET_CONTROL, ERR_INVALID_LENGTH);
         return;
@@ -410,6 +910,8 @@ void handleGetControl(const uint8_t* payload, uint16_t length) {
 }
 
 void handleGetPixels(const uint8_t* payload, uint16_t length) {
+    LTP_PROFILE_SCOPE(PROF_HANDLE_GET_PIXELS);
+
     if (length < 5) {
         protocol.sendNak(CMD_GET_PIXELS, ERR_INVALID_LENGTH);
         return;
@@ -424,8 +926,8 @@ void handleGetPixels(const uint8_t* payload, uint16_t length) {
     uint16_t start = payload[1] | ((uint16_t)payload[2] << 8);
     uint16_t count = payload[3] | ((uint16_t)payload[4] << 8);
 
-    if (count == 0) count = NUM_PIXELS - start;
-    if (start + count > NUM_PIXELS) {
+    if (count == 0) count = leds.getNumPixels() - start;
+    if (start + count > leds.getNumPixels()) {
         protocol.sendNak(CMD_GET_PIXELS, ERR_PIXEL_OVERFLOW);
         return;
     }
@@ -434,23 +936,301 @@ void handleGetPixels(const uint8_t* payload, uint16_t length) {
     uint16_t maxPixels = (MAX_PAYLOAD_SIZE - 5) / leds.getBytesPerPixel();
     if (count > maxPixels) count = maxPixels;
 
-    uint8_t* response = new uint8_t[5 + count * leds.getBytesPerPixel()];
-    if (!response) {
-        protocol.sendNak(CMD_GET_PIXELS, ERR_BUFFER_OVERFLOW);
+    uint8_t header[5];
+    header[0] = stripId;
+    header[1] = start & 0xFF;
+    header[2] = start >> 8;
+    header[3] = count & 0xFF;
+    header[4] = count >> 8;
+
+    // Streamed a few pixels at a time, so the reply needs no buffer
+    uint8_t bpp = leds.getBytesPerPixel();
+    uint8_t chunk[8 * 4];
+    protocol.beginPacket(CMD_PIXEL_RESPONSE, 5 + count * bpp);
+    protocol.writePayload(header, sizeof(header));
+    for (uint16_t i = 0; i < count; i += 8) {
+        uint16_t n = min(8, count - i);
+        leds.readBuffer(start + i, n, chunk);
+        protocol.writePayload(chunk, n * bpp);
+    }
+    protocol.endPacket();
+}
+
+void handleProfile(const uint8_t* payload, uint16_t length) {
+#if LTP_PROFILE
+    uint8_t response[LtpProfile::INFO_MAX_SIZE];
+    uint16_t respLen = LtpProfile::writeInfo(response);
+    protocol.sendPacket(CMD_PROFILE, response, respLen);
+    // Optional options byte: bit 0 clears the table after reading
+    if (length >= 1 && (payload[0] & 0x01)) LtpProfile::clear();
+#else
+    protocol.sendNak(CMD_PROFILE, ERR_NOT_SUPPORTED);
+#endif
+}
+
+void handleTrace(const uint8_t* payload, uint16_t length) {
+#if LTP_TRACE_ENTRIES
+    // Optional: options byte (bit 0 clears the ring after reading), then
+    // the sequence number to start from (4 bytes, default oldest)
+    uint32_t from = 0;
+    if (length >= 5) {
+        from = (uint32_t)payload[1] | ((uint32_t)payload[2] << 8) |
+               ((uint32_t)payload[3] << 16) | ((uint32_t)payload[4] << 24);
+    }
+    uint8_t response[LtpTrace::INFO_MAX_SIZE];
+    uint16_t respLen = trace.writeInfo(response, from);
+    protocol.sendPacket(CMD_TRACE, response, respLen);
+    if (length >= 1 && (payload[0] & 0x01)) trace.clear();
+#else
+    protocol.sendNak(CMD_TRACE, ERR_NOT_SUPPORTED);
+#endif
+}
+
+void handleAnimStart(const uint8_t* payload, uint16_t length) {
+#if LTP_ANIMATION
+    uint8_t err = animation.start(payload, length, leds.getNumPixels());
+    if (err != ERR_OK) {
+        protocol.sendNak(CMD_ANIM_START, err);
         return;
     }
+    stopEffects(FX_FADE | FX_SHADER | FX_SEQUENCE);
+    protocol.sendAck(CMD_ANIM_START);
+#else
+    protocol.sendNak(CMD_ANIM_START, ERR_NOT_SUPPORTED);
+#endif
+}
+
+void handleAnimStop(const uint8_t* payload, uint16_t length) {
+    stopEffects(FX_ALL);
+    // Option bit 0: blank the animation's, shader's and visualizer's pixels
+    if (length >= 1 && (payload[0] & 0x01)) {
+#if LTP_ANIMATION
+        animation.clear(setLedPixel);
+#endif
+#if LTP_SHADER
+        shader.clear(setLedPixel);
+#endif
+#if LTP_VISUALIZER
+        visualizer.clear(setLedPixel);
+#endif
+        showFrame();
+    }
+    protocol.sendAck(CMD_ANIM_STOP);
+}
+
+// Engines the build leaves out report all zeros: stopped, with no capacity
+void handleAnimStatus() {
+    uint8_t response[LtpAnimation::INFO_SIZE + decltype(fade)::INFO_SIZE + Shader::INFO_SIZE +
+                     LtpVisualizer::INFO_SIZE];
+    memset(response, 0, sizeof(response));
+    uint16_t respLen = 0;
+#if LTP_ANIMATION
+    animation.writeInfo(response);
+#endif
+    respLen += LtpAnimation::INFO_SIZE;
+    respLen += fade.writeInfo(response + respLen);
+#if LTP_SHADER
+    shader.writeInfo(response + respLen);
+#endif
+    respLen += Shader::INFO_SIZE;
+#if LTP_VISUALIZER
+    visualizer.writeInfo(response + respLen);
+#endif
+    respLen += LtpVisualizer::INFO_SIZE;
+    protocol.sendPacket(CMD_ANIM_STATUS, response, respLen);
+}
+
+void handleFadeTo(const uint8_t* payload, uint16_t length) {
+    uint8_t err = fade.queue(payload, length, leds.getNumPixels());
+    if (err != ERR_OK) {
+        protocol.sendNak(CMD_FADE_TO, err);
+        return;
+    }
+    // The animation would overwrite the fade's frames
+    stopEffects(FX_ANIMATION | FX_SHADER | FX_SEQUENCE);
+    protocol.sendAck(CMD_FADE_TO);
+}
+
+void handleShaderLoad(const uint8_t* payload, uint16_t length) {
+#if LTP_SHADER
+    uint8_t err = shader.load(payload, length, leds.getNumPixels(), leds.getNumPixels());
+    if (err != ERR_OK) {
+        protocol.sendNak(CMD_SHADER_LOAD, err);
+        return;
+    }
+    if (payload[0] & SHADER_RUN) {
+        stopEffects(FX_ANIMATION | FX_FADE | FX_SEQUENCE);
+        shader.start();
+    }
+    if (payload[0] & SHADER_TEST) {
+        uint8_t response[Shader::TEST_SIZE];
+        uint16_t respLen = shader.test(response, getLedCoord);
+        protocol.sendPacket(CMD_SHADER_LOAD, response, respLen);
+        return;
+    }
+    protocol.sendAck(CMD_SHADER_LOAD);
+#else
+    protocol.sendNak(CMD_SHADER_LOAD, ERR_NOT_SUPPORTED);
+#endif
+}
 
-    response[0] = stripId;
-    response[1] = start & 0xFF;
-    response[2] = start >> 8;
-    response[3] = count & 0xFF;
-    response[4] = count >> 8;
+void handleShaderParam(const uint8_t* payload, uint16_t length) {
+#if LTP_SHADER
+    uint8_t err = shader.setParams(payload, length);
+    if (err != ERR_OK) {
+        protocol.sendNak(CMD_SHADER_PARAM, err);
+        return;
+    }
+    protocol.sendAck(CMD_SHADER_PARAM);
+#else
+    protocol.sendNak(CMD_SHADER_PARAM, ERR_NOT_SUPPORTED);
+#endif
+}
 
-    uint8_t* pixelBuf = leds.getPixelBuffer();
-    memcpy(response + 5, pixelBuf + start * leds.getBytesPerPixel(), count * leds.getBytesPerPixel());
+void handleVisConfig(const uint8_t* payload, uint16_t length) {
+#if LTP_VISUALIZER
+    uint8_t err = visualizer.configure(payload, length, leds.getNumPixels());
+    if (err != ERR_OK) {
+        protocol.sendNak(CMD_VIS_CONFIG, err);
+        return;
+    }
+    protocol.sendAck(CMD_VIS_CONFIG);
+#else
+    protocol.sendNak(CMD_VIS_CONFIG, ERR_NOT_SUPPORTED);
+#endif
+}
 
-    protocol.sendPacket(CMD_PIXEL_RESPONSE, response, 5 + count * leds.getBytesPerPixel());
-    delete[] response;
+// Like the pixel data commands, values are only NAKed
+void handleVisValue(const uint8_t* payload, uint16_t length) {
+#if LTP_VISUALIZER
+    uint8_t err = visualizer.setValues(payload, length);
+    if (err != ERR_OK) protocol.sendNak(CMD_VIS_VALUE, err);
+#else
+    protocol.sendNak(CMD_VIS_VALUE, ERR_NOT_SUPPORTED);
+#endif
+}
+
+// SCENE_RECALL: slot ID, then optionally a fade time (4 bytes, ms) and
+// easing; without a fade the scene is shown at once
+void handleSceneRecall(const uint8_t* data, uint16_t length) {
+    if (length < 1) {
+        protocol.sendNak(CMD_SCENE, ERR_INVALID_LENGTH);
+        return;
+    }
+    uint8_t id = data[0];
+    uint32_t fadeMs = 0;
+    if (length >= 5) {
+        fadeMs = (uint32_t)data[1] | ((uint32_t)data[2] << 8) |
+                 ((uint32_t)data[3] << 16) | ((uint32_t)data[4] << 24);
+    }
+    uint8_t easing = length >= 6 ? data[5] : FADE_LINEAR;
+    uint8_t err = scenes.check(id);
+    if (err == ERR_OK && fadeMs) {
+        err = fade.queueFrame(fadeMs, easing, FADE_REPLACE, 0, scenes.size(),
+            [id](uint16_t i, uint8_t& r, uint8_t& g, uint8_t& b) { scenes.getPixel(id, i, r, g, b); });
+    }
+    if (err != ERR_OK) {
+        protocol.sendNak(CMD_SCENE, err);
+        return;
+    }
+    // The scene replaces whatever else was drawing
+    stopEffects(FX_ANIMATION | FX_SHADER | FX_VISUALIZER | FX_SEQUENCE);
+    if (!fadeMs) {
+        stopEffects(FX_FADE);
+        scenes.recall(id, setLedPixel);
+        showFrame();
+    }
+    protocol.sendAck(CMD_SCENE);
+}
+
+void handleScene(const LtpPacket& pkt) {
+    if (pkt.length >= 1 && pkt.payload[0] == SCENE_RECALL) {
+        handleSceneRecall(pkt.payload + 1, pkt.length - 1);
+        return;
+    }
+    scenes.command(protocol, pkt, getLedPixel);
+}
+
+void handleSequence(const LtpPacket& pkt) {
+#if LTP_SEQUENCE
+    sequence.command(protocol, pkt, setLedPixel);
+    // A playing sequence replaces whatever else was drawing
+    if (sequence.isRunning()) stopEffects(FX_ANIMATION | FX_FADE | FX_SHADER | FX_VISUALIZER);
+#else
+    protocol.sendNak(CMD_SEQUENCE, ERR_NOT_SUPPORTED);
+#endif
+}
+
+void handlePalette(const LtpPacket& pkt) {
+#if LTP_PALETTE_BITS
+    if (!palette.command(protocol, pkt, leds)) return;
+    if (pkt.payload[0] == PAL_INDICES) stats.framesReceived++;
+    if (config.autoShow) showFrame();
+#else
+    protocol.sendNak(CMD_PALETTE, ERR_NOT_SUPPORTED);
+#endif
+}
+
+// DISPLAY_LIST: optional options byte, bit 0 clears the dropped count
+// after reading
+void handleDisplayList(const uint8_t* payload, uint16_t length) {
+#if LTP_DISPLAY_LIST
+    uint8_t response[12];
+    uint32_t dropped = leds.droppedSpans();
+    response[0] = leds.MAX_SPANS;
+    response[1] = leds.spanCount();
+    response[2] = sizeof(decltype(leds)::Span);
+    response[3] = leds.getNumPixels() & 0xFF;
+    response[4] = leds.getNumPixels() >> 8;
+    for (uint8_t k = 0; k < 4; k++) response[5 + k] = dropped >> (8 * k);
+    response[9] = leds.spanCount(SPAN_SOLID);
+    response[10] = leds.spanCount(SPAN_RAMP);
+    response[11] = leds.spanCount(SPAN_PATTERN);
+    protocol.sendPacket(CMD_DISPLAY_LIST, response, sizeof(response));
+    if (length >= 1 && (payload[0] & 0x01)) leds.clearDropped();
+#else
+    protocol.sendNak(CMD_DISPLAY_LIST, ERR_NOT_SUPPORTED);
+#endif
+}
+
+void handleBench(const uint8_t* payload, uint16_t length) {
+    LtpBenchResult r;
+    r.pixels = leds.getNumPixels();
+    // Optional iteration count (default 10)
+    r.iterations = (length >= 1 && payload[0]) ? payload[0] : LtpBenchResult::DEFAULT_ITERATIONS;
+    uint8_t n = r.iterations;
+
+    r.timeShow([] { leds.show(); });
+
+    r.setPixelNs = LtpBenchResult::nanosPer((uint32_t)leds.getNumPixels() * n, [n] {
+        for (uint8_t k = 0; k < n; k++) {
+            for (uint16_t i = 0; i < leds.getNumPixels(); i++) leds.setPixel(i, i, k, 0);
+        }
+    });
+
+    // Copy 16 pixels at a time from RGB bytes, as PIXEL_FRAME does
+    uint8_t chunk[16 * 3];
+    for (uint8_t i = 0; i < sizeof(chunk); i++) chunk[i] = i * 5;
+    r.ingestNs = LtpBenchResult::nanosPer((uint32_t)leds.getNumPixels() * n, [n, &chunk] {
+        for (uint8_t k = 0; k < n; k++) {
+            for (uint16_t start = 0; start < leds.getNumPixels(); start += 16) {
+                copyPixels(start, chunk, min(16, leds.getNumPixels() - start));
+            }
+        }
+    });
+
+    // Full-strip PIXEL_FRAME packets; overwrites `payload`
+    r.parserNs = protocol.benchParser(5 + leds.getNumPixels() * leds.getBytesPerPixel(), n);
+
+    // loop() with no input and no frame due (benchIdlePass)
+    r.timeLoop(benchIdlePass, Serial);
+
+    leds.clear();
+    leds.show();
+
+    uint8_t response[LtpBenchResult::INFO_SIZE];
+    uint16_t respLen = r.writeInfo(response);
+    protocol.sendPacket(CMD_BENCH, response, respLen);
 }
 
 void processPacket(const LtpPacket& pkt) {
@@ -466,8 +1246,8 @@ void processPacket(const LtpPacket& pkt) {
             protocol.sendAck(CMD_RESET);
             delay(10);
             // Software reset - platform specific
-#if defined(__arm__) && defined(CORE_TEENSY)
-            // Teensy 3.x/4.x (ARM)
+#if (defined(__arm__) && defined(CORE_TEENSY)) || defined(LTP_HOST_BUILD)
+            // Teensy 3.x/4.x (ARM); the host build emulates this register
             SCB_AIRCR = 0x05FA0004;  // System reset request
 #elif defined(__AVR__)
             // AVR (Arduino Uno, Nano, Mega, etc.)
@@ -512,10 +1292,97 @@ void processPacket(const LtpPacket& pkt) {
             handlePixelFrame(pkt.payload, pkt.length);
             break;
 
+        case CMD_PIXEL_FILL:
+            handlePixelFill(pkt.payload, pkt.length);
+            break;
+
         case CMD_SET_CONTROL:
             handleSetControl(pkt.payload, pkt.length);
             break;
 
+        case CMD_SET_STRIP:
+            handleSetStrip(pkt.payload, pkt.length);
+            break;
+
+        case CMD_ANIM_START:
+            handleAnimStart(pkt.payload, pkt.length);
+            break;
+
+        case CMD_ANIM_STOP:
+            handleAnimStop(pkt.payload, pkt.length);
+            break;
+
+        case CMD_ANIM_STATUS:
+            handleAnimStatus();
+            break;
+
+        case CMD_FADE_TO:
+            handleFadeTo(pkt.payload, pkt.length);
+            break;
+
+        case CMD_SHADER_LOAD:
+            handleShaderLoad(pkt.payload, pkt.length);
+            break;
+
+        case CMD_SHADER_PARAM:
+            handleShaderParam(pkt.payload, pkt.length);
+            break;
+
+        case CMD_COORDS:
+            coords.command(protocol, pkt);
+            break;
+
+        case CMD_VIS_CONFIG:
+            handleVisConfig(pkt.payload, pkt.length);
+            break;
+
+        case CMD_VIS_VALUE:
+            handleVisValue(pkt.payload, pkt.length);
+            break;
+
+        case CMD_SCENE:
+            handleScene(pkt);
+            break;
+
+        case CMD_SEQUENCE:
+            handleSequence(pkt);
+            break;
+
+        case CMD_PALETTE:
+            handlePalette(pkt);
+            break;
+
+        case CMD_DISPLAY_LIST:
+            handleDisplayList(pkt.payload, pkt.length);
+            break;
+
+        case CMD_PROFILE:
+            handleProfile(pkt.payload, pkt.length);
+            break;
+
+        case CMD_TRACE:
+            handleTrace(pkt.payload, pkt.length);
+            break;
+
+        case CMD_BENCH:
+            handleBench(pkt.payload, pkt.length);
+            break;
+
+#if LTP_LINK_PROBE
+        case CMD_ECHO:
+            linkProbe.echo(protocol, pkt);
+            break;
+
+        case CMD_SINK:
+            linkProbe.sink(protocol, pkt);
+            break;
+#else
+        case CMD_ECHO:
+        case CMD_SINK:
+            protocol.sendNak(pkt.cmd, ERR_NOT_SUPPORTED);
+            break;
+#endif
+
         default:
             protocol.sendNak(pkt.cmd, ERR_INVALID_CMD);
             break;
@@ -535,17 +1402,45 @@ void setup() {
     leds.clear();
     leds.show();
 
+    // Effect buffers after the strip, and the coordinates and scenes saved
+    // in EEPROM
+    carveStrip(leds.getNumPixels());
+
     // Record start time
     stats.startTime = millis();
 
+#if LTP_PROFILE
+    LtpProfile::begin();
+#endif
+
     // Send HELLO to announce ourselves
     delay(100); // Small delay for serial to stabilize
     sendHello();
 }
 
 void loop() {
+#if LTP_TELEMETRY
+    // Receive queue depth and periodic STATUS_UPDATE telemetry
+    telemetry.update(protocol, config.statusInterval, stats.framesReceived, Serial.available());
+#endif
+
     // Process incoming serial data
     if (protocol.processInput()) {
-        processPacket(protocol.getPacket());
+        const LtpPacket& pkt = protocol.getPacket();
+#if LTP_LATENCY
+        latency.packetStart(pkt);
+#endif
+#if LTP_TRACE_ENTRIES
+        trace.packetStart(pkt, protocol.getErrorStats());
+#endif
+        processPacket(pkt);
+#if LTP_LATENCY
+        latency.packetDone();
+#endif
+#if LTP_TRACE_ENTRIES
+        trace.packetDone(protocol.getErrorStats());
+#endif
     }
+
+    if (updateEffects()) showFrame();
 }
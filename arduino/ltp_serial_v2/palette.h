@@ -0,0 +1,182 @@
+/**
+ * LTP Serial Protocol v2 - Palette Commands
+ *
+ * CMD_PALETTE (0x6D) for sketches built with a palette-indexed driver
+ * (LedDriverLPD8806Palette, LTP_PALETTE_BITS 4 or 8). The host loads the
+ * palette with PAL_SET and writes indices with PAL_INDICES, packed at the
+ * driver's index width, so a frame costs half a byte or a byte per pixel
+ * on the wire as in RAM. The pixel data commands keep working through the
+ * driver's nearest-color mapping.
+ *
+ * PAL_ROTATE shifts a range of entries once, or every interval for
+ * color-cycling effects (flowing water, fire, marquees) that animate the
+ * whole strip without touching a pixel: each step costs a few bytes of
+ * palette moves plus the show. The sketch calls update() once per loop()
+ * and shows the frame when it returns true; ANIM_STOP stops the rotation.
+ */
+
+#ifndef LTP_PALETTE_H
+#define LTP_PALETTE_H
+
+#include <Arduino.h>
+#include "protocol.h"
+
+class LtpPalette {
+public:
+    LtpPalette() : first(0), count(0), step(0), intervalMs(0), lastStep(0), steps(0) {}
+
+    /**
+     * CMD_PALETTE: operation byte, then its parameters. SET and ROTATE
+     * reply ACK; INDICES is only NAKed, like pixel data; INFO replies with
+     * a CMD_PALETTE packet. Returns true when the frame changed, for the
+     * sketch to show it under Auto Show.
+     */
+    template <typename Driver>
+    bool command(LtpProtocol& protocol, const LtpPacket& pkt, Driver& leds) {
+        if (pkt.length < 1) {
+            protocol.sendNak(CMD_PALETTE, ERR_INVALID_LENGTH);
+            return false;
+        }
+        const uint8_t* data = pkt.payload + 1;
+        uint16_t length = pkt.length - 1;
+        uint8_t err;
+        switch (pkt.payload[0]) {
+            case PAL_SET:
+                err = setColors(data, length, leds);
+                break;
+            case PAL_ROTATE:
+                err = rotate(data, length, leds);
+                break;
+            case PAL_INDICES:
+                err = setIndices(data, length, leds);
+                if (err != ERR_OK) {
+                    protocol.sendNak(CMD_PALETTE, err);
+                    return false;
+                }
+                return true;
+            case PAL_INFO: {
+                uint8_t response[INFO_SIZE];
+                protocol.sendPacket(CMD_PALETTE, response, writeInfo(response, leds));
+                return false;
+            }
+            default:
+                err = ERR_INVALID_PARAM;
+                break;
+        }
+        if (err != ERR_OK) {
+            protocol.sendNak(CMD_PALETTE, err);
+            return false;
+        }
+        protocol.sendAck(CMD_PALETTE);
+        return true;
+    }
+
+    // Rotate the running range when a step is due
+    template <typename Driver>
+    bool update(uint32_t now, Driver& leds) {
+        if (!isRunning() || now - lastStep < intervalMs * 1000UL) return false;
+        lastStep = now;
+        leds.rotate(first, count, step);
+        steps++;
+        return true;
+    }
+
+    void stop() {
+        intervalMs = 0;
+    }
+
+    bool isRunning() const {
+        return intervalMs != 0;
+    }
+
+    // update() would rotate the palette at now
+    bool due(uint32_t now) const {
+        return isRunning() && now - lastStep >= intervalMs * 1000UL;
+    }
+
+    // Bits, colors (2), pixels (2), index bytes (2), rotation first, count,
+    // step, interval (2), steps taken (4)
+    static const uint8_t INFO_SIZE = 16;
+
+private:
+    uint8_t first;
+    uint16_t count;
+    int8_t step;
+    uint16_t intervalMs;            // 0 = not rotating
+    uint32_t lastStep;
+    uint32_t steps;
+
+    // PAL_SET: first entry, then RGB per entry
+    template <typename Driver>
+    uint8_t setColors(const uint8_t* data, uint16_t length, Driver& leds) {
+        if (length < 4 || (length - 1) % 3) return ERR_INVALID_LENGTH;
+        uint16_t n = (length - 1) / 3;
+        if (data[0] + n > Driver::PALETTE_COLORS) return ERR_INVALID_PARAM;
+        for (uint16_t e = 0; e < n; e++) {
+            const uint8_t* c = data + 1 + e * 3;
+            leds.setPaletteColor(data[0] + e, c[0], c[1], c[2]);
+        }
+        return ERR_OK;
+    }
+
+    // PAL_INDICES: start pixel (2), then indices packed at the driver's
+    // width, the first pixel in the high nibble of 4-bit pairs
+    template <typename Driver>
+    uint8_t setIndices(const uint8_t* data, uint16_t length, Driver& leds) {
+        if (length < 3) return ERR_INVALID_LENGTH;
+        uint16_t start = data[0] | (data[1] << 8);
+        uint16_t n = (length - 2) * (8 / Driver::INDEX_BITS);
+        if (start >= leds.getNumPixels()) return ERR_PIXEL_OVERFLOW;
+        // A 4-bit payload may pad the last byte past the end of the strip
+        uint16_t room = leds.getNumPixels() - start;
+        if (n > room + (Driver::INDEX_BITS == 4 ? 1 : 0)) return ERR_PIXEL_OVERFLOW;
+        if (n > room) n = room;
+        for (uint16_t i = 0; i < n; i++) {
+            uint8_t entry = Driver::INDEX_BITS == 8 ? data[2 + i] :
+                            (i & 1 ? data[2 + (i >> 1)] & 0x0F : data[2 + (i >> 1)] >> 4);
+            if (entry >= Driver::PALETTE_COLORS) return ERR_INVALID_PARAM;
+            leds.setIndex(start + i, entry);
+        }
+        return ERR_OK;
+    }
+
+    // PAL_ROTATE: first entry, count (0 = to the last entry), step (signed,
+    // entries moved toward higher indices), interval in ms (2, 0 = once)
+    template <typename Driver>
+    uint8_t rotate(const uint8_t* data, uint16_t length, Driver& leds) {
+        if (length < 3) return ERR_INVALID_LENGTH;
+        if (data[0] >= Driver::PALETTE_COLORS) return ERR_INVALID_PARAM;
+        uint16_t n = data[1] ? data[1] : Driver::PALETTE_COLORS - data[0];
+        if (data[0] + n > Driver::PALETTE_COLORS) return ERR_INVALID_PARAM;
+        uint16_t interval = length >= 5 ? data[3] | (data[4] << 8) : 0;
+        if (interval == 0 || (int8_t)data[2] == 0) {
+            stop();
+            leds.rotate(data[0], n, (int8_t)data[2]);
+            return ERR_OK;
+        }
+        first = data[0];
+        count = n;
+        step = (int8_t)data[2];
+        intervalMs = interval;
+        lastStep = micros();
+        steps = 0;
+        return ERR_OK;
+    }
+
+    template <typename Driver>
+    uint16_t writeInfo(uint8_t* out, Driver& leds) const {
+        uint16_t i = 0;
+        out[i++] = Driver::INDEX_BITS;
+        i += putU16(out + i, Driver::PALETTE_COLORS);
+        i += putU16(out + i, leds.getNumPixels());
+        i += putU16(out + i, leds.indexBytes());
+        out[i++] = first;
+        out[i++] = count & 0xFF;        // 256 entries as 0, "to the end"
+        out[i++] = (uint8_t)step;
+        i += putU16(out + i, intervalMs);
+        i += putU32(out + i, steps);
+        return i;
+    }
+};
+
+#endif // LTP_PALETTE_H
@@ -10,12 +10,48 @@
 
 #include <Arduino.h>
 
+// Boards with 2.5 KB of RAM or less (Uno, Nano, Leonardo), where the packet
+// buffer and the strip take most of it: optional features default to off
+#if defined(__AVR__) && !defined(LTP_HOST_BUILD) && RAMEND < 0x1000
+#define LTP_SMALL_RAM       1
+#else
+#define LTP_SMALL_RAM       0
+#endif
+
 // Protocol constants
 #define LTP_START_BYTE      0xAA
-#define LTP_MAX_PAYLOAD     1024
 #define LTP_PROTOCOL_MAJOR  2
 #define LTP_PROTOCOL_MINOR  0
 
+// Largest payload a packet buffer holds. Small-RAM boards keep 512 bytes,
+// all ltp_serial_v2 accepts anyway; set it for every file when overriding
+#ifndef LTP_MAX_PAYLOAD
+#if LTP_SMALL_RAM
+#define LTP_MAX_PAYLOAD     512
+#else
+#define LTP_MAX_PAYLOAD     1024
+#endif
+#endif
+
+// Commands whose NAKs are counted individually in INFO_STATS; NAKs for
+// further commands only add to the total
+#ifndef LTP_NAK_SLOTS
+#define LTP_NAK_SLOTS       8
+#endif
+
+// Serial receive buffer capacity, to count the times it filled up (bytes
+// arriving then are lost). 0 where it is unknown or the link is flow
+// controlled (USB CDC).
+#ifndef LTP_RX_BUFFER_SIZE
+#if defined(LTP_HOST_RX_BUFFER) && !LTP_HOST_USB_SERIAL
+#define LTP_RX_BUFFER_SIZE  LTP_HOST_RX_BUFFER
+#elif defined(SERIAL_RX_BUFFER_SIZE) && !defined(LTP_HOST_BUILD)
+#define LTP_RX_BUFFER_SIZE  SERIAL_RX_BUFFER_SIZE
+#else
+#define LTP_RX_BUFFER_SIZE  0
+#endif
+#endif
+
 // Packet flags
 #define FLAG_COMPRESSED     0x10
 #define FLAG_CONTINUED      0x08
@@ -54,6 +90,7 @@
 #define CMD_PIXEL_FRAME     0x33
 #define CMD_PIXEL_FRAME_RLE 0x34
 #define CMD_PIXEL_DELTA     0x35
+#define CMD_PIXEL_FILL      0x36
 
 // Configuration Commands (0x40-0x4F)
 #define CMD_SET_CONTROL     0x40
@@ -69,6 +106,141 @@
 #define CMD_ERROR_EVENT     0x52
 #define CMD_INPUT_EVENT     0x53
 
+// Status types for STATUS_UPDATE
+#define STATUS_READY        0x01
+#define STATUS_BUSY         0x02
+#define STATUS_ERROR        0x03
+#define STATUS_TEMPERATURE  0x04
+#define STATUS_VOLTAGE      0x05
+#define STATUS_BUFFER       0x06
+#define STATUS_TELEMETRY    0x07
+
+// Animation Commands (0x60-0x6F), built-in patterns rendered on the device
+#define CMD_ANIM_START      0x60
+#define CMD_ANIM_STOP       0x61
+#define CMD_ANIM_STATUS     0x62
+#define CMD_FADE_TO         0x63
+#define CMD_SHADER_LOAD     0x64
+#define CMD_SHADER_PARAM    0x65
+#define CMD_COORDS          0x66
+#define CMD_VIS_CONFIG      0x67
+#define CMD_VIS_VALUE       0x68
+#define CMD_AUDIO           0x69
+#define CMD_SCENE           0x6A
+#define CMD_SEQUENCE        0x6B
+#define CMD_LAYER           0x6C
+#define CMD_PALETTE         0x6D
+#define CMD_DISPLAY_LIST    0x6E
+
+// Patterns for ANIM_START
+#define ANIM_SOLID          0x00
+#define ANIM_RAINBOW        0x01
+#define ANIM_CHASE          0x02
+#define ANIM_CYLON          0x03
+#define ANIM_BREATHE        0x04
+#define ANIM_SPARKLE        0x05
+#define ANIM_FIRE           0x06
+#define ANIM_SWEEP          0x07    // Band across the coordinate table
+#define ANIM_RADIAL         0x08    // Rings from the coordinate origin
+#define ANIM_SPECTRUM       0x09    // Audio bands along the segment
+#define ANIM_PULSE          0x0A    // Audio level and beats
+#define ANIM_PATTERN_COUNT  11
+
+// Palettes for ANIM_START
+#define PALETTE_RAINBOW     0x00
+#define PALETTE_FIRE        0x01
+#define PALETTE_ICE         0x02
+#define PALETTE_OCEAN       0x03
+#define PALETTE_FOREST      0x04
+#define PALETTE_LAVA        0x05
+#define PALETTE_COUNT       6
+#define PALETTE_GRADIENT    0xFF    // color1 to color2
+
+// FADE_TO modes, easing curves and flags
+#define FADE_FRAME          0x00    // To target colors
+#define FADE_LEVEL          0x01    // Brightness ramp of the current colors
+#define FADE_LINEAR         0x00
+#define FADE_EASE_IN        0x01
+#define FADE_EASE_OUT       0x02
+#define FADE_EASE_IN_OUT    0x03
+#define FADE_REPLACE        0x01    // Drop queued keyframes first
+#define FADE_CONTINUED      0x02    // More of this keyframe's targets follow
+
+// SHADER_LOAD flags
+#define SHADER_RUN          0x01    // Start the program
+#define SHADER_TEST         0x02    // Reply with a test frame's hash
+
+// COORDS operations
+#define COORDS_WRITE        0x00
+#define COORDS_CLEAR        0x01
+#define COORDS_SAVE         0x02    // To EEPROM, loaded at startup
+#define COORDS_INFO         0x03
+#define COORDS_READ         0x04
+
+// VIS_CONFIG modes and flags
+#define VIS_OFF             0x00
+#define VIS_BAR             0x01
+#define VIS_METER           0x02    // Green, yellow and red segments
+#define VIS_GAUGE           0x03    // Fill colored by the value
+#define VIS_REVERSE         0x01    // Fill from the end
+#define VIS_CENTER          0x02    // Fill from the middle (both ends with VIS_REVERSE)
+#define VIS_GRADIENT        0x04    // VIS_BAR colored along the bar
+
+// AUDIO operations
+#define AUDIO_START         0x00
+#define AUDIO_STOP          0x01
+#define AUDIO_INFO          0x02
+#define AUDIO_BANDS         8       // Octave bands from the audio engine
+
+// PIXEL_FILL operations
+#define FILL_GRADIENT       0x00
+#define FILL_PATTERN        0x01
+#define FILL_STRIDE         0x02
+#define FILL_POSITIONS      0x80    // Gradient stop count flag: stops carry a position
+
+// SCENE operations
+#define SCENE_STORE         0x00    // Current frame into a slot
+#define SCENE_UPLOAD        0x01    // Host frame into a slot, in chunks
+#define SCENE_RECALL        0x02    // Show a slot, optionally fading to it
+#define SCENE_DELETE        0x03
+#define SCENE_INFO          0x04
+
+// SEQUENCE operations, sources and play flags
+#define SEQ_PLAY            0x00
+#define SEQ_STOP            0x01
+#define SEQ_SEEK            0x02
+#define SEQ_SYNC            0x03    // Cue: continue past a sync point
+#define SEQ_INFO            0x04
+#define SEQ_FLASH           0x00    // Compiled into the sketch (PROGMEM)
+#define SEQ_SD              0x01    // File on the SD card
+#define SEQ_LOOP            0x01
+
+// LAYER operations, blend modes and flags
+#define LAYER_CONFIG        0x00
+#define LAYER_OPACITY       0x01
+#define LAYER_PIXELS        0x02
+#define LAYER_FILL          0x03
+#define LAYER_CLEAR         0x04
+#define LAYER_INFO          0x05
+#define LAYER_OVER          0x00
+#define LAYER_ADD           0x01
+#define LAYER_MULTIPLY      0x02
+#define LAYER_MAX           0x03
+#define LAYER_KEY           0x01    // Black layer pixels are transparent
+
+// PALETTE operations (palette-indexed pixel storage)
+#define PAL_SET             0x00
+#define PAL_INDICES         0x01
+#define PAL_ROTATE          0x02
+#define PAL_INFO            0x03
+
+// Diagnostic Commands (0x90-0x9F), answered with the same command
+#define CMD_PROFILE         0x90
+#define CMD_TRACE           0x91
+#define CMD_BENCH           0x92
+#define CMD_ECHO            0x93
+#define CMD_SINK            0x94
+
 // Info types for GET_INFO
 #define INFO_ALL            0x00
 #define INFO_VERSION        0x01
@@ -77,6 +249,8 @@
 #define INFO_CONTROLS       0x04
 #define INFO_STATS          0x05
 #define INFO_INPUTS         0x06
+#define INFO_LATENCY        0x07
+#define INFO_MEMORY         0x08
 
 // Error codes
 #define ERR_OK              0x00
@@ -122,6 +296,8 @@
 #define CAPS_USB_HIGHSPEED  0x08
 #define CAPS_MULTI_STRIP    0x10
 #define CAPS_INPUTS         0x20
+#define CAPS_ANIMATION      0x40
+#define CAPS_SHADER         0x80
 
 // Control types
 #define CTRL_BOOL           0x01
@@ -154,6 +330,26 @@
 // Strip ID for all strips
 #define STRIP_ALL           0xFF
 
+// Little-endian payload fields. The put helpers return the bytes written,
+// so replies are built as n += putU16(out + n, value)
+inline uint8_t putU16(uint8_t* out, uint16_t v) {
+    out[0] = v & 0xFF;
+    out[1] = v >> 8;
+    return 2;
+}
+
+inline uint8_t putU32(uint8_t* out, uint32_t v) {
+    out[0] = v & 0xFF;
+    out[1] = (v >> 8) & 0xFF;
+    out[2] = (v >> 16) & 0xFF;
+    out[3] = (v >> 24) & 0xFF;
+    return 4;
+}
+
+inline uint32_t getU32(const uint8_t* in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
 // Parser states
 enum class ParserState : uint8_t {
     WAIT_START,
@@ -172,6 +368,8 @@ struct LtpPacket {
     uint8_t cmd;
     uint8_t payload[LTP_MAX_PAYLOAD];
     uint8_t checksum;
+    uint32_t firstByteMicros;   // micros() when the START byte was read
+    uint32_t completeMicros;    // micros() when the checksum was verified
 
     void clear() {
         flags = 0;
@@ -181,6 +379,35 @@ struct LtpPacket {
     }
 };
 
+// Parser error counters (bytes and packets lost before dispatch)
+struct LtpParserStats {
+    uint32_t packets;           // Valid packets received
+    uint32_t resyncBytes;       // Bytes discarded while hunting for START
+    uint32_t droppedBytes;      // Bytes of packets discarded below
+    uint16_t checksumErrors;    // Packets dropped on checksum mismatch
+    uint16_t oversizePackets;   // Headers with length > maxPayload
+    uint16_t timeouts;          // Partial packets dropped by inter-byte timeout
+    uint16_t rxBufferFull;      // Times the serial RX buffer filled up
+};
+
+// Errors after dispatch: NAKs sent and frames the host numbered but
+// never delivered
+struct LtpErrorStats {
+    struct NakCount {
+        uint8_t cmd;
+        uint8_t lastError;      // Error code of the most recent NAK
+        uint16_t count;
+    };
+    NakCount naks[LTP_NAK_SLOTS];   // In order of first NAK
+    uint8_t nakCommands;        // Slots in use
+    uint16_t nakTotal;          // All NAKs, including untracked commands
+    uint8_t lastNakError;       // Error code of the most recent NAK
+    uint32_t droppedFrames;     // Gaps in SHOW frame numbers
+    uint16_t frameRestarts;     // SHOW frame numbers that went backwards
+    uint16_t lastFrame;
+    bool haveFrame;
+};
+
 // Protocol handler class
 class LtpProtocol {
 public:
@@ -195,6 +422,17 @@ public:
     // Send packet
     void sendPacket(uint8_t cmd, const uint8_t* payload, uint16_t length, uint8_t flags = 0);
 
+    // Send only if the whole packet fits in the TX buffer without blocking;
+    // returns false (nothing written) otherwise
+    bool trySendPacket(uint8_t cmd, const uint8_t* payload, uint16_t length, uint8_t flags = 0);
+
+    // Send a packet whose payload is written in pieces, so a reply can be
+    // generated without buffering it: beginPacket(), writePayload() until
+    // exactly `length` bytes are out, then endPacket()
+    void beginPacket(uint8_t cmd, uint16_t length, uint8_t flags = 0);
+    void writePayload(const uint8_t* data, uint16_t length);
+    void endPacket();
+
     // Send simple responses
     void sendAck(uint8_t cmd, uint8_t seq = 0);
     void sendNak(uint8_t cmd, uint8_t errorCode);
@@ -202,16 +440,52 @@ public:
     // Reset parser state
     void reset();
 
+    // Parser error counters
+    const LtpParserStats& getParserStats() const { return parserStats; }
+    void clearParserStats() { memset(&parserStats, 0, sizeof(parserStats)); }
+
+    // NAK and dropped-frame counters
+    const LtpErrorStats& getErrorStats() const { return errorStats; }
+    void clearErrorStats() { memset(&errorStats, 0, sizeof(errorStats)); }
+
+    /**
+     * Parse `packets` generated PIXEL_FRAME packets of payloadLength bytes
+     * (capped at maxPayload) and return the ns per byte, including
+     * generating the bytes. For CMD_BENCH: overwrites the received packet
+     * and leaves the parser counters as they were.
+     */
+    uint32_t benchParser(uint16_t payloadLength, uint16_t packets);
+
+    // Count the frames skipped before this SHOW frame number
+    void trackFrameNumber(uint16_t frame);
+
+    // Parser and error counters as appended to INFO_STATS. Returns the
+    // length written (at most ERROR_INFO_MAX_SIZE).
+    uint16_t writeErrorInfo(uint8_t* out) const;
+    static const uint16_t ERROR_INFO_MAX_SIZE = 25 + 4 * LTP_NAK_SLOTS;
+
+    // XOR checksum over a byte range, continuing from seed
+    static uint8_t checksum(const uint8_t* data, uint16_t length, uint8_t seed = 0);
+
+    // A partial packet is discarded if no byte arrives within this time
+    static const uint32_t INTER_BYTE_TIMEOUT = 10; // ms
+
 private:
     Stream& serial;
     LtpPacket rxPacket;
     ParserState state;
     uint16_t payloadIndex;
     uint8_t runningChecksum;
+    uint8_t txChecksum;
     uint16_t maxPayload;
     uint32_t lastByteTime;
+    uint16_t packetBytes;       // Bytes of the packet being parsed
+    bool rxFull;
+    LtpParserStats parserStats;
+    LtpErrorStats errorStats;
 
-    static const uint32_t INTER_BYTE_TIMEOUT = 10; // ms
+    void dropPacket();
+    bool processByte(uint8_t byte);
 };
 
 #endif // LTP_PROTOCOL_H
@@ -0,0 +1,111 @@
+/**
+ * LTP Serial Protocol v2 - On-Device Self-Benchmark
+ *
+ * Result and timing helpers for the CMD_BENCH diagnostic command (0x92).
+ * The sketch's handler times, on the board itself:
+ *   show()      the configured strip, mean and max of N calls
+ *   setPixel    per pixel, over the whole strip
+ *   ingest      per pixel, PIXEL_FRAME's copy from RGB bytes to the strip
+ *   parser      per byte, full-strip PIXEL_FRAME packets generated in RAM
+ *   idle loop   one pass of the sketch's own loop() while no input waits,
+ *               with whatever effects are running
+ * and returns them in one response, so capacity can be measured per board
+ * and build instead of estimated from spec tables.
+ *
+ * Timing uses micros() (4 us resolution on 16 MHz AVR); the per-pixel and
+ * per-byte figures average enough work to stay well above that. A BENCH
+ * stalls the sketch for about N show() times and leaves the strip cleared.
+ */
+
+#ifndef LTP_SELFBENCH_H
+#define LTP_SELFBENCH_H
+
+#include <Arduino.h>
+#include "protocol.h"
+
+struct LtpBenchResult {
+    uint16_t pixels;
+    uint8_t iterations;
+    uint32_t showMeanUs;
+    uint32_t showMaxUs;
+    uint32_t setPixelNs;        // Per pixel
+    uint32_t ingestNs;          // Per pixel
+    uint32_t parserNs;          // Per byte
+    uint32_t idleLoopNs;        // Per loop() pass
+
+    static const uint16_t DEFAULT_ITERATIONS = 10;
+    static const uint16_t IDLE_LOOPS = 1000;
+    static const uint16_t INFO_SIZE = 31;
+
+    // Run body() and return ns per unit of work
+    template <typename F>
+    static uint32_t nanosPer(uint32_t units, F body) {
+        uint32_t start = micros();
+        body();
+        return perUnitNs(micros() - start, units);
+    }
+
+    // ns per unit of work from elapsed microseconds
+    static uint32_t perUnitNs(uint32_t elapsedUs, uint32_t units) {
+        if (!units) return 0;
+        // Avoid 64-bit division (large on AVR)
+        return elapsedUs < 4000000UL ? elapsedUs * 1000 / units : elapsedUs / units * 1000;
+    }
+
+    /**
+     * Time up to IDLE_LOOPS calls of idlePass() into idleLoopNs, stopping
+     * early when input arrives so the BENCH reply is not held up. idlePass
+     * is the sketch's loop() with nothing to do: its checks for input and
+     * due frames, returning whether there was any, but never reading a
+     * packet or showing a frame, which would run inside the BENCH handler.
+     */
+    template <typename F>
+    void timeLoop(F idlePass, Stream& input) {
+        uint16_t passes = 0;
+        volatile bool busy = false;     // Keeps the checks from being optimised out
+        uint32_t start = micros();
+        while (passes < IDLE_LOOPS && !input.available()) {
+            busy = idlePass();
+            passes++;
+        }
+        (void)busy;
+        idleLoopNs = perUnitNs(micros() - start, passes);
+    }
+
+    // Time `iterations` calls of show() into showMeanUs/showMaxUs
+    template <typename F>
+    void timeShow(F show) {
+        uint32_t total = 0;
+        showMaxUs = 0;
+        for (uint8_t i = 0; i < iterations; i++) {
+            uint32_t start = micros();
+            show();
+            uint32_t elapsed = micros() - start;
+            total += elapsed;
+            if (elapsed > showMaxUs) showMaxUs = elapsed;
+        }
+        showMeanUs = total / iterations;
+    }
+
+    // CMD_BENCH response. Returns the length written (INFO_SIZE).
+    uint16_t writeInfo(uint8_t* out) const {
+        uint16_t n = 0;
+        out[n++] = pixels & 0xFF;
+        out[n++] = pixels >> 8;
+        out[n++] = iterations;
+#ifdef F_CPU
+        n += putU32(out + n, F_CPU);
+#else
+        n += putU32(out + n, 0);
+#endif
+        n += putU32(out + n, showMeanUs);
+        n += putU32(out + n, showMaxUs);
+        n += putU32(out + n, setPixelNs);
+        n += putU32(out + n, ingestNs);
+        n += putU32(out + n, parserNs);
+        n += putU32(out + n, idleLoopNs);
+        return n;
+    }
+};
+
+#endif // LTP_SELFBENCH_H
@@ -0,0 +1,479 @@
+/**
+ * LTP Serial Protocol v2 - Sequence Playback
+ *
+ * Plays prerecorded sequences kept on the device, from flash (PROGMEM,
+ * compiled into the sketch) or a file on an SD card, straight into the LED
+ * driver at the recorded timing, so an installation runs at full frame rate
+ * with the host disconnected. CMD_SEQUENCE (0x6B) plays, stops, seeks,
+ * cues sync points and reports progress.
+ *
+ * Sequence format "LSQ1" (integers little-endian):
+ *   Header  "LSQ1", header size (1, 16), flags (1, 0), pixels (2),
+ *           frames (4), duration (4, ms)
+ *   Frame   data length (2), hold (2, ms until the next frame), flags (1,
+ *           LTP_SEQ_KEY | LTP_SEQ_CUE), then data: runs of
+ *           skip (1), count (1), then R, G, B once, or per pixel when
+ *           count has LTP_SEQ_RUN_LITERAL set
+ *
+ * A run leaves skip pixels as they are and sets the next count (up to 127)
+ * to one color or to a color each, so a frame holds only what changed
+ * since the previous one and varied pixels cost little over raw RGB. KEY
+ * frames set every pixel and decode on their own; SEEK decodes forward
+ * from the last one at or before its target. After a CUE frame the player
+ * waits for SEQ_SYNC from the host (one that arrives early lets the next
+ * cue pass), then holds the frame for its time.
+ *
+ * SD reads go through two BlockSize buffers: frames decode from one while
+ * update() fills the other between frames, so card latency stays out of
+ * the frame timing. A frame that reaches a block not read ahead waits for
+ * it, counted as a stall. BlockSize 0 leaves SD out and takes no buffer
+ * RAM; flash is read in place.
+ *
+ * The sketch calls begin() from setup(), dispatches CMD_SEQUENCE to
+ * command() and calls update() once per loop(), showing the frame when it
+ * returns true.
+ */
+
+#ifndef LTP_SEQUENCE_H
+#define LTP_SEQUENCE_H
+
+#include <Arduino.h>
+#include "protocol.h"
+#include "profile.h"
+
+// SD card sources where the core has the SD library
+#ifndef LTP_SEQ_SD
+#if defined(CORE_TEENSY) || defined(LTP_HOST_BUILD)
+#define LTP_SEQ_SD          1
+#else
+#define LTP_SEQ_SD          0
+#endif
+#endif
+
+// Longest SD file name SEQ_PLAY takes
+#ifndef LTP_SEQ_NAME_MAX
+#define LTP_SEQ_NAME_MAX    32
+#endif
+
+#if LTP_SEQ_SD
+#include <SD.h>
+#endif
+
+// Frame flags
+#define LTP_SEQ_KEY         0x01    // Sets every pixel
+#define LTP_SEQ_CUE         0x02    // Wait for SEQ_SYNC after this frame
+
+// Run count byte
+#define LTP_SEQ_RUN_LITERAL 0x80    // A color per pixel follows
+#define LTP_SEQ_RUN_COUNT   0x7F
+
+template <uint16_t BlockSize>
+class LtpSequence {
+public:
+    LtpSequence()
+        : state(STOPPED), source(SEQ_FLASH), flags(0), flash(nullptr), flashSize(0),
+          sdPin(0), sdStarted(false), open(false), limit(0), pixels(0), frames(0),
+          frame(0), duration(0), loops(0), firstFrame(HEADER_SIZE), pos(0), size(0),
+          restart(false), restartHold(0), cued(false), pendingShow(false),
+          blockReads(0), stalls(0), lastMicros(0), maxMicros(0), nextFrame(0), inFrame(false) {
+        for (uint8_t b = 0; b < 2; b++) {
+            blockPos[b] = 0;
+            blockLen[b] = 0;
+        }
+    }
+
+    // The sketch's flash sequence (nullptr if none), the SD card's chip
+    // select pin and the logical pixel count
+    void begin(const uint8_t* flashData, uint32_t flashLength, uint8_t sdChipSelect, uint16_t pixelCount) {
+        flash = flashData;
+        flashSize = flashData ? flashLength : 0;
+        sdPin = sdChipSelect;
+        limit = pixelCount;
+    }
+
+    /**
+     * CMD_SEQUENCE: operation byte, then for SEQ_PLAY the source, flags
+     * (SEQ_LOOP) and for SEQ_SD the file name; for SEQ_SEEK the frame (4).
+     * SEEK writes the frame through setPixel(index, r, g, b). All but INFO
+     * reply ACK; INFO replies with a CMD_SEQUENCE packet.
+     */
+    template <typename SetPixel>
+    void command(LtpProtocol& protocol, const LtpPacket& pkt, SetPixel setPixel) {
+        if (pkt.length < 1) {
+            protocol.sendNak(CMD_SEQUENCE, ERR_INVALID_LENGTH);
+            return;
+        }
+        uint8_t err = ERR_OK;
+        switch (pkt.payload[0]) {
+            case SEQ_PLAY:
+                err = play(pkt.payload + 1, pkt.length - 1);
+                break;
+            case SEQ_STOP:
+                stop();
+                break;
+            case SEQ_SEEK:
+                err = seek(pkt.payload + 1, pkt.length - 1, setPixel);
+                break;
+            case SEQ_SYNC:
+                err = sync();
+                break;
+            case SEQ_INFO: {
+                uint8_t response[INFO_SIZE];
+                protocol.sendPacket(CMD_SEQUENCE, response, writeInfo(response));
+                return;
+            }
+            default:
+                err = ERR_INVALID_PARAM;
+                break;
+        }
+        if (err != ERR_OK) {
+            protocol.sendNak(CMD_SEQUENCE, err);
+        } else {
+            protocol.sendAck(CMD_SEQUENCE);
+        }
+    }
+
+    // Stop at the current frame; the pixels keep their colors
+    void stop() {
+        state = STOPPED;
+    }
+
+    /**
+     * Decode the next frame through setPixel(index, r, g, b) when it is
+     * due, else read ahead. Returns true when the caller should show the
+     * frame (also after SEQ_SEEK).
+     */
+    template <typename SetPixel>
+    bool update(uint32_t now, SetPixel setPixel) {
+        bool show = pendingShow;
+        pendingShow = false;
+        if (state == PLAYING && restart) {
+            nextFrame = now + restartHold * 1000UL;
+            restart = false;
+        }
+        if (state != PLAYING || (int32_t)(now - nextFrame) < 0) {
+            prefetch();
+            return show;
+        }
+
+        LTP_PROFILE_SCOPE(PROF_SEQ_FRAME);
+        uint32_t startMicros = micros();
+        if (frame >= frames) {
+            if (!(flags & SEQ_LOOP) || frames == 0) {
+                state = STOPPED;
+                return show;
+            }
+            rewind();
+            loops++;
+        }
+        uint16_t hold;
+        uint8_t frameFlags;
+        inFrame = true;
+        bool ok = decode(setPixel, hold, frameFlags);
+        inFrame = false;
+        if (!ok) {
+            state = STOPPED;        // Truncated sequence
+            return show;
+        }
+        frame++;
+        lastMicros = micros() - startMicros;
+        if (lastMicros > maxMicros) maxMicros = lastMicros;
+
+        // Frames keep the recorded timing; a late one is caught up on the
+        // next loop() rather than skipped, since deltas build on it
+        nextFrame += hold * 1000UL;
+        if (frameFlags & LTP_SEQ_CUE) {
+            if (!cued) {
+                state = WAITING;
+                restartHold = hold;
+            }
+            cued = false;
+        }
+        return true;
+    }
+
+    bool isRunning() const { return state != STOPPED; }
+
+    // update() would draw or show a frame at now
+    bool due(uint32_t now) const {
+        return pendingShow || (state == PLAYING && !restart && (int32_t)(now - nextFrame) >= 0);
+    }
+
+    // SEQ_INFO response: state, source, flags, what the device can play
+    // (bit 0 flash sequence, bit 1 SD), the sequence's pixels, frames,
+    // frames played, duration (ms) and loops, then the block size, blocks
+    // read, stalls and the last and longest frame decode (us)
+    uint16_t writeInfo(uint8_t* out) const {
+        uint16_t n = 0;
+        out[n++] = state;
+        out[n++] = source;
+        out[n++] = flags;
+        out[n++] = (flashSize >= HEADER_SIZE ? 0x01 : 0) | (LTP_SEQ_SD && BlockSize ? 0x02 : 0);
+        n += putU16(out + n, pixels);
+        n += putU32(out + n, frames);
+        n += putU32(out + n, frame);
+        n += putU32(out + n, duration);
+        n += putU16(out + n, loops);
+        n += putU16(out + n, BlockSize);
+        n += putU32(out + n, blockReads);
+        n += putU32(out + n, stalls);
+        n += putU32(out + n, lastMicros);
+        n += putU32(out + n, maxMicros);
+        return n;
+    }
+
+    static const uint8_t INFO_SIZE = 38;
+    static const uint8_t HEADER_SIZE = 16;
+    static const uint8_t FRAME_HEADER_SIZE = 5;
+
+private:
+    enum State : uint8_t { STOPPED, PLAYING, WAITING };
+
+    static const uint16_t BUFFER_SIZE = BlockSize ? BlockSize : 1;
+
+    State state;
+    uint8_t source;
+    uint8_t flags;
+    const uint8_t* flash;
+    uint32_t flashSize;
+    uint8_t sdPin;
+    bool sdStarted;
+    bool open;                  // A sequence is loaded
+    uint16_t limit;             // Pixels the device has
+    uint16_t pixels;            // Pixels in the sequence
+    uint32_t frames;
+    uint32_t frame;             // Frames played, the next one to decode
+    uint32_t duration;
+    uint16_t loops;
+    uint8_t firstFrame;         // Offset of frame 0
+    uint32_t pos;               // Read position
+    uint32_t size;
+    bool restart;               // Time from the next update()
+    uint16_t restartHold;       // ms until the first frame then
+    bool cued;                  // SEQ_SYNC arrived before the cue frame
+    bool pendingShow;
+    uint32_t blockReads;
+    uint32_t stalls;
+    uint32_t lastMicros;
+    uint32_t maxMicros;
+    uint32_t nextFrame;
+    bool inFrame;
+#if LTP_SEQ_SD
+    File file;
+#endif
+    uint8_t blocks[2][BUFFER_SIZE];
+    uint32_t blockPos[2];
+    uint16_t blockLen[2];       // 0 = empty
+
+    uint8_t play(const uint8_t* data, uint16_t length) {
+        if (length < 1) return ERR_INVALID_LENGTH;
+        uint8_t src = data[0];
+        uint8_t playFlags = length > 1 ? data[1] : 0;
+
+        // A request this device cannot play leaves the loaded sequence be
+        if (src == SEQ_FLASH) {
+            if (flashSize < HEADER_SIZE) return ERR_NOT_SUPPORTED;
+            stop();
+            close();
+            size = flashSize;
+        } else if (src == SEQ_SD) {
+#if LTP_SEQ_SD
+            if (BlockSize == 0) return ERR_NOT_SUPPORTED;
+            if (length < 3 || length - 2 > LTP_SEQ_NAME_MAX) return ERR_INVALID_LENGTH;
+            char name[LTP_SEQ_NAME_MAX + 1];
+            memcpy(name, data + 2, length - 2);
+            name[length - 2] = '\0';
+            stop();
+            close();
+            if (!sdStarted) sdStarted = SD.begin(sdPin);
+            if (!sdStarted) return ERR_HARDWARE;
+            file = SD.open(name);
+            if (!file) return ERR_INVALID_PARAM;
+            size = file.size();
+#else
+            return ERR_NOT_SUPPORTED;
+#endif
+        } else {
+            return ERR_INVALID_PARAM;
+        }
+        source = src;
+        open = true;
+        blockLen[0] = blockLen[1] = 0;
+
+        uint8_t header[HEADER_SIZE];
+        pos = 0;
+        if (!read(header, HEADER_SIZE) || memcmp(header, "LSQ1", 4) != 0 || header[4] < HEADER_SIZE) {
+            close();
+            return ERR_INVALID_PARAM;
+        }
+        firstFrame = header[4];
+        pixels = header[6] | (header[7] << 8);
+        frames = getU32(header + 8);
+        duration = getU32(header + 12);
+        flags = playFlags;
+        loops = 0;
+        blockReads = 0;
+        stalls = 0;
+        lastMicros = 0;
+        maxMicros = 0;
+        rewind();
+        state = PLAYING;
+        restart = true;
+        restartHold = 0;
+        cued = false;
+        return ERR_OK;
+    }
+
+    template <typename SetPixel>
+    uint8_t seek(const uint8_t* data, uint16_t length, SetPixel setPixel) {
+        if (length < 4) return ERR_INVALID_LENGTH;
+        if (!open) return ERR_CONFIG;
+        uint32_t target = getU32(data);
+        if (target >= frames) return ERR_INVALID_PARAM;
+
+        // Walk the frame headers to the last key frame at or before target
+        uint32_t keyPos = firstFrame;
+        uint32_t keyFrame = 0;
+        pos = firstFrame;
+        for (uint32_t i = 0; i <= target; i++) {
+            uint8_t head[FRAME_HEADER_SIZE];
+            uint32_t at = pos;
+            if (!read(head, FRAME_HEADER_SIZE)) return ERR_INVALID_PARAM;
+            if (head[4] & LTP_SEQ_KEY) {
+                keyPos = at;
+                keyFrame = i;
+            }
+            pos += head[0] | (head[1] << 8);
+        }
+
+        pos = keyPos;
+        uint16_t hold = 0;
+        for (uint32_t i = keyFrame; i <= target; i++) {
+            uint8_t frameFlags;
+            if (!decode(setPixel, hold, frameFlags)) return ERR_INVALID_PARAM;
+        }
+        frame = target + 1;
+        pendingShow = true;
+        if (state != STOPPED) {
+            state = PLAYING;
+            restart = true;
+            restartHold = hold;
+        }
+        return ERR_OK;
+    }
+
+    uint8_t sync() {
+        if (state == WAITING) {
+            state = PLAYING;
+            restart = true;
+        } else if (state == PLAYING) {
+            cued = true;
+        } else {
+            return ERR_CONFIG;
+        }
+        return ERR_OK;
+    }
+
+    void rewind() {
+        pos = firstFrame;
+        frame = 0;
+    }
+
+    void close() {
+#if LTP_SEQ_SD
+        if (open && source == SEQ_SD) file.close();
+#endif
+        open = false;
+        pixels = frames = frame = duration = 0;
+    }
+
+    template <typename SetPixel>
+    bool decode(SetPixel setPixel, uint16_t& hold, uint8_t& frameFlags) {
+        uint8_t head[FRAME_HEADER_SIZE];
+        if (!read(head, FRAME_HEADER_SIZE)) return false;
+        uint16_t length = head[0] | (head[1] << 8);
+        hold = head[2] | (head[3] << 8);
+        frameFlags = head[4];
+        uint16_t count = pixels < limit ? pixels : limit;
+        uint16_t index = 0;
+        while (length >= 2) {
+            uint8_t run[2];
+            if (!read(run, 2)) return false;
+            length -= 2;
+            index += run[0];
+            uint8_t n = run[1] & LTP_SEQ_RUN_COUNT;
+            bool literal = run[1] & LTP_SEQ_RUN_LITERAL;
+            uint8_t c[3];
+            for (uint8_t k = 0; k < n; k++, index++) {
+                if (literal || k == 0) {
+                    if (length < 3 || !read(c, 3)) return false;
+                    length -= 3;
+                }
+                if (index < count) setPixel(index, c[0], c[1], c[2]);
+            }
+        }
+        pos += length;
+        return true;
+    }
+
+    // Copy n bytes from the read position
+    bool read(uint8_t* out, uint16_t n) {
+        if (pos + n > size) return false;
+        if (source == SEQ_FLASH) {
+            memcpy_P(out, flash + pos, n);
+            pos += n;
+            return true;
+        }
+        while (n > 0) {
+            int8_t b = blockFor(pos);
+            if (b < 0) {
+                // Fill an empty buffer, else replace the earlier block
+                b = !blockLen[0] ? 0 : !blockLen[1] ? 1 : blockPos[0] <= blockPos[1] ? 0 : 1;
+                if (!load(b, pos - pos % BUFFER_SIZE)) return false;
+                if (inFrame) stalls++;
+            }
+            uint16_t offset = pos - blockPos[b];
+            uint16_t chunk = blockLen[b] - offset < n ? blockLen[b] - offset : n;
+            memcpy(out, blocks[b] + offset, chunk);
+            out += chunk;
+            pos += chunk;
+            n -= chunk;
+        }
+        return true;
+    }
+
+    // Load the block after the one being read, if it is not already
+    void prefetch() {
+        if (source != SEQ_SD || !open || state == STOPPED) return;
+        int8_t b = blockFor(pos);
+        uint32_t next = pos - pos % BUFFER_SIZE + (b < 0 ? 0 : BUFFER_SIZE);
+        if (next >= size || blockFor(next) >= 0) return;
+        load(b < 0 ? 0 : 1 - b, next);
+    }
+
+    int8_t blockFor(uint32_t at) const {
+        for (uint8_t b = 0; b < 2; b++) {
+            if (blockLen[b] && at >= blockPos[b] && at < blockPos[b] + blockLen[b]) return b;
+        }
+        return -1;
+    }
+
+    bool load(uint8_t b, uint32_t at) {
+#if LTP_SEQ_SD
+        blockLen[b] = 0;
+        if (!file.seek(at)) return false;
+        int got = file.read(blocks[b], BUFFER_SIZE);
+        if (got <= 0) return false;
+        blockPos[b] = at;
+        blockLen[b] = got;
+        blockReads++;
+        return true;
+#else
+        (void)b;
+        (void)at;
+        return false;
+#endif
+    }
+};
+
+#endif // LTP_SEQUENCE_H
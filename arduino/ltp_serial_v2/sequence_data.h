@@ -0,0 +1,62 @@
+// LSQ1 sequence: 160 pixels, 32 frames, 960 ms, 785 bytes
+// Generated by: python -m ltp_serial_cli PORT sequence build OUT.h
+
+#ifndef SEQUENCE_DATA_H
+#define SEQUENCE_DATA_H
+
+#include <Arduino.h>
+
+const uint8_t SEQUENCE_DATA[] PROGMEM = {
+    0x4C, 0x53, 0x51, 0x31, 0x10, 0x00, 0xA0, 0x00, 0x20, 0x00, 0x00, 0x00, 0xC0, 0x03, 0x00, 0x00,
+    0x0F, 0x00, 0x1E, 0x00, 0x01, 0x00, 0x81, 0xFF, 0x40, 0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00,
+    0x20, 0x00, 0x00, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x00, 0x81, 0x00, 0x00, 0x00, 0x05, 0x84,
+    0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00,
+    0x00, 0x06, 0x04, 0x00, 0x00, 0x00, 0x06, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10,
+    0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x10, 0x04, 0x00, 0x00, 0x00, 0x06, 0x84,
+    0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00,
+    0x00, 0x1A, 0x04, 0x00, 0x00, 0x00, 0x06, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10,
+    0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x24, 0x04, 0x00, 0x00, 0x00, 0x06, 0x84,
+    0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00,
+    0x00, 0x2E, 0x04, 0x00, 0x00, 0x00, 0x06, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10,
+    0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x38, 0x04, 0x00, 0x00, 0x00, 0x06, 0x84,
+    0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00,
+    0x00, 0x42, 0x04, 0x00, 0x00, 0x00, 0x06, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10,
+    0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x4C, 0x04, 0x00, 0x00, 0x00, 0x06, 0x84,
+    0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00,
+    0x00, 0x56, 0x04, 0x00, 0x00, 0x00, 0x06, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10,
+    0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x60, 0x04, 0x00, 0x00, 0x00, 0x06, 0x84,
+    0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00,
+    0x00, 0x6A, 0x04, 0x00, 0x00, 0x00, 0x06, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10,
+    0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x74, 0x04, 0x00, 0x00, 0x00, 0x06, 0x84,
+    0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00,
+    0x00, 0x7E, 0x04, 0x00, 0x00, 0x00, 0x06, 0x84, 0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10,
+    0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x88, 0x04, 0x00, 0x00, 0x00, 0x06, 0x84,
+    0x03, 0x01, 0x00, 0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x18, 0x00, 0x1E, 0x00,
+    0x01, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x1D, 0x00, 0x00, 0x00, 0x00, 0x84, 0x03, 0x01, 0x00,
+    0x0F, 0x04, 0x00, 0x3F, 0x10, 0x00, 0xFF, 0x40, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x96, 0x84,
+    0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x02, 0x04, 0x00, 0x00,
+    0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x8C, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04,
+    0x00, 0x03, 0x01, 0x00, 0x06, 0x04, 0x00, 0x00, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x82, 0x84,
+    0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x06, 0x04, 0x00, 0x00,
+    0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x78, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04,
+    0x00, 0x03, 0x01, 0x00, 0x06, 0x04, 0x00, 0x00, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x6E, 0x84,
+    0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x06, 0x04, 0x00, 0x00,
+    0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x64, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04,
+    0x00, 0x03, 0x01, 0x00, 0x06, 0x04, 0x00, 0x00, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x5A, 0x84,
+    0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x06, 0x04, 0x00, 0x00,
+    0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x50, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04,
+    0x00, 0x03, 0x01, 0x00, 0x06, 0x04, 0x00, 0x00, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x46, 0x84,
+    0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x06, 0x04, 0x00, 0x00,
+    0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x3C, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04,
+    0x00, 0x03, 0x01, 0x00, 0x06, 0x04, 0x00, 0x00, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x32, 0x84,
+    0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x06, 0x04, 0x00, 0x00,
+    0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x28, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04,
+    0x00, 0x03, 0x01, 0x00, 0x06, 0x04, 0x00, 0x00, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x1E, 0x84,
+    0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x06, 0x04, 0x00, 0x00,
+    0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x14, 0x84, 0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04,
+    0x00, 0x03, 0x01, 0x00, 0x06, 0x04, 0x00, 0x00, 0x00, 0x13, 0x00, 0x1E, 0x00, 0x00, 0x0A, 0x84,
+    0xFF, 0x40, 0x00, 0x3F, 0x10, 0x00, 0x0F, 0x04, 0x00, 0x03, 0x01, 0x00, 0x06, 0x04, 0x00, 0x00,
+    0x00,
+};
+
+#endif // SEQUENCE_DATA_H
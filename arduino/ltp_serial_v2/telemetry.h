@@ -0,0 +1,98 @@
+/**
+ * LTP Serial Protocol v2 - Periodic Telemetry
+ *
+ * Sends a STATUS_UPDATE (type STATUS_TELEMETRY) every STATUS_INTERVAL
+ * seconds with the frame rates, receive queue depth and high-water mark,
+ * parser errors and show() times of the period since the previous report,
+ * so a host can watch device health without GET_INFO round trips.
+ *
+ * Reports only go out when the whole packet fits in the serial TX buffer;
+ * otherwise the report is retried on the next loop() and the period grows
+ * until it does, so telemetry never stalls pixel traffic.
+ *
+ * The sketch calls update() once per loop() before processInput() and
+ * frameShown() after every displayed frame.
+ */
+
+#ifndef LTP_TELEMETRY_H
+#define LTP_TELEMETRY_H
+
+#include <Arduino.h>
+#include "protocol.h"
+
+class LtpTelemetry {
+public:
+    LtpTelemetry() : periodStart(0), lastReceived(0), lastParserErrors{0, 0} { clearPeriod(); }
+
+    // After each displayed frame, with the time its show() took
+    void frameShown(uint32_t showMicros) {
+        if (framesShown != 0xFFFF) framesShown++;
+        showTotal += showMicros;
+        if (showMicros > showMax) showMax = showMicros;
+    }
+
+    /**
+     * Track the receive queue and send a report when the interval has
+     * elapsed. intervalSeconds 0 disables reports; the first report after
+     * enabling covers the time since it was enabled.
+     */
+    void update(LtpProtocol& protocol, uint16_t intervalSeconds, uint32_t framesReceived, uint16_t rxQueued) {
+        if (rxQueued > rxHighWater) rxHighWater = rxQueued;
+
+        uint32_t now = millis();
+        if (intervalSeconds == 0) {
+            startPeriod(protocol, now, framesReceived);
+            return;
+        }
+        if (now - periodStart < (uint32_t)intervalSeconds * 1000) return;
+
+        const LtpParserStats& ps = protocol.getParserStats();
+        uint8_t payload[PAYLOAD_SIZE];
+        uint8_t n = 0;
+        payload[n++] = STATUS_TELEMETRY;
+        n += putU32(payload + n, now - periodStart);
+        n += putU16(payload + n, saturate16(framesReceived - lastReceived));
+        n += putU16(payload + n, framesShown);
+        n += putU16(payload + n, rxQueued);
+        n += putU16(payload + n, rxHighWater);
+        n += putU16(payload + n, (uint16_t)(ps.checksumErrors - lastParserErrors[0]));
+        n += putU16(payload + n, (uint16_t)(ps.oversizePackets + ps.timeouts - lastParserErrors[1]));
+        n += putU16(payload + n, saturate16(framesShown ? showTotal / framesShown : 0));
+        n += putU16(payload + n, saturate16(showMax));
+
+        if (protocol.trySendPacket(CMD_STATUS_UPDATE, payload, n)) {
+            startPeriod(protocol, now, framesReceived);
+        }
+    }
+
+    static const uint8_t PAYLOAD_SIZE = 21;
+
+private:
+    uint32_t periodStart;
+    uint32_t lastReceived;
+    uint16_t lastParserErrors[2];   // Checksum; oversize + timeouts
+    uint16_t framesShown;
+    uint16_t rxHighWater;
+    uint32_t showTotal;
+    uint32_t showMax;
+
+    void clearPeriod() {
+        framesShown = 0;
+        rxHighWater = 0;
+        showTotal = 0;
+        showMax = 0;
+    }
+
+    void startPeriod(LtpProtocol& protocol, uint32_t now, uint32_t framesReceived) {
+        const LtpParserStats& ps = protocol.getParserStats();
+        periodStart = now;
+        lastReceived = framesReceived;
+        lastParserErrors[0] = ps.checksumErrors;
+        lastParserErrors[1] = ps.oversizePackets + ps.timeouts;
+        clearPeriod();
+    }
+
+    static uint16_t saturate16(uint32_t v) { return v > 0xFFFF ? 0xFFFF : (uint16_t)v; }
+};
+
+#endif // LTP_TELEMETRY_H
@@ -0,0 +1,119 @@
+/**
+ * LTP Serial Protocol v2 - Packet Trace Ring
+ *
+ * Records the last LTP_TRACE_ENTRIES dispatched packets: command, flags,
+ * length, micros() at the START byte, handler duration and result (ERR_OK
+ * or the error code of the NAK the handler sent). Read with the CMD_TRACE
+ * diagnostic command (0x91) after a glitch to see what the controller was
+ * doing, in order, without a serial sniffer.
+ *
+ * Recording is a handful of stores per packet. The sketch calls
+ * packetStart() before processPacket() and packetDone() after it.
+ */
+
+#ifndef LTP_TRACE_H
+#define LTP_TRACE_H
+
+#include <Arduino.h>
+#include "protocol.h"
+
+// Ring size (11 bytes per entry); 0 disables tracing
+#ifndef LTP_TRACE_ENTRIES
+#if LTP_SMALL_RAM
+#define LTP_TRACE_ENTRIES   0
+#elif defined(__AVR__) && !defined(LTP_HOST_BUILD)
+#define LTP_TRACE_ENTRIES   8
+#else
+#define LTP_TRACE_ENTRIES   128
+#endif
+#endif
+
+// Most entries in one CMD_TRACE reply
+#define LTP_TRACE_REPLY_ENTRIES (LTP_TRACE_ENTRIES < 32 ? LTP_TRACE_ENTRIES : 32)
+
+struct LtpTraceEntry {
+    uint32_t arrival;           // micros() at the START byte
+    uint16_t duration;          // Handler time in us, saturated
+    uint16_t length;
+    uint8_t cmd;
+    uint8_t flags;
+    uint8_t result;             // ERR_OK or NAK error code
+};
+
+#if LTP_TRACE_ENTRIES
+
+class LtpTrace {
+public:
+    LtpTrace() : count(0), clearPending(false) {}
+
+    // Empty the ring once the packet being handled is done; the packet
+    // that asked for it is not recorded
+    void clear() { clearPending = true; }
+
+    void packetStart(const LtpPacket& pkt, const LtpErrorStats& errors) {
+        LtpTraceEntry& e = entries[count % LTP_TRACE_ENTRIES];
+        e.arrival = pkt.firstByteMicros;
+        e.length = pkt.length;
+        e.cmd = pkt.cmd;
+        e.flags = pkt.flags;
+        nakTotal = errors.nakTotal;
+        start = micros();
+    }
+
+    void packetDone(const LtpErrorStats& errors) {
+        LtpTraceEntry& e = entries[count % LTP_TRACE_ENTRIES];
+        uint32_t elapsed = micros() - start;
+        e.duration = elapsed > 0xFFFF ? 0xFFFF : (uint16_t)elapsed;
+        e.result = errors.nakTotal != nakTotal ? errors.lastNakError : ERR_OK;
+        count++;
+        if (clearPending) {
+            count = 0;
+            clearPending = false;
+        }
+    }
+
+    /**
+     * CMD_TRACE response: capacity, packets traced, current micros(), the
+     * sequence number of the first entry returned and the entries from
+     * sequence number `from` on (oldest first, at most
+     * LTP_TRACE_REPLY_ENTRIES). Entries older than the ring are skipped.
+     */
+    uint16_t writeInfo(uint8_t* out, uint32_t from) const {
+        uint32_t oldest = count > LTP_TRACE_ENTRIES ? count - LTP_TRACE_ENTRIES : 0;
+        if (from < oldest) from = oldest;
+        if (from > count) from = count;
+        uint32_t n = count - from;
+        if (n > LTP_TRACE_REPLY_ENTRIES) n = LTP_TRACE_REPLY_ENTRIES;
+
+        uint16_t len = 0;
+        len += putU16(out + len, LTP_TRACE_ENTRIES);
+        len += putU32(out + len, count);
+        len += putU32(out + len, micros());
+        len += putU32(out + len, from);
+        out[len++] = (uint8_t)n;
+        for (uint32_t seq = from; seq < from + n; seq++) {
+            const LtpTraceEntry& e = entries[seq % LTP_TRACE_ENTRIES];
+            out[len++] = e.cmd;
+            out[len++] = e.flags;
+            len += putU16(out + len, e.length);
+            len += putU32(out + len, e.arrival);
+            len += putU16(out + len, e.duration);
+            out[len++] = e.result;
+        }
+        return len;
+    }
+
+    static const uint16_t ENTRY_SIZE = 11;
+    static const uint16_t INFO_MAX_SIZE = 15 + ENTRY_SIZE * LTP_TRACE_REPLY_ENTRIES;
+
+private:
+    LtpTraceEntry entries[LTP_TRACE_ENTRIES];
+    uint32_t count;             // Packets traced; the next entry's sequence number
+    uint32_t start;
+    uint16_t nakTotal;          // errors.nakTotal before the handler ran
+    bool clearPending;
+};
+
+#endif // LTP_TRACE_ENTRIES
+
+#endif // LTP_TRACE_H
@@ -27,21 +27,62 @@ from .protocol import (
     CMD_NOP, CMD_RESET, CMD_ACK, CMD_NAK, CMD_HELLO, CMD_SHOW,
     CMD_GET_INFO, CMD_GET_PIXELS, CMD_GET_CONTROL, CMD_GET_STRIP, CMD_GET_INPUT,
     CMD_PIXEL_SET_ALL, CMD_PIXEL_SET_RANGE, CMD_PIXEL_SET_INDEXED,
-    CMD_PIXEL_FRAME, CMD_PIXEL_FRAME_RLE, CMD_PIXEL_DELTA,
-    CMD_SET_CONTROL, CMD_INPUT_EVENT,
+    CMD_PIXEL_FRAME, CMD_PIXEL_FRAME_RLE, CMD_PIXEL_DELTA, CMD_PIXEL_FILL,
+    CMD_SET_CONTROL, CMD_INPUT_EVENT, CMD_PROFILE, CMD_TRACE, CMD_BENCH,
+    CMD_ECHO, CMD_SINK, CMD_ANIM_START, CMD_ANIM_STOP, CMD_ANIM_STATUS,
+    CMD_FADE_TO, CMD_SHADER_LOAD, CMD_SHADER_PARAM, CMD_COORDS,
+    CMD_VIS_CONFIG, CMD_VIS_VALUE, CMD_AUDIO, CMD_SCENE, CMD_SEQUENCE, CMD_LAYER, CMD_PALETTE,
+    CMD_DISPLAY_LIST,
     # Info types
-    INFO_ALL, INFO_VERSION, INFO_STRIPS, INFO_STATUS, INFO_CONTROLS, INFO_STATS, INFO_INPUTS,
+    INFO_ALL, INFO_VERSION, INFO_STRIPS, INFO_STATUS, INFO_CONTROLS, INFO_STATS, INFO_INPUTS, INFO_LATENCY,
+    INFO_MEMORY,
     # Error codes
     ERR_OK, ERR_CHECKSUM, ERR_INVALID_CMD, ERR_INVALID_LENGTH,
     ERR_INVALID_PARAM, ERR_BUFFER_OVERFLOW, ERR_PIXEL_OVERFLOW,
     # Control IDs
     CTRL_ID_BRIGHTNESS, CTRL_ID_GAMMA, CTRL_ID_IDLE_TIMEOUT,
-    CTRL_ID_AUTO_SHOW, CTRL_ID_FRAME_ACK,
+    CTRL_ID_AUTO_SHOW, CTRL_ID_FRAME_ACK, CTRL_ID_STATUS_INTERVAL,
+    # Status types
+    STATUS_TELEMETRY,
     # LED types
     LED_TYPE_WS2812, LED_TYPE_SK6812, LED_TYPE_APA102, LED_TYPE_LPD8806,
+    # Built-in animations
+    ANIM_SOLID, ANIM_RAINBOW, ANIM_CHASE, ANIM_CYLON, ANIM_BREATHE, ANIM_SPARKLE, ANIM_FIRE,
+    ANIM_SWEEP, ANIM_RADIAL, ANIM_SPECTRUM, ANIM_PULSE,
+    PALETTE_RAINBOW, PALETTE_FIRE, PALETTE_ICE, PALETTE_OCEAN, PALETTE_FOREST, PALETTE_LAVA,
+    PALETTE_GRADIENT,
+    FADE_LINEAR, FADE_EASE_IN, FADE_EASE_OUT, FADE_EASE_IN_OUT,
+    # Visualizers
+    VIS_OFF, VIS_BAR, VIS_METER, VIS_GAUGE, VIS_REVERSE, VIS_CENTER, VIS_GRADIENT,
+    # Audio engine
+    AUDIO_START, AUDIO_STOP, AUDIO_INFO, AUDIO_BANDS,
+    # Scene cache
+    SCENE_STORE, SCENE_UPLOAD, SCENE_RECALL, SCENE_DELETE, SCENE_INFO,
+    # Fill primitives
+    FILL_GRADIENT, FILL_PATTERN, FILL_STRIDE, FILL_POSITIONS,
+    # Stored sequences
+    SEQ_PLAY, SEQ_STOP, SEQ_SEEK, SEQ_SYNC, SEQ_INFO, SEQ_FLASH, SEQ_SD, SEQ_LOOP,
+    # Layer compositor
+    LAYER_CONFIG, LAYER_OPACITY, LAYER_PIXELS, LAYER_FILL, LAYER_CLEAR, LAYER_INFO,
+    LAYER_OVER, LAYER_ADD, LAYER_MULTIPLY, LAYER_MAX, LAYER_KEY,
+    # Palette-indexed pixels
+    PAL_SET, PAL_INDICES, PAL_ROTATE, PAL_INFO,
 )
 
-from .device import LtpDevice, DeviceInfo, StripInfo, DeviceStatus, DeviceStats
+from .device import (
+    LtpDevice, DeviceInfo, StripInfo, DeviceStatus, DeviceStats, NakCount, DeviceLatency,
+    DeviceProfile, ProfileSection, DeviceTelemetry,
+    DeviceTrace, TraceEntry, DeviceBench, SinkReport, LinkProbe,
+    DeviceAnimation, DeviceShader, ShaderTest, DeviceCoords,
+    DeviceVisualizer, DeviceAudio, DeviceScenes, SceneSlot,
+    DeviceSequence, DeviceLayers, LayerState, DevicePalette,
+    DeviceDisplayList, DeviceMemory,
+)
+from .shader import ShaderFrame, ShaderError, assemble, disassemble, render as render_shader
+from .sequence import (
+    SequenceWriter, SequenceFrame, read_sequence, from_capture, demo_sequence,
+)
+from .capture import CaptureWriter, CaptureRecord, read_capture
 from .exceptions import (
     LtpError,
     LtpConnectionError,
@@ -61,6 +102,46 @@ __all__ = [
     "StripInfo",
     "DeviceStatus",
     "DeviceStats",
+    "NakCount",
+    "DeviceLatency",
+    "DeviceProfile",
+    "DeviceTelemetry",
+    "ProfileSection",
+    "DeviceTrace",
+    "TraceEntry",
+    "DeviceBench",
+    "SinkReport",
+    "LinkProbe",
+    "DeviceAnimation",
+    "DeviceShader",
+    "ShaderTest",
+    "DeviceCoords",
+    "DeviceVisualizer",
+    "DeviceAudio",
+    "DeviceScenes",
+    "SceneSlot",
+    "DeviceSequence",
+    "DeviceLayers",
+    "LayerState",
+    "DevicePalette",
+    "DeviceDisplayList",
+    "DeviceMemory",
+    # Pixel shaders
+    "ShaderFrame",
+    "ShaderError",
+    "assemble",
+    "disassemble",
+    "render_shader",
+    # Stored sequences
+    "SequenceWriter",
+    "SequenceFrame",
+    "read_sequence",
+    "from_capture",
+    "demo_sequence",
+    # Capture files
+    "CaptureWriter",
+    "CaptureRecord",
+    "read_capture",
     # Exceptions
     "LtpError",
     "LtpConnectionError",
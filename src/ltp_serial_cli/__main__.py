@@ -9,11 +9,18 @@ Usage:
 """
 
 import argparse
+import json
 import sys
 import time
 
-from .device import LtpDevice
+from .device import DeviceAnimation, DeviceLatency, DeviceTelemetry, LtpDevice
 from .exceptions import LtpError
+from .protocol import (
+    ANIM_PATTERN_NAMES, FADE_EASING_NAMES, LAYER_BLEND_NAMES, PALETTE_NAMES, VIS_MODE_NAMES,
+    VIS_OFF, VIS_REVERSE, VIS_CENTER, VIS_GRADIENT,
+)
+from .sequence import demo_sequence, from_capture
+from .shader import ShaderError, assemble
 
 
 def cmd_info(device: LtpDevice, args: argparse.Namespace):
@@ -71,6 +78,586 @@ def cmd_stats(device: LtpDevice, args: argparse.Namespace):
     seconds = uptime % 60
     print(f"Uptime: {hours}h {minutes}m {seconds}s")
 
+    if not stats.extended:
+        return
+
+    print()
+    print(f"Packets Received: {stats.packets_received}")
+    print(f"Oversize Packets: {stats.oversize_packets}")
+    print(f"Timeouts: {stats.timeouts}")
+    print(f"Resync Bytes: {stats.resync_bytes}")
+    print(f"Dropped Bytes: {stats.dropped_bytes}")
+    print(f"Dropped Frames: {stats.dropped_frames} ({stats.frame_restarts} restarts)")
+    print(f"NAKs: {stats.nak_total}")
+    for nak in stats.naks:
+        print(f"  {nak.command_name:<16} {nak.count:6}  last {nak.last_error_name}")
+
+
+def _format_us(us) -> str:
+    if us is None:
+        return "-"
+    return f"{us / 1000:.2f} ms" if us >= 1000 else f"{us} us"
+
+
+def cmd_latency(device: LtpDevice, args: argparse.Namespace):
+    """Show device-side frame latency."""
+    latency = device.get_latency(clear=args.clear)
+    print(f"Frames Measured: {latency.frames}")
+    if not latency.frames:
+        return
+
+    print("Last Frame (after first byte):")
+    print(f"  Checksum OK:  {_format_us(latency.last_checksum_us)}")
+    print(f"  Handler Done: {_format_us(latency.last_handler_us)}")
+    print(f"  Show Start:   {_format_us(latency.last_show_start_us)}")
+    print(f"  Show Done:    {_format_us(latency.last_show_done_us)}")
+
+    # Percentiles are bucket upper bounds (log2 histograms)
+    for name, hist in (("Receive to Show", latency.receive_to_show), ("Show Duration", latency.show_duration)):
+        p50 = DeviceLatency.percentile(hist, 50)
+        p99 = DeviceLatency.percentile(hist, 99)
+        print(f"{name}: p50 <= {_format_us(p50)}, p99 <= {_format_us(p99)}")
+
+
+def cmd_telemetry(device: LtpDevice, args: argparse.Namespace):
+    """Stream periodic device telemetry."""
+
+    def on_telemetry(t: DeviceTelemetry):
+        print(
+            f"rx {t.receive_fps:6.1f} fps  shown {t.display_fps:6.1f} fps  "
+            f"queue {t.rx_queued:4d} (max {t.rx_high_water:4d})  "
+            f"errors {t.checksum_errors}/{t.framing_errors}  "
+            f"show {t.show_mean_us} us (max {t.show_max_us} us)",
+            flush=True,
+        )
+
+    device.set_telemetry_callback(on_telemetry)
+    device.set_status_interval(args.interval)
+    print(f"Telemetry every {args.interval} s (Ctrl+C to stop)")
+    try:
+        if args.duration:
+            time.sleep(args.duration)
+        else:
+            while True:
+                time.sleep(1)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        device.set_status_interval(0)
+
+
+def cmd_profile(device: LtpDevice, args: argparse.Namespace):
+    """Show the firmware section profile."""
+    profile = device.get_profile(clear=args.clear)
+    if not profile.sections:
+        print("No profiled sections entered")
+        return
+
+    print(f"Tick Rate: {profile.tick_hz} Hz")
+    print(f"{'Section':<26} {'Calls':>10} {'Mean':>10} {'Max':>10} {'Total':>12}")
+    for s in profile.sections:
+        mean = profile.to_us(s.total_ticks / s.count)
+        print(
+            f"{s.name:<26} {s.count:>10} {mean:>7.2f} us {profile.to_us(s.max_ticks):>7.1f} us"
+            f" {profile.to_us(s.total_ticks) / 1000:>9.2f} ms"
+        )
+
+
+def cmd_bench(device: LtpDevice, args: argparse.Namespace):
+    """Run the on-device self-benchmark."""
+    bench = device.bench(args.iterations)
+
+    def cycles(ns):
+        c = bench.cycles(ns)
+        return f"  ({c:.0f} cycles)" if c is not None else ""
+
+    clock = f"{bench.cpu_hz / 1e6:.0f} MHz" if bench.cpu_hz else "unknown"
+    print(f"Pixels: {bench.pixels}, {bench.iterations} iterations, CPU {clock}")
+    print(f"show():      {_format_us(bench.show_mean_us)} mean, {_format_us(bench.show_max_us)} max")
+    print(f"setPixel:    {bench.set_pixel_ns} ns/pixel{cycles(bench.set_pixel_ns)}")
+    print(f"Ingest:      {bench.ingest_ns} ns/pixel{cycles(bench.ingest_ns)}")
+    print(f"Parser:      {bench.parser_ns} ns/byte{cycles(bench.parser_ns)}"
+          f"  (max {bench.max_parse_bytes_per_second / 1000:.0f} KB/s)")
+    print(f"Idle loop:   {bench.idle_loop_ns} ns{cycles(bench.idle_loop_ns)}")
+    print(f"Max FPS (ingest + show, no link): {bench.max_fps:.1f}")
+
+
+def cmd_probe(device: LtpDevice, args: argparse.Namespace):
+    """Measure round-trip time and link throughput."""
+    link = device.probe_link(rounds=args.rounds, sink_bytes=args.bytes)
+    sink = link.sink
+    print(f"Round trip:  {link.rtt_min_ms:.2f} ms min, {link.rtt_mean_ms:.2f} ms mean, {link.rtt_max_ms:.2f} ms max")
+    print(f"Upstream:    {link.upstream_bytes_per_second / 1000:.1f} KB/s (device to host)")
+    print(f"Downstream:  {link.downstream_bytes_per_second / 1000:.1f} KB/s (host to device, "
+          f"{sink.bytes} bytes in {_format_us(sink.elapsed_us)})")
+    print(f"Loss:        {sink.lost_packets} of {sink.packets + sink.lost_packets} packets ({link.loss:.1%}), "
+          f"{sink.checksum_errors} checksum, {sink.framing_errors} framing, {sink.rx_buffer_full} RX buffer full")
+    if device.info and device.info.total_pixels:
+        print(f"Max FPS (link, full PIXEL_FRAME): {link.max_fps(device.info.total_pixels):.1f}")
+
+
+def _parse_color(text: str) -> tuple[int, int, int]:
+    """Parse RRGGBB hex or R,G,B."""
+    parts = text.split(",")
+    if len(parts) == 3:
+        return tuple(max(0, min(255, int(p))) for p in parts)
+    value = int(text.lstrip("#"), 16)
+    return ((value >> 16) & 0xFF, (value >> 8) & 0xFF, value & 0xFF)
+
+
+def _print_animation(anim: DeviceAnimation):
+    if not anim.running:
+        print(f"Animation: stopped (last: {anim.pattern_name}, {anim.frames} frames)")
+        return
+    print(f"Animation: {anim.pattern_name} on pixels {anim.start}-{anim.start + anim.count - 1} at {anim.fps} FPS")
+    print(f"  Speed {anim.speed} (16 = default), size {anim.size}, intensity {anim.intensity}, "
+          f"palette {anim.palette_name}")
+    print(f"  Color #{bytes(anim.color1).hex()}, background #{bytes(anim.color2).hex()}")
+    print(f"  Frames: {anim.frames}, last render {_format_us(anim.render_us)}")
+
+
+def _print_fade(anim: DeviceAnimation):
+    if not anim.fade_pixels:
+        print("Fades: not supported")
+    elif anim.fade_queued:
+        print(f"Fades: {anim.fade_queued} of {anim.fade_capacity} keyframes queued, "
+              f"running one {anim.fade_progress:.0%} done")
+    else:
+        print(f"Fades: idle ({anim.fade_capacity} keyframes of up to {anim.fade_pixels} pixels)")
+
+
+def _print_shader(anim: DeviceAnimation):
+    shader = anim.shader
+    if shader is None:
+        return
+    if not shader.code_length:
+        print(f"Shader: none loaded (up to {shader.code_capacity} bytes)")
+        return
+    state = "running" if shader.running else "stopped"
+    print(f"Shader: {shader.code_length} bytes, {state} on pixels {shader.start}-{shader.start + shader.count - 1} "
+          f"({shader.width}x{shader.height}) at {shader.fps} FPS")
+    print(f"  Frames: {shader.frames}, last render {_format_us(shader.render_us)}, "
+          f"{shader.frame_steps} instructions")
+    print(f"  Most per pixel: {shader.max_pixel_steps} of {shader.budget}, faults: {shader.faults}")
+    print(f"  Params: {' '.join(str(v) for v in shader.params)}")
+
+
+def _print_visualizer(anim: DeviceAnimation):
+    vis = anim.visualizer
+    if vis is None:
+        return
+    if vis.mode == VIS_OFF:
+        print(f"Visualizer: off ({vis.frames} frames)")
+        return
+    print(f"Visualizer: {vis.bars} {vis.mode_name}(s) on pixels {vis.start}-{vis.start + vis.count - 1}")
+    print(f"  Values: {' '.join(str(v) for v in vis.values)}, shown {' '.join(str(v) for v in vis.levels)}, "
+          f"peaks {' '.join(str(v) for v in vis.peaks)}")
+    print(f"  Frames: {vis.frames}, last render {_format_us(vis.render_us)}")
+
+
+def cmd_animate(device: LtpDevice, args: argparse.Namespace):
+    """Start, stop or show the device's built-in animation."""
+    if args.pattern == "status":
+        anim = device.get_animation()
+        _print_animation(anim)
+        _print_fade(anim)
+        _print_shader(anim)
+        _print_visualizer(anim)
+        return
+    if args.pattern == "stop":
+        device.stop_animation(clear=args.clear)
+        print("Animation stopped")
+        return
+
+    patterns = {name: value for value, name in ANIM_PATTERN_NAMES.items()}
+    palettes = {name: value for value, name in PALETTE_NAMES.items()}
+    device.start_animation(
+        patterns[args.pattern],
+        speed=args.speed,
+        size=args.size,
+        intensity=args.intensity,
+        palette=None if args.palette is None else palettes[args.palette],
+        color1=None if args.color is None else _parse_color(args.color),
+        color2=_parse_color(args.background),
+        start=args.start,
+        count=args.count,
+        fps=args.fps,
+    )
+    _print_animation(device.get_animation())
+
+
+def cmd_fade(device: LtpDevice, args: argparse.Namespace):
+    """Fade to a color or through a brightness ramp, rendered on the device."""
+    easings = {name: value for value, name in FADE_EASING_NAMES.items()}
+    easing = easings[args.easing]
+    if args.level:
+        device.fade_level(args.level[0], args.level[1], args.duration, args.start, args.count,
+                          easing, replace=args.replace)
+        print(f"Fading level {args.level[0]} -> {args.level[1]} over {args.duration:g} s")
+        return
+
+    count = args.count or (device.pixel_count or 160) - args.start
+    color = _parse_color(args.color)
+    device.fade_to(bytes(color) * count, args.duration, args.start, easing, replace=args.replace)
+    print(f"Fading {count} pixels to #{bytes(color).hex()} over {args.duration:g} s")
+
+
+def cmd_shader(device: LtpDevice, args: argparse.Namespace):
+    """Upload, test or set parameters of a pixel shader."""
+    if args.action == "param":
+        if len(args.args) < 2:
+            print("Usage: shader param FIRST VALUE [VALUE ...]", file=sys.stderr)
+            return
+        values = [int(v, 0) for v in args.args[1:]]
+        device.set_shader_params(int(args.args[0]), values)
+        print(f"Parameters {args.args[0]}+: {' '.join(str(v) for v in values)}")
+        return
+
+    if len(args.args) != 1:
+        print(f"Usage: shader {args.action} FILE", file=sys.stderr)
+        return
+    try:
+        with open(args.args[0]) as f:
+            code = assemble(f.read())
+    except (OSError, ShaderError) as e:
+        print(f"Error: {args.args[0]}: {e}", file=sys.stderr)
+        return
+
+    if args.params:
+        device.set_shader_params(0, args.params)
+    if args.action == "test":
+        test = device.test_shader(code, args.time, args.budget, args.start, args.count)
+        ref = test.reference
+        print(f"Device:    hash {test.hash:08X}, {test.steps} instructions "
+              f"(max {test.max_pixel_steps}/pixel), {test.faults} faults, {_format_us(test.render_us)}")
+        if ref is not None:
+            print(f"Reference: hash {ref.hash:08X}, {ref.steps} instructions "
+                  f"(max {ref.max_pixel_steps}/pixel), {ref.faults} faults")
+        print("Match" if test.matches else "MISMATCH")
+        return
+
+    device.load_shader(code, run=args.action == "run", fps=args.fps, budget=args.budget,
+                       start=args.start, count=args.count)
+    print(f"Shader {'running' if args.action == 'run' else 'loaded'}: {len(code)} bytes")
+
+
+def cmd_vis(device: LtpDevice, args: argparse.Namespace):
+    """Set up a bar graph, meter or gauge on the device, or send it values."""
+    if args.action == "set":
+        if not args.values:
+            print("Usage: vis set VALUE [VALUE ...]", file=sys.stderr)
+            return
+        device.set_visualizer(args.values, args.low, args.high)
+        # VIS_VALUE has no ACK; read the state back so a NAK shows up here
+        _print_visualizer(device.get_animation())
+        return
+    if args.action == "status":
+        _print_visualizer(device.get_animation())
+        return
+
+    modes = {name: value for value, name in VIS_MODE_NAMES.items()}
+    flags = ((VIS_REVERSE if args.reverse else 0) | (VIS_CENTER if args.center else 0) |
+             (VIS_GRADIENT if args.gradient else 0))
+    colors = {}
+    for name in ("color1", "color2", "background"):
+        if getattr(args, name) is not None:
+            colors[name] = _parse_color(getattr(args, name))
+    device.configure_visualizer(
+        modes[args.action], flags, args.start, args.count, args.bars, args.gap, args.segments,
+        args.fall, args.hold, **colors,
+    )
+    if args.values:
+        device.set_visualizer(args.values, args.low, args.high)
+    _print_visualizer(device.get_animation())
+
+
+def cmd_audio(device: LtpDevice, args: argparse.Namespace):
+    """Start, stop or show the device's audio engine."""
+    if args.action == "start":
+        device.start_audio(args.gain, args.threshold)
+    elif args.action == "stop":
+        device.stop_audio()
+    audio = device.get_audio()
+    state = "running" if audio.running else "stopped"
+    gain = f"{audio.gain} dB" if audio.gain else "automatic"
+    print(f"Audio: {state}, {audio.rate} Hz in blocks of {audio.samples}, gain {gain}, "
+          f"beat threshold {audio.threshold / 64:.2f}x")
+    print(f"  Level: {audio.level}, bands: {' '.join(str(v) for v in audio.bands)}")
+    bpm = f", {audio.bpm:.1f} BPM" if audio.bpm else ""
+    print(f"  Blocks: {audio.blocks}, overruns: {audio.overruns}, beats: {audio.beats}{bpm}")
+    print(f"  Per block: last {_format_us(round(audio.ticks_to_us(audio.last_ticks)))}, "
+          f"mean {_format_us(round(audio.ticks_to_us(audio.mean_ticks)))}, "
+          f"max {_format_us(round(audio.ticks_to_us(audio.max_ticks)))}")
+
+
+def cmd_scene(device: LtpDevice, args: argparse.Namespace):
+    """Store, upload, recall or delete scenes in the device's scene cache."""
+    if args.action != "info":
+        if args.id is None:
+            print(f"Usage: scene {args.action} ID", file=sys.stderr)
+            return
+        if args.action == "store":
+            device.store_scene(args.id)
+            print(f"Stored the current frame as scene {args.id}")
+        elif args.action == "upload":
+            scenes = device.get_scenes()
+            color = _parse_color(args.color)
+            device.upload_scene(args.id, [color] * scenes.pixels)
+            print(f"Uploaded {scenes.pixels} pixels of #{bytes(color).hex()} as scene {args.id}")
+        elif args.action == "recall":
+            easings = {name: value for value, name in FADE_EASING_NAMES.items()}
+            device.recall_scene(args.id, args.duration, easings[args.easing])
+            fade = f" over {args.duration:g} s" if args.duration else ""
+            print(f"Recalled scene {args.id}{fade}")
+        else:
+            device.delete_scene(args.id)
+            print(f"Deleted scene {args.id}")
+        return
+
+    scenes = device.get_scenes()
+    print(f"Scenes: {len(scenes.slots)} slots of {scenes.pixels} pixels, {len(scenes.free)} free")
+    for slot in scenes.slots:
+        storage = "EEPROM" if slot.eeprom else "RAM"
+        contents = f"{slot.pixels} pixels" if slot.pixels else "empty"
+        print(f"  [{slot.id}] {storage:6s} {contents}")
+
+
+def cmd_sequence(device: LtpDevice, args: argparse.Namespace):
+    """Build, play, stop, seek or cue stored sequences."""
+    if args.action == "build":
+        if not args.arg:
+            print("Usage: sequence build OUT.lsq|OUT.h [--from CAPTURE] [--pixels N]", file=sys.stderr)
+            return
+        pixels = args.pixels or (device.info.total_pixels if device.info else 0)
+        if args.source:
+            writer = from_capture(args.source, pixels, args.key_interval)
+        else:
+            writer = demo_sequence(pixels)
+        if args.arg.endswith(".h"):
+            writer.write_c_header(args.arg)
+        else:
+            writer.write(args.arg)
+        size = len(writer.to_bytes())
+        print(f"Wrote {args.arg}: {pixels} pixels, {writer.frame_count} frames, "
+              f"{writer.duration_ms / 1000:.2f} s, {size} bytes "
+              f"({100 * size / max(1, writer.frame_count * pixels * 3):.1f}% of raw)")
+        return
+    if args.action == "play":
+        device.play_sequence(args.arg, loop=args.loop)
+        source = f"SD file {args.arg}" if args.arg else "flash sequence"
+        print(f"Playing the {source}{' in a loop' if args.loop else ''}")
+        return
+    if args.action == "stop":
+        device.stop_sequence()
+        print("Sequence stopped")
+        return
+    if args.action == "seek":
+        if args.arg is None:
+            print("Usage: sequence seek FRAME", file=sys.stderr)
+            return
+        device.seek_sequence(int(args.arg))
+        print(f"Sequence at frame {int(args.arg)}")
+        return
+    if args.action == "sync":
+        device.sync_sequence()
+        print("Sync sent")
+        return
+
+    seq = device.get_sequence()
+    sources = [name for name, present in (("flash", seq.has_flash), ("SD", seq.has_sd)) if present]
+    print(f"Sequence: {seq.state_name} (sources: {', '.join(sources) or 'none'})")
+    if seq.frames:
+        source = "SD" if seq.source else "flash"
+        print(f"  {source}: {seq.pixels} pixels, frame {seq.frame}/{seq.frames}, "
+              f"{seq.duration_ms / 1000:.2f} s{', looping' if seq.loop else ''}, {seq.loops} loops")
+    if seq.has_sd:
+        print(f"  SD blocks: {seq.block_reads} x {seq.block_size} bytes, {seq.stalls} stalls")
+    print(f"  Decode: last {_format_us(seq.last_decode_us)}, max {_format_us(seq.max_decode_us)}")
+
+
+def cmd_layer(device: LtpDevice, args: argparse.Namespace):
+    """Place, restyle or clear overlay layers composited over the frame on the device."""
+    blends = {name: value for value, name in LAYER_BLEND_NAMES.items()}
+    if args.action == "set":
+        if args.id is None or len(args.values) < 2:
+            print("Usage: layer set ID START COUNT [COLOR...]", file=sys.stderr)
+            return
+        start, count = int(args.values[0]), int(args.values[1])
+        colors = [_parse_color(c) for c in args.values[2:]] or [(255, 255, 255)]
+        device.configure_layer(args.id, start, count, blends[args.blend], args.opacity, args.key)
+        if count:
+            device.fill_layer(args.id, colors, 0, count)
+        device.show()
+        print(f"Layer {args.id}: {args.blend} at opacity {args.opacity} over pixels {start}-{start + count - 1}"
+              if count else f"Layer {args.id} off")
+        return
+    if args.action == "opacity":
+        if args.id is None or not args.values:
+            print("Usage: layer opacity ID VALUE [--blend MODE]", file=sys.stderr)
+            return
+        blend = blends[args.blend] if args.blend != "over" else None
+        device.set_layer_opacity(args.id, int(args.values[0]), blend)
+        device.show()
+        print(f"Layer {args.id} opacity {int(args.values[0])}")
+        return
+    if args.action == "clear":
+        device.clear_layers()
+        device.show()
+        print("Layers cleared")
+        return
+
+    info = device.get_layers()
+    print(f"Layers: {info.used}/{info.pool} pixels used")
+    for layer in info.layers:
+        if not layer.count:
+            print(f"  [{layer.id}] off")
+            continue
+        key = ", black transparent" if layer.key else ""
+        print(f"  [{layer.id}] {layer.blend_name:8s} opacity {layer.opacity:3d}  "
+              f"pixels {layer.start}-{layer.start + layer.count - 1}{key}")
+    print(f"  Composite: {info.composites} shows, last {info.ticks_to_us(info.last_ticks):.1f} us, "
+          f"mean {info.ticks_to_us(info.mean_ticks):.1f} us, max {info.ticks_to_us(info.max_ticks):.1f} us")
+
+
+def cmd_palette(device: LtpDevice, args: argparse.Namespace):
+    """Load, index and rotate the palette of a palette-indexed strip."""
+    if args.action == "set":
+        if len(args.values) < 2:
+            print("Usage: palette set FIRST COLOR...", file=sys.stderr)
+            return
+        first = int(args.values[0])
+        colors = [_parse_color(c) for c in args.values[1:]]
+        device.set_palette(colors, first)
+        device.show()
+        print(f"Palette entries {first}-{first + len(colors) - 1} set")
+        return
+    if args.action == "indices":
+        if len(args.values) < 2:
+            print("Usage: palette indices START INDEX...", file=sys.stderr)
+            return
+        start = int(args.values[0])
+        indices = [int(v) for v in args.values[1:]]
+        device.set_palette_indices(indices, start)
+        device.show()
+        print(f"Pixels {start}-{start + len(indices) - 1} indexed")
+        return
+    if args.action in ("rotate", "stop"):
+        step = 0 if args.action == "stop" else int(args.values[0]) if args.values else 1
+        device.rotate_palette(step, args.interval if step else 0, args.first, args.count)
+        device.show()
+        if not step:
+            print("Palette rotation stopped")
+        elif args.interval:
+            print(f"Palette rotating by {step} every {args.interval} ms")
+        else:
+            print(f"Palette rotated by {step}")
+        return
+
+    info = device.get_palette()
+    print(f"Palette: {info.colors} colors, {info.bits}-bit indices")
+    print(f"  Pixels: {info.pixels} in {info.index_bytes} bytes (RGB: {info.pixels * 3})")
+    if info.rotate_interval_ms:
+        last = info.rotate_first + (info.rotate_count or info.colors - info.rotate_first) - 1
+        print(f"  Rotating entries {info.rotate_first}-{last} by {info.rotate_step} "
+              f"every {info.rotate_interval_ms} ms ({info.rotate_steps} steps)")
+    else:
+        print("  Rotation: stopped")
+
+
+def cmd_spans(device: LtpDevice, args: argparse.Namespace):
+    """Show the span list of a display-list strip."""
+    info = device.get_display_list(clear=args.clear)
+    print(f"Display list: {info.spans}/{info.max_spans} spans ({info.span_bytes} bytes each)")
+    print(f"  Pixels: {info.pixels} in {info.max_spans * info.span_bytes} bytes (RGB: {info.pixels * 3})")
+    print(f"  Solid: {info.solid}  Ramp: {info.ramp}  Pattern: {info.pattern}")
+    if info.dropped:
+        print(f"  Dropped: {info.dropped} writes (list full)")
+
+
+def cmd_memory(device: LtpDevice, args: argparse.Namespace):
+    """Show the strip storage arena."""
+    info = device.get_memory()
+    print(f"Arena: {info.used}/{info.arena_size} bytes used, {info.free} free "
+          f"(peak {info.high_water})")
+    print(f"  Strip: {info.pixels} pixels, longest that fits: {info.longest_strip}")
+    if info.strip_bytes or info.effect_bytes:
+        print(f"  Strip storage: {info.strip_bytes} bytes, effect buffers: {info.effect_bytes} bytes")
+
+
+def cmd_strip(device: LtpDevice, args: argparse.Namespace):
+    """Change a strip's length without reflashing."""
+    device.set_strip(args.pixels, strip_id=args.strip)
+    info = device.get_memory()
+    print(f"Strip {args.strip}: {info.pixels} pixels ({info.used}/{info.arena_size} bytes)")
+
+
+def _load_coords(path: str, scale: float, center: bool) -> list[tuple[int, int, int]]:
+    """Read [x, y, z] rows, or a custom topology's coordinates, as integers."""
+    with open(path) as f:
+        data = json.load(f)
+    if isinstance(data, dict):
+        rows = sorted(data.get("coordinates", []), key=lambda c: c["index"])
+        points = [(c["x"], c["y"], c.get("z") or 0.0) for c in rows]
+    else:
+        points = [tuple(row) + (0,) * (3 - len(row)) for row in data]
+    offset = [0.0, 0.0, 0.0]
+    if center and points:
+        offset = [(min(p[a] for p in points) + max(p[a] for p in points)) / 2 for a in range(3)]
+    return [tuple(round((p[a] - offset[a]) * scale) for a in range(3)) for p in points]
+
+
+def cmd_coords(device: LtpDevice, args: argparse.Namespace):
+    """Manage the coordinate table used by the spatial animations and shaders."""
+    if args.action == "upload":
+        if not args.file:
+            print("Usage: coords upload FILE", file=sys.stderr)
+            return
+        try:
+            coords = _load_coords(args.file, args.scale, args.center)
+        except (OSError, ValueError, KeyError, TypeError) as e:
+            print(f"Error: {args.file}: {e}", file=sys.stderr)
+            return
+        device.set_coords(coords, save=args.save)
+        print(f"Uploaded {len(coords)} coordinates{' and saved' if args.save else ''}")
+    elif args.action == "save":
+        device.save_coords()
+        print("Coordinates saved")
+    elif args.action == "clear":
+        device.clear_coords()
+        print("Coordinates cleared")
+    elif args.action == "dump":
+        print(json.dumps([list(c) for c in device.get_coords()]))
+        return
+
+    info = device.get_coords_info()
+    if not info.capacity:
+        print("Coordinates: not supported by this firmware")
+        return
+    print(f"Coordinates: {info.count} of {info.capacity} pixels, {info.bits}-bit, "
+          f"{info.saved} saved (EEPROM fits {info.eeprom_capacity})")
+    if info.count:
+        for axis, low, high in zip("xyz", info.low, info.high):
+            print(f"  {axis}: {low} to {high}")
+
+
+def cmd_trace(device: LtpDevice, args: argparse.Namespace):
+    """Show the last packets the device handled."""
+    trace = device.get_trace(clear=args.clear)
+    print(f"Packets Traced: {trace.total} (last {len(trace.entries)} of {trace.capacity} kept)")
+    if not trace.entries:
+        return
+
+    print(f"{'Seq':>8} {'Age':>12} {'Gap':>10} {'Command':<16} {'Flags':>5} {'Len':>5} {'Handler':>10}  Result")
+    prev = None
+    for e in trace.entries:
+        gap = "-" if prev is None else _format_us((e.arrival_us - prev.arrival_us) & 0xFFFFFFFF)
+        result = "ok" if e.result == 0 else e.result_name
+        print(
+            f"{e.sequence:>8} {_format_us(trace.age_us(e)):>12} {gap:>10} {e.command_name:<16}"
+            f" {e.flags:>#5x} {e.length:>5} {_format_us(e.duration_us):>10}  {result}"
+        )
+        prev = e
+
 
 def cmd_fill(device: LtpDevice, args: argparse.Namespace):
     """Fill all pixels with a color."""
@@ -79,6 +666,22 @@ def cmd_fill(device: LtpDevice, args: argparse.Namespace):
     print(f"Filled with RGB({args.r}, {args.g}, {args.b})")
 
 
+def cmd_draw(device: LtpDevice, args: argparse.Namespace):
+    """Draw a gradient, repeating pattern or strided fill on the device."""
+    colors = [_parse_color(c) for c in args.colors]
+    end = args.end if args.end is not None else (device.info.total_pixels if device.info else 0)
+    if args.shape == "gradient":
+        positions = [int(p) for p in args.positions.split(",")] if args.positions else None
+        device.fill_gradient(args.start, end, colors, positions, strip_id=args.strip)
+    elif args.shape == "pattern":
+        device.fill_pattern(args.start, end, colors, args.width, args.offset, strip_id=args.strip)
+    else:
+        device.fill_stride(args.start, end, colors[0], args.stride, args.width, args.offset,
+                           strip_id=args.strip)
+    device.show()
+    print(f"Drew {args.shape} of {len(colors)} color(s) over pixels {args.start}-{end - 1}")
+
+
 def cmd_clear(device: LtpDevice, args: argparse.Namespace):
     """Clear all pixels."""
     device.clear()
@@ -181,6 +784,7 @@ def main():
     parser.add_argument("-b", "--baudrate", type=int, default=115200, help="Baud rate")
     parser.add_argument("-t", "--timeout", type=float, default=2.0, help="Timeout (seconds)")
     parser.add_argument("-d", "--debug", action="store_true", help="Show packets sent/received")
+    parser.add_argument("--capture", metavar="FILE", help="Record link traffic to a capture file")
 
     subparsers = parser.add_subparsers(dest="command", help="Command")
 
@@ -193,12 +797,170 @@ def main():
     # stats
     subparsers.add_parser("stats", help="Show device statistics")
 
+    # latency
+    p = subparsers.add_parser("latency", help="Show device-side frame latency")
+    p.add_argument("--clear", action="store_true", help="Clear the histograms after reading")
+
+    # telemetry
+    p = subparsers.add_parser("telemetry", help="Stream periodic device telemetry")
+    p.add_argument("-i", "--interval", type=int, default=1, help="Report interval in seconds (default 1)")
+    p.add_argument("--duration", type=float, default=0, help="Stop after this many seconds (default: until Ctrl+C)")
+
+    # profile
+    p = subparsers.add_parser("profile", help="Show the firmware section profile (LTP_PROFILE builds)")
+    p.add_argument("--clear", action="store_true", help="Clear the profile after reading")
+
+    # bench
+    p = subparsers.add_parser("bench", help="Run the on-device self-benchmark (clears the strip)")
+    p.add_argument("-n", "--iterations", type=int, default=0, help="Iterations, 1-255 (default: firmware's 10)")
+
+    # probe
+    p = subparsers.add_parser("probe", help="Measure round-trip time and link throughput (ECHO/SINK)")
+    p.add_argument("-n", "--rounds", type=int, default=8, help="ECHO round trips per measurement (default 8)")
+    p.add_argument("--bytes", type=int, default=0, help="SINK burst size (default: about 0.25 s at the baud rate)")
+
+    # trace
+    p = subparsers.add_parser("trace", help="Show the last packets the device handled")
+    p.add_argument("--clear", action="store_true", help="Clear the trace after reading")
+
+    # animate
+    p = subparsers.add_parser("animate", help="Run a built-in animation on the device (stop, status)")
+    p.add_argument("pattern", choices=list(ANIM_PATTERN_NAMES.values()) + ["stop", "status"])
+    p.add_argument("--speed", type=int, default=0, help="Rate, 16 = default (1-255)")
+    p.add_argument("--size", type=int, help="Wavelength/length/width/waveform/fade/cooling/band/rings (per pattern)")
+    p.add_argument("--intensity", type=int, help="Saturation/spacing/fade/min level/density/sparking/axis (per pattern)")
+    p.add_argument("--palette", choices=list(PALETTE_NAMES.values()), help="Palette (gradient = color to background)")
+    p.add_argument("--color", help="Color as RRGGBB or R,G,B")
+    p.add_argument("--background", default="000000", help="Background color (default 000000)")
+    p.add_argument("-s", "--start", type=int, default=0, help="First pixel")
+    p.add_argument("-c", "--count", type=int, default=0, help="Pixels (default: to the end)")
+    p.add_argument("--fps", type=int, default=0, help="Frame rate (default: firmware's 30)")
+    p.add_argument("--clear", action="store_true", help="With stop: blank the animated pixels")
+
+    # fade
+    p = subparsers.add_parser("fade", help="Fade to a color or brightness level on the device (FADE_TO)")
+    p.add_argument("color", nargs="?", default="000000", help="Target color as RRGGBB or R,G,B (default black)")
+    p.add_argument("-d", "--duration", type=float, default=1.0, help="Seconds (default 1)")
+    p.add_argument("--easing", choices=list(FADE_EASING_NAMES.values()), default="linear")
+    p.add_argument("--level", type=int, nargs=2, metavar=("FROM", "TO"), help="Brightness ramp of the current colors instead")
+    p.add_argument("-s", "--start", type=int, default=0, help="First pixel")
+    p.add_argument("-c", "--count", type=int, default=0, help="Pixels (default: to the end)")
+    p.add_argument("--replace", action="store_true", help="Drop queued keyframes first")
+
+    # shader
+    p = subparsers.add_parser("shader", help="Run, load or test a pixel shader on the device, or set its parameters")
+    p.add_argument("action", choices=["run", "load", "test", "param"])
+    p.add_argument("args", nargs="*", help="Assembly source file, or for param: first parameter and values")
+    p.add_argument("--params", type=int, nargs="+", metavar="V", help="Set parameters p0.. first")
+    p.add_argument("--fps", type=int, default=0, help="Frame rate (default: firmware's 30)")
+    p.add_argument("--budget", type=int, default=0, help="Instructions per pixel (default: firmware's 256)")
+    p.add_argument("--time", type=int, default=0, help="With test: time input in ms")
+    p.add_argument("-s", "--start", type=int, default=0, help="First pixel")
+    p.add_argument("-c", "--count", type=int, default=0, help="Pixels (default: to the end)")
+
+    # coords
+    p = subparsers.add_parser("coords", help="Upload, save, clear or show the device's pixel coordinate table")
+    p.add_argument("action", choices=["upload", "save", "clear", "info", "dump"])
+    p.add_argument("file", nargs="?", help="With upload: JSON list of [x, y, z] per pixel, or a custom topology")
+    p.add_argument("--scale", type=float, default=1.0, help="Multiply coordinates before rounding (e.g. 127 for 0-1 topologies)")
+    p.add_argument("--center", action="store_true", help="Move the middle of the bounding box to the origin")
+    p.add_argument("--save", action="store_true", help="With upload: store in EEPROM too")
+
+    # vis
+    p = subparsers.add_parser("vis", help="Drive a bar graph, VU meter or gauge on the device from values")
+    p.add_argument("action", choices=list(VIS_MODE_NAMES.values()) + ["set", "status"])
+    p.add_argument("values", type=float, nargs="*", help="One value per bar, from --low to --high")
+    p.add_argument("--low", type=float, default=0.0, help="Value shown as empty (default 0)")
+    p.add_argument("--high", type=float, default=1.0, help="Value shown as full (default 1)")
+    p.add_argument("--bars", type=int, default=1, help="Bars side by side (1-4)")
+    p.add_argument("--gap", type=int, default=1, help="Pixels between bars (default 1)")
+    p.add_argument("--segments", type=int, default=10, help="Meter segments per bar (0 = one per pixel)")
+    p.add_argument("--fall", type=float, help="Seconds a full-scale level takes to fall (meter default 1.5)")
+    p.add_argument("--hold", type=float, help="Seconds the peak holds, 0 = no peak (meter default 1)")
+    p.add_argument("--reverse", action="store_true", help="Fill from the end (with --center: from both ends)")
+    p.add_argument("--center", action="store_true", help="Fill from the middle")
+    p.add_argument("--gradient", action="store_true", help="Bar: color1 to color2 along the bar")
+    p.add_argument("--color1", help="Fill color as RRGGBB or R,G,B (default 00ff00)")
+    p.add_argument("--color2", help="Gradient and gauge end color (default ff0000)")
+    p.add_argument("--background", help="Unlit pixels (default 000000)")
+    p.add_argument("-s", "--start", type=int, default=0, help="First pixel")
+    p.add_argument("-c", "--count", type=int, default=0, help="Pixels (default: to the end)")
+
+    # audio
+    p = subparsers.add_parser("audio", help="Start, stop or show the device's audio engine (spectrum and pulse animations)")
+    p.add_argument("action", choices=["start", "stop", "info"])
+    p.add_argument("--gain", type=int, default=0, help="With start: dB of boost, 0-48 (default 0 = automatic)")
+    p.add_argument("--threshold", type=int, default=0, help="With start: beat threshold in 1/64 (default 0 = 1.4x)")
+
+    # scene
+    p = subparsers.add_parser("scene", help="Store, upload, recall or delete frames in the device's scene cache")
+    p.add_argument("action", choices=["store", "upload", "recall", "delete", "info"])
+    p.add_argument("id", type=int, nargs="?", help="Scene slot")
+    p.add_argument("color", nargs="?", default="ffffff", help="With upload: color for every pixel (default ffffff)")
+    p.add_argument("-d", "--duration", type=float, default=0.0, help="With recall: fade seconds (default 0 = at once)")
+    p.add_argument("--easing", choices=list(FADE_EASING_NAMES.values()), default="linear")
+
+    # sequence
+    p = subparsers.add_parser("sequence", help="Build, play, stop, seek or cue stored sequences on the device")
+    p.add_argument("action", choices=["build", "play", "stop", "seek", "sync", "info"])
+    p.add_argument("arg", nargs="?", help="build: output .lsq (or .h for PROGMEM); play: SD file "
+                   "(default: flash sequence); seek: frame")
+    p.add_argument("--loop", action="store_true", help="With play: start over at the end")
+    p.add_argument("--from", dest="source", metavar="CAPTURE",
+                   help="With build: frames from a capture file (default: demo)")
+    p.add_argument("--pixels", type=int, default=0, help="With build: pixels per frame (default: the device's)")
+    p.add_argument("--key-interval", type=int, default=30, help="With build: frames between key frames")
+
+    # layer
+    p = subparsers.add_parser("layer", help="Overlay layers blended over the frame on the device (ltp_octo_v2)")
+    p.add_argument("action", choices=["set", "opacity", "clear", "info"])
+    p.add_argument("id", type=int, nargs="?", help="Layer, 1-3")
+    p.add_argument("values", nargs="*", help="set: START COUNT [COLOR...] (one color fills, "
+                   "more make a gradient; COUNT 0 turns the layer off); opacity: 0-255")
+    p.add_argument("--blend", choices=list(LAYER_BLEND_NAMES.values()), default="over",
+                   help="Blend mode (with opacity: change it too)")
+    p.add_argument("--opacity", type=int, default=255, help="With set: 0-255 (default 255)")
+    p.add_argument("--key", action="store_true", help="With set: black layer pixels show the frame beneath")
+
+    # palette
+    p = subparsers.add_parser("palette", help="Palette colors, indices and rotation (palette-indexed ltp_serial_v2)")
+    p.add_argument("action", choices=["set", "indices", "rotate", "stop", "info"])
+    p.add_argument("values", nargs="*", help="set: FIRST COLOR...; indices: START INDEX...; "
+                   "rotate: STEP (default 1)")
+    p.add_argument("--interval", type=int, default=0, help="With rotate: repeat every MS (default: once)")
+    p.add_argument("--first", type=int, default=0, help="With rotate: first entry to rotate")
+    p.add_argument("--count", type=int, default=0, help="With rotate: entries to rotate (default: to the last)")
+
+    # spans
+    p = subparsers.add_parser("spans", help="Show span list usage (display-list ltp_serial_v2)")
+    p.add_argument("--clear", action="store_true", help="Clear the dropped write count after reading")
+
+    # memory
+    subparsers.add_parser("memory", help="Show the strip storage arena (ltp_serial_v2)")
+
+    # strip
+    p = subparsers.add_parser("strip", help="Change the strip length without reflashing")
+    p.add_argument("pixels", type=int, help="New pixel count")
+    p.add_argument("--strip", type=int, default=0, help="Strip ID")
+
     # fill
     p = subparsers.add_parser("fill", help="Fill all pixels with a color")
     p.add_argument("r", type=int, help="Red (0-255)")
     p.add_argument("g", type=int, help="Green (0-255)")
     p.add_argument("b", type=int, help="Blue (0-255)")
 
+    # draw
+    p = subparsers.add_parser("draw", help="Draw a gradient, repeating pattern or every Nth pixel on the device")
+    p.add_argument("shape", choices=["gradient", "pattern", "stride"])
+    p.add_argument("colors", nargs="+", help="Colors, RRGGBB or R,G,B (stride: one)")
+    p.add_argument("-s", "--start", type=int, default=0, help="First pixel")
+    p.add_argument("-e", "--end", type=int, help="End pixel, exclusive (default: all)")
+    p.add_argument("--strip", type=int, default=0, help="Strip ID")
+    p.add_argument("--positions", help="gradient: stop positions 0-255, comma-separated (default: even)")
+    p.add_argument("-w", "--width", type=int, default=1, help="pattern: pixels per color; stride: pixels lit")
+    p.add_argument("--stride", type=int, default=2, help="stride: light one pixel group out of every N")
+    p.add_argument("--offset", type=int, default=0, help="pattern: shift in pixels; stride: first lit pixel")
+
     # clear
     subparsers.add_parser("clear", help="Clear all pixels")
 
@@ -234,7 +996,27 @@ def main():
         "info": cmd_info,
         "status": cmd_status,
         "stats": cmd_stats,
+        "latency": cmd_latency,
+        "telemetry": cmd_telemetry,
+        "profile": cmd_profile,
+        "trace": cmd_trace,
+        "bench": cmd_bench,
+        "probe": cmd_probe,
+        "animate": cmd_animate,
+        "fade": cmd_fade,
+        "shader": cmd_shader,
+        "coords": cmd_coords,
+        "vis": cmd_vis,
+        "audio": cmd_audio,
+        "scene": cmd_scene,
+        "sequence": cmd_sequence,
+        "layer": cmd_layer,
+        "palette": cmd_palette,
+        "spans": cmd_spans,
+        "memory": cmd_memory,
+        "strip": cmd_strip,
         "fill": cmd_fill,
+        "draw": cmd_draw,
         "clear": cmd_clear,
         "brightness": cmd_brightness,
         "rainbow": cmd_rainbow,
@@ -244,7 +1026,9 @@ def main():
     }
 
     try:
-        with LtpDevice(args.port, args.baudrate, args.timeout, debug=args.debug) as device:
+        with LtpDevice(
+            args.port, args.baudrate, args.timeout, debug=args.debug, capture=args.capture
+        ) as device:
             handlers[args.command](device, args)
     except LtpError as e:
         print(f"Error: {e}", file=sys.stderr)
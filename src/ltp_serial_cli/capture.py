@@ -0,0 +1,108 @@
+"""
+LTP Serial Protocol v2 - Link Capture Files
+
+Records the raw bytes crossing a serial link, with timestamps and
+direction, so a field session can be replayed into the firmware parser
+later (see arduino/host/replay_main.cpp).
+
+File layout (all integers little-endian):
+    Header  b"LTPCAP01", uint64 start time (microseconds since Unix epoch)
+    Record  uint64 timestamp (microseconds since start), uint8 direction,
+            uint16 length, data[length]
+
+Direction 0 is host to device, 1 is device to host.
+"""
+
+import struct
+import threading
+import time
+from dataclasses import dataclass
+from typing import BinaryIO, Iterator
+
+CAPTURE_MAGIC = b"LTPCAP01"
+CAPTURE_HOST_TO_DEVICE = 0
+CAPTURE_DEVICE_TO_HOST = 1
+
+_HEADER = struct.Struct("<8sQ")
+_RECORD = struct.Struct("<QBH")
+
+
+@dataclass
+class CaptureRecord:
+    """One chunk of bytes as read from or written to the link."""
+
+    timestamp_us: int
+    direction: int
+    data: bytes
+
+    @property
+    def is_host_to_device(self) -> bool:
+        return self.direction == CAPTURE_HOST_TO_DEVICE
+
+
+class CaptureWriter:
+    """
+    Append link traffic to a capture file.
+
+    Safe to call from the LtpDevice reader thread and the sending thread
+    at the same time.
+
+    Example:
+        with CaptureWriter("session.ltpcap") as capture:
+            capture.write(CAPTURE_HOST_TO_DEVICE, packet)
+    """
+
+    def __init__(self, path: str):
+        self.path = path
+        self._file: BinaryIO = open(path, "wb")
+        self._lock = threading.Lock()
+        self._start_ns = time.monotonic_ns()
+        self._file.write(_HEADER.pack(CAPTURE_MAGIC, time.time_ns() // 1000))
+
+    def write(self, direction: int, data: bytes) -> None:
+        """Record data at the current time."""
+        if not data:
+            return
+        timestamp = (time.monotonic_ns() - self._start_ns) // 1000
+        with self._lock:
+            if self._file.closed:
+                return
+            for offset in range(0, len(data), 0xFFFF):
+                chunk = data[offset:offset + 0xFFFF]
+                self._file.write(_RECORD.pack(timestamp, direction, len(chunk)))
+                self._file.write(chunk)
+
+    def close(self) -> None:
+        with self._lock:
+            if not self._file.closed:
+                self._file.close()
+
+    def __enter__(self) -> "CaptureWriter":
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb) -> bool:
+        self.close()
+        return False
+
+
+def read_capture(path: str) -> Iterator[CaptureRecord]:
+    """
+    Iterate over the records of a capture file.
+
+    Raises:
+        ValueError: The file is not a capture file
+    """
+    with open(path, "rb") as f:
+        header = f.read(_HEADER.size)
+        if len(header) < _HEADER.size or header[:8] != CAPTURE_MAGIC:
+            raise ValueError(f"{path}: not an LTP capture file")
+
+        while True:
+            head = f.read(_RECORD.size)
+            if len(head) < _RECORD.size:
+                return
+            timestamp, direction, length = _RECORD.unpack(head)
+            data = f.read(length)
+            if len(data) < length:
+                return  # Truncated final record
+            yield CaptureRecord(timestamp, direction, data)
@@ -27,20 +27,75 @@ from .protocol import (
     CMD_INPUT_EVENT,
     CMD_FRAME_ACK,
     CMD_STATUS_UPDATE,
+    CMD_PROFILE,
+    CMD_TRACE,
+    CMD_BENCH,
+    CMD_ECHO,
+    CMD_SINK,
+    CMD_ANIM_START,
+    CMD_ANIM_STOP,
+    CMD_ANIM_STATUS,
+    CMD_FADE_TO,
+    CMD_SHADER_LOAD,
+    CMD_SHADER_PARAM,
+    CMD_COORDS,
+    CMD_AUDIO,
+    CMD_SCENE,
+    SCENE_STORE,
+    SCENE_DELETE,
+    SCENE_INFO,
+    CMD_SEQUENCE,
+    SEQ_STOP,
+    SEQ_SYNC,
+    SEQ_INFO,
+    SEQ_FLASH,
+    SEQ_SD,
+    CMD_LAYER,
+    LAYER_CLEAR,
+    LAYER_INFO,
+    LAYER_KEY,
+    LAYER_OVER,
+    LAYER_BLEND_NAMES,
+    CMD_PALETTE,
+    CMD_DISPLAY_LIST,
+    AUDIO_STOP,
+    AUDIO_INFO,
+    COORDS_CLEAR,
+    COORDS_SAVE,
+    COORDS_INFO,
+    VIS_OFF,
+    FADE_LINEAR,
+    SHADER_RUN,
+    SHADER_TEST,
+    SINK_DATA,
+    SINK_START,
+    SINK_REPORT,
     INFO_ALL,
     INFO_STRIPS,
     INFO_STATUS,
     INFO_STATS,
+    INFO_LATENCY,
+    INFO_MEMORY,
     CTRL_ID_BRIGHTNESS,
     CTRL_ID_GAMMA,
     CTRL_ID_AUTO_SHOW,
     CTRL_ID_FRAME_ACK,
+    CTRL_ID_STATUS_INTERVAL,
+    STATUS_TELEMETRY,
     CAPS_EXTENDED,
+    CAPS_ANIMATION,
+    CAPS_SHADER,
     LED_TYPE_NAMES,
     COLOR_FORMAT_NAMES,
     COMMAND_NAMES,
+    PROFILE_SECTION_NAMES,
+    ANIM_PATTERN_NAMES,
+    PALETTE_NAMES,
+    VIS_MODE_NAMES,
     STRIP_ALL,
 )
+from .capture import CaptureWriter, CAPTURE_HOST_TO_DEVICE, CAPTURE_DEVICE_TO_HOST
+from .shader import ShaderFrame, render as render_shader
 from .exceptions import (
     LtpConnectionError,
     LtpTimeoutError,
@@ -48,6 +103,15 @@ from .exceptions import (
     LtpDeviceError,
 )
 
+# Pixels per COORDS write or read, within the serial sketch's 512-byte payload
+COORDS_CHUNK = 80
+# Pixels per SCENE upload, likewise
+SCENE_CHUNK = 160
+# Pixels per FADE_TO packet, likewise; longer targets continue in the next
+FADE_CHUNK = 160
+# Writing a scene to EEPROM takes about 3.3 ms per changed byte on AVR
+SCENE_EEPROM_TIMEOUT = 5.0
+
 
 @dataclass
 class StripInfo:
@@ -120,6 +184,14 @@ class DeviceInfo:
     def has_inputs(self) -> bool:
         return bool(self.capabilities1 & CAPS_EXTENDED) and bool(self.capabilities2 & 0x20)
 
+    @property
+    def has_animation(self) -> bool:
+        return bool(self.capabilities1 & CAPS_EXTENDED) and bool(self.capabilities2 & CAPS_ANIMATION)
+
+    @property
+    def has_shader(self) -> bool:
+        return bool(self.capabilities1 & CAPS_EXTENDED) and bool(self.capabilities2 & CAPS_SHADER)
+
     @property
     def is_usb_highspeed(self) -> bool:
         return bool(self.capabilities1 & CAPS_EXTENDED) and bool(self.capabilities2 & 0x08)
@@ -140,21 +212,545 @@ class DeviceStatus:
         return {0: "idle", 1: "running", 2: "error"}.get(self.state, "unknown")
 
 
+@dataclass
+class NakCount:
+    """NAKs the device sent for one command."""
+
+    command: int
+    last_error: int
+    count: int
+
+    @property
+    def command_name(self) -> str:
+        return COMMAND_NAMES.get(self.command, f"0x{self.command:02X}")
+
+    @property
+    def last_error_name(self) -> str:
+        return LtpDeviceError.ERROR_NAMES.get(self.last_error, f"UNKNOWN_0x{self.last_error:02X}")
+
+
 @dataclass
 class DeviceStats:
-    """Device statistics."""
+    """
+    Device statistics.
+
+    The fields after uptime_seconds come from the extended INFO_STATS
+    reply; `extended` is False (and they stay 0) for older firmware.
+    """
 
     frames_received: int = 0
     frames_displayed: int = 0
     bytes_received: int = 0
     checksum_errors: int = 0
-    buffer_overflows: int = 0
+    buffer_overflows: int = 0   # Times the device RX buffer filled up
     uptime_seconds: int = 0
+    extended: bool = False
+    packets_received: int = 0
+    resync_bytes: int = 0       # Bytes skipped hunting for a START byte
+    dropped_bytes: int = 0      # Bytes of packets the parser discarded
+    oversize_packets: int = 0
+    timeouts: int = 0
+    dropped_frames: int = 0     # Gaps in SHOW frame numbers
+    frame_restarts: int = 0
+    nak_total: int = 0
+    naks: list[NakCount] = field(default_factory=list)
+
+    @property
+    def link_errors(self) -> int:
+        """Packets lost to corruption or truncation on the wire."""
+        return self.checksum_errors + self.oversize_packets + self.timeouts
+
+
+@dataclass
+class DeviceLatency:
+    """
+    Per-frame latency histograms (GET_INFO type 0x07).
+
+    Histogram bucket 0 counts 0-1 us and bucket n counts 2^n to 2^(n+1)-1 us;
+    the last bucket also holds everything longer.
+    """
+
+    frames: int = 0             # Host frames; local effect frames only add to show_duration
+    # Last host frame, microseconds after its first byte
+    last_checksum_us: int = 0
+    last_handler_us: int = 0
+    last_show_start_us: int = 0
+    last_show_done_us: int = 0
+    receive_to_show: list[int] = field(default_factory=list)
+    show_duration: list[int] = field(default_factory=list)
+
+    @staticmethod
+    def percentile(histogram: list[int], p: float) -> Optional[int]:
+        """Upper bound in microseconds of the bucket holding percentile p (0-100)."""
+        total = sum(histogram)
+        if total == 0:
+            return None
+        target = total * p / 100.0
+        count = 0
+        for bucket, n in enumerate(histogram):
+            count += n
+            if count >= target:
+                return (1 << (bucket + 1)) - 1
+        return (1 << len(histogram)) - 1
+
+
+@dataclass
+class DeviceTelemetry:
+    """
+    Periodic device telemetry (STATUS_UPDATE type 0x07).
+
+    Counts cover the period since the previous report.
+    """
+
+    period_ms: int = 0
+    frames_received: int = 0
+    frames_displayed: int = 0
+    rx_queued: int = 0          # Bytes waiting in the receive buffer at report time
+    rx_high_water: int = 0      # Most bytes waiting at once during the period
+    checksum_errors: int = 0
+    framing_errors: int = 0     # Oversize packets and inter-byte timeouts
+    show_mean_us: int = 0
+    show_max_us: int = 0
+    received_at: float = 0.0    # Host time.time() when the report arrived
+
+    @property
+    def receive_fps(self) -> float:
+        return self.frames_received * 1000.0 / self.period_ms if self.period_ms else 0.0
+
+    @property
+    def display_fps(self) -> float:
+        return self.frames_displayed * 1000.0 / self.period_ms if self.period_ms else 0.0
+
+    @property
+    def errors(self) -> int:
+        return self.checksum_errors + self.framing_errors
+
+
+@dataclass
+class ProfileSection:
+    """One firmware profiler section; times are in device ticks."""
+
+    section_id: int
+    count: int
+    total_ticks: int
+    max_ticks: int
+
+    @property
+    def name(self) -> str:
+        return PROFILE_SECTION_NAMES.get(self.section_id, f"section_0x{self.section_id:02X}")
+
+
+@dataclass
+class DeviceProfile:
+    """
+    Firmware section profile (PROFILE command 0x90).
+
+    Only sections entered since the last clear are reported. Tick rate is
+    the CPU clock on Teensy, F_CPU/8 on AVR and 1 GHz (ns) on the host build.
+    """
+
+    tick_hz: int = 0
+    sections: list[ProfileSection] = field(default_factory=list)
+
+    def to_us(self, ticks: float) -> float:
+        return ticks * 1e6 / self.tick_hz if self.tick_hz else 0.0
+
+
+@dataclass
+class TraceEntry:
+    """One packet in the device trace ring."""
+
+    sequence: int
+    command: int
+    flags: int
+    length: int
+    arrival_us: int         # Device micros() at the START byte
+    duration_us: int        # Handler time, saturates at 65535
+    result: int             # 0 or the error code of the NAK sent
+
+    @property
+    def command_name(self) -> str:
+        return COMMAND_NAMES.get(self.command, f"0x{self.command:02X}")
+
+    @property
+    def result_name(self) -> str:
+        return LtpDeviceError.ERROR_NAMES.get(self.result, f"UNKNOWN_0x{self.result:02X}")
+
+
+@dataclass
+class DeviceTrace:
+    """
+    Last packets the device handled (TRACE command 0x91), oldest first.
+
+    `total` counts every packet traced since the last clear; only the last
+    `capacity` of them are kept. `now_us` is the device micros() when the
+    first page was read, for computing how long ago an entry arrived.
+    """
+
+    capacity: int = 0
+    total: int = 0
+    now_us: int = 0
+    entries: list[TraceEntry] = field(default_factory=list)
+
+    def age_us(self, entry: TraceEntry) -> int:
+        return (self.now_us - entry.arrival_us) & 0xFFFFFFFF
+
+
+@dataclass
+class DeviceBench:
+    """
+    On-device self-benchmark (BENCH command 0x92), measured with micros().
+
+    Per-pixel and per-byte figures are nanoseconds; cpu_hz is 0 where the
+    firmware does not know its clock (host build).
+    """
+
+    pixels: int = 0
+    iterations: int = 0
+    cpu_hz: int = 0
+    show_mean_us: int = 0
+    show_max_us: int = 0
+    set_pixel_ns: int = 0
+    ingest_ns: int = 0          # PIXEL_FRAME copy, per pixel
+    parser_ns: int = 0          # Per received byte
+    idle_loop_ns: int = 0       # One loop() pass with no input
+
+    def cycles(self, ns: int) -> Optional[float]:
+        """Convert a duration to CPU cycles, if the clock is known."""
+        return ns * self.cpu_hz / 1e9 if self.cpu_hz else None
+
+    @property
+    def max_parse_bytes_per_second(self) -> float:
+        """Receive rate the parser alone could sustain."""
+        return 1e9 / self.parser_ns if self.parser_ns else 0.0
+
+    @property
+    def max_fps(self) -> float:
+        """Frame rate bound from ingesting and showing a full frame locally."""
+        frame_us = self.show_mean_us + self.ingest_ns * self.pixels / 1000
+        return 1e6 / frame_us if frame_us else 0.0
+
+
+@dataclass
+class DeviceShader:
+    """Pixel shader state, from the ANIM_STATUS response."""
+
+    running: bool = False
+    code_length: int = 0        # Loaded program, 0 = none
+    budget: int = 0             # Instructions per pixel
+    fps: int = 0
+    start: int = 0
+    count: int = 0
+    width: int = 0              # Geometry x and y come from
+    height: int = 0
+    frames: int = 0
+    render_us: int = 0          # Last frame, excluding show()
+    frame_steps: int = 0        # Instructions run in the last frame
+    max_pixel_steps: int = 0    # Most in one pixel since start
+    faults: int = 0             # Pixels ended by a stack error or the budget
+    code_capacity: int = 0
+    params: tuple[int, ...] = ()
+
+
+@dataclass
+class ShaderTest:
+    """
+    One frame rendered by SHADER_TEST, next to the host reference
+    interpreter's rendering of the same frame.
+    """
+
+    hash: int = 0
+    steps: int = 0
+    max_pixel_steps: int = 0
+    faults: int = 0
+    render_us: int = 0
+    reference: Optional[ShaderFrame] = None
+
+    @property
+    def matches(self) -> bool:
+        """True when the device produced the reference pixels."""
+        return self.reference is not None and self.reference.hash == self.hash
+
+
+@dataclass
+class DeviceCoords:
+    """Coordinate table state (COORDS command 0x66, INFO operation)."""
+
+    count: int = 0              # Pixels 0..count-1 have coordinates
+    capacity: int = 0           # Most pixels the table can cover (0 = no table)
+    saved: int = 0              # Pixels in the EEPROM copy
+    eeprom_capacity: int = 0    # Most pixels COORDS_SAVE can store
+    bits: int = 16              # Per coordinate; 8-bit tables take -128..127
+    low: tuple[int, int, int] = (0, 0, 0)
+    high: tuple[int, int, int] = (0, 0, 0)
+
+
+@dataclass
+class DeviceAudio:
+    """Audio engine state (AUDIO command 0x69, INFO operation)."""
+
+    running: bool = False
+    rate: int = 0               # Samples per second
+    samples: int = 0            # Per analysed block
+    gain: int = 0               # dB, 0 = automatic
+    threshold: int = 0          # Beat threshold in 1/64
+    level: int = 0              # 0-255, last block
+    bands: tuple[int, ...] = () # Octave bands, 0-255, last block
+    blocks: int = 0
+    overruns: int = 0           # Blocks dropped while the loop was busy
+    beats: int = 0
+    beat_interval_ms: int = 0   # Average, 0 = no beats yet
+    tick_hz: int = 0
+    last_ticks: int = 0         # Analysis cost per block
+    mean_ticks: int = 0
+    max_ticks: int = 0
+
+    @property
+    def bpm(self) -> float:
+        return 60000.0 / self.beat_interval_ms if self.beat_interval_ms else 0.0
+
+    def ticks_to_us(self, ticks: int) -> float:
+        return ticks * 1e6 / self.tick_hz if self.tick_hz else 0.0
+
+
+@dataclass
+class SceneSlot:
+    """One scene cache slot (SCENE command 0x6A, INFO operation)."""
+
+    id: int
+    eeprom: bool                # Kept across resets
+    pixels: int                 # 0 = empty
+
+
+@dataclass
+class DeviceScenes:
+    """Scene cache capacity and contents."""
+
+    pixels: int = 0             # Pixels a scene covers
+    slots: list[SceneSlot] = field(default_factory=list)
+
+    @property
+    def free(self) -> list[int]:
+        return [s.id for s in self.slots if not s.pixels]
+
+
+@dataclass
+class DeviceSequence:
+    """Stored sequence player state (SEQUENCE command 0x6B, INFO operation)."""
+
+    state: int = 0              # 0 stopped, 1 playing, 2 waiting for sync
+    source: int = SEQ_FLASH
+    loop: bool = False
+    has_flash: bool = False     # Sketch carries a PROGMEM sequence
+    has_sd: bool = False        # Firmware can play from an SD card
+    pixels: int = 0
+    frames: int = 0
+    frame: int = 0              # Frames played
+    duration_ms: int = 0
+    loops: int = 0
+    block_size: int = 0
+    block_reads: int = 0
+    stalls: int = 0             # Frames that waited for an SD block
+    last_decode_us: int = 0
+    max_decode_us: int = 0
+
+    @property
+    def state_name(self) -> str:
+        return ("stopped", "playing", "waiting for sync")[self.state] if self.state < 3 else str(self.state)
+
+
+@dataclass
+class LayerState:
+    """One overlay layer (LAYER command 0x6C, INFO operation)."""
+
+    id: int
+    blend: int = LAYER_OVER
+    opacity: int = 0
+    key: bool = False           # Black pixels transparent
+    start: int = 0
+    count: int = 0              # 0 = off
+
+    @property
+    def blend_name(self) -> str:
+        return LAYER_BLEND_NAMES.get(self.blend, f"0x{self.blend:02X}")
+
+
+@dataclass
+class DeviceLayers:
+    """Layer compositor state and per-show composite cost."""
+
+    pool: int = 0               # Layer pixels available
+    used: int = 0
+    layers: list[LayerState] = field(default_factory=list)
+    tick_hz: int = 0
+    composites: int = 0
+    last_ticks: int = 0
+    mean_ticks: int = 0
+    max_ticks: int = 0
+
+    def ticks_to_us(self, ticks: int) -> float:
+        return ticks * 1e6 / self.tick_hz if self.tick_hz else 0.0
+
+
+@dataclass
+class DevicePalette:
+    """Palette-indexed pixel storage (PALETTE command 0x6D, INFO operation)."""
+
+    bits: int = 0               # Index width, 4 or 8
+    colors: int = 0             # Palette entries
+    pixels: int = 0
+    index_bytes: int = 0        # RAM the indices take
+    rotate_first: int = 0
+    rotate_count: int = 0       # 0 = to the last entry
+    rotate_step: int = 0
+    rotate_interval_ms: int = 0 # 0 = not rotating
+    rotate_steps: int = 0       # Steps taken since the rotation started
+
+
+@dataclass
+class DeviceDisplayList:
+    """Display-list pixel storage (DISPLAY_LIST command 0x6E)."""
+
+    max_spans: int = 0
+    spans: int = 0              # In use
+    span_bytes: int = 0         # RAM per span
+    pixels: int = 0
+    dropped: int = 0            # Writes refused because the list was full
+    solid: int = 0
+    ramp: int = 0
+    pattern: int = 0
+
+
+@dataclass
+class DeviceMemory:
+    """Strip storage and effect buffer arena (GET_INFO type 0x08)."""
+
+    arena_size: int = 0         # Bytes, fixed by the firmware build
+    used: int = 0
+    free: int = 0
+    high_water: int = 0         # Most bytes ever in use
+    pixels: int = 0             # Current strip length
+    longest_strip: int = 0      # Longest length SET_STRIP would accept
+    strip_bytes: int = 0        # Of used, the strip's storage
+    effect_bytes: int = 0       # Of used, fade, scene, coordinate and animation buffers
+
+
+@dataclass
+class DeviceVisualizer:
+    """Scalar visualizer state, from the ANIM_STATUS response."""
+
+    mode: int = VIS_OFF
+    flags: int = 0
+    bars: int = 0
+    start: int = 0
+    count: int = 0
+    values: tuple[int, ...] = ()    # Last VIS_VALUE, per bar
+    levels: tuple[int, ...] = ()    # Shown, after the fall time
+    peaks: tuple[int, ...] = ()
+    frames: int = 0
+    render_us: int = 0              # Last frame, excluding show()
+
+    @property
+    def mode_name(self) -> str:
+        return VIS_MODE_NAMES.get(self.mode, f"0x{self.mode:02X}")
+
+
+@dataclass
+class DeviceAnimation:
+    """
+    Built-in animation state (ANIM_STATUS command 0x62).
+
+    Parameters are as the device applied them: defaults filled in and
+    count resolved to the segment length.
+    """
+
+    running: bool = False
+    pattern: int = 0
+    speed: int = 16
+    size: int = 0
+    intensity: int = 0
+    palette: int = 0
+    color1: tuple[int, int, int] = (0, 0, 0)
+    color2: tuple[int, int, int] = (0, 0, 0)
+    start: int = 0
+    count: int = 0
+    fps: int = 0
+    frames: int = 0
+    render_us: int = 0          # Last frame, excluding show()
+    state_pixels: int = 0       # Most pixels sparkle and fire animate
+    fade_queued: int = 0        # FADE_TO keyframes, running one included
+    fade_capacity: int = 0
+    fade_progress: float = 0.0  # Running keyframe, 0-1
+    fade_pixels: int = 0        # Most pixels one keyframe covers (0 = no fades)
+    shader: Optional[DeviceShader] = None
+    visualizer: Optional[DeviceVisualizer] = None
+
+    @property
+    def pattern_name(self) -> str:
+        return ANIM_PATTERN_NAMES.get(self.pattern, f"0x{self.pattern:02X}")
+
+    @property
+    def palette_name(self) -> str:
+        return PALETTE_NAMES.get(self.palette, f"0x{self.palette:02X}")
+
+
+@dataclass
+class SinkReport:
+    """
+    Host-to-device transfer as measured by the device (SINK command 0x94).
+
+    Bytes include packet framing. Elapsed time runs from the START byte of
+    the first data packet to the checksum of the last one.
+    """
+
+    packets: int = 0
+    bytes: int = 0
+    elapsed_us: int = 0
+    bytes_per_second: int = 0
+    lost_packets: int = 0       # Gaps in the data sequence numbers
+    checksum_errors: int = 0    # Parser errors since the SINK start
+    framing_errors: int = 0     # Oversize headers and timeouts
+    rx_buffer_full: int = 0
+
+    @property
+    def loss(self) -> float:
+        """Fraction of the data packets sent that never arrived."""
+        sent = self.packets + self.lost_packets
+        return self.lost_packets / sent if sent else 0.0
+
+
+@dataclass
+class LinkProbe:
+    """
+    Measured capacity of the current link (ECHO and SINK commands).
+
+    Round trips are small ECHOs; upstream is timed by the host from large
+    ECHO replies, downstream by the device from a SINK burst.
+    """
+
+    rtt_min_ms: float = 0.0
+    rtt_mean_ms: float = 0.0
+    rtt_max_ms: float = 0.0
+    upstream_bytes_per_second: float = 0.0      # Device to host
+    downstream_bytes_per_second: float = 0.0    # Host to device
+    sink: SinkReport = field(default_factory=SinkReport)
+
+    @property
+    def loss(self) -> float:
+        return self.sink.loss
+
+    def max_fps(self, pixels: int, bytes_per_pixel: int = 3) -> float:
+        """Frame rate the link can carry as one PIXEL_FRAME per frame."""
+        frame_bytes = 6 + 5 + pixels * bytes_per_pixel
+        return self.downstream_bytes_per_second / frame_bytes
 
 
 # Type alias for input event callback
 InputEventCallback = Callable[[int, int, int, bytes], None]
 
+# Type alias for telemetry callback
+TelemetryCallback = Callable[[DeviceTelemetry], None]
+
 
 class LtpDevice:
     """
@@ -179,6 +775,7 @@ class LtpDevice:
         timeout: float = 1.0,
         debug: bool = False,
         debug_file: Optional[TextIO] = None,
+        capture: Optional[str] = None,
     ):
         """
         Initialize device connection.
@@ -189,12 +786,15 @@ class LtpDevice:
             timeout: Response timeout in seconds
             debug: Enable debug output showing packets sent/received
             debug_file: File to write debug output (default: stderr)
+            capture: Record all link traffic to this capture file
         """
         self.port = port
         self.baudrate = baudrate
         self.timeout = timeout
         self.debug = debug
         self._debug_file = debug_file or sys.stderr
+        self.capture_path = capture
+        self._capture: Optional[CaptureWriter] = None
 
         self._serial: Optional[serial.Serial] = None
         self._protocol = LtpProtocol()
@@ -203,6 +803,8 @@ class LtpDevice:
 
         # For async input events
         self._input_callback: Optional[InputEventCallback] = None
+        self._telemetry_callback: Optional[TelemetryCallback] = None
+        self._telemetry: Optional[DeviceTelemetry] = None
         self._reader_thread: Optional[threading.Thread] = None
         self._stop_reader = threading.Event()
         self._response_queue: list[LtpPacket] = []
@@ -214,6 +816,11 @@ class LtpDevice:
         """Device information (populated after connect)."""
         return self._info
 
+    @property
+    def telemetry(self) -> Optional[DeviceTelemetry]:
+        """Most recent telemetry report (see set_status_interval)."""
+        return self._telemetry
+
     @property
     def is_connected(self) -> bool:
         """Check if device is connected."""
@@ -247,6 +854,9 @@ class LtpDevice:
         except serial.SerialException as e:
             raise LtpConnectionError(f"Failed to open {self.port}: {e}") from e
 
+        if self.capture_path and not self._capture:
+            self._capture = CaptureWriter(self.capture_path)
+
         # Clear any pending data
         self._serial.reset_input_buffer()
         self._protocol.reset()
@@ -289,6 +899,10 @@ class LtpDevice:
             self._serial.close()
             self._serial = None
 
+        if self._capture:
+            self._capture.close()
+            self._capture = None
+
         self._info = None
 
     def __enter__(self):
@@ -327,6 +941,41 @@ class LtpDevice:
         """
         self._send(LtpProtocol.build_pixel_set_range(strip_id, start, end, r, g, b))
 
+    def fill_gradient(
+        self, start: int, end: int, colors: list[tuple[int, int, int]],
+        positions: Optional[list[int]] = None, strip_id: int = 0,
+    ):
+        """
+        Fill a range with a gradient drawn on the device.
+
+        Args:
+            start: Start index (inclusive)
+            end: End index (exclusive)
+            colors: 2-16 color stops
+            positions: Stop positions along the range, 0-255 (default: evenly spaced)
+            strip_id: Strip ID
+        """
+        self._send(LtpProtocol.build_pixel_fill_gradient(strip_id, start, end, colors, positions))
+
+    def fill_pattern(
+        self, start: int, end: int, colors: list[tuple[int, int, int]],
+        width: int = 1, offset: int = 0, strip_id: int = 0,
+    ):
+        """
+        Fill a range by repeating colors, width pixels each, shifted by offset pixels.
+        """
+        self._send(LtpProtocol.build_pixel_fill_pattern(strip_id, start, end, colors, width, offset))
+
+    def fill_stride(
+        self, start: int, end: int, color: tuple[int, int, int], stride: int,
+        width: int = 1, phase: int = 0, strip_id: int = 0,
+    ):
+        """
+        Set width pixels out of every stride in a range, the first at start + phase;
+        the pixels between keep their colors.
+        """
+        self._send(LtpProtocol.build_pixel_fill_stride(strip_id, start, end, color, stride, width, phase))
+
     def set_pixels(self, pixel_data: bytes, start: int = 0, strip_id: int = 0):
         """
         Set pixel data from raw bytes.
@@ -397,6 +1046,10 @@ class LtpDevice:
         """Enable/disable frame acknowledgment."""
         self._send(LtpProtocol.build_set_control_bool(CTRL_ID_FRAME_ACK, enabled))
 
+    def set_status_interval(self, seconds: int):
+        """Send STATUS_UPDATE telemetry every `seconds` (0 = off)."""
+        self._send(LtpProtocol.build_set_control_uint16(CTRL_ID_STATUS_INTERVAL, seconds))
+
     def set_control(self, control_id: int, value: int):
         """Set a control value (generic UINT8)."""
         self._send(LtpProtocol.build_set_control_uint8(control_id, value))
@@ -430,6 +1083,694 @@ class LtpDevice:
         packet = self._wait_for_response(CMD_INFO_RESPONSE)
         return self._parse_stats_response(packet)
 
+    def get_latency(self, clear: bool = False) -> DeviceLatency:
+        """Get frame latency histograms, optionally clearing them on the device."""
+        self._send(LtpProtocol.build_get_latency(clear))
+        packet = self._wait_for_response(CMD_INFO_RESPONSE)
+        return self._parse_latency_response(packet)
+
+    def get_memory(self) -> DeviceMemory:
+        """
+        Get the strip storage arena's size and use. Raises LtpDeviceError
+        (ERR_INVALID_PARAM) on devices without an arena.
+        """
+        self._send(LtpProtocol.build_get_info(INFO_MEMORY))
+        p = self._wait_for_response(CMD_INFO_RESPONSE).payload
+        if len(p) < 12:
+            raise LtpProtocolError("Memory info response too short")
+        size, used, free, high_water, pixels, longest = struct.unpack_from("<6H", p)
+        info = DeviceMemory(
+            arena_size=size,
+            used=used,
+            free=free,
+            high_water=high_water,
+            pixels=pixels,
+            longest_strip=longest,
+        )
+        if len(p) >= 16:
+            info.strip_bytes, info.effect_bytes = struct.unpack_from("<2H", p, 12)
+        return info
+
+    def set_strip(self, pixels: int, strip_id: int = 0):
+        """
+        Lay a strip out again as `pixels` pixels, keeping its format, type
+        and pins. The strip is cleared and running effects stop. Raises
+        LtpDeviceError (ERR_BUFFER_OVERFLOW) if it does not fit the device's
+        arena; see get_memory().
+        """
+        self._send(LtpProtocol.build_get_info(INFO_STRIPS))
+        strips = self._parse_strips_response(self._wait_for_response(CMD_INFO_RESPONSE))
+        strip = next((s for s in strips if s.strip_id == strip_id), None)
+        if strip is None:
+            raise LtpProtocolError(f"Device has no strip {strip_id}")
+        self._send(LtpProtocol.build_set_strip(
+            strip_id, pixels, strip.color_format, strip.led_type,
+            strip.data_pin, strip.clock_pin, strip.flags,
+        ))
+        self._wait_for_response(CMD_ACK)
+        strip.pixel_count = pixels
+        if self._info:
+            self._info.strips = strips
+            self._info.total_pixels = sum(s.pixel_count for s in strips)
+
+    def get_profile(self, clear: bool = False) -> DeviceProfile:
+        """
+        Get the firmware section profile, optionally clearing it on the device.
+
+        Raises LtpDeviceError (ERR_NOT_SUPPORTED) if the firmware was built
+        without LTP_PROFILE.
+        """
+        self._send(LtpProtocol.build_profile(clear))
+        packet = self._wait_for_response(CMD_PROFILE)
+        return self._parse_profile_response(packet)
+
+    def bench(self, iterations: int = 0) -> DeviceBench:
+        """
+        Run the on-device self-benchmark. The device stalls for about
+        `iterations` show() times and clears the strip afterwards.
+        """
+        self._send(LtpProtocol.build_bench(iterations))
+        packet = self._wait_for_response(CMD_BENCH, timeout=max(self.timeout, 10.0))
+        return self._parse_bench_response(packet)
+
+    def echo(self, reply_length: int = 0, data: bytes = b"") -> tuple[float, bytes]:
+        """
+        Send an ECHO and return the round-trip time in seconds and the reply
+        data (reply_length bytes, or data echoed back if 0).
+        """
+        start = time.perf_counter()
+        self._send(LtpProtocol.build_echo(reply_length, data))
+        packet = self._wait_for_response(CMD_ECHO)
+        rtt = time.perf_counter() - start
+        if len(packet.payload) < 8:
+            raise LtpProtocolError("Echo response too short")
+        return rtt, packet.payload[8:]
+
+    def sink_start(self) -> SinkReport:
+        """Reset the device's SINK counters."""
+        self._send(LtpProtocol.build_sink(SINK_START))
+        return self._parse_sink_response(self._wait_for_response(CMD_SINK))
+
+    def sink_send(self, packets: int, filler: int = 256, seq: int = 0) -> int:
+        """
+        Send SINK data packets of `filler` bytes without waiting for replies.
+        Returns the wire bytes written.
+        """
+        sent = 0
+        for i in range(packets):
+            packet = LtpProtocol.build_sink(SINK_DATA, seq + i, filler)
+            self._send(packet)
+            sent += len(packet)
+        return sent
+
+    def sink_report(self, timeout: Optional[float] = None) -> SinkReport:
+        """Read the device's SINK counters."""
+        self._send(LtpProtocol.build_sink(SINK_REPORT))
+        return self._parse_sink_response(self._wait_for_response(CMD_SINK, timeout))
+
+    def probe_link(
+        self, rounds: int = 8, sink_bytes: int = 0, echo_bytes: int = 1000
+    ) -> LinkProbe:
+        """
+        Measure round-trip time and throughput in both directions.
+
+        Takes `rounds` small and large ECHOs, then sends a SINK burst of
+        sink_bytes (default: about a quarter second at the configured baud
+        rate). Raises LtpDeviceError (ERR_INVALID_CMD) on firmware without
+        the link probe.
+        """
+        rounds = max(1, rounds)
+        rtts = [self.echo()[0] for _ in range(rounds)]
+        rtt_min = min(rtts)
+
+        # Large replies: what the round trip adds is the upstream transfer
+        reply_wire = 6 + 8 + echo_bytes
+        best = min(self.echo(echo_bytes)[0] for _ in range(rounds))
+        upstream = reply_wire / max(best - rtt_min, 1e-6)
+
+        filler = 256
+        sink_bytes = sink_bytes or min(max(4096, self.baudrate // 40), 65536)
+        packets = max(2, sink_bytes // (filler + 9))
+        self.sink_start()
+        sent = self.sink_send(packets, filler)
+        # Enough time to drain the burst at the configured baud rate
+        wait = max(self.timeout, 2 * sent * 10 / self.baudrate)
+        report = self.sink_report(timeout=wait)
+        report.lost_packets += max(0, packets - report.packets - report.lost_packets)
+
+        return LinkProbe(
+            rtt_min_ms=rtt_min * 1000,
+            rtt_mean_ms=sum(rtts) / len(rtts) * 1000,
+            rtt_max_ms=max(rtts) * 1000,
+            upstream_bytes_per_second=upstream,
+            downstream_bytes_per_second=float(report.bytes_per_second),
+            sink=report,
+        )
+
+    def start_animation(
+        self,
+        pattern: int,
+        speed: int = 0,
+        size: Optional[int] = None,
+        intensity: Optional[int] = None,
+        palette: Optional[int] = None,
+        color1: Optional[tuple[int, int, int]] = None,
+        color2: tuple[int, int, int] = (0, 0, 0),
+        start: int = 0,
+        count: int = 0,
+        fps: int = 0,
+    ):
+        """
+        Start a built-in animation on pixels start..start+count-1 (count 0 =
+        to the end). speed 16 is the pattern's default rate; None and 0
+        parameters take the firmware defaults. Raises LtpDeviceError on
+        firmware without animations (ERR_INVALID_CMD) or a bad parameter.
+        """
+        self._send(LtpProtocol.build_anim_start(
+            pattern, speed, size, intensity, palette, color1, color2, start, count, fps
+        ))
+        self._wait_for_response(CMD_ACK)
+
+    def stop_animation(self, clear: bool = False):
+        """Stop the built-in animation, optionally blanking its pixels."""
+        self._send(LtpProtocol.build_anim_stop(clear))
+        self._wait_for_response(CMD_ACK)
+
+    def fade_to(
+        self,
+        data: bytes,
+        duration: float,
+        start: int = 0,
+        easing: int = FADE_LINEAR,
+        replace: bool = False,
+    ):
+        """
+        Fade pixels from `start` from their current colors to `data` (RGB)
+        over `duration` seconds, rendered on the device. Keyframes queue
+        behind a running fade unless `replace`; a full queue raises
+        LtpDeviceError (ERR_BUSY). Targets longer than one packet go in
+        several, which the device joins into one keyframe.
+        """
+        pixels = len(data) // 3
+        for first in range(0, pixels, FADE_CHUNK):
+            part = data[first * 3:(first + FADE_CHUNK) * 3]
+            self._send(LtpProtocol.build_fade_frame(
+                part, round(duration * 1000), start + first, easing, replace,
+                continued=first + FADE_CHUNK < pixels,
+            ))
+            self._wait_for_response(CMD_ACK)
+
+    def fade_level(
+        self,
+        from_level: int,
+        to_level: int,
+        duration: float,
+        start: int = 0,
+        count: int = 0,
+        easing: int = FADE_LINEAR,
+        replace: bool = False,
+    ):
+        """
+        Ramp the brightness of the pixels' current colors from from_level to
+        to_level (0-255) over `duration` seconds. To fade a new frame in,
+        load it without show() and ramp from 0.
+        """
+        self._send(LtpProtocol.build_fade_level(
+            from_level, to_level, round(duration * 1000), start, count, easing, replace
+        ))
+        self._wait_for_response(CMD_ACK)
+
+    def load_shader(
+        self,
+        code: bytes,
+        run: bool = True,
+        fps: int = 0,
+        budget: int = 0,
+        start: int = 0,
+        count: int = 0,
+    ):
+        """
+        Upload a pixel shader (see ltp_serial_cli.shader.assemble) and, with
+        run, start it on pixels start..start+count-1 (count 0 = to the end).
+        budget is the instructions one pixel may run (0 = firmware default).
+        Empty code keeps the loaded program. Raises LtpDeviceError when the
+        firmware rejects the program (ERR_INVALID_PARAM) or it does not fit
+        (ERR_BUFFER_OVERFLOW).
+        """
+        self._send(LtpProtocol.build_shader_load(
+            code, SHADER_RUN if run else 0, fps, budget, start, count
+        ))
+        self._wait_for_response(CMD_ACK)
+
+    def set_shader_params(self, first: int, values: list[int]):
+        """Set shader parameters first..first+len(values)-1 (signed 16-bit)."""
+        self._send(LtpProtocol.build_shader_param(first, values))
+        self._wait_for_response(CMD_ACK)
+
+    def test_shader(
+        self,
+        code: bytes,
+        time_ms: int = 0,
+        budget: int = 0,
+        start: int = 0,
+        count: int = 0,
+        run: bool = False,
+    ) -> ShaderTest:
+        """
+        Load a shader and have the device render one frame at time_ms into a
+        hash, then render the same frame with the reference interpreter
+        using the device's geometry and parameters. The LEDs are untouched
+        unless run is set.
+        """
+        self._send(LtpProtocol.build_shader_load(
+            code, SHADER_TEST | (SHADER_RUN if run else 0), 0, budget, start, count, time_ms
+        ))
+        response = self._wait_for_response(CMD_SHADER_LOAD)
+        if len(response.payload) < 16:
+            raise LtpProtocolError("Shader test response too short")
+        test = ShaderTest(*struct.unpack("<IIHHI", response.payload[0:16]))
+
+        shader = self.get_animation().shader
+        if shader is not None:
+            try:
+                coords = self.get_coords() if self.get_coords_info().count else []
+            except LtpDeviceError:
+                coords = []         # Firmware without a coordinate table
+            test.reference = render_shader(
+                code, shader.count, time_ms, 0, shader.params,
+                shader.start, shader.width, shader.height, shader.budget, coords,
+            )
+        return test
+
+    def set_coords(self, coords: list[tuple[int, int, int]], save: bool = False):
+        """
+        Replace the device's coordinate table with (x, y, z) for logical
+        pixels 0.. onwards, and with save, store it in EEPROM so it is
+        loaded at startup. Raises LtpDeviceError when a value is out of
+        range for the table (ERR_INVALID_PARAM), the table is longer than
+        the strip (ERR_PIXEL_OVERFLOW) or the firmware has no table
+        (ERR_NOT_SUPPORTED).
+        """
+        self.clear_coords()
+        for first in range(0, len(coords), COORDS_CHUNK):
+            self._send(LtpProtocol.build_coords_write(first, coords[first:first + COORDS_CHUNK]))
+            self._wait_for_response(CMD_ACK)
+        if save:
+            self.save_coords()
+
+    def get_coords(self) -> list[tuple[int, int, int]]:
+        """Read back the device's coordinate table."""
+        coords: list[tuple[int, int, int]] = []
+        while True:
+            self._send(LtpProtocol.build_coords_read(len(coords), COORDS_CHUNK))
+            p = self._wait_for_response(CMD_COORDS).payload
+            if len(p) < 2 or (len(p) - 2) % 6:
+                raise LtpProtocolError("Bad COORDS read response")
+            chunk = [struct.unpack_from("<hhh", p, 2 + i * 6) for i in range((len(p) - 2) // 6)]
+            if not chunk:
+                return coords
+            coords.extend(chunk)
+
+    def get_coords_info(self) -> DeviceCoords:
+        """Get the coordinate table's size, capacity and bounds."""
+        self._send(LtpProtocol.build_coords(COORDS_INFO))
+        p = self._wait_for_response(CMD_COORDS).payload
+        if len(p) < 22:
+            raise LtpProtocolError("COORDS info response too short")
+        count, capacity, saved, eeprom, bits, _, *bounds = struct.unpack("<HHHHBB6h", p[0:22])
+        return DeviceCoords(
+            count=count,
+            capacity=capacity,
+            saved=saved,
+            eeprom_capacity=eeprom,
+            bits=bits,
+            low=tuple(bounds[0::2]),
+            high=tuple(bounds[1::2]),
+        )
+
+    def save_coords(self):
+        """
+        Store the coordinate table in EEPROM. Raises LtpDeviceError
+        (ERR_BUFFER_OVERFLOW) when it does not fit, or ERR_NOT_SUPPORTED.
+        """
+        self._send(LtpProtocol.build_coords(COORDS_SAVE))
+        self._wait_for_response(CMD_ACK)
+
+    def clear_coords(self):
+        """Empty the coordinate table; the EEPROM copy stays until saved over."""
+        self._send(LtpProtocol.build_coords(COORDS_CLEAR))
+        self._wait_for_response(CMD_ACK)
+
+    def configure_visualizer(
+        self,
+        mode: int,
+        flags: int = 0,
+        start: int = 0,
+        count: int = 0,
+        bars: int = 1,
+        gap: int = 1,
+        segments: int = 10,
+        fall: Optional[float] = None,
+        hold: Optional[float] = None,
+        **colors,
+    ):
+        """
+        Set pixels start..start+count-1 (count 0 = to the end) up as 1-4 bar
+        graphs, meters or gauges drawn from set_visualizer() values. fall is
+        the seconds a full-scale level takes to drop and hold the seconds
+        the peak stays (None = firmware default); colors are the yellow and
+        red thresholds and color1, color2 and background of
+        LtpProtocol.build_vis_config. VIS_OFF stops it.
+        """
+        self._send(LtpProtocol.build_vis_config(
+            mode, flags, start, count, bars, gap, segments,
+            None if fall is None else min(255, round(fall * 10)),
+            None if hold is None else min(255, round(hold * 10)),
+            **colors,
+        ))
+        self._wait_for_response(CMD_ACK)
+
+    def set_visualizer(self, values: list[float], low: float = 0.0, high: float = 1.0):
+        """
+        Send one value per bar, scaled from low..high to the device's 0-255
+        and clamped. No ACK; errors arrive as a NAK on a later command.
+        """
+        span = (high - low) or 1.0
+        scaled = [min(255, max(0, round((v - low) / span * 255))) for v in values]
+        self._send(LtpProtocol.build_vis_value(scaled))
+
+    def start_audio(self, gain: int = 0, threshold: int = 0):
+        """
+        Start sampling and analysing the audio input, for the spectrum and
+        pulse animations. gain is dB of boost (0 = automatic), threshold
+        the beat threshold in 1/64 (0 = 1.4x). Raises LtpDeviceError
+        (ERR_INVALID_CMD) on firmware without the audio engine.
+        """
+        self._send(LtpProtocol.build_audio_start(gain, threshold))
+        self._wait_for_response(CMD_ACK)
+
+    def stop_audio(self):
+        """Stop sampling the audio input."""
+        self._send(LtpProtocol.build_audio(AUDIO_STOP))
+        self._wait_for_response(CMD_ACK)
+
+    def get_audio(self) -> DeviceAudio:
+        """Get the audio engine's last analysis and per-block cost."""
+        self._send(LtpProtocol.build_audio(AUDIO_INFO))
+        p = self._wait_for_response(CMD_AUDIO).payload
+        if len(p) < 9 or len(p) < 9 + p[5] + 30:
+            raise LtpProtocolError("AUDIO info response too short")
+        running, rate, samples, n, gain, threshold, level = struct.unpack_from("<BHHBBBB", p, 0)
+        bands = tuple(p[9:9 + n])
+        blocks, overruns, beats, interval, tick_hz, last, mean, peak = struct.unpack_from(
+            "<IIIHIIII", p, 9 + n)
+        return DeviceAudio(
+            running=bool(running),
+            rate=rate,
+            samples=samples,
+            gain=gain,
+            threshold=threshold,
+            level=level,
+            bands=bands,
+            blocks=blocks,
+            overruns=overruns,
+            beats=beats,
+            beat_interval_ms=interval,
+            tick_hz=tick_hz,
+            last_ticks=last,
+            mean_ticks=mean,
+            max_ticks=peak,
+        )
+
+    def store_scene(self, scene_id: int):
+        """
+        Store the pixels as shown now under scene_id, waiting out the
+        EEPROM write (AVR reads nothing past its 64-byte RX buffer until it
+        ACKs). Raises LtpDeviceError (ERR_INVALID_PARAM) for a slot the
+        device does not have, or ERR_BUFFER_OVERFLOW when the strip is
+        longer than a scene holds.
+        """
+        self._send(LtpProtocol.build_scene(SCENE_STORE, scene_id))
+        self._wait_for_response(CMD_ACK, timeout=max(self.timeout, SCENE_EEPROM_TIMEOUT))
+
+    def upload_scene(self, scene_id: int, colors: list[tuple[int, int, int]]):
+        """
+        Store colors for pixels 0.. onwards under scene_id, without showing
+        them, one SCENE_CHUNK per packet and each ACKed before the next.
+        """
+        for first in range(0, len(colors), SCENE_CHUNK):
+            self._send(LtpProtocol.build_scene_upload(scene_id, first, colors[first:first + SCENE_CHUNK]))
+            self._wait_for_response(CMD_ACK, timeout=max(self.timeout, SCENE_EEPROM_TIMEOUT))
+
+    def recall_scene(self, scene_id: int, fade: float = 0.0, easing: int = FADE_LINEAR):
+        """
+        Show scene scene_id, stopping animations, shaders and visualizers;
+        with fade (seconds), crossfade to it on the device. Raises
+        LtpDeviceError (ERR_INVALID_PARAM) for an empty slot, or
+        ERR_NOT_SUPPORTED for a fade on firmware without FADE_TO.
+        """
+        self._send(LtpProtocol.build_scene_recall(scene_id, round(fade * 1000), easing))
+        self._wait_for_response(CMD_ACK)
+
+    def delete_scene(self, scene_id: int):
+        """Empty slot scene_id."""
+        self._send(LtpProtocol.build_scene(SCENE_DELETE, scene_id))
+        self._wait_for_response(CMD_ACK)
+
+    def get_scenes(self) -> DeviceScenes:
+        """Get the scene cache's slots and what each holds."""
+        self._send(LtpProtocol.build_scene(SCENE_INFO))
+        p = self._wait_for_response(CMD_SCENE).payload
+        if len(p) < 3 or len(p) < 3 + p[0] * 3:
+            raise LtpProtocolError("SCENE info response too short")
+        slots = []
+        for i in range(p[0]):
+            storage, pixels = struct.unpack_from("<BH", p, 3 + i * 3)
+            slots.append(SceneSlot(id=i, eeprom=bool(storage), pixels=pixels))
+        return DeviceScenes(pixels=struct.unpack_from("<H", p, 1)[0], slots=slots)
+
+    def play_sequence(self, name: Optional[str] = None, loop: bool = False):
+        """
+        Play the sketch's flash sequence, or with name the file on the
+        device's SD card, stopping animations, fades, shaders and
+        visualizers. Raises LtpDeviceError: ERR_NOT_SUPPORTED without that
+        source, ERR_HARDWARE if the card does not start, ERR_INVALID_PARAM
+        for a missing file or one that is not a sequence.
+        """
+        if name is None:
+            self._send(LtpProtocol.build_sequence_play(SEQ_FLASH, loop=loop))
+        else:
+            self._send(LtpProtocol.build_sequence_play(SEQ_SD, name, loop))
+        self._wait_for_response(CMD_ACK)
+
+    def stop_sequence(self):
+        """Stop the sequence at its current frame."""
+        self._send(LtpProtocol.build_sequence(SEQ_STOP))
+        self._wait_for_response(CMD_ACK)
+
+    def seek_sequence(self, frame: int):
+        """Show frame (from 0) of the loaded sequence and continue from it."""
+        self._send(LtpProtocol.build_sequence_seek(frame))
+        self._wait_for_response(CMD_ACK)
+
+    def sync_sequence(self):
+        """Continue past the sync point the sequence waits at, or the next one."""
+        self._send(LtpProtocol.build_sequence(SEQ_SYNC))
+        self._wait_for_response(CMD_ACK)
+
+    def get_sequence(self) -> DeviceSequence:
+        """Get the sequence player's state and SD read statistics."""
+        self._send(LtpProtocol.build_sequence(SEQ_INFO))
+        p = self._wait_for_response(CMD_SEQUENCE).payload
+        if len(p) < 38:
+            raise LtpProtocolError("SEQUENCE info response too short")
+        (state, source, flags, caps, pixels, frames, frame, duration, loops, block_size,
+         block_reads, stalls, last_us, max_us) = struct.unpack_from("<BBBBHIIIHHIIII", p)
+        return DeviceSequence(
+            state=state,
+            source=source,
+            loop=bool(flags & 0x01),
+            has_flash=bool(caps & 0x01),
+            has_sd=bool(caps & 0x02),
+            pixels=pixels,
+            frames=frames,
+            frame=frame,
+            duration_ms=duration,
+            loops=loops,
+            block_size=block_size,
+            block_reads=block_reads,
+            stalls=stalls,
+            last_decode_us=last_us,
+            max_decode_us=max_us,
+        )
+
+    def configure_layer(
+        self, layer_id: int, start: int, count: int, blend: int = LAYER_OVER,
+        opacity: int = 255, key: bool = False,
+    ):
+        """
+        Place overlay layer_id (1-3) over count pixels from start, black
+        until drawn; count 0 turns it off. Raises LtpDeviceError:
+        ERR_BUFFER_OVERFLOW when the layers would need more pixels than the
+        device keeps for them, ERR_PIXEL_OVERFLOW past the last pixel.
+        """
+        self._send(LtpProtocol.build_layer_config(
+            layer_id, start, count, blend, opacity, LAYER_KEY if key else 0))
+        self._wait_for_response(CMD_ACK)
+
+    def set_layer_opacity(self, layer_id: int, opacity: int, blend: Optional[int] = None):
+        """Change a layer's opacity (0-255), and optionally its blend mode."""
+        self._send(LtpProtocol.build_layer_opacity(layer_id, opacity, blend))
+
+    def set_layer_pixels(self, layer_id: int, colors: list[tuple[int, int, int]], start: int = 0):
+        """Write colors into a layer from its pixel start."""
+        self._send(LtpProtocol.build_layer_pixels(layer_id, start, colors))
+
+    def fill_layer(
+        self, layer_id: int, colors: list[tuple[int, int, int]], start: int = 0,
+        end: Optional[int] = None, positions: Optional[list[int]] = None,
+    ):
+        """
+        Fill pixels start to end - 1 of a layer (end None: to the layer's
+        end) with one color, or a gradient through several.
+        """
+        if end is None:
+            end = next((layer.count for layer in self.get_layers().layers if layer.id == layer_id), 0)
+        self._send(LtpProtocol.build_layer_fill(layer_id, start, end, colors, positions))
+
+    def clear_layers(self):
+        """Turn every overlay layer off."""
+        self._send(LtpProtocol.build_layer(LAYER_CLEAR))
+        self._wait_for_response(CMD_ACK)
+
+    def get_layers(self) -> DeviceLayers:
+        """Get the overlay layers and the cost of compositing them."""
+        self._send(LtpProtocol.build_layer(LAYER_INFO))
+        p = self._wait_for_response(CMD_LAYER).payload
+        if len(p) < 5 or len(p) < 25 + 7 * p[0]:
+            raise LtpProtocolError("LAYER info response too short")
+        n, pool, used = struct.unpack_from("<BHH", p)
+        layers = []
+        for i in range(n):
+            blend, opacity, flags, start, count = struct.unpack_from("<BBBHH", p, 5 + 7 * i)
+            layers.append(LayerState(i + 1, blend, opacity, bool(flags & LAYER_KEY), start, count))
+        tick_hz, composites, last, mean, peak = struct.unpack_from("<IIIII", p, 5 + 7 * n)
+        return DeviceLayers(
+            pool=pool,
+            used=used,
+            layers=layers,
+            tick_hz=tick_hz,
+            composites=composites,
+            last_ticks=last,
+            mean_ticks=mean,
+            max_ticks=peak,
+        )
+
+    def set_palette(self, colors: list[tuple[int, int, int]], first: int = 0):
+        """
+        Load colors into palette entries from first; every pixel using an
+        entry changes color at the next show.
+        """
+        self._send(LtpProtocol.build_palette_set(first, colors))
+        self._wait_for_response(CMD_ACK)
+
+    def set_palette_indices(self, indices: list[int], start: int = 0, bits: Optional[int] = None):
+        """
+        Write palette entries to pixels from start, packed at the device's
+        index width (bits None: read it with get_palette()).
+        """
+        if bits is None:
+            bits = self.get_palette().bits
+        self._send(LtpProtocol.build_palette_indices(start, indices, bits))
+
+    def rotate_palette(self, step: int = 1, interval_ms: int = 0, first: int = 0, count: int = 0):
+        """
+        Rotate palette entries first to first + count - 1 (count 0: to the
+        last entry) by step, once or every interval_ms; step 0 stops it.
+        """
+        self._send(LtpProtocol.build_palette_rotate(first, count, step, interval_ms))
+        self._wait_for_response(CMD_ACK)
+
+    def get_palette(self) -> DevicePalette:
+        """
+        Get the palette layout and rotation. Raises LtpDeviceError
+        (ERR_NOT_SUPPORTED) when the device stores RGB per pixel.
+        """
+        self._send(LtpProtocol.build_palette_info())
+        p = self._wait_for_response(CMD_PALETTE).payload
+        if len(p) < 16:
+            raise LtpProtocolError("PALETTE info response too short")
+        bits, colors, pixels, index_bytes, first, count, step, interval, steps = \
+            struct.unpack_from("<BHHHBBbHI", p)
+        return DevicePalette(
+            bits=bits,
+            colors=colors,
+            pixels=pixels,
+            index_bytes=index_bytes,
+            rotate_first=first,
+            rotate_count=count,
+            rotate_step=step,
+            rotate_interval_ms=interval,
+            rotate_steps=steps,
+        )
+
+    def get_display_list(self, clear: bool = False) -> DeviceDisplayList:
+        """
+        Get the span list usage, optionally clearing the dropped count.
+        Raises LtpDeviceError (ERR_NOT_SUPPORTED) when the device keeps a
+        pixel buffer.
+        """
+        self._send(LtpProtocol.build_display_list(clear))
+        p = self._wait_for_response(CMD_DISPLAY_LIST).payload
+        if len(p) < 12:
+            raise LtpProtocolError("DISPLAY_LIST response too short")
+        max_spans, spans, span_bytes, pixels, dropped, solid, ramp, pattern = \
+            struct.unpack_from("<BBBHIBBB", p)
+        return DeviceDisplayList(
+            max_spans=max_spans,
+            spans=spans,
+            span_bytes=span_bytes,
+            pixels=pixels,
+            dropped=dropped,
+            solid=solid,
+            ramp=ramp,
+            pattern=pattern,
+        )
+
+    def get_animation(self) -> DeviceAnimation:
+        """Get the built-in animation state."""
+        self._send(LtpProtocol.build_packet(CMD_ANIM_STATUS))
+        return self._parse_animation_response(self._wait_for_response(CMD_ANIM_STATUS))
+
+    def get_trace(self, clear: bool = False) -> DeviceTrace:
+        """
+        Read the device packet trace, optionally clearing it afterwards.
+
+        Reads in pages until it reaches the packets traced before the first
+        request, so the TRACE requests themselves are not included. Raises
+        LtpDeviceError (ERR_NOT_SUPPORTED) if the firmware was built with
+        LTP_TRACE_ENTRIES=0.
+        """
+        trace: Optional[DeviceTrace] = None
+        start = 0
+        while True:
+            self._send(LtpProtocol.build_trace(start))
+            page = self._parse_trace_response(self._wait_for_response(CMD_TRACE))
+            if trace is None:
+                trace = page
+            else:
+                trace.entries.extend(e for e in page.entries if e.sequence < trace.total)
+            if not page.entries:
+                break
+            start = page.entries[-1].sequence + 1
+            if start >= trace.total:
+                break
+
+        if clear:
+            self._send(LtpProtocol.build_trace(0xFFFFFFFF, clear=True))
+            self._wait_for_response(CMD_TRACE)
+        return trace
+
     def get_pixels(
         self, start: int = 0, count: int = 0, strip_id: int = 0
     ) -> bytes:
@@ -480,6 +1821,14 @@ class LtpDevice:
         """
         self._input_callback = callback
 
+    def set_telemetry_callback(self, callback: Optional[TelemetryCallback]):
+        """
+        Set callback for telemetry reports.
+
+        Called from the reader thread with each DeviceTelemetry.
+        """
+        self._telemetry_callback = callback
+
     # =========================================================================
     # Internal Methods
     # =========================================================================
@@ -490,6 +1839,8 @@ class LtpDevice:
             raise LtpConnectionError("Not connected")
         if self.debug:
             self._debug_tx(packet)
+        if self._capture:
+            self._capture.write(CAPTURE_HOST_TO_DEVICE, packet)
         self._serial.write(packet)
 
     def _debug_tx(self, packet: bytes):
@@ -534,8 +1885,12 @@ class LtpDevice:
                 break
 
             try:
-                data = self._serial.read(256)
+                # Block for the first byte only, so short replies are not
+                # held until the read timeout
+                data = self._serial.read(max(1, self._serial.in_waiting))
                 if data:
+                    if self._capture:
+                        self._capture.write(CAPTURE_DEVICE_TO_HOST, data)
                     packets = self._protocol.feed(data)
                     for packet in packets:
                         self._handle_packet(packet)
@@ -558,7 +1913,12 @@ class LtpDevice:
             return
 
         if packet.cmd == CMD_STATUS_UPDATE:
-            # Could emit an event here
+            if packet.payload[:1] == bytes([STATUS_TELEMETRY]):
+                telemetry = self._parse_telemetry(packet)
+                if telemetry:
+                    self._telemetry = telemetry
+                    if self._telemetry_callback:
+                        self._telemetry_callback(telemetry)
             return
 
         # Queue response for synchronous handlers
@@ -688,7 +2048,7 @@ class LtpDevice:
         if len(p) < 20:
             return DeviceStats()
 
-        return DeviceStats(
+        stats = DeviceStats(
             frames_received=struct.unpack("<I", p[0:4])[0],
             frames_displayed=struct.unpack("<I", p[4:8])[0],
             bytes_received=struct.unpack("<I", p[8:12])[0],
@@ -696,3 +2056,167 @@ class LtpDevice:
             buffer_overflows=struct.unpack("<H", p[14:16])[0],
             uptime_seconds=struct.unpack("<I", p[16:20])[0],
         )
+        if len(p) < 45:
+            return stats
+
+        (
+            stats.packets_received,
+            stats.resync_bytes,
+            stats.dropped_bytes,
+            stats.oversize_packets,
+            stats.timeouts,
+            stats.dropped_frames,
+            stats.frame_restarts,
+            stats.nak_total,
+        ) = struct.unpack("<IIIHHIHH", p[20:44])
+        stats.extended = True
+        nak_commands = p[44]
+        if len(p) < 45 + 4 * nak_commands:
+            raise LtpProtocolError("Stats response too short")
+        for i in range(nak_commands):
+            cmd, error, count = struct.unpack("<BBH", p[45 + 4 * i : 49 + 4 * i])
+            stats.naks.append(NakCount(cmd, error, count))
+        return stats
+
+    def _parse_latency_response(self, packet: LtpPacket) -> DeviceLatency:
+        """Parse latency histograms from INFO_RESPONSE."""
+        p = packet.payload
+        if len(p) < 21:
+            return DeviceLatency()
+
+        buckets = p[0]
+        if len(p) < 21 + 4 * buckets:
+            raise LtpProtocolError("Latency response too short")
+
+        offsets = struct.unpack("<IIIII", p[1:21])
+        histograms = struct.unpack(f"<{2 * buckets}H", p[21 : 21 + 4 * buckets])
+        return DeviceLatency(
+            frames=offsets[0],
+            last_checksum_us=offsets[1],
+            last_handler_us=offsets[2],
+            last_show_start_us=offsets[3],
+            last_show_done_us=offsets[4],
+            receive_to_show=list(histograms[:buckets]),
+            show_duration=list(histograms[buckets:]),
+        )
+
+    def _parse_telemetry(self, packet: LtpPacket) -> Optional[DeviceTelemetry]:
+        """Parse a STATUS_UPDATE telemetry report."""
+        p = packet.payload
+        if len(p) < 21:
+            return None
+
+        values = struct.unpack("<I8H", p[1:21])
+        return DeviceTelemetry(*values, received_at=time.time())
+
+    def _parse_bench_response(self, packet: LtpPacket) -> DeviceBench:
+        """Parse a BENCH response."""
+        p = packet.payload
+        if len(p) < 31:
+            raise LtpProtocolError("Bench response too short")
+        return DeviceBench(*struct.unpack("<HBIIIIIII", p[0:31]))
+
+    def _parse_animation_response(self, packet: LtpPacket) -> DeviceAnimation:
+        """Parse an ANIM_STATUS response."""
+        p = packet.payload
+        if len(p) < 27:
+            raise LtpProtocolError("Animation response too short")
+        fields = struct.unpack("<BBBBBB3s3sHHBIIH", p[0:27])
+        anim = DeviceAnimation(
+            running=bool(fields[0]),
+            pattern=fields[1],
+            speed=fields[2],
+            size=fields[3],
+            intensity=fields[4],
+            palette=fields[5],
+            color1=tuple(fields[6]),
+            color2=tuple(fields[7]),
+            start=fields[8],
+            count=fields[9],
+            fps=fields[10],
+            frames=fields[11],
+            render_us=fields[12],
+            state_pixels=fields[13],
+        )
+        if len(p) >= 33:
+            queued, capacity, progress, pixels = struct.unpack("<BBHH", p[27:33])
+            anim.fade_queued = queued
+            anim.fade_capacity = capacity
+            anim.fade_progress = progress / 0xFFFF
+            anim.fade_pixels = pixels
+        if len(p) >= 83:
+            fields = struct.unpack("<BHHBHHHHIIIHIH8h", p[33:83])
+            anim.shader = DeviceShader(
+                running=bool(fields[0]),
+                code_length=fields[1],
+                budget=fields[2],
+                fps=fields[3],
+                start=fields[4],
+                count=fields[5],
+                width=fields[6],
+                height=fields[7],
+                frames=fields[8],
+                render_us=fields[9],
+                frame_steps=fields[10],
+                max_pixel_steps=fields[11],
+                faults=fields[12],
+                code_capacity=fields[13],
+                params=fields[14:],
+            )
+        if len(p) >= 110:
+            fields = struct.unpack("<BBBHH4s4s4sII", p[83:110])
+            bars = fields[2]
+            anim.visualizer = DeviceVisualizer(
+                mode=fields[0],
+                flags=fields[1],
+                bars=bars,
+                start=fields[3],
+                count=fields[4],
+                values=tuple(fields[5][:bars]),
+                levels=tuple(fields[6][:bars]),
+                peaks=tuple(fields[7][:bars]),
+                frames=fields[8],
+                render_us=fields[9],
+            )
+        return anim
+
+    def _parse_sink_response(self, packet: LtpPacket) -> SinkReport:
+        """Parse a SINK report."""
+        p = packet.payload
+        if len(p) < 26:
+            raise LtpProtocolError("Sink response too short")
+        return SinkReport(*struct.unpack("<IIIIIHHH", p[0:26]))
+
+    def _parse_trace_response(self, packet: LtpPacket) -> DeviceTrace:
+        """Parse one page of the packet trace from a TRACE response."""
+        p = packet.payload
+        if len(p) < 15:
+            raise LtpProtocolError("Trace response too short")
+
+        capacity, total, now_us, first, count = struct.unpack("<HIIIB", p[0:15])
+        if len(p) < 15 + 11 * count:
+            raise LtpProtocolError("Trace response too short")
+
+        entries = []
+        for i in range(count):
+            cmd, flags, length, arrival, duration, result = struct.unpack(
+                "<BBHIHB", p[15 + 11 * i : 26 + 11 * i]
+            )
+            entries.append(TraceEntry(first + i, cmd, flags, length, arrival, duration, result))
+        return DeviceTrace(capacity=capacity, total=total, now_us=now_us, entries=entries)
+
+    def _parse_profile_response(self, packet: LtpPacket) -> DeviceProfile:
+        """Parse the section table from a PROFILE response."""
+        p = packet.payload
+        if len(p) < 5:
+            raise LtpProtocolError("Profile response too short")
+
+        tick_hz, count = struct.unpack("<IB", p[0:5])
+        if len(p) < 5 + 17 * count:
+            raise LtpProtocolError("Profile response too short")
+
+        sections = []
+        for i in range(count):
+            section_id, calls, total, max_ticks = struct.unpack("<BIQI", p[5 + 17 * i : 22 + 17 * i])
+            sections.append(ProfileSection(section_id, calls, total, max_ticks))
+        return DeviceProfile(tick_hz=tick_hz, sections=sections)
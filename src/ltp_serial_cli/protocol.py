@@ -6,7 +6,7 @@ Low-level protocol implementation for building and parsing LTP packets.
 
 from dataclasses import dataclass, field
 from enum import IntEnum
-from typing import Optional
+from typing import Optional, Tuple
 import struct
 
 # Protocol constants
@@ -53,6 +53,7 @@ CMD_PIXEL_SET_INDEXED = 0x32
 CMD_PIXEL_FRAME = 0x33
 CMD_PIXEL_FRAME_RLE = 0x34
 CMD_PIXEL_DELTA = 0x35
+CMD_PIXEL_FILL = 0x36
 
 # Configuration Commands (0x40-0x4F)
 CMD_SET_CONTROL = 0x40
@@ -68,6 +69,145 @@ CMD_FRAME_ACK = 0x51
 CMD_ERROR_EVENT = 0x52
 CMD_INPUT_EVENT = 0x53
 
+# Status types for STATUS_UPDATE
+STATUS_READY = 0x01
+STATUS_BUSY = 0x02
+STATUS_ERROR = 0x03
+STATUS_TEMPERATURE = 0x04
+STATUS_VOLTAGE = 0x05
+STATUS_BUFFER = 0x06
+STATUS_TELEMETRY = 0x07
+
+# Animation Commands (0x60-0x6F)
+CMD_ANIM_START = 0x60
+CMD_ANIM_STOP = 0x61
+CMD_ANIM_STATUS = 0x62
+CMD_FADE_TO = 0x63
+CMD_SHADER_LOAD = 0x64
+CMD_SHADER_PARAM = 0x65
+CMD_COORDS = 0x66
+CMD_VIS_CONFIG = 0x67
+CMD_VIS_VALUE = 0x68
+CMD_AUDIO = 0x69
+CMD_SCENE = 0x6A
+CMD_SEQUENCE = 0x6B
+CMD_LAYER = 0x6C
+CMD_PALETTE = 0x6D
+CMD_DISPLAY_LIST = 0x6E
+
+# Built-in animation patterns (ANIM_START)
+ANIM_SOLID = 0x00
+ANIM_RAINBOW = 0x01
+ANIM_CHASE = 0x02
+ANIM_CYLON = 0x03
+ANIM_BREATHE = 0x04
+ANIM_SPARKLE = 0x05
+ANIM_FIRE = 0x06
+ANIM_SWEEP = 0x07
+ANIM_RADIAL = 0x08
+ANIM_SPECTRUM = 0x09
+ANIM_PULSE = 0x0A
+
+# Built-in animation palettes (ANIM_START)
+PALETTE_RAINBOW = 0x00
+PALETTE_FIRE = 0x01
+PALETTE_ICE = 0x02
+PALETTE_OCEAN = 0x03
+PALETTE_FOREST = 0x04
+PALETTE_LAVA = 0x05
+PALETTE_GRADIENT = 0xFF
+
+# FADE_TO modes, easing curves and flags
+FADE_FRAME = 0x00
+FADE_LEVEL = 0x01
+FADE_LINEAR = 0x00
+FADE_EASE_IN = 0x01
+FADE_EASE_OUT = 0x02
+FADE_EASE_IN_OUT = 0x03
+FADE_REPLACE = 0x01
+FADE_CONTINUED = 0x02
+
+# SHADER_LOAD flags
+SHADER_RUN = 0x01
+SHADER_TEST = 0x02
+
+# COORDS operations
+COORDS_WRITE = 0x00
+COORDS_CLEAR = 0x01
+COORDS_SAVE = 0x02
+COORDS_INFO = 0x03
+COORDS_READ = 0x04
+
+# VIS_CONFIG modes and flags
+VIS_OFF = 0x00
+VIS_BAR = 0x01
+VIS_METER = 0x02
+VIS_GAUGE = 0x03
+VIS_REVERSE = 0x01
+VIS_CENTER = 0x02
+VIS_GRADIENT = 0x04
+
+# AUDIO operations
+AUDIO_START = 0x00
+AUDIO_STOP = 0x01
+AUDIO_INFO = 0x02
+AUDIO_BANDS = 8
+
+# PIXEL_FILL operations
+FILL_GRADIENT = 0x00
+FILL_PATTERN = 0x01
+FILL_STRIDE = 0x02
+FILL_POSITIONS = 0x80
+FILL_MAX_STOPS = 16
+
+# SCENE operations
+SCENE_STORE = 0x00
+SCENE_UPLOAD = 0x01
+SCENE_RECALL = 0x02
+SCENE_DELETE = 0x03
+SCENE_INFO = 0x04
+
+# SEQUENCE operations, sources and play flags
+SEQ_PLAY = 0x00
+SEQ_STOP = 0x01
+SEQ_SEEK = 0x02
+SEQ_SYNC = 0x03
+SEQ_INFO = 0x04
+SEQ_FLASH = 0x00
+SEQ_SD = 0x01
+SEQ_LOOP = 0x01
+
+# LAYER operations, blend modes and flags
+LAYER_CONFIG = 0x00
+LAYER_OPACITY = 0x01
+LAYER_PIXELS = 0x02
+LAYER_FILL = 0x03
+LAYER_CLEAR = 0x04
+LAYER_INFO = 0x05
+LAYER_OVER = 0x00
+LAYER_ADD = 0x01
+LAYER_MULTIPLY = 0x02
+LAYER_MAX = 0x03
+LAYER_KEY = 0x01       # Black layer pixels are transparent
+
+# PALETTE operations (palette-indexed pixel storage)
+PAL_SET = 0x00
+PAL_INDICES = 0x01
+PAL_ROTATE = 0x02
+PAL_INFO = 0x03
+
+# Diagnostic Commands (0x90-0x9F), answered with the same command
+CMD_PROFILE = 0x90
+CMD_TRACE = 0x91
+CMD_BENCH = 0x92
+CMD_ECHO = 0x93
+CMD_SINK = 0x94
+
+# SINK operations
+SINK_DATA = 0x00
+SINK_START = 0x01
+SINK_REPORT = 0x02
+
 # Info types
 INFO_ALL = 0x00
 INFO_VERSION = 0x01
@@ -76,6 +216,8 @@ INFO_STATUS = 0x03
 INFO_CONTROLS = 0x04
 INFO_STATS = 0x05
 INFO_INPUTS = 0x06
+INFO_LATENCY = 0x07
+INFO_MEMORY = 0x08
 
 # Error codes
 ERR_OK = 0x00
@@ -123,6 +265,8 @@ CAPS_EEPROM = 0x04
 CAPS_USB_HIGHSPEED = 0x08
 CAPS_MULTI_STRIP = 0x10
 CAPS_INPUTS = 0x20
+CAPS_ANIMATION = 0x40
+CAPS_SHADER = 0x80
 
 # Control types
 CTRL_BOOL = 0x01
@@ -181,6 +325,7 @@ COMMAND_NAMES = {
     CMD_PIXEL_FRAME: "PIXEL_FRAME",
     CMD_PIXEL_FRAME_RLE: "PIXEL_FRAME_RLE",
     CMD_PIXEL_DELTA: "PIXEL_DELTA",
+    CMD_PIXEL_FILL: "PIXEL_FILL",
     CMD_SET_CONTROL: "SET_CONTROL",
     CMD_SET_STRIP: "SET_STRIP",
     CMD_SAVE_CONFIG: "SAVE_CONFIG",
@@ -191,6 +336,115 @@ COMMAND_NAMES = {
     CMD_FRAME_ACK: "FRAME_ACK",
     CMD_ERROR_EVENT: "ERROR_EVENT",
     CMD_INPUT_EVENT: "INPUT_EVENT",
+    CMD_ANIM_START: "ANIM_START",
+    CMD_ANIM_STOP: "ANIM_STOP",
+    CMD_ANIM_STATUS: "ANIM_STATUS",
+    CMD_FADE_TO: "FADE_TO",
+    CMD_SHADER_LOAD: "SHADER_LOAD",
+    CMD_SHADER_PARAM: "SHADER_PARAM",
+    CMD_COORDS: "COORDS",
+    CMD_VIS_CONFIG: "VIS_CONFIG",
+    CMD_VIS_VALUE: "VIS_VALUE",
+    CMD_AUDIO: "AUDIO",
+    CMD_SCENE: "SCENE",
+    CMD_SEQUENCE: "SEQUENCE",
+    CMD_LAYER: "LAYER",
+    CMD_PALETTE: "PALETTE",
+    CMD_DISPLAY_LIST: "DISPLAY_LIST",
+    CMD_PROFILE: "PROFILE",
+    CMD_TRACE: "TRACE",
+    CMD_BENCH: "BENCH",
+    CMD_ECHO: "ECHO",
+    CMD_SINK: "SINK",
+}
+
+# Firmware profiler section IDs (profile.h LtpProfileSection)
+PROFILE_SECTION_NAMES = {
+    0x00: "parse/wait_start",
+    0x01: "parse/read_flags",
+    0x02: "parse/read_length_low",
+    0x03: "parse/read_length_high",
+    0x04: "parse/read_cmd",
+    0x05: "parse/read_payload",
+    0x06: "parse/read_checksum",
+    0x07: "handle/get_info",
+    0x08: "handle/show",
+    0x09: "handle/pixel_set_all",
+    0x0A: "handle/pixel_set_range",
+    0x0B: "handle/pixel_frame",
+    0x0C: "handle/set_control",
+    0x0D: "handle/get_control",
+    0x0E: "handle/get_pixels",
+    0x0F: "map_pixel",
+    0x10: "driver/show",
+    0x11: "animation/render",
+    0x12: "shader/render",
+    0x13: "visualizer/render",
+    0x14: "audio/block",
+    0x15: "sequence/frame",
+    0x16: "handle/pixel_fill",
+    0x17: "layer/composite",
+    0x18: "handle/set_strip",
+}
+
+ANIM_PATTERN_NAMES = {
+    ANIM_SOLID: "solid",
+    ANIM_RAINBOW: "rainbow",
+    ANIM_CHASE: "chase",
+    ANIM_CYLON: "cylon",
+    ANIM_BREATHE: "breathe",
+    ANIM_SPARKLE: "sparkle",
+    ANIM_FIRE: "fire",
+    ANIM_SWEEP: "sweep",
+    ANIM_RADIAL: "radial",
+    ANIM_SPECTRUM: "spectrum",
+    ANIM_PULSE: "pulse",
+}
+
+PALETTE_NAMES = {
+    PALETTE_RAINBOW: "rainbow",
+    PALETTE_FIRE: "fire",
+    PALETTE_ICE: "ice",
+    PALETTE_OCEAN: "ocean",
+    PALETTE_FOREST: "forest",
+    PALETTE_LAVA: "lava",
+    PALETTE_GRADIENT: "gradient",
+}
+
+VIS_MODE_NAMES = {
+    VIS_OFF: "off",
+    VIS_BAR: "bar",
+    VIS_METER: "meter",
+    VIS_GAUGE: "gauge",
+}
+
+LAYER_BLEND_NAMES = {
+    LAYER_OVER: "over",
+    LAYER_ADD: "add",
+    LAYER_MULTIPLY: "multiply",
+    LAYER_MAX: "max",
+}
+
+FADE_EASING_NAMES = {
+    FADE_LINEAR: "linear",
+    FADE_EASE_IN: "in",
+    FADE_EASE_OUT: "out",
+    FADE_EASE_IN_OUT: "in-out",
+}
+
+# Firmware defaults per pattern (animation.h): size, intensity, palette, color1
+ANIM_DEFAULTS = {
+    ANIM_SOLID: (0, 0, PALETTE_RAINBOW, (255, 255, 255)),
+    ANIM_RAINBOW: (10, 255, PALETTE_RAINBOW, (255, 255, 255)),
+    ANIM_CHASE: (5, 10, PALETTE_RAINBOW, (255, 255, 255)),
+    ANIM_CYLON: (5, 204, PALETTE_RAINBOW, (255, 0, 0)),
+    ANIM_BREATHE: (0, 0, PALETTE_RAINBOW, (255, 255, 255)),
+    ANIM_SPARKLE: (230, 13, PALETTE_RAINBOW, (255, 255, 255)),
+    ANIM_FIRE: (55, 120, PALETTE_FIRE, (255, 255, 255)),
+    ANIM_SWEEP: (32, 0, PALETTE_RAINBOW, (255, 255, 255)),
+    ANIM_RADIAL: (2, 255, PALETTE_RAINBOW, (255, 255, 255)),
+    ANIM_SPECTRUM: (10, 0, PALETTE_RAINBOW, (255, 255, 255)),
+    ANIM_PULSE: (30, 128, PALETTE_RAINBOW, (255, 255, 255)),
 }
 
 LED_TYPE_NAMES = {
@@ -250,6 +504,28 @@ class LtpPacket:
         return f"LtpPacket({self.command_name}{flags_part}, {len(self.payload)} bytes: {payload_preview})"
 
 
+def _fill_gradient(colors: list[tuple[int, int, int]], positions: Optional[list[int]] = None) -> bytes:
+    """FILL_GRADIENT operation and parameters, as PIXEL_FILL and LAYER_FILL carry them."""
+    if not 2 <= len(colors) <= FILL_MAX_STOPS:
+        raise ValueError(f"Gradient needs 2-{FILL_MAX_STOPS} colors")
+    if positions is None:
+        return bytes([FILL_GRADIENT, len(colors)]) + b"".join(bytes(c) for c in colors)
+    if len(positions) != len(colors):
+        raise ValueError("One position per color")
+    return bytes([FILL_GRADIENT, FILL_POSITIONS | len(colors)]) + b"".join(
+        bytes([p, *c]) for p, c in zip(positions, colors))
+
+
+def _fill_pattern(colors: list[tuple[int, int, int]], width: int = 1, offset: int = 0) -> bytes:
+    """FILL_PATTERN operation and parameters."""
+    return bytes([FILL_PATTERN, width, offset]) + b"".join(bytes(c) for c in colors)
+
+
+def _fill_stride(color: tuple[int, int, int], stride: int, width: int = 1, phase: int = 0) -> bytes:
+    """FILL_STRIDE operation and parameters."""
+    return bytes([FILL_STRIDE, stride, width, phase, *color])
+
+
 class LtpProtocol:
     """
     Low-level LTP protocol handler.
@@ -381,6 +657,332 @@ class LtpProtocol:
         """Build a GET_INFO packet."""
         return LtpProtocol.build_packet(CMD_GET_INFO, bytes([info_type]))
 
+    @staticmethod
+    def build_get_latency(clear: bool = False) -> bytes:
+        """Build a GET_INFO packet for the latency histograms."""
+        return LtpProtocol.build_packet(CMD_GET_INFO, bytes([INFO_LATENCY, 0x01 if clear else 0x00]))
+
+    @staticmethod
+    def build_profile(clear: bool = False) -> bytes:
+        """Build a PROFILE packet reading the firmware section profile."""
+        return LtpProtocol.build_packet(CMD_PROFILE, bytes([0x01 if clear else 0x00]))
+
+    @staticmethod
+    def build_bench(iterations: int = 0) -> bytes:
+        """Build a BENCH packet; iterations 0 uses the firmware default (10)."""
+        return LtpProtocol.build_packet(CMD_BENCH, bytes([iterations & 0xFF]))
+
+    @staticmethod
+    def build_echo(reply_length: int = 0, data: bytes = b"") -> bytes:
+        """Build an ECHO packet; reply_length 0 echoes data back."""
+        return LtpProtocol.build_packet(CMD_ECHO, struct.pack("<H", reply_length) + data)
+
+    @staticmethod
+    def build_sink(op: int, seq: int = 0, filler: int = 0) -> bytes:
+        """Build a SINK packet; SINK_DATA carries a sequence number and filler bytes."""
+        payload = bytes([op])
+        if op == SINK_DATA:
+            payload += struct.pack("<H", seq & 0xFFFF) + bytes(filler)
+        return LtpProtocol.build_packet(CMD_SINK, payload)
+
+    @staticmethod
+    def build_anim_start(
+        pattern: int,
+        speed: int = 0,
+        size: Optional[int] = None,
+        intensity: Optional[int] = None,
+        palette: Optional[int] = None,
+        color1: Optional[Tuple[int, int, int]] = None,
+        color2: Tuple[int, int, int] = (0, 0, 0),
+        start: int = 0,
+        count: int = 0,
+        fps: int = 0,
+    ) -> bytes:
+        """Build an ANIM_START packet; None takes the pattern's firmware default."""
+        d_size, d_intensity, d_palette, d_color1 = ANIM_DEFAULTS.get(pattern, ANIM_DEFAULTS[ANIM_SOLID])
+        payload = struct.pack(
+            "<BBBBB3s3sHHB",
+            pattern,
+            speed,
+            d_size if size is None else size,
+            d_intensity if intensity is None else intensity,
+            d_palette if palette is None else palette,
+            bytes(d_color1 if color1 is None else color1),
+            bytes(color2),
+            start,
+            count,
+            fps,
+        )
+        return LtpProtocol.build_packet(CMD_ANIM_START, payload)
+
+    @staticmethod
+    def build_anim_stop(clear: bool = False) -> bytes:
+        """Build an ANIM_STOP packet; clear blanks the animated pixels."""
+        return LtpProtocol.build_packet(CMD_ANIM_STOP, bytes([0x01 if clear else 0x00]))
+
+    @staticmethod
+    def build_fade_frame(
+        data: bytes,
+        duration_ms: int,
+        start: int = 0,
+        easing: int = FADE_LINEAR,
+        replace: bool = False,
+        continued: bool = False,
+    ) -> bytes:
+        """
+        Build a FADE_TO packet fading pixels from start to the RGB data;
+        continued says the next packet carries more of the same keyframe.
+        """
+        flags = (FADE_REPLACE if replace else 0) | (FADE_CONTINUED if continued else 0)
+        payload = struct.pack("<BBBIH", FADE_FRAME, easing, flags, duration_ms, start)
+        return LtpProtocol.build_packet(CMD_FADE_TO, payload + bytes(data))
+
+    @staticmethod
+    def build_fade_level(
+        from_level: int,
+        to_level: int,
+        duration_ms: int,
+        start: int = 0,
+        count: int = 0,
+        easing: int = FADE_LINEAR,
+        replace: bool = False,
+    ) -> bytes:
+        """Build a FADE_TO packet ramping the current colors' brightness."""
+        payload = struct.pack(
+            "<BBBIHHBB",
+            FADE_LEVEL,
+            easing,
+            FADE_REPLACE if replace else 0,
+            duration_ms,
+            start,
+            count,
+            from_level,
+            to_level,
+        )
+        return LtpProtocol.build_packet(CMD_FADE_TO, payload)
+
+    @staticmethod
+    def build_shader_load(
+        code: bytes = b"",
+        flags: int = SHADER_RUN,
+        fps: int = 0,
+        budget: int = 0,
+        start: int = 0,
+        count: int = 0,
+        test_time_ms: int = 0,
+    ) -> bytes:
+        """Build a SHADER_LOAD packet; empty code keeps the loaded program."""
+        payload = struct.pack("<BBHHHH", flags, fps, budget, start, count, test_time_ms & 0xFFFF)
+        return LtpProtocol.build_packet(CMD_SHADER_LOAD, payload + bytes(code))
+
+    @staticmethod
+    def build_shader_param(first: int, values: list[int]) -> bytes:
+        """Build a SHADER_PARAM packet setting parameters first.. to values."""
+        payload = bytes([first]) + b"".join(struct.pack("<H", v & 0xFFFF) for v in values)
+        return LtpProtocol.build_packet(CMD_SHADER_PARAM, payload)
+
+    @staticmethod
+    def build_coords_write(start: int, coords: list[tuple[int, int, int]]) -> bytes:
+        """Build a COORDS write of (x, y, z) for pixels start.. onwards."""
+        payload = struct.pack("<BH", COORDS_WRITE, start)
+        payload += b"".join(struct.pack("<hhh", x, y, z) for x, y, z in coords)
+        return LtpProtocol.build_packet(CMD_COORDS, payload)
+
+    @staticmethod
+    def build_coords_read(start: int, count: int) -> bytes:
+        """Build a COORDS read of count pixels' coordinates from start."""
+        return LtpProtocol.build_packet(CMD_COORDS, struct.pack("<BHH", COORDS_READ, start, count))
+
+    @staticmethod
+    def build_coords(op: int) -> bytes:
+        """Build a COORDS CLEAR, SAVE or INFO packet."""
+        return LtpProtocol.build_packet(CMD_COORDS, bytes([op]))
+
+    @staticmethod
+    def build_vis_config(
+        mode: int,
+        flags: int = 0,
+        start: int = 0,
+        count: int = 0,
+        bars: int = 1,
+        gap: int = 1,
+        segments: int = 10,
+        fall: Optional[int] = None,
+        hold: Optional[int] = None,
+        yellow: int = 153,
+        red: int = 217,
+        color1: Tuple[int, int, int] = (0, 255, 0),
+        color2: Tuple[int, int, int] = (255, 0, 0),
+        background: Tuple[int, int, int] = (0, 0, 0),
+    ) -> bytes:
+        """
+        Build a VIS_CONFIG packet. fall and hold are in 1/10 s; None takes
+        the firmware default (1.5 s and 1 s for VIS_METER, else 0).
+        """
+        if mode == VIS_OFF:
+            return LtpProtocol.build_packet(CMD_VIS_CONFIG, bytes([VIS_OFF]))
+        meter = mode == VIS_METER
+        payload = struct.pack(
+            "<BBHHBBBBBBB3s3s3s",
+            mode,
+            flags,
+            start,
+            count,
+            bars,
+            gap,
+            segments,
+            (15 if meter else 0) if fall is None else fall,
+            (10 if meter else 0) if hold is None else hold,
+            yellow,
+            red,
+            bytes(color1),
+            bytes(color2),
+            bytes(background),
+        )
+        return LtpProtocol.build_packet(CMD_VIS_CONFIG, payload)
+
+    @staticmethod
+    def build_vis_value(values: list[int]) -> bytes:
+        """Build a VIS_VALUE packet, one value (0-255) per bar."""
+        return LtpProtocol.build_packet(CMD_VIS_VALUE, bytes(values))
+
+    @staticmethod
+    def build_audio_start(gain: int = 0, threshold: int = 0) -> bytes:
+        """
+        Build an AUDIO START packet. gain is dB of boost (0 = automatic),
+        threshold the beat threshold in 1/64 (0 = firmware default 1.4x).
+        """
+        return LtpProtocol.build_packet(CMD_AUDIO, bytes([AUDIO_START, gain, threshold]))
+
+    @staticmethod
+    def build_audio(operation: int) -> bytes:
+        """Build an AUDIO STOP or INFO packet."""
+        return LtpProtocol.build_packet(CMD_AUDIO, bytes([operation]))
+
+    @staticmethod
+    def build_scene(operation: int, scene_id: Optional[int] = None) -> bytes:
+        """Build a SCENE STORE, DELETE (with scene_id) or INFO packet."""
+        payload = bytes([operation]) if scene_id is None else bytes([operation, scene_id])
+        return LtpProtocol.build_packet(CMD_SCENE, payload)
+
+    @staticmethod
+    def build_scene_upload(scene_id: int, start: int, colors: list[tuple[int, int, int]]) -> bytes:
+        """Build a SCENE UPLOAD packet writing colors from pixel start."""
+        payload = struct.pack("<BBH", SCENE_UPLOAD, scene_id, start) + b"".join(bytes(c) for c in colors)
+        return LtpProtocol.build_packet(CMD_SCENE, payload)
+
+    @staticmethod
+    def build_scene_recall(scene_id: int, fade_ms: int = 0, easing: int = FADE_LINEAR) -> bytes:
+        """Build a SCENE RECALL packet; fade_ms 0 shows the scene at once."""
+        if fade_ms:
+            payload = struct.pack("<BBIB", SCENE_RECALL, scene_id, fade_ms, easing)
+        else:
+            payload = bytes([SCENE_RECALL, scene_id])
+        return LtpProtocol.build_packet(CMD_SCENE, payload)
+
+    @staticmethod
+    def build_sequence(operation: int) -> bytes:
+        """Build a SEQUENCE STOP, SYNC or INFO packet."""
+        return LtpProtocol.build_packet(CMD_SEQUENCE, bytes([operation]))
+
+    @staticmethod
+    def build_sequence_play(source: int = SEQ_FLASH, name: str = "", loop: bool = False) -> bytes:
+        """Build a SEQUENCE PLAY packet for the flash sequence or an SD file."""
+        payload = bytes([SEQ_PLAY, source, SEQ_LOOP if loop else 0]) + name.encode("ascii")
+        return LtpProtocol.build_packet(CMD_SEQUENCE, payload)
+
+    @staticmethod
+    def build_sequence_seek(frame: int) -> bytes:
+        """Build a SEQUENCE SEEK packet."""
+        return LtpProtocol.build_packet(CMD_SEQUENCE, struct.pack("<BI", SEQ_SEEK, frame))
+
+    @staticmethod
+    def build_layer(operation: int) -> bytes:
+        """Build a LAYER CLEAR or INFO packet."""
+        return LtpProtocol.build_packet(CMD_LAYER, bytes([operation]))
+
+    @staticmethod
+    def build_layer_config(
+        layer_id: int, start: int, count: int, blend: int = LAYER_OVER,
+        opacity: int = 255, flags: int = 0,
+    ) -> bytes:
+        """Build a LAYER CONFIG packet; count 0 turns the layer off."""
+        payload = struct.pack("<BBBBBHH", LAYER_CONFIG, layer_id, blend, opacity, flags, start, count)
+        return LtpProtocol.build_packet(CMD_LAYER, payload)
+
+    @staticmethod
+    def build_layer_opacity(layer_id: int, opacity: int, blend: Optional[int] = None) -> bytes:
+        """Build a LAYER OPACITY packet, optionally changing the blend mode."""
+        payload = bytes([LAYER_OPACITY, layer_id, opacity])
+        if blend is not None:
+            payload += bytes([blend])
+        return LtpProtocol.build_packet(CMD_LAYER, payload)
+
+    @staticmethod
+    def build_layer_pixels(layer_id: int, start: int, colors: list[tuple[int, int, int]]) -> bytes:
+        """Build a LAYER PIXELS packet writing colors from pixel start of the layer."""
+        payload = struct.pack("<BBH", LAYER_PIXELS, layer_id, start) + b"".join(bytes(c) for c in colors)
+        return LtpProtocol.build_packet(CMD_LAYER, payload)
+
+    @staticmethod
+    def build_layer_fill(
+        layer_id: int, start: int, end: int, colors: list[tuple[int, int, int]],
+        positions: Optional[list[int]] = None,
+    ) -> bytes:
+        """
+        Build a LAYER FILL packet over pixels start to end - 1 of the layer:
+        one color fills them, more make a gradient.
+        """
+        data = _fill_pattern(colors) if len(colors) == 1 else _fill_gradient(colors, positions)
+        payload = struct.pack("<BBHH", LAYER_FILL, layer_id, start, end) + data
+        return LtpProtocol.build_packet(CMD_LAYER, payload)
+
+    @staticmethod
+    def build_palette_info() -> bytes:
+        """Build a PALETTE INFO packet."""
+        return LtpProtocol.build_packet(CMD_PALETTE, bytes([PAL_INFO]))
+
+    @staticmethod
+    def build_palette_set(first: int, colors: list[tuple[int, int, int]]) -> bytes:
+        """Build a PALETTE SET packet loading colors into entries from first."""
+        payload = bytes([PAL_SET, first]) + b"".join(bytes(c) for c in colors)
+        return LtpProtocol.build_packet(CMD_PALETTE, payload)
+
+    @staticmethod
+    def build_palette_indices(start: int, indices: list[int], bits: int = 4) -> bytes:
+        """
+        Build a PALETTE INDICES packet writing palette entries from pixel
+        start, packed at the device's index width (4 bits: two per byte,
+        first pixel in the high nibble).
+        """
+        if bits == 4:
+            padded = list(indices) + [0] * (len(indices) & 1)
+            data = bytes((padded[i] << 4) | padded[i + 1] for i in range(0, len(padded), 2))
+        else:
+            data = bytes(indices)
+        return LtpProtocol.build_packet(CMD_PALETTE, struct.pack("<BH", PAL_INDICES, start) + data)
+
+    @staticmethod
+    def build_palette_rotate(first: int = 0, count: int = 0, step: int = 1, interval_ms: int = 0) -> bytes:
+        """
+        Build a PALETTE ROTATE packet: entries first to first + count - 1
+        (count 0 = to the last entry) move step entries up, once, or every
+        interval_ms until ANIM_STOP or another ROTATE.
+        """
+        payload = struct.pack("<BBBbH", PAL_ROTATE, first, count & 0xFF, step, interval_ms)
+        return LtpProtocol.build_packet(CMD_PALETTE, payload)
+
+    @staticmethod
+    def build_display_list(clear: bool = False) -> bytes:
+        """Build a DISPLAY_LIST packet reading the span list usage."""
+        return LtpProtocol.build_packet(CMD_DISPLAY_LIST, bytes([0x01 if clear else 0x00]))
+
+    @staticmethod
+    def build_trace(start: int = 0, clear: bool = False) -> bytes:
+        """Build a TRACE packet reading the packet trace from sequence number start."""
+        payload = struct.pack("<BI", 0x01 if clear else 0x00, start)
+        return LtpProtocol.build_packet(CMD_TRACE, payload)
+
     @staticmethod
     def build_get_pixels(strip_id: int, start: int, count: int) -> bytes:
         """Build a GET_PIXELS packet."""
@@ -416,6 +1018,43 @@ class LtpProtocol:
         payload = struct.pack("<BHH", strip_id, start, count) + pixel_data
         return LtpProtocol.build_packet(CMD_PIXEL_FRAME, payload)
 
+    @staticmethod
+    def build_pixel_fill_gradient(
+        strip_id: int, start: int, end: int, colors: list[tuple[int, int, int]],
+        positions: Optional[list[int]] = None,
+    ) -> bytes:
+        """Build a PIXEL_FILL gradient through colors, evenly spaced or at positions (0-255)."""
+        payload = struct.pack("<BHH", strip_id, start, end) + _fill_gradient(colors, positions)
+        return LtpProtocol.build_packet(CMD_PIXEL_FILL, payload)
+
+    @staticmethod
+    def build_pixel_fill_pattern(
+        strip_id: int, start: int, end: int, colors: list[tuple[int, int, int]],
+        width: int = 1, offset: int = 0,
+    ) -> bytes:
+        """Build a PIXEL_FILL repeating colors, width pixels each, shifted by offset."""
+        payload = struct.pack("<BHH", strip_id, start, end) + _fill_pattern(colors, width, offset)
+        return LtpProtocol.build_packet(CMD_PIXEL_FILL, payload)
+
+    @staticmethod
+    def build_pixel_fill_stride(
+        strip_id: int, start: int, end: int, color: tuple[int, int, int],
+        stride: int, width: int = 1, phase: int = 0,
+    ) -> bytes:
+        """Build a PIXEL_FILL lighting width pixels of every stride, from start + phase."""
+        payload = struct.pack("<BHH", strip_id, start, end) + _fill_stride(color, stride, width, phase)
+        return LtpProtocol.build_packet(CMD_PIXEL_FILL, payload)
+
+    @staticmethod
+    def build_set_strip(
+        strip_id: int, pixels: int, color_format: int, led_type: int,
+        data_pin: int, clock_pin: int = 0, flags: int = 0,
+    ) -> bytes:
+        """Build a SET_STRIP packet."""
+        payload = struct.pack("<BHBBBBB", strip_id, pixels, color_format, led_type,
+                              data_pin, clock_pin, flags)
+        return LtpProtocol.build_packet(CMD_SET_STRIP, payload)
+
     @staticmethod
     def build_set_control_uint8(control_id: int, value: int) -> bytes:
         """Build a SET_CONTROL packet for UINT8 value."""
@@ -0,0 +1,275 @@
+"""
+LTP Serial Protocol v2 - Stored Sequence Files
+
+Writes and reads the "LSQ1" sequences the firmware plays on its own
+(SEQUENCE command 0x6B, arduino/ltp_serial_v2/sequence.h), either from an
+SD card or compiled into the sketch as a PROGMEM array.
+
+File layout (all integers little-endian):
+    Header  b"LSQ1", uint8 header size (16), uint8 flags (0),
+            uint16 pixels, uint32 frames, uint32 duration (ms)
+    Frame   uint16 data length, uint16 hold (ms until the next frame),
+            uint8 flags (SEQ_FRAME_KEY, SEQ_FRAME_CUE), then data: runs of
+            uint8 skip, uint8 count, then R, G, B once, or per pixel when
+            count has SEQ_RUN_LITERAL set
+
+A run leaves skip pixels unchanged and sets the next count (up to 127) to
+one color, or to a color each. Key frames cover every pixel, so the device
+can seek to them; the frames between hold only what changed.
+"""
+
+import struct
+from dataclasses import dataclass
+from typing import Iterator, Optional, Sequence
+
+from .capture import read_capture
+from .protocol import (
+    CMD_PIXEL_FRAME,
+    CMD_PIXEL_SET_ALL,
+    CMD_PIXEL_SET_RANGE,
+    CMD_SHOW,
+    LtpProtocol,
+)
+
+SEQ_MAGIC = b"LSQ1"
+SEQ_FRAME_KEY = 0x01
+SEQ_FRAME_CUE = 0x02
+SEQ_RUN_LITERAL = 0x80
+
+_HEADER = struct.Struct("<4sBBHII")
+_FRAME = struct.Struct("<HHB")
+_SKIP_MAX = 255
+_RUN_MAX = 127
+_HOLD_MAX = 0xFFFF
+
+Color = tuple[int, int, int]
+
+
+@dataclass
+class SequenceFrame:
+    """One decoded frame: every pixel's color and how long it is shown."""
+
+    colors: list[Color]
+    hold_ms: int
+    key: bool = False
+    cue: bool = False
+
+
+class SequenceWriter:
+    """
+    Builds a sequence frame by frame.
+
+    Args:
+        pixels: Pixels per frame
+        key_interval: Frames between key frames (0 = only the first)
+    """
+
+    def __init__(self, pixels: int, key_interval: int = 30):
+        if not 0 < pixels <= 0xFFFF:
+            raise ValueError(f"Pixel count out of range: {pixels}")
+        self.pixels = pixels
+        self.key_interval = key_interval
+        self._frames: list[bytes] = []
+        self._previous: Optional[list[Color]] = None
+        self._duration = 0
+
+    @property
+    def frame_count(self) -> int:
+        return len(self._frames)
+
+    @property
+    def duration_ms(self) -> int:
+        return self._duration
+
+    def add_frame(self, colors: Sequence[Color], hold_ms: int, cue: bool = False) -> None:
+        """
+        Append a frame.
+
+        Args:
+            colors: (r, g, b) for every pixel
+            hold_ms: Time until the next frame, 0-65535 ms
+            cue: Wait for SEQUENCE sync from the host after this frame
+        """
+        if len(colors) != self.pixels:
+            raise ValueError(f"Frame has {len(colors)} pixels, expected {self.pixels}")
+        if not 0 <= hold_ms <= _HOLD_MAX:
+            raise ValueError(f"Hold out of range: {hold_ms}")
+        colors = [tuple(c) for c in colors]
+        index = len(self._frames)
+        key = self._previous is None or (self.key_interval > 0 and index % self.key_interval == 0)
+        data = _encode_runs(colors, None if key else self._previous)
+        flags = (SEQ_FRAME_KEY if key else 0) | (SEQ_FRAME_CUE if cue else 0)
+        self._frames.append(_FRAME.pack(len(data), hold_ms, flags) + data)
+        self._previous = colors
+        self._duration += hold_ms
+
+    def to_bytes(self) -> bytes:
+        header = _HEADER.pack(SEQ_MAGIC, _HEADER.size, 0, self.pixels,
+                              len(self._frames), self._duration)
+        return header + b"".join(self._frames)
+
+    def write(self, path: str) -> None:
+        with open(path, "wb") as f:
+            f.write(self.to_bytes())
+
+    def write_c_header(self, path: str, name: str = "SEQUENCE_DATA") -> None:
+        """Write the sequence as a PROGMEM array for a sketch to include."""
+        data = self.to_bytes()
+        guard = name.upper() + "_H"
+        lines = [
+            f"// LSQ1 sequence: {self.pixels} pixels, {len(self._frames)} frames, "
+            f"{self._duration} ms, {len(data)} bytes",
+            "// Generated by: python -m ltp_serial_cli PORT sequence build OUT.h",
+            "",
+            f"#ifndef {guard}",
+            f"#define {guard}",
+            "",
+            "#include <Arduino.h>",
+            "",
+            f"const uint8_t {name}[] PROGMEM = {{",
+        ]
+        for i in range(0, len(data), 16):
+            lines.append("    " + ", ".join(f"0x{b:02X}" for b in data[i:i + 16]) + ",")
+        lines += ["};", "", f"#endif // {guard}", ""]
+        with open(path, "w") as f:
+            f.write("\n".join(lines))
+
+
+def _encode_runs(colors: list[Color], previous: Optional[list[Color]]) -> bytes:
+    """Runs covering every pixel (previous None) or only the changed ones."""
+    n = len(colors)
+
+    def changed(k: int) -> bool:
+        return previous is None or colors[k] != previous[k]
+
+    def repeat(k: int) -> int:
+        """Changed pixels from k on with the color of k."""
+        j = k
+        while j < n and j - k < _RUN_MAX and colors[j] == colors[k] and changed(j):
+            j += 1
+        return j - k
+
+    out = bytearray()
+    i = 0
+    skip = 0
+    while i < n:
+        if not changed(i):
+            skip += 1
+            i += 1
+            continue
+        while skip > _SKIP_MAX:
+            # An empty run carries the excess skip
+            out += bytes([_SKIP_MAX, 0])
+            skip -= _SKIP_MAX
+        count = repeat(i)
+        if count >= 2:
+            out += bytes([skip, count, *colors[i]])
+        else:
+            # Literal colors up to the next unchanged pixel or repeat
+            count = 1
+            while i + count < n and count < _RUN_MAX and changed(i + count) and repeat(i + count) < 3:
+                count += 1
+            out += bytes([skip, SEQ_RUN_LITERAL | count])
+            for c in colors[i:i + count]:
+                out += bytes(c)
+        skip = 0
+        i += count
+    return bytes(out)
+
+
+def read_sequence(data: bytes) -> tuple[int, Iterator[SequenceFrame]]:
+    """
+    Decode a sequence as the firmware does.
+
+    Returns:
+        The pixel count and an iterator over the frames
+    """
+    if len(data) < _HEADER.size:
+        raise ValueError("Sequence too short")
+    magic, header_size, _flags, pixels, frames, _duration = _HEADER.unpack_from(data)
+    if magic != SEQ_MAGIC or header_size < _HEADER.size:
+        raise ValueError("Not an LSQ1 sequence")
+
+    def frames_iter() -> Iterator[SequenceFrame]:
+        colors: list[Color] = [(0, 0, 0)] * pixels
+        pos = header_size
+        for _ in range(frames):
+            length, hold, flags = _FRAME.unpack_from(data, pos)
+            pos += _FRAME.size
+            end = pos + length
+            index = 0
+            while pos + 2 <= end:
+                skip, count = data[pos:pos + 2]
+                pos += 2
+                index += skip
+                literal = count & SEQ_RUN_LITERAL
+                color = (0, 0, 0)
+                for k in range(count & ~SEQ_RUN_LITERAL):
+                    if literal or k == 0:
+                        color = tuple(data[pos:pos + 3])
+                        pos += 3
+                    if index < pixels:
+                        colors[index] = color
+                    index += 1
+            pos = end
+            yield SequenceFrame(list(colors), hold, bool(flags & SEQ_FRAME_KEY),
+                                bool(flags & SEQ_FRAME_CUE))
+
+    return pixels, frames_iter()
+
+
+def from_capture(path: str, pixels: int, key_interval: int = 30) -> SequenceWriter:
+    """
+    Rebuild a sequence from the frames a host sent in a capture file
+    (ltp_serial_cli --capture): the pixel commands change a local frame and
+    every SHOW becomes a frame held until the next SHOW. PIXEL_SET_ALL,
+    PIXEL_SET_RANGE and PIXEL_FRAME (RGB) are followed; other commands are
+    ignored.
+    """
+    writer = SequenceWriter(pixels, key_interval)
+    parser = LtpProtocol()
+    colors: list[Color] = [(0, 0, 0)] * pixels
+    shown: Optional[list[Color]] = None
+    shown_at = 0
+    for record in read_capture(path):
+        if not record.is_host_to_device:
+            continue
+        for pkt in parser.feed(record.data):
+            p = pkt.payload
+            if pkt.cmd == CMD_PIXEL_SET_ALL and len(p) >= 4:
+                colors = [(p[1], p[2], p[3])] * pixels
+            elif pkt.cmd == CMD_PIXEL_SET_RANGE and len(p) >= 8:
+                _strip, start, end, r, g, b = struct.unpack_from("<BHHBBB", p)
+                for i in range(start, min(end, pixels)):
+                    colors[i] = (r, g, b)
+            elif pkt.cmd == CMD_PIXEL_FRAME and len(p) >= 5:
+                _strip, start, count = struct.unpack_from("<BHH", p)
+                for k in range(count):
+                    i = start + k
+                    if i < pixels and 5 + k * 3 + 3 <= len(p):
+                        colors[i] = tuple(p[5 + k * 3:8 + k * 3])
+            elif pkt.cmd == CMD_SHOW:
+                now = record.timestamp_us // 1000
+                if shown is not None:
+                    writer.add_frame(shown, min(now - shown_at, _HOLD_MAX))
+                shown = list(colors)
+                shown_at = now
+    if shown is not None:
+        writer.add_frame(shown, 0)
+    return writer
+
+
+def demo_sequence(pixels: int, frames: int = 32, hold_ms: int = 30) -> SequenceWriter:
+    """A dot with a fading tail that bounces along the strip."""
+    writer = SequenceWriter(pixels, key_interval=16)
+    span = max(pixels - 1, 1)
+    for n in range(frames):
+        phase = n * 2 * span // frames
+        head = phase if phase <= span else 2 * span - phase
+        colors: list[Color] = [(0, 0, 0)] * pixels
+        for t in range(4):
+            i = head - t if phase <= span else head + t
+            if 0 <= i < pixels:
+                colors[i] = (255 >> (2 * t), 64 >> (2 * t), 0)
+        writer.add_frame(colors, hold_ms)
+    return writer
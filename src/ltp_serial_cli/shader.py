@@ -0,0 +1,476 @@
+"""
+LTP Serial Protocol v2 - Pixel Shader Assembler and Reference Interpreter
+
+Pixel shaders are small bytecode programs the firmware runs once per pixel
+per frame (SHADER_LOAD command 0x64, arduino/ltp_serial_v2/shader.h). This
+module assembles them from text and runs them on the host with the same
+integer arithmetic, so a program can be checked before it is uploaded and
+the device's output compared against it (SHADER_TEST frame hashes).
+
+Assembly is one instruction per line; ';' starts a comment and 'name:'
+defines a jump label:
+
+    ; Rainbow that scrolls with time, brightness from parameter 0
+        load index
+        push 4
+        mul
+        load time
+        push 4
+        shr
+        add             ; hue
+        push 255        ; saturation
+        load p0         ; value
+        hsv
+
+Variables for load/store: index, count, time, frame, x, y, width, height,
+z (x, y and z come from the device's coordinate table for the pixels it
+covers, COORDS command 0x66; otherwise z is 0), p0-p7 (set with SHADER_PARAM), r0-r7 (registers, zero at the start of
+each frame) and red, green, blue (the output, zero at the start of each
+pixel). Only registers and outputs can be stored.
+"""
+
+import math
+import struct
+from dataclasses import dataclass
+from typing import Optional, Sequence
+
+SHADER_PARAMS = 8
+SHADER_REGS = 8
+SHADER_STACK = 16
+SHADER_DEFAULT_BUDGET = 256
+
+# Opcodes: name -> (opcode, operand bytes)
+OPCODES = {
+    "end": (0x00, 0),
+    "push8": (0x01, 1),
+    "push16": (0x02, 2),
+    "load": (0x03, 1),
+    "store": (0x04, 1),
+    "dup": (0x05, 0),
+    "drop": (0x06, 0),
+    "swap": (0x07, 0),
+    "over": (0x08, 0),
+    "add": (0x10, 0),
+    "sub": (0x11, 0),
+    "mul": (0x12, 0),
+    "div": (0x13, 0),
+    "mod": (0x14, 0),
+    "mul8": (0x15, 0),
+    "neg": (0x16, 0),
+    "abs": (0x17, 0),
+    "min": (0x18, 0),
+    "max": (0x19, 0),
+    "shl": (0x1A, 0),
+    "shr": (0x1B, 0),
+    "and": (0x1C, 0),
+    "or": (0x1D, 0),
+    "xor": (0x1E, 0),
+    "not": (0x1F, 0),
+    "eq": (0x20, 0),
+    "lt": (0x21, 0),
+    "gt": (0x22, 0),
+    "sin8": (0x28, 0),
+    "tri8": (0x29, 0),
+    "hash8": (0x2A, 0),
+    "clamp8": (0x2B, 0),
+    "lerp8": (0x2C, 0),
+    "hsv": (0x2D, 0),
+    "rgb": (0x2E, 0),
+    "hypot": (0x2F, 0),
+    "jmp": (0x30, 2),
+    "jz": (0x31, 2),
+    "jnz": (0x32, 2),
+}
+_OPERAND_SIZE = {op: size for op, size in OPCODES.values()}
+_JUMPS = {OPCODES["jmp"][0], OPCODES["jz"][0], OPCODES["jnz"][0]}
+
+# Variables for load/store
+VARIABLES = {
+    "index": 0x00,
+    "count": 0x01,
+    "time": 0x02,
+    "frame": 0x03,
+    "x": 0x04,
+    "y": 0x05,
+    "width": 0x06,
+    "height": 0x07,
+    "z": 0x08,
+    **{f"p{i}": 0x10 + i for i in range(SHADER_PARAMS)},
+    **{f"r{i}": 0x20 + i for i in range(SHADER_REGS)},
+    "red": 0x30,
+    "green": 0x31,
+    "blue": 0x32,
+}
+_INPUTS = 0x09
+_PARAM = 0x10
+_REG = 0x20
+_RED = 0x30
+
+
+def _loadable(var: int) -> bool:
+    return var < _INPUTS or _PARAM <= var < _PARAM + SHADER_PARAMS or _storable(var)
+
+
+def _storable(var: int) -> bool:
+    return _REG <= var < _REG + SHADER_REGS or _RED <= var <= _RED + 2
+
+
+class ShaderError(ValueError):
+    """A program that does not assemble or would be rejected by SHADER_LOAD."""
+
+
+def assemble(source: str) -> bytes:
+    """Assemble shader source text into bytecode."""
+    code = bytearray()
+    labels: dict[str, int] = {}
+    fixups: list[tuple[int, str, int]] = []
+
+    for line_no, line in enumerate(source.splitlines(), 1):
+        line = line.split(";", 1)[0].strip()
+        while ":" in line:
+            label, line = line.split(":", 1)
+            label = label.strip()
+            if not label.isidentifier() or label in labels:
+                raise ShaderError(f"line {line_no}: bad or duplicate label '{label}'")
+            labels[label] = len(code)
+            line = line.strip()
+        if not line:
+            continue
+
+        parts = line.split()
+        name = parts[0].lower()
+        args = parts[1:]
+        if name == "push":
+            if len(args) != 1:
+                raise ShaderError(f"line {line_no}: push takes one value")
+            value = _parse_int(args[0], line_no)
+            name = "push8" if 0 <= value <= 255 else "push16"
+        if name not in OPCODES:
+            raise ShaderError(f"line {line_no}: unknown instruction '{parts[0]}'")
+        op, size = OPCODES[name]
+        if len(args) != (1 if size else 0):
+            raise ShaderError(f"line {line_no}: {name} takes {'one operand' if size else 'no operands'}")
+
+        code.append(op)
+        if op in _JUMPS:
+            fixups.append((len(code), args[0], line_no))
+            code += b"\x00\x00"
+        elif name in ("load", "store"):
+            var = VARIABLES.get(args[0].lower())
+            if var is None or (name == "store" and not _storable(var)):
+                raise ShaderError(f"line {line_no}: cannot {name} '{args[0]}'")
+            code.append(var)
+        elif size == 1:
+            value = _parse_int(args[0], line_no)
+            if not 0 <= value <= 255:
+                raise ShaderError(f"line {line_no}: {value} out of range 0-255")
+            code.append(value)
+        elif size == 2:
+            value = _parse_int(args[0], line_no)
+            if not -32768 <= value <= 65535:
+                raise ShaderError(f"line {line_no}: {value} out of 16-bit range")
+            code += struct.pack("<H", value & 0xFFFF)
+
+    for offset, label, line_no in fixups:
+        if label not in labels:
+            raise ShaderError(f"line {line_no}: unknown label '{label}'")
+        code[offset:offset + 2] = struct.pack("<H", labels[label])
+    return bytes(code)
+
+
+def _parse_int(text: str, line_no: int) -> int:
+    try:
+        return int(text, 0)
+    except ValueError:
+        raise ShaderError(f"line {line_no}: bad number '{text}'") from None
+
+
+def validate(code: bytes) -> None:
+    """Raise ShaderError if SHADER_LOAD would reject the program."""
+    starts = set()
+    pc = 0
+    while pc < len(code):
+        op = code[pc]
+        size = _OPERAND_SIZE.get(op)
+        if size is None:
+            raise ShaderError(f"offset {pc}: unknown opcode 0x{op:02X}")
+        if pc + 1 + size > len(code):
+            raise ShaderError(f"offset {pc}: truncated operand")
+        if op == OPCODES["load"][0] and not _loadable(code[pc + 1]):
+            raise ShaderError(f"offset {pc}: cannot load variable 0x{code[pc + 1]:02X}")
+        if op == OPCODES["store"][0] and not _storable(code[pc + 1]):
+            raise ShaderError(f"offset {pc}: cannot store variable 0x{code[pc + 1]:02X}")
+        starts.add(pc)
+        pc += 1 + size
+    for pc in sorted(starts):
+        if code[pc] in _JUMPS:
+            target = code[pc + 1] | (code[pc + 2] << 8)
+            if target != len(code) and target not in starts:
+                raise ShaderError(f"offset {pc}: jump to {target} is not an instruction")
+
+
+@dataclass
+class ShaderFrame:
+    """One frame rendered by the reference interpreter."""
+
+    pixels: bytes                   # RGB, count * 3 bytes
+    steps: int = 0                  # Instructions run
+    max_pixel_steps: int = 0
+    faults: int = 0                 # Pixels ended by a stack error or the budget
+
+    @property
+    def hash(self) -> int:
+        """FNV-1a of the pixels, as SHADER_TEST reports it."""
+        return frame_hash(self.pixels)
+
+
+def frame_hash(pixels: bytes) -> int:
+    """32-bit FNV-1a hash of RGB bytes."""
+    h = 0x811C9DC5
+    for b in pixels:
+        h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def _s16(v: int) -> int:
+    v &= 0xFFFF
+    return v - 0x10000 if v & 0x8000 else v
+
+
+def _trunc_div(a: int, b: int) -> int:
+    q = abs(a) // abs(b)
+    return q if (a < 0) == (b < 0) else -q
+
+
+def _triangle8(x: int) -> int:
+    x &= 0xFF
+    return x << 1 if x < 128 else (255 - x) << 1
+
+
+def _sine8(x: int) -> int:
+    s = _triangle8(x + 64)
+    s += s >> 7
+    v = (((s * s) >> 8) * (768 - 2 * s)) >> 8
+    return min(v, 255)
+
+
+def _hash8(v: int) -> int:
+    h = ((v & 0xFFFF) * 40503) & 0xFFFF
+    h ^= h >> 8
+    return h & 0xFF
+
+
+def _lerp8(a: int, b: int, amount: int) -> int:
+    a, b, amount = a & 0xFF, b & 0xFF, amount & 0xFF
+    w = amount + (amount >> 7)
+    return (a * (256 - w) + b * w) >> 8
+
+
+def _clamp8(v: int) -> int:
+    return 0 if v < 0 else 255 if v > 255 else v
+
+
+def _hsv(h: int, s: int, v: int) -> list[int]:
+    h, s, v = h & 0xFF, s & 0xFF, v & 0xFF
+    sector = h // 43
+    rem = ((h - sector * 43) * 6) & 0xFF
+    p = (v * (255 - s)) >> 8
+    q = (v * (255 - ((s * rem) >> 8))) >> 8
+    t = (v * (255 - ((s * (255 - rem)) >> 8))) >> 8
+    return [
+        [v, t, p], [q, v, p], [p, v, t], [p, q, v], [t, p, v], [v, p, q],
+    ][min(sector, 5)]
+
+
+_BINARY = {
+    0x10: lambda a, b: a + b,
+    0x11: lambda a, b: a - b,
+    0x12: lambda a, b: a * b,
+    0x13: lambda a, b: _trunc_div(a, b) if b else 0,
+    0x14: lambda a, b: a - _trunc_div(a, b) * b if b else 0,
+    0x15: lambda a, b: (a * b) >> 8,
+    0x18: min,
+    0x19: max,
+    0x1A: lambda a, b: a << (b & 15),
+    0x1B: lambda a, b: a >> (b & 15),
+    0x1C: lambda a, b: a & b,
+    0x1D: lambda a, b: a | b,
+    0x1E: lambda a, b: a ^ b,
+    0x20: lambda a, b: int(a == b),
+    0x21: lambda a, b: int(a < b),
+    0x22: lambda a, b: int(a > b),
+    0x2F: lambda a, b: min(math.isqrt(a * a + b * b), 0x7FFF),
+}
+
+_UNARY = {
+    0x16: lambda a: -a,
+    0x17: abs,
+    0x1F: lambda a: int(a == 0),
+    0x28: _sine8,
+    0x29: _triangle8,
+    0x2A: _hash8,
+    0x2B: _clamp8,
+}
+
+
+class _Fault(Exception):
+    pass
+
+
+def _run_pixel(code: bytes, inputs: list[int], params: list[int], regs: list[int],
+               budget: int) -> tuple[list[int], int, bool]:
+    """Run one pixel; returns the output, instructions run and success."""
+    stack: list[int] = []
+    rgb = [0, 0, 0]
+    steps = 0
+    pc = 0
+
+    def need(n: int):
+        if len(stack) < n:
+            raise _Fault()
+
+    def push(v: int):
+        if len(stack) == SHADER_STACK:
+            raise _Fault()
+        stack.append(_s16(v))
+
+    try:
+        while pc < len(code):
+            if steps == budget:
+                return rgb, steps, False
+            steps += 1
+            op = code[pc]
+            pc += 1
+            if op == 0x00:
+                break
+            elif op == 0x01:
+                push(code[pc])
+                pc += 1
+            elif op == 0x02:
+                push(code[pc] | (code[pc + 1] << 8))
+                pc += 2
+            elif op == 0x03:
+                var = code[pc]
+                pc += 1
+                if var < _INPUTS:
+                    push(inputs[var])
+                elif var < _REG:
+                    push(params[var - _PARAM])
+                elif var < _RED:
+                    push(regs[var - _REG])
+                else:
+                    push(rgb[var - _RED])
+            elif op == 0x04:
+                var = code[pc]
+                pc += 1
+                need(1)
+                v = stack.pop()
+                if var < _RED:
+                    regs[var - _REG] = v
+                else:
+                    rgb[var - _RED] = v
+            elif op == 0x05:
+                need(1)
+                push(stack[-1])
+            elif op == 0x06:
+                need(1)
+                stack.pop()
+            elif op == 0x07:
+                need(2)
+                stack[-1], stack[-2] = stack[-2], stack[-1]
+            elif op == 0x08:
+                need(2)
+                push(stack[-2])
+            elif op in _BINARY:
+                need(2)
+                b = stack.pop()
+                stack[-1] = _s16(_BINARY[op](stack[-1], b))
+            elif op in _UNARY:
+                need(1)
+                stack[-1] = _s16(_UNARY[op](stack[-1]))
+            elif op == 0x2C:
+                need(3)
+                t = stack.pop()
+                b = stack.pop()
+                stack[-1] = _lerp8(stack[-1], b, t)
+            elif op in (0x2D, 0x2E):
+                need(3)
+                values = stack[-3:]
+                del stack[-3:]
+                rgb = _hsv(*values) if op == 0x2D else values
+            elif op == 0x30:
+                pc = code[pc] | (code[pc + 1] << 8)
+            elif op in (0x31, 0x32):
+                need(1)
+                zero = stack.pop() == 0
+                if zero == (op == 0x31):
+                    pc = code[pc] | (code[pc + 1] << 8)
+                else:
+                    pc += 2
+    except _Fault:
+        return rgb, steps, False
+    return rgb, steps, True
+
+
+def render(
+    code: bytes,
+    count: int,
+    time_ms: int = 0,
+    frame: int = 0,
+    params: Sequence[int] = (),
+    start: int = 0,
+    width: Optional[int] = None,
+    height: Optional[int] = None,
+    budget: int = 0,
+    coords: Sequence[tuple[int, int, int]] = (),
+) -> ShaderFrame:
+    """
+    Render one frame of pixels start..start+count-1 as the firmware would.
+    width and height are the device's (ANIM_STATUS reports them); by default
+    the pixels form one row. coords is the device's coordinate table, (x, y,
+    z) for logical pixels 0.. onwards. budget 0 is the firmware default.
+    """
+    validate(code)
+    width = width or start + count
+    height = height or (start + count + width - 1) // width
+    budget = budget or SHADER_DEFAULT_BUDGET
+    p = [_s16(v) for v in params] + [0] * (SHADER_PARAMS - len(params))
+    regs = [0] * SHADER_REGS
+    out = bytearray()
+    result = ShaderFrame(b"")
+    x, y = start % width, start // width
+    for i in range(count):
+        px, py, pz = coords[start + i] if start + i < len(coords) else (x, y, 0)
+        inputs = [_s16(v) for v in (i, count, time_ms, frame, px, py, width, height, pz)]
+        rgb, steps, ok = _run_pixel(code, inputs, p, regs, budget)
+        out += bytes(_clamp8(c) for c in rgb)
+        result.steps += steps
+        result.max_pixel_steps = max(result.max_pixel_steps, steps)
+        result.faults += not ok
+        x += 1
+        if x == width:
+            x, y = 0, y + 1
+    result.pixels = bytes(out)
+    return result
+
+
+def disassemble(code: bytes) -> str:
+    """Readable listing of bytecode, one instruction per line with offsets."""
+    names = {op: name for name, (op, _) in OPCODES.items()}
+    var_names = {v: name for name, v in VARIABLES.items()}
+    lines = []
+    pc = 0
+    while pc < len(code):
+        op = code[pc]
+        size = _OPERAND_SIZE.get(op, 0)
+        text = names.get(op, f"db 0x{op:02X}")
+        if op in (OPCODES["load"][0], OPCODES["store"][0]) and pc + 1 < len(code):
+            text += f" {var_names.get(code[pc + 1], hex(code[pc + 1]))}"
+        elif size == 1 and pc + 1 < len(code):
+            text += f" {code[pc + 1]}"
+        elif size == 2 and pc + 2 < len(code):
+            value = code[pc + 1] | (code[pc + 2] << 8)
+            text += f" {value if op in _JUMPS else _s16(value)}"
+        lines.append(f"{pc:4d}  {code[pc:pc + 1 + size].hex(' '):<9} {text}")
+        pc += 1 + size
+    return "\n".join(lines)
@@ -100,6 +100,24 @@ def parse_args() -> argparse.Namespace:
         action="store_true",
         help="Show serial protocol packets sent/received",
     )
+    parser.add_argument(
+        "--capture",
+        type=str,
+        metavar="FILE",
+        help="Record serial link traffic to a capture file for replay",
+    )
+    parser.add_argument(
+        "--telemetry-interval",
+        type=int,
+        default=1,
+        metavar="SECONDS",
+        help="Device telemetry report interval, 0 to disable (default: 1)",
+    )
+    parser.add_argument(
+        "--probe-link",
+        action="store_true",
+        help="Measure link round trip and throughput on connect; cap the advertised refresh rate to it",
+    )
     parser.add_argument(
         "--no-serial",
         action="store_true",
@@ -151,6 +169,12 @@ def load_config(path: Path) -> SerialSinkConfig:
             config_dict["timeout"] = serial["timeout"]
         if "debug" in serial:
             config_dict["debug"] = serial["debug"]
+        if "capture" in serial:
+            config_dict["capture"] = serial["capture"]
+        if "telemetry_interval" in serial:
+            config_dict["telemetry_interval"] = serial["telemetry_interval"]
+        if "probe_link" in serial:
+            config_dict["probe_link"] = serial["probe_link"]
 
     return SerialSinkConfig(**config_dict)
 
@@ -186,6 +210,9 @@ def config_from_args(args: argparse.Namespace) -> SerialSinkConfig:
         dimensions=dimensions,
         color_format=color_map.get(args.color_format, ColorFormat.RGB),
         debug=args.debug,
+        capture=args.capture,
+        telemetry_interval=args.telemetry_interval,
+        probe_link=args.probe_link,
         no_serial=getattr(args, 'no_serial', False),
     )
 
@@ -310,9 +337,13 @@ def main() -> int:
             print(f"Error: Config file not found: {args.config}", file=sys.stderr)
             return 1
         config = load_config(args.config)
-        # Override debug from command line
+        # Override debug/capture/probe from command line
         if args.debug:
             config = SerialSinkConfig(**{**config.model_dump(), "debug": True})
+        if args.capture:
+            config = SerialSinkConfig(**{**config.model_dump(), "capture": args.capture})
+        if args.probe_link:
+            config = SerialSinkConfig(**{**config.model_dump(), "probe_link": True})
     else:
         config = config_from_args(args)
 
@@ -340,6 +371,8 @@ def main() -> int:
         print(f"  Pixels: {config.pixels if config.pixels > 0 else 'auto-detect'}")
         print(f"  Serial port: {config.port}")
         print(f"  Baud rate: {config.baudrate}")
+        if config.capture:
+            print(f"  Capture: {config.capture}")
     if config.dimensions:
         print(f"  Dimensions: {config.dimensions}")
     print(f"  Debug packets: {config.debug}")
@@ -33,6 +33,7 @@ from libltp.types import StreamAction
 from libltp.transport import ControlServer, DataReceiver, StreamManager
 
 from ltp_serial_sink.v2_renderer import V2Renderer, V2RendererConfig
+from ltp_serial_cli import DeviceTelemetry
 from ltp_serial_cli.protocol import CTRL_ID_BRIGHTNESS, CTRL_ID_GAMMA
 
 logger = logging.getLogger(__name__)
@@ -65,6 +66,15 @@ class SerialSinkConfig(BaseModel):
     # Debug options
     debug: bool = False  # Show packets sent/received
     debug_file: TextIO | None = None
+    capture: str | None = None  # Record serial link traffic to this file
+
+    # Device telemetry (STATUS_UPDATE) interval in seconds, 0 = off. Shown
+    # as read-only controls in the "telemetry" group.
+    telemetry_interval: int = 1
+
+    # Measure the link (ECHO/SINK) on connect and advertise no more than
+    # the frame rate it can carry
+    probe_link: bool = False
 
     # Test mode
     no_serial: bool = False  # Run without serial device (network test only)
@@ -100,9 +110,13 @@ class SerialSink:
                 timeout=self.config.timeout,
                 debug=self.config.debug,
                 debug_file=self.config.debug_file or sys.stderr,
+                capture=self.config.capture,
                 auto_show=True,
+                telemetry_interval=self.config.telemetry_interval,
+                probe_link=self.config.probe_link,
             )
             self._renderer = V2Renderer(renderer_config)
+            self._renderer.on_telemetry = self._update_telemetry_controls
 
         # Controls registry - will be populated after device connection
         self._controls = ControlRegistry()
@@ -194,8 +208,57 @@ class SerialSink:
                 )
             )
 
+        if self.config.telemetry_interval:
+            self._setup_telemetry_controls()
+
         logger.info(f"Device controls registered: {[c.id for c in self._controls._controls.values()]}")
 
+    # Read-only controls fed by device telemetry: (id, name, description, unit)
+    TELEMETRY_CONTROLS = [
+        ("device_fps", "Device FPS", "Frames shown per second by the controller", "fps"),
+        ("device_rx_fps", "Device Receive FPS", "Frames received per second by the controller", "fps"),
+        ("device_rx_high_water", "RX High Water", "Most bytes queued in the device receive buffer", "bytes"),
+        ("device_errors", "Link Errors", "Checksum and framing errors in the last report period", ""),
+        ("device_show_us", "Show Time", "Mean LED show() time", "us"),
+    ]
+
+    def _setup_telemetry_controls(self) -> None:
+        """Register read-only controls updated from device telemetry."""
+        for control_id, name, description, unit in self.TELEMETRY_CONTROLS:
+            self._controls.register(
+                NumberControl(
+                    id=control_id,
+                    name=name,
+                    description=description,
+                    value=0.0,
+                    unit=unit,
+                    readonly=True,
+                    group="telemetry",
+                )
+            )
+
+    def _update_telemetry_controls(self, telemetry: DeviceTelemetry) -> None:
+        """Store a telemetry report in the telemetry controls (reader thread)."""
+        values = {
+            "device_fps": round(telemetry.display_fps, 1),
+            "device_rx_fps": round(telemetry.receive_fps, 1),
+            "device_rx_high_water": float(telemetry.rx_high_water),
+            "device_errors": float(telemetry.errors),
+            "device_show_us": float(telemetry.show_mean_us),
+        }
+        for control_id, value in values.items():
+            control = self._controls.get(control_id)
+            if control is not None:
+                # Read-only controls reject set_value(); replace the model instead
+                self._controls.register(control.model_copy(update={"value": value}))
+
+    def _max_refresh_hz(self) -> int:
+        """Configured refresh rate, capped by the measured link if probed."""
+        link_fps = self._renderer.link_max_fps if self._renderer else None
+        if link_fps is None:
+            return self.config.max_refresh_hz
+        return max(1, min(self.config.max_refresh_hz, int(link_fps)))
+
     def _update_from_device(self) -> None:
         """Update configuration from connected device."""
         if self._renderer is None:
@@ -269,7 +332,7 @@ class SerialSink:
             "dimensions": self._dimensions or [self._pixel_count],
             "topology": topology_dict,
             "color_formats": [self.config.color_format.name.lower()],
-            "max_refresh_hz": self.config.max_refresh_hz,
+            "max_refresh_hz": self._max_refresh_hz(),
             "protocol_version": "0.1",
             "controls": self._controls.to_list(),
             "backend": {
@@ -638,7 +701,7 @@ class SerialSink:
             pixels=self._pixel_count,
             dimensions=self._dimensions,
             color_format=self.config.color_format,
-            max_rate=self.config.max_refresh_hz,
+            max_rate=self._max_refresh_hz(),
             has_controls=True,
         )
         await self._advertiser.start()
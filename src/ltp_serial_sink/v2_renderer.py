@@ -6,8 +6,9 @@ running the ltp_serial_v2 firmware.
 
 import logging
 import sys
+import time
 from dataclasses import dataclass, field
-from typing import Any, TextIO
+from typing import Any, Callable, TextIO
 
 import numpy as np
 
@@ -23,6 +24,8 @@ from ltp_serial_cli import (
     DeviceInfo,
     DeviceStatus,
     DeviceStats,
+    DeviceTelemetry,
+    LinkProbe,
     StripInfo,
     LtpError,
     LtpConnectionError,
@@ -50,11 +53,18 @@ class V2RendererConfig:
     # Debug options
     debug: bool = False
     debug_file: TextIO | None = None
+    capture: str | None = None  # Record link traffic to this capture file
 
     # Frame options
     auto_show: bool = True  # Automatically call show() after sending pixels
     use_frame_ack: bool = False  # Wait for frame acknowledgment
 
+    # Device telemetry (STATUS_UPDATE) report interval in seconds, 0 = off
+    telemetry_interval: int = 1
+
+    # Measure round-trip time and throughput (ECHO/SINK) on connect
+    probe_link: bool = False
+
 
 @dataclass
 class DeviceControl:
@@ -92,6 +102,10 @@ class V2Renderer:
         # Device info cached after connection
         self._device_info: DeviceInfo | None = None
         self._controls: dict[int, DeviceControl] = {}
+        self._link: LinkProbe | None = None
+
+        # Called from the device reader thread with each telemetry report
+        self.on_telemetry: Callable[[DeviceTelemetry], None] | None = None
 
     def is_connected(self) -> bool:
         """Check if device is connected."""
@@ -110,6 +124,7 @@ class V2Renderer:
             timeout=self.config.timeout,
             debug=self.config.debug,
             debug_file=self.config.debug_file,
+            capture=self.config.capture,
         )
 
         try:
@@ -129,11 +144,17 @@ class V2Renderer:
                 # Build controls list from device capabilities
                 self._populate_controls()
 
+            if self.config.probe_link:
+                self._probe_link()
+
             # Configure device for streaming
             if self.config.auto_show:
                 self._device.set_auto_show(True)
             if self.config.use_frame_ack:
                 self._device.set_frame_ack(True)
+            if self.config.telemetry_interval:
+                self._device.set_telemetry_callback(self._handle_telemetry)
+                self._device.set_status_interval(self.config.telemetry_interval)
 
         except LtpError as e:
             logger.error(f"Failed to connect: {e}")
@@ -146,6 +167,42 @@ class V2Renderer:
                 self._device = None
             raise
 
+    def _probe_link(self) -> None:
+        try:
+            self._link = self._device.probe_link()
+        except LtpError as e:
+            # Firmware without ECHO/SINK: stream without a measured limit
+            logger.warning(f"Link probe failed: {e}")
+            self._link = None
+            return
+        logger.info(
+            f"Link: {self._link.rtt_min_ms:.1f} ms round trip, "
+            f"{self._link.downstream_bytes_per_second / 1000:.1f} KB/s down, "
+            f"{self._link.upstream_bytes_per_second / 1000:.1f} KB/s up, "
+            f"{self._link.loss:.1%} loss, max {self.link_max_fps:.1f} FPS"
+        )
+
+    @property
+    def link(self) -> LinkProbe | None:
+        """Link measurement from the last connect, if probe_link is set."""
+        return self._link
+
+    @property
+    def link_max_fps(self) -> float | None:
+        """Full frames per second the measured link can carry."""
+        if not self._link or not self.pixel_count:
+            return None
+        return self._link.max_fps(self.pixel_count)
+
+    def _handle_telemetry(self, telemetry: DeviceTelemetry) -> None:
+        if self.on_telemetry:
+            self.on_telemetry(telemetry)
+
+    @property
+    def telemetry(self) -> DeviceTelemetry | None:
+        """Most recent device telemetry report, if enabled."""
+        return self._device.telemetry if self._device else None
+
     def _populate_controls(self) -> None:
         """Populate controls dict from device capabilities."""
         self._controls.clear()
@@ -329,6 +386,37 @@ class V2Renderer:
                 "checksum_errors": device_stats.checksum_errors if device_stats else 0,
                 "uptime_seconds": device_stats.uptime_seconds if device_stats else 0,
             } if device_stats else None,
+            "telemetry": self._telemetry_dict(),
+            "link": self._link_dict(),
+        }
+
+    def _link_dict(self) -> dict[str, Any] | None:
+        link = self._link
+        if not link:
+            return None
+        return {
+            "rtt_min_ms": round(link.rtt_min_ms, 2),
+            "rtt_mean_ms": round(link.rtt_mean_ms, 2),
+            "downstream_bytes_per_second": round(link.downstream_bytes_per_second),
+            "upstream_bytes_per_second": round(link.upstream_bytes_per_second),
+            "loss": round(link.loss, 4),
+            "max_fps": round(self.link_max_fps or 0, 1),
+        }
+
+    def _telemetry_dict(self) -> dict[str, Any] | None:
+        t = self.telemetry
+        if not t:
+            return None
+        return {
+            "receive_fps": round(t.receive_fps, 1),
+            "display_fps": round(t.display_fps, 1),
+            "rx_queued": t.rx_queued,
+            "rx_high_water": t.rx_high_water,
+            "checksum_errors": t.checksum_errors,
+            "framing_errors": t.framing_errors,
+            "show_mean_us": t.show_mean_us,
+            "show_max_us": t.show_max_us,
+            "age_seconds": round(time.time() - t.received_at, 1),
         }
 
     @staticmethod